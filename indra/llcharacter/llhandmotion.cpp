@@ -112,7 +112,8 @@ BOOL LLHandMotion::onActivate()
 			mCharacter->setVisualParamWeight(gHandPoseNames[i], 0.f);
 		}
 		mCharacter->setVisualParamWeight(gHandPoseNames[mCurrentPose], 1.f);
-		mCharacter->updateVisualParams();
+		//mCharacter->updateVisualParams();
+		mCharacter->getMotionController().requestVisualParamsUpdate(); // <polarity/>
 	}
 	return TRUE;
 }
@@ -154,7 +155,8 @@ BOOL LLHandMotion::onUpdate(F32 time, U8* joint_mask)
 			// Update visual params now if we won't blend
 			if (mCurrentPose == HAND_POSE_RELAXED)
 			{
-				mCharacter->updateVisualParams();
+				//mCharacter->updateVisualParams();
+				mCharacter->getMotionController().requestVisualParamsUpdate(); // <polarity/>
 			}
 		}
 		mNewPose = HAND_POSE_RELAXED;
@@ -187,7 +189,8 @@ BOOL LLHandMotion::onUpdate(F32 time, U8* joint_mask)
 				// Update visual params now if we won't blend
 				if (mCurrentPose == *requestedHandPose)
 				{
-					mCharacter->updateVisualParams();
+					//mCharacter->updateVisualParams();
+					mCharacter->getMotionController().requestVisualParamsUpdate(); // <polarity/>
 				}
 			}
 			mNewPose = *requestedHandPose;
@@ -226,7 +229,8 @@ BOOL LLHandMotion::onUpdate(F32 time, U8* joint_mask)
 			mCharacter->setVisualParamWeight(gHandPoseNames[mCurrentPose], outgoingWeight);
 		}
 
-		mCharacter->updateVisualParams();
+		//mCharacter->updateVisualParams();
+		mCharacter->getMotionController().requestVisualParamsUpdate(); // <polarity/>
 		
 		if (incomingWeight == 1.f && outgoingWeight == 0.f)
 		{
@@ -37,8 +37,8 @@
 #include "llcallstack.h"
 #include <boost/algorithm/string.hpp>
 
-S32 LLJoint::sNumUpdates = 0;
-S32 LLJoint::sNumTouches = 0;
+LLAtomic32<S32> LLJoint::sNumUpdates(0);
+LLAtomic32<S32> LLJoint::sNumTouches(0);
 
 template <class T>
 constexpr bool attachment_map_iter_compare_key(const T& a, const T& b)
@@ -112,6 +112,7 @@ void LLJoint::init()
 	mXform.setScale(LLVector3(1.0f, 1.0f, 1.0f));
 	mDirtyFlags = MATRIX_DIRTY | ROTATION_DIRTY | POSITION_DIRTY;
 	mUpdateXform = TRUE;
+	mTopologySerial = 0;
     mSupport = SUPPORT_BASE;
     mEnd = LLVector3(0.0f, 0.0f, 0.0f);
 }
@@ -283,6 +284,7 @@ void LLJoint::addChild(LLJoint* joint)
 	joint->mXform.setParent(&mXform);
 	joint->mParent = this;	
 	joint->touch();
+	bumpTopologySerial();
 }
 
 
@@ -299,6 +301,7 @@ void LLJoint::removeChild(LLJoint* joint)
 		joint->mXform.setParent(NULL);
 		joint->mParent = NULL;
 		joint->touch();
+		bumpTopologySerial();
 	}
 }
 
@@ -318,6 +321,18 @@ void LLJoint::removeAllChildren()
 		joint->mParent = NULL;
 		joint->touch();
 	}
+	bumpTopologySerial();
+}
+
+//--------------------------------------------------------------------
+// bumpTopologySerial()
+//--------------------------------------------------------------------
+void LLJoint::bumpTopologySerial()
+{
+	for (LLJoint* joint = this; joint; joint = joint->mParent)
+	{
+		joint->mTopologySerial++;
+	}
 }
 
 
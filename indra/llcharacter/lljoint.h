@@ -32,6 +32,7 @@
 //-----------------------------------------------------------------------------
 #include <list>
 
+#include "llatomic.h"
 #include "v3math.h"
 #include "v4math.h"
 #include "m4math.h"
@@ -131,9 +132,15 @@ public:
 	typedef std::list<LLJoint*> child_list_t;
 	child_list_t mChildren;
 
-	// debug statics
-	static S32		sNumTouches;
-	static S32		sNumUpdates;
+	// debug statics, the avatar update workers count too
+	static LLAtomic32<S32>	sNumTouches;
+	static LLAtomic32<S32>	sNumUpdates;
+
+	// bumped on this joint and all its ancestors whenever a parent/child
+	// link below it changes, lets a flattened copy of the tree rooted here
+	// (LLJointHierarchy) know it is stale. Links only change on the main
+	// thread, never while the avatar update workers run.
+	U32				mTopologySerial;
     typedef std::set<std::string> debug_joint_name_t;
     static debug_joint_name_t s_debugJointNames;
     static void setDebugJointNames(const debug_joint_name_t& names);
@@ -174,6 +181,7 @@ public:
 
 private:
 	void init();
+	void bumpTopologySerial();
 
 public:
 	// set name and parent
@@ -0,0 +1,182 @@
+/** 
+ * @file lljointhierarchy.cpp
+ * @brief Flattened, breadth-first copy of an LLJoint tree for fast world
+ * matrix updates.
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "lljointhierarchy.h"
+
+LLJointHierarchy::LLJointHierarchy()
+:	mRoot(NULL),
+	mTopologySerial(0)
+{
+}
+
+//-----------------------------------------------------------------------------
+// build()
+//-----------------------------------------------------------------------------
+void LLJointHierarchy::build(LLJoint* root)
+{
+	clear();
+	mRoot = root;
+	if (!mRoot)
+	{
+		return;
+	}
+	mTopologySerial = mRoot->mTopologySerial;
+
+	// breadth-first walk, mJoints doubles as the queue
+	mJoints.push_back(mRoot);
+	mParentIndices.push_back(-1);
+	for (U32 i = 0; i < mJoints.size(); ++i)
+	{
+		LLJoint* joint = mJoints[i];
+		for (LLJoint::child_list_t::iterator iter = joint->mChildren.begin();
+			 iter != joint->mChildren.end(); ++iter)
+		{
+			mJoints.push_back(*iter);
+			mParentIndices.push_back((S32)i);
+		}
+	}
+
+	const U32 count = mJoints.size();
+	mLocalPositions.resize(count);
+	mLocalRotations.resize(count);
+	mLocalScales.resize(count);
+	mWorldPositions.resize(count);
+	mWorldRotations.resize(count);
+	mWorldMatrices.resize(count);
+	mFlags.resize(count, 0);
+}
+
+//-----------------------------------------------------------------------------
+// clear()
+//-----------------------------------------------------------------------------
+void LLJointHierarchy::clear()
+{
+	mRoot = NULL;
+	mJoints.clear();
+	mParentIndices.clear();
+	mLocalPositions.clear();
+	mLocalRotations.clear();
+	mLocalScales.clear();
+	mWorldPositions.clear();
+	mWorldRotations.clear();
+	mWorldMatrices.clear();
+	mFlags.clear();
+}
+
+//-----------------------------------------------------------------------------
+// updateWorldMatrices()
+//-----------------------------------------------------------------------------
+void LLJointHierarchy::updateWorldMatrices()
+{
+	if (!mRoot)
+	{
+		return;
+	}
+
+	if (mTopologySerial != mRoot->mTopologySerial)
+	{
+		// something below the root was relinked
+		build(mRoot);
+	}
+
+	if (!mRoot->mUpdateXform)
+	{
+		return;
+	}
+
+	// The root may hang off a non-joint xform (e.g. a seat), so let
+	// LLXformMatrix deal with it.
+	mRoot->updateWorldMatrix();
+
+	const S32 count = (S32)mJoints.size();
+
+	// gather: one touch per joint to pull local transforms and state into
+	// the flat arrays
+	for (S32 i = 0; i < count; ++i)
+	{
+		LLJoint* joint = mJoints[i];
+		const S32 parent = mParentIndices[i];
+		U8 flags = 0;
+		if (joint->mUpdateXform && (parent < 0 || (mFlags[parent] & FLAG_ACTIVE)))
+		{
+			LLXformMatrix* xform = joint->getXform();
+			flags |= FLAG_ACTIVE;
+			if (joint->mDirtyFlags & LLJoint::MATRIX_DIRTY)
+			{
+				flags |= FLAG_DIRTY;
+			}
+			if (xform->getScaleChildOffset())
+			{
+				flags |= FLAG_SCALE_CHILD_OFFSET;
+			}
+			mLocalPositions[i] = xform->getPosition();
+			mLocalRotations[i] = xform->getRotation();
+			mLocalScales[i] = xform->getScale();
+			if (!(flags & FLAG_DIRTY))
+			{
+				mWorldPositions[i] = xform->getWorldPosition();
+				mWorldRotations[i] = xform->getWorldRotation();
+				mWorldMatrices[i] = xform->getWorldMatrix();
+			}
+		}
+		mFlags[i] = flags;
+	}
+
+	// solve: parents always precede children, so their world transform is
+	// final by the time we get to a child
+	for (S32 i = 1; i < count; ++i)
+	{
+		if ((mFlags[i] & (FLAG_ACTIVE | FLAG_DIRTY)) != (FLAG_ACTIVE | FLAG_DIRTY))
+		{
+			continue;
+		}
+		const S32 parent = mParentIndices[i];
+
+		LLVector3 world_pos = mLocalPositions[i];
+		if (mFlags[parent] & FLAG_SCALE_CHILD_OFFSET)
+		{
+			world_pos.scaleVec(mLocalScales[parent]);
+		}
+		world_pos *= mWorldRotations[parent];
+		world_pos += mWorldPositions[parent];
+		mWorldPositions[i] = world_pos;
+		mWorldRotations[i] = mLocalRotations[i] * mWorldRotations[parent];
+		mWorldMatrices[i].initAll(mLocalScales[i], mWorldRotations[i], mWorldPositions[i]);
+	}
+
+	// scatter the results back so the LLJoint API sees them
+	for (S32 i = 1; i < count; ++i)
+	{
+		if ((mFlags[i] & (FLAG_ACTIVE | FLAG_DIRTY)) != (FLAG_ACTIVE | FLAG_DIRTY))
+		{
+			continue;
+		}
+		LLJoint* joint = mJoints[i];
+		joint->getXform()->setWorldTransform(mWorldPositions[i], mWorldRotations[i], mWorldMatrices[i]);
+		joint->mDirtyFlags = 0x0;
+		LLJoint::sNumUpdates++;
+	}
+}
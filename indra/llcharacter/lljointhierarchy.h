@@ -0,0 +1,83 @@
+/** 
+ * @file lljointhierarchy.h
+ * @brief Flattened, breadth-first copy of an LLJoint tree for fast world
+ * matrix updates.
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLJOINTHIERARCHY_H
+#define LL_LLJOINTHIERARCHY_H
+
+#include "lljoint.h"
+
+//-----------------------------------------------------------------------------
+// class LLJointHierarchy
+// Keeps parent indices and local/world transforms of a joint tree in
+// contiguous arrays sorted breadth-first, so that every parent comes before
+// its children and the whole tree can be updated in one linear pass instead
+// of recursing through LLJoint::updateWorldMatrixChildren().
+//
+// The LLJoint objects stay authoritative: local transforms are read from
+// them and the resulting world transforms are written back, so joint
+// overrides, attachments and anything else using the LLJoint API keep
+// working unchanged.
+//-----------------------------------------------------------------------------
+class LLJointHierarchy
+{
+public:
+	LLJointHierarchy();
+
+	// (re)flatten the tree below root
+	void build(LLJoint* root);
+	void clear();
+
+	LLJoint* getRoot() const { return mRoot; }
+	S32 getNumJoints() const { return (S32)mJoints.size(); }
+	LLJoint* getJoint(S32 index) const { return mJoints[index]; }
+	S32 getParentIndex(S32 index) const { return mParentIndices[index]; }
+	const LLMatrix4& getWorldMatrix(S32 index) const { return mWorldMatrices[index]; }
+
+	// same result as getRoot()->updateWorldMatrixChildren()
+	void updateWorldMatrices();
+
+private:
+	LLJoint*					mRoot;
+	U32							mTopologySerial;
+
+	// all arrays are indexed in breadth-first order
+	std::vector<LLJoint*>		mJoints;
+	std::vector<S32>			mParentIndices; // -1 for the root
+	std::vector<LLVector3>		mLocalPositions;
+	std::vector<LLQuaternion>	mLocalRotations;
+	std::vector<LLVector3>		mLocalScales;
+	std::vector<LLVector3>		mWorldPositions;
+	std::vector<LLQuaternion>	mWorldRotations;
+	std::vector<LLMatrix4>		mWorldMatrices;
+
+	enum
+	{
+		FLAG_ACTIVE = 0x1,				// mUpdateXform set on the joint and all its ancestors
+		FLAG_DIRTY = 0x2,				// world matrix needs recomputing
+		FLAG_SCALE_CHILD_OFFSET = 0x4	// children offsets are scaled by this joint
+	};
+	std::vector<U8>				mFlags;
+};
+
+#endif // LL_LLJOINTHIERARCHY_H
@@ -0,0 +1,150 @@
+/** 
+ * @file llkeyframedecodethread.cpp
+ * @brief Worker thread decoding animation assets into keyframe data.
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llkeyframedecodethread.h"
+#include "lldatapacker.h"
+#include "lltimer.h"
+
+//----------------------------------------------------------------------------
+
+// MAIN THREAD
+LLKeyframeDecodeThread::LLKeyframeDecodeThread(bool threaded)
+	: LLQueuedThread("keyframedecode", threaded)
+{
+	mCreationMutex = new LLMutex();
+	mResultMutex = new LLMutex();
+}
+
+//virtual 
+LLKeyframeDecodeThread::~LLKeyframeDecodeThread()
+{
+	for (creation_list_t::iterator iter = mCreationList.begin();
+		 iter != mCreationList.end(); ++iter)
+	{
+		delete [] iter->data;
+	}
+	mCreationList.clear();
+	mResultList.clear();
+	delete mCreationMutex;
+	delete mResultMutex;
+}
+
+// MAIN THREAD
+S32 LLKeyframeDecodeThread::update(F32 max_time_ms)
+{
+	{
+		LLMutexLock lock(mCreationMutex);
+		for (creation_list_t::iterator iter = mCreationList.begin();
+			 iter != mCreationList.end(); ++iter)
+		{
+			creation_info& info = *iter;
+			DecodeRequest* req = new DecodeRequest(info.handle, this, info.asset_id, info.data, info.size);
+
+			bool res = addRequest(req);
+			if (!res)
+			{
+				LL_WARNS("Animation") << "request added after LLKeyframeDecodeThread shutdown" << LL_ENDL;
+				return 0;
+			}
+		}
+		mCreationList.clear();
+	}
+
+	S32 res = LLQueuedThread::update(max_time_ms);
+
+	// Deliver finished decodes outside of the lock, binding to a skeleton may
+	// well queue more work.
+	result_list_t results;
+	{
+		LLMutexLock lock(mResultMutex);
+		results.swap(mResultList);
+	}
+	for (result_list_t::iterator iter = results.begin(); iter != results.end(); ++iter)
+	{
+		if (iter->joint_motion_list.notNull())
+		{
+			LLKeyframeDataCache::recordDecode(iter->decode_time_ms);
+		}
+		LLKeyframeMotion::onDecodeComplete(iter->asset_id, iter->joint_motion_list);
+	}
+
+	return res + (S32)results.size();
+}
+
+LLKeyframeDecodeThread::handle_t LLKeyframeDecodeThread::decodeMotion(const LLUUID& asset_id, U8* data, S32 size)
+{
+	LLMutexLock lock(mCreationMutex);
+	handle_t handle = generateHandle();
+	mCreationList.push_back(creation_info(handle, asset_id, data, size));
+	return handle;
+}
+
+// ANY THREAD
+void LLKeyframeDecodeThread::addResult(const LLUUID& asset_id, LLKeyframeMotion::JointMotionList* joint_motion_list, F64 decode_time_ms)
+{
+	LLMutexLock lock(mResultMutex);
+	decode_result result;
+	result.asset_id = asset_id;
+	result.joint_motion_list = joint_motion_list;
+	result.decode_time_ms = decode_time_ms;
+	mResultList.push_back(result);
+}
+
+//----------------------------------------------------------------------------
+
+LLKeyframeDecodeThread::DecodeRequest::DecodeRequest(handle_t handle, LLKeyframeDecodeThread* thread,
+													 const LLUUID& asset_id, U8* data, S32 size)
+	: LLQueuedThread::QueuedRequest(handle, LLQueuedThread::PRIORITY_NORMAL, FLAG_AUTO_COMPLETE),
+	  mThread(thread),
+	  mAssetID(asset_id),
+	  mData(data),
+	  mSize(size),
+	  mDecodeTimeMs(0.0)
+{
+}
+
+LLKeyframeDecodeThread::DecodeRequest::~DecodeRequest()
+{
+	delete [] mData;
+	mData = NULL;
+	mJointMotionList = NULL;
+}
+
+// Returns true when done, whether or not decode was successful.
+bool LLKeyframeDecodeThread::DecodeRequest::processRequest()
+{
+	LLTimer decode_timer;
+	LLDataPackerBinaryBuffer dp(mData, mSize);
+	mJointMotionList = LLKeyframeMotion::parseJointMotionList(dp, mAssetID);
+	mDecodeTimeMs = decode_timer.getElapsedTimeF64().value() * 1000.0;
+	return true;
+}
+
+void LLKeyframeDecodeThread::DecodeRequest::finishRequest(bool completed)
+{
+	// an aborted request still reports back so waiting motions can fail
+	mThread->addResult(mAssetID, completed ? mJointMotionList.get() : NULL, mDecodeTimeMs);
+	// Will automatically be deleted
+}
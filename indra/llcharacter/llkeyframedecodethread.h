@@ -0,0 +1,95 @@
+/** 
+ * @file llkeyframedecodethread.h
+ * @brief Worker thread decoding animation assets into keyframe data.
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLKEYFRAMEDECODETHREAD_H
+#define LL_LLKEYFRAMEDECODETHREAD_H
+
+#include "llkeyframemotion.h"
+#include "llqueuedthread.h"
+
+class LLKeyframeDecodeThread : public LLQueuedThread
+{
+public:
+	class DecodeRequest : public LLQueuedThread::QueuedRequest
+	{
+	protected:
+		virtual ~DecodeRequest(); // use deleteRequest()
+
+	public:
+		DecodeRequest(handle_t handle, LLKeyframeDecodeThread* thread,
+					  const LLUUID& asset_id, U8* data, S32 size);
+
+		/*virtual*/ bool processRequest();
+		/*virtual*/ void finishRequest(bool completed);
+
+	private:
+		LLKeyframeDecodeThread* mThread;
+		// input
+		LLUUID mAssetID;
+		U8* mData;
+		S32 mSize;
+		// output
+		LLPointer<LLKeyframeMotion::JointMotionList> mJointMotionList;
+		F64 mDecodeTimeMs;
+	};
+
+public:
+	LLKeyframeDecodeThread(bool threaded = true);
+	virtual ~LLKeyframeDecodeThread();
+
+	// takes ownership of data, which must have been allocated with new[]
+	handle_t decodeMotion(const LLUUID& asset_id, U8* data, S32 size);
+
+	// MAIN THREAD: queues new requests and delivers finished ones to LLKeyframeMotion
+	S32 update(F32 max_time_ms);
+
+private:
+	struct decode_result
+	{
+		LLUUID asset_id;
+		LLPointer<LLKeyframeMotion::JointMotionList> joint_motion_list;
+		F64 decode_time_ms;
+	};
+	typedef std::list<decode_result> result_list_t;
+
+	void addResult(const LLUUID& asset_id, LLKeyframeMotion::JointMotionList* joint_motion_list, F64 decode_time_ms);
+
+	struct creation_info
+	{
+		handle_t handle;
+		LLUUID asset_id;
+		U8* data;
+		S32 size;
+		creation_info(handle_t h, const LLUUID& id, U8* d, S32 s)
+			: handle(h), asset_id(id), data(d), size(s)
+		{}
+	};
+	typedef std::list<creation_info> creation_list_t;
+	creation_list_t mCreationList;
+	LLMutex* mCreationMutex;
+
+	result_list_t mResultList;
+	LLMutex* mResultMutex;
+};
+
+#endif // LL_LLKEYFRAMEDECODETHREAD_H
@@ -40,7 +40,9 @@
 #include "lldir.h"
 #include "llendianswizzle.h"
 #include "llkeyframemotion.h"
+#include "llkeyframedecodethread.h"
 #include "llquantize.h"
+#include "lltrace.h"
 #include "llvfile.h"
 #include "m3math.h"
 #include "message.h"
@@ -49,7 +51,22 @@
 // Static Definitions
 //-----------------------------------------------------------------------------
 LLVFS*				LLKeyframeMotion::sVFS = NULL;
+LLKeyframeMotion::pending_decode_map_t	LLKeyframeMotion::sPendingDecodes;
 LLKeyframeDataCache::keyframe_data_map_t	LLKeyframeDataCache::sKeyframeDataMap;
+LLKeyframeDataCache::lru_list_t	LLKeyframeDataCache::sLRUList;
+U64					LLKeyframeDataCache::sMaxSize = 0;
+U64					LLKeyframeDataCache::sCurrentSize = 0;
+U32					LLKeyframeDataCache::sHits = 0;
+U32					LLKeyframeDataCache::sMisses = 0;
+U32					LLKeyframeDataCache::sEvictions = 0;
+U32					LLKeyframeDataCache::sDecodes = 0;
+F64					LLKeyframeDataCache::sTotalDecodeTimeMs = 0.0;
+
+static LLKeyframeDecodeThread* sDecodeThread = NULL;
+
+static LLTrace::CountStatHandle<> sKeyframeCacheHits("keyframecachehits", "Number of animations found in the keyframe data cache");
+static LLTrace::CountStatHandle<> sKeyframeCacheMisses("keyframecachemisses", "Number of animations that had to be decoded");
+static LLTrace::EventStatHandle<F64Milliseconds> sKeyframeDecodeTime("keyframedecodetime", "Time spent decoding a single animation asset");
 
 //-----------------------------------------------------------------------------
 // Globals
@@ -76,7 +93,8 @@ LLKeyframeMotion::JointMotionList::JointMotionList()
 	  mEaseOutDuration(0.f),
 	  mBasePriority(LLJoint::LOW_PRIORITY),
 	  mHandPose(LLHandMotion::HAND_POSE_SPREAD),
-	  mMaxPriority(LLJoint::LOW_PRIORITY)
+	  mMaxPriority(LLJoint::LOW_PRIORITY),
+	  mConstraintsBound(FALSE)
 {
 }
 
@@ -124,6 +142,23 @@ U32 LLKeyframeMotion::JointMotionList::dumpDiagInfo()
 	return total_size;
 }
 
+U32 LLKeyframeMotion::JointMotionList::getSizeInBytes() const
+{
+	U32 total_size = sizeof(JointMotionList);
+
+	for (U32 i = 0; i < getNumJointMotions(); i++)
+	{
+		const LLKeyframeMotion::JointMotion* joint_motion_p = mJointMotionArray[i];
+		total_size += sizeof(JointMotion);
+		total_size += joint_motion_p->mScaleCurve.mNumKeys * sizeof(ScaleKey);
+		total_size += joint_motion_p->mRotationCurve.mNumKeys * sizeof(RotationKey);
+		total_size += joint_motion_p->mPositionCurve.mNumKeys * sizeof(PositionKey);
+	}
+	total_size += mConstraints.size() * sizeof(JointConstraintSharedData);
+
+	return total_size;
+}
+
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 // ****Curve classes
@@ -511,6 +546,7 @@ LLMotion::LLMotionInitStatus LLKeyframeMotion::onInitialize(LLCharacter *charact
 
 		return STATUS_HOLD;
 	case ASSET_FETCHED:
+	case ASSET_DECODING:
 		return STATUS_HOLD;
 	case ASSET_FETCH_FAILED:
 		return STATUS_FAILURE;
@@ -527,31 +563,11 @@ LLMotion::LLMotionInitStatus LLKeyframeMotion::onInitialize(LLCharacter *charact
 	if(joint_motion_list)
 	{
 		// motion already existed in cache, so grab it
-		mJointMotionList = joint_motion_list;
-
-		mJointStates.reserve(mJointMotionList->getNumJointMotions());
-		
-		// don't forget to allocate joint states
-		// set up joint states to point to character joints
-		for(U32 i = 0; i < mJointMotionList->getNumJointMotions(); i++)
+		if (!bindJointMotionList(joint_motion_list))
 		{
-			JointMotion* joint_motion = mJointMotionList->getJointMotion(i);
-			if (LLJoint *joint = mCharacter->getJoint(joint_motion->mJointName))
-			{
-				LLPointer<LLJointState> joint_state = new LLJointState;
-				mJointStates.push_back(joint_state);
-				joint_state->setJoint(joint);
-				joint_state->setUsage(joint_motion->mUsage);
-				joint_state->setPriority(joint_motion->mPriority);
-			}
-			else
-			{
-				// add dummy joint state with no associated joint
-				mJointStates.push_back(new LLJointState);
-			}
+			mAssetStatus = ASSET_FETCH_FAILED;
+			return STATUS_FAILURE;
 		}
-		mAssetStatus = ASSET_LOADED;
-		setupPose();
 		return STATUS_SUCCESS;
 	}
 
@@ -597,12 +613,19 @@ LLMotion::LLMotionInitStatus LLKeyframeMotion::onInitialize(LLCharacter *charact
 
 	LL_DEBUGS() << "Loading keyframe data for: " << getName() << ":" << getID() << " (" << anim_file_size << " bytes)" << LL_ENDL;
 
+	if (requestDecode(anim_data, anim_file_size))
+	{
+		// decode thread owns anim_data now
+		return STATUS_HOLD;
+	}
+
 	LLDataPackerBinaryBuffer dp(anim_data, anim_file_size);
 
 	if (!deserialize(dp))
 	{
 		LL_WARNS() << "Failed to decode asset for animation " << getName() << ":" << getID() << LL_ENDL;
 		mAssetStatus = ASSET_FETCH_FAILED;
+		delete []anim_data;
 		return STATUS_FAILURE;
 	}
 
@@ -731,8 +754,20 @@ BOOL LLKeyframeMotion::onUpdate(F32 time, U8* joint_mask)
 void LLKeyframeMotion::applyKeyframes(F32 time)
 {
 	llassert_always (mJointMotionList->getNumJointMotions() <= mJointStates.size());
+	// <polarity> Animation level of detail
+	const bool skip_extended = mCharacter->getMotionController().skipExtendedJoints();
+	// </polarity>
 	for (U32 i=0; i<mJointMotionList->getNumJointMotions(); i++)
 	{
+		// <polarity> Animation level of detail
+		// a zero weight keeps the blender off this joint, so it holds its last pose
+		LLJoint* joint = mJointStates[i]->getJoint();
+		if (skip_extended && joint && joint->getSupport() == LLJoint::SUPPORT_EXTENDED)
+		{
+			mJointStates[i]->setWeight(0.f);
+			continue;
+		}
+		// </polarity>
 		mJointMotionList->getJointMotion(i)->update(mJointStates[i],
 													  time, 
 													  mJointMotionList->mDuration );
@@ -1222,12 +1257,14 @@ void LLKeyframeMotion::applyConstraint(JointConstraint* constraint, F32 time, U8
 }
 
 //-----------------------------------------------------------------------------
-// deserialize()
+// parseJointMotionList()
+// Decodes the character independent part of an animation asset. Safe to
+// call from a worker thread, see LLKeyframeDecodeThread.
 //-----------------------------------------------------------------------------
-BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
+LLPointer<LLKeyframeMotion::JointMotionList> LLKeyframeMotion::parseJointMotionList(LLDataPacker& dp, const LLUUID& asset_id)
 {
 	BOOL old_version = FALSE;
-	mJointMotionList = new LLKeyframeMotion::JointMotionList;
+	LLPointer<JointMotionList> joint_motion_list = new JointMotionList;
 
 	//-------------------------------------------------------------------------
 	// get base priority
@@ -1239,15 +1276,13 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
 	if (!dp.unpackU16(version, "version"))
 	{
 		LL_WARNS() << "can't read version number" << LL_ENDL;
-		delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-		return FALSE;
+		return NULL;
 	}
 
 	if (!dp.unpackU16(sub_version, "sub_version"))
 	{
 		LL_WARNS() << "can't read sub version number" << LL_ENDL;
-		delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-		return FALSE;
+		return NULL;
 	}
 
 	if (version == 0 && sub_version == 1)
@@ -1258,8 +1293,7 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
 	{
 #if LL_RELEASE
 		LL_WARNS() << "Bad animation version " << version << "." << sub_version << LL_ENDL;
-		delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-		return FALSE;
+		return NULL;
 #else
 		LL_ERRS() << "Bad animation version " << version << "." << sub_version << LL_ENDL;
 #endif
@@ -1268,101 +1302,90 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
 	if (!dp.unpackS32(temp_priority, "base_priority"))
 	{
 		LL_WARNS() << "can't read animation base_priority" << LL_ENDL;
-		delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-		return FALSE;
+		return NULL;
 	}
-	mJointMotionList->mBasePriority = (LLJoint::JointPriority) temp_priority;
+	joint_motion_list->mBasePriority = (LLJoint::JointPriority) temp_priority;
 
-	if (mJointMotionList->mBasePriority >= LLJoint::ADDITIVE_PRIORITY)
+	if (joint_motion_list->mBasePriority >= LLJoint::ADDITIVE_PRIORITY)
 	{
-		mJointMotionList->mBasePriority = (LLJoint::JointPriority)((S32)LLJoint::ADDITIVE_PRIORITY-1);
-		mJointMotionList->mMaxPriority = mJointMotionList->mBasePriority;
+		joint_motion_list->mBasePriority = (LLJoint::JointPriority)((S32)LLJoint::ADDITIVE_PRIORITY-1);
+		joint_motion_list->mMaxPriority = joint_motion_list->mBasePriority;
 	}
-	else if (mJointMotionList->mBasePriority < LLJoint::USE_MOTION_PRIORITY)
+	else if (joint_motion_list->mBasePriority < LLJoint::USE_MOTION_PRIORITY)
 	{
-		LL_WARNS() << "bad animation base_priority " << mJointMotionList->mBasePriority << LL_ENDL;
-		delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-		return FALSE;
+		LL_WARNS() << "bad animation base_priority " << joint_motion_list->mBasePriority << LL_ENDL;
+		return NULL;
 	}
 
 	//-------------------------------------------------------------------------
 	// get duration
 	//-------------------------------------------------------------------------
-	if (!dp.unpackF32(mJointMotionList->mDuration, "duration"))
+	if (!dp.unpackF32(joint_motion_list->mDuration, "duration"))
 	{
 		LL_WARNS() << "can't read duration" << LL_ENDL;
-		delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-		return FALSE;
+		return NULL;
 	}
 	
-	if (mJointMotionList->mDuration > MAX_ANIM_DURATION ||
-	    !llfinite(mJointMotionList->mDuration))
+	if (joint_motion_list->mDuration > MAX_ANIM_DURATION ||
+	    !llfinite(joint_motion_list->mDuration))
 	{
 		LL_WARNS() << "invalid animation duration" << LL_ENDL;
-		delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-		return FALSE;
+		return NULL;
 	}
 
 	//-------------------------------------------------------------------------
 	// get emote (optional)
 	//-------------------------------------------------------------------------
-	if (!dp.unpackString(mJointMotionList->mEmoteName, "emote_name"))
+	if (!dp.unpackString(joint_motion_list->mEmoteName, "emote_name"))
 	{
 		LL_WARNS() << "can't read optional_emote_animation" << LL_ENDL;
-		delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-		return FALSE;
+		return NULL;
 	}
 
-	if(mJointMotionList->mEmoteName==mID.asString())
+	if(joint_motion_list->mEmoteName==asset_id.asString())
 	{
 		LL_WARNS() << "Malformed animation mEmoteName==mID" << LL_ENDL;
-		delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-		return FALSE;
+		return NULL;
 	}
 
 	//-------------------------------------------------------------------------
 	// get loop
 	//-------------------------------------------------------------------------
-	if (!dp.unpackF32(mJointMotionList->mLoopInPoint, "loop_in_point") ||
-	    !llfinite(mJointMotionList->mLoopInPoint))
+	if (!dp.unpackF32(joint_motion_list->mLoopInPoint, "loop_in_point") ||
+	    !llfinite(joint_motion_list->mLoopInPoint))
 	{
 		LL_WARNS() << "can't read loop point" << LL_ENDL;
-		delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-		return FALSE;
+		return NULL;
 	}
 
-	if (!dp.unpackF32(mJointMotionList->mLoopOutPoint, "loop_out_point") ||
-	    !llfinite(mJointMotionList->mLoopOutPoint))
+	if (!dp.unpackF32(joint_motion_list->mLoopOutPoint, "loop_out_point") ||
+	    !llfinite(joint_motion_list->mLoopOutPoint))
 	{
 		LL_WARNS() << "can't read loop point" << LL_ENDL;
-		delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-		return FALSE;
+		return NULL;
 	}
 
-	if (!dp.unpackS32(mJointMotionList->mLoop, "loop"))
+	if (!dp.unpackS32(joint_motion_list->mLoop, "loop"))
 	{
 		LL_WARNS() << "can't read loop" << LL_ENDL;
-		delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-		return FALSE;
+		return NULL;
 	}
 
 	//-------------------------------------------------------------------------
 	// get easeIn and easeOut
 	//-------------------------------------------------------------------------
-	if (!dp.unpackF32(mJointMotionList->mEaseInDuration, "ease_in_duration") ||
-	    !llfinite(mJointMotionList->mEaseInDuration))
+	if (!dp.unpackF32(joint_motion_list->mEaseInDuration, "ease_in_duration") ||
+	    !llfinite(joint_motion_list->mEaseInDuration))
 	{
 		LL_WARNS() << "can't read easeIn" << LL_ENDL;
-		delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-		return FALSE;
+		return NULL;
 	}
 
-	if (!dp.unpackF32(mJointMotionList->mEaseOutDuration, "ease_out_duration") ||
-	    !llfinite(mJointMotionList->mEaseOutDuration))
+	if (!dp.unpackF32(joint_motion_list->mEaseOutDuration, "ease_out_duration") ||
+	    !llfinite(joint_motion_list->mEaseOutDuration))
 	{
 		LL_WARNS() << "can't read easeOut" << LL_ENDL;
-		delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-		return FALSE;
+		return NULL;
 	}
 
 	//-------------------------------------------------------------------------
@@ -1372,18 +1395,16 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
 	if (!dp.unpackU32(word, "hand_pose"))
 	{
 		LL_WARNS() << "can't read hand pose" << LL_ENDL;
-		delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-		return FALSE;
+		return NULL;
 	}
 	
 	if(word > LLHandMotion::NUM_HAND_POSES)
 	{
 		LL_WARNS() << "invalid LLHandMotion::eHandPose index: " << word << LL_ENDL;
-		delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-		return FALSE;
+		return NULL;
 	}
 	
-	mJointMotionList->mHandPose = (LLHandMotion::eHandPose)word;
+	joint_motion_list->mHandPose = (LLHandMotion::eHandPose)word;
 
 	//-------------------------------------------------------------------------
 	// get number of joint motions
@@ -1392,27 +1413,22 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
 	if (!dp.unpackU32(num_motions, "num_joints"))
 	{
 		LL_WARNS() << "can't read number of joints" << LL_ENDL;
-		delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-		return FALSE;
+		return NULL;
 	}
 
 	if (num_motions == 0)
 	{
 		LL_WARNS() << "no joints in animation" << LL_ENDL;
-		delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-		return FALSE;
+		return NULL;
 	}
 	else if (num_motions > LL_CHARACTER_MAX_ANIMATED_JOINTS)
 	{
 		LL_WARNS() << "too many joints in animation" << LL_ENDL;
-		delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-		return FALSE;
+		return NULL;
 	}
 
-	mJointMotionList->mJointMotionArray.clear();
-	mJointMotionList->mJointMotionArray.reserve(num_motions);
-	mJointStates.clear();
-	mJointStates.reserve(num_motions);
+	joint_motion_list->mJointMotionArray.clear();
+	joint_motion_list->mJointMotionArray.reserve(num_motions);
 
 	//-------------------------------------------------------------------------
 	// initialize joint motions
@@ -1421,50 +1437,23 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
 	for(U32 i=0; i<num_motions; ++i)
 	{
 		JointMotion* joint_motion = new JointMotion;		
-		mJointMotionList->mJointMotionArray.push_back(joint_motion);
+		joint_motion_list->mJointMotionArray.push_back(joint_motion);
 		
 		std::string joint_name;
 		if (!dp.unpackString(joint_name, "joint_name"))
 		{
 			LL_WARNS() << "can't read joint name" << LL_ENDL;
-			delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-			return FALSE;
+			return NULL;
 		}
 
 		if (joint_name == "mScreen" || joint_name == "mRoot")
 		{
 			LL_WARNS() << "attempted to animate special " << joint_name << " joint" << LL_ENDL;
-			delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-			return FALSE;
+			return NULL;
 		}
 				
-		//---------------------------------------------------------------------
-		// find the corresponding joint
-		//---------------------------------------------------------------------
-		LLJoint *joint = mCharacter->getJoint( joint_name );
-		if (joint)
-		{
-            S32 joint_num = joint->getJointNum();
-//			LL_INFOS() << "  joint: " << joint_name << LL_ENDL;
-            if ((joint_num >= (S32)LL_CHARACTER_MAX_ANIMATED_JOINTS) || (joint_num < 0))
-            {
-                LL_WARNS() << "Joint will be omitted from animation: joint_num " << joint_num << " is outside of legal range [0-"
-                           << LL_CHARACTER_MAX_ANIMATED_JOINTS << ") for joint " << joint->getName() << LL_ENDL;
-                joint = NULL;
-            }
-		}
-		else
-		{
-			LL_WARNS() << "joint not found: " << joint_name << LL_ENDL;
-			//return FALSE;
-		}
-
 		joint_motion->mJointName = joint_name;
-		
-		LLPointer<LLJointState> joint_state = new LLJointState;
-		mJointStates.push_back(joint_state);
-		joint_state->setJoint( joint ); // note: can accept NULL
-		joint_state->setUsage( 0 );
+		joint_motion->mUsage = 0;
 
 		//---------------------------------------------------------------------
 		// get joint priority
@@ -1473,40 +1462,35 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
 		if (!dp.unpackS32(joint_priority, "joint_priority"))
 		{
 			LL_WARNS() << "can't read joint priority." << LL_ENDL;
-			delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-			return FALSE;
+			return NULL;
 		}
 
 		if (joint_priority < LLJoint::USE_MOTION_PRIORITY)
 		{
 			LL_WARNS() << "joint priority unknown - too low." << LL_ENDL;
-			delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-			return FALSE;
+			return NULL;
 		}
 		
 		joint_motion->mPriority = (LLJoint::JointPriority)joint_priority;
 		if (joint_priority != LLJoint::USE_MOTION_PRIORITY &&
-		    joint_priority > mJointMotionList->mMaxPriority)
+		    joint_priority > joint_motion_list->mMaxPriority)
 		{
-			mJointMotionList->mMaxPriority = (LLJoint::JointPriority)joint_priority;
+			joint_motion_list->mMaxPriority = (LLJoint::JointPriority)joint_priority;
 		}
 
-		joint_state->setPriority((LLJoint::JointPriority)joint_priority);
-
 		//---------------------------------------------------------------------
 		// scan rotation curve header
 		//---------------------------------------------------------------------
 		if (!dp.unpackS32(joint_motion->mRotationCurve.mNumKeys, "num_rot_keys") || joint_motion->mRotationCurve.mNumKeys < 0)
 		{
 			LL_WARNS() << "can't read number of rotation keys" << LL_ENDL;
-			delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-			return FALSE;
+			return NULL;
 		}
 
 		joint_motion->mRotationCurve.mInterpolationType = IT_LINEAR;
 		if (joint_motion->mRotationCurve.mNumKeys != 0)
 		{
-			joint_state->setUsage(joint_state->getUsage() | LLJointState::ROT );
+			joint_motion->mUsage |= LLJointState::ROT;
 		}
 
 		//---------------------------------------------------------------------
@@ -1525,8 +1509,7 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
 				    !llfinite(time))
 				{
 					LL_WARNS() << "can't read rotation key (" << k << ")" << LL_ENDL;
-					delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-					return FALSE;
+					return NULL;
 				}
 
 			}
@@ -1535,17 +1518,15 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
 				if (!dp.unpackU16(time_short, "time"))
 				{
 					LL_WARNS() << "can't read rot_angles in rotation key (" << k << ")" << LL_ENDL;
-					delete mJointMotionList;
-					return FALSE;
+					return NULL;
 				}
 
-				time = U16_to_F32(time_short, 0.f, mJointMotionList->mDuration);
+				time = U16_to_F32(time_short, 0.f, joint_motion_list->mDuration);
 				
-				if (time < 0 || time > mJointMotionList->mDuration)
+				if (time < 0 || time > joint_motion_list->mDuration)
 				{
 					LL_WARNS() << "invalid frame time" << LL_ENDL;
-					delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-					return FALSE;
+					return NULL;
 				}
 			}
 			
@@ -1585,8 +1566,7 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
 			if (!success)
 			{
 				LL_WARNS() << "can't read rotation key (" << k << ")" << LL_ENDL;
-				delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-				return FALSE;
+				return NULL;
 			}
 
 			rCurve->mKeys[time] = rot_key;
@@ -1598,14 +1578,13 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
 		if (!dp.unpackS32(joint_motion->mPositionCurve.mNumKeys, "num_pos_keys") || joint_motion->mPositionCurve.mNumKeys < 0)
 		{
 			LL_WARNS() << "can't read number of position keys" << LL_ENDL;
-			delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-			return FALSE;
+			return NULL;
 		}
 
 		joint_motion->mPositionCurve.mInterpolationType = IT_LINEAR;
 		if (joint_motion->mPositionCurve.mNumKeys != 0)
 		{
-			joint_state->setUsage(joint_state->getUsage() | LLJointState::POS );
+			joint_motion->mUsage |= LLJointState::POS;
 		}
 
 		//---------------------------------------------------------------------
@@ -1624,8 +1603,7 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
 				    !llfinite(pos_key.mTime))
 				{
 					LL_WARNS() << "can't read position key (" << k << ")" << LL_ENDL;
-					delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-					return FALSE;
+					return NULL;
 				}
 			}
 			else
@@ -1633,11 +1611,10 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
 				if (!dp.unpackU16(time_short, "time"))
 				{
 					LL_WARNS() << "can't read position key (" << k << ")" << LL_ENDL;
-					delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-					return FALSE;
+					return NULL;
 				}
 
-				pos_key.mTime = U16_to_F32(time_short, 0.f, mJointMotionList->mDuration);
+				pos_key.mTime = U16_to_F32(time_short, 0.f, joint_motion_list->mDuration);
 			}
 
 			BOOL success = TRUE;
@@ -1674,19 +1651,16 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
 			if (!success)
 			{
 				LL_WARNS() << "can't read position key (" << k << ")" << LL_ENDL;
-				delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-				return FALSE;
+				return NULL;
 			}
 			
 			pCurve->mKeys[pos_key.mTime] = pos_key;
 
 			if (is_pelvis)
 			{
-				mJointMotionList->mPelvisBBox.addPoint(pos_key.mPosition);
+				joint_motion_list->mPelvisBBox.addPoint(pos_key.mPosition);
 			}
 		}
-
-		joint_motion->mUsage = joint_state->getUsage();
 	}
 
 	//-------------------------------------------------------------------------
@@ -1696,8 +1670,7 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
 	if (!dp.unpackS32(num_constraints, "num_constraints"))
 	{
 		LL_WARNS() << "can't read number of constraints" << LL_ENDL;
-		delete mJointMotionList;
-		return FALSE;
+		return NULL;
 	}
 
 	if (num_constraints > MAX_CONSTRAINTS || num_constraints < 0)
@@ -1719,30 +1692,26 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
 			if (!dp.unpackU8(byte, "chain_length"))
 			{
 				LL_WARNS() << "can't read constraint chain length" << LL_ENDL;
-				delete mJointMotionList; 
-				return FALSE;
+				return NULL;
 			}
 			constraintp->mChainLength = (S32) byte;
 
-			if((U32)constraintp->mChainLength > mJointMotionList->getNumJointMotions())
+			if((U32)constraintp->mChainLength > joint_motion_list->getNumJointMotions())
 			{
 				LL_WARNS() << "invalid constraint chain length" << LL_ENDL;
-				delete mJointMotionList;
-				return FALSE;
+				return NULL;
 			}
 
 			if (!dp.unpackU8(byte, "constraint_type"))
 			{
 				LL_WARNS() << "can't read constraint type" << LL_ENDL;
-				delete mJointMotionList;
-				return FALSE;
+				return NULL;
 			}
 			
 			if( byte >= NUM_CONSTRAINT_TYPES )
 			{
 				LL_WARNS() << "invalid constraint type" << LL_ENDL;
-				delete mJointMotionList;
-				return FALSE;
+				return NULL;
 			}
 			constraintp->mConstraintType = (EConstraintType)byte;
 
@@ -1751,33 +1720,29 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
 			if (!dp.unpackBinaryDataFixed(bin_data, BIN_DATA_LENGTH, "source_volume"))
 			{
 				LL_WARNS() << "can't read source volume name" << LL_ENDL;
-				delete mJointMotionList;
-				return FALSE;
+				return NULL;
 			}
 
 			bin_data[BIN_DATA_LENGTH] = 0; // Ensure null termination
 			str = (char*)bin_data;
-			constraintp->mSourceConstraintVolume = mCharacter->getCollisionVolumeID(str);
+			constraintp->mSourceConstraintVolumeName = str;
 
 			if (!dp.unpackVector3(constraintp->mSourceConstraintOffset, "source_offset"))
 			{
 				LL_WARNS() << "can't read constraint source offset" << LL_ENDL;
-				delete mJointMotionList;
-				return FALSE;
+				return NULL;
 			}
 			
 			if( !(constraintp->mSourceConstraintOffset.isFinite()) )
 			{
 				LL_WARNS() << "non-finite constraint source offset" << LL_ENDL;
-				delete mJointMotionList;
-				return FALSE;
+				return NULL;
 			}
 			
 			if (!dp.unpackBinaryDataFixed(bin_data, BIN_DATA_LENGTH, "target_volume"))
 			{
 				LL_WARNS() << "can't read target volume name" << LL_ENDL;
-				delete mJointMotionList;
-				return FALSE;
+				return NULL;
 			}
 
 			bin_data[BIN_DATA_LENGTH] = 0; // Ensure null termination
@@ -1790,35 +1755,31 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
 			else
 			{
 				constraintp->mConstraintTargetType = CONSTRAINT_TARGET_TYPE_BODY;
-				constraintp->mTargetConstraintVolume = mCharacter->getCollisionVolumeID(str);
+				constraintp->mTargetConstraintVolumeName = str;
 			}
 
 			if (!dp.unpackVector3(constraintp->mTargetConstraintOffset, "target_offset"))
 			{
 				LL_WARNS() << "can't read constraint target offset" << LL_ENDL;
-				delete mJointMotionList;
-				return FALSE;
+				return NULL;
 			}
 
 			if( !(constraintp->mTargetConstraintOffset.isFinite()) )
 			{
 				LL_WARNS() << "non-finite constraint target offset" << LL_ENDL;
-				delete mJointMotionList;
-				return FALSE;
+				return NULL;
 			}
 			
 			if (!dp.unpackVector3(constraintp->mTargetConstraintDir, "target_dir"))
 			{
 				LL_WARNS() << "can't read constraint target direction" << LL_ENDL;
-				delete mJointMotionList;
-				return FALSE;
+				return NULL;
 			}
 
 			if( !(constraintp->mTargetConstraintDir.isFinite()) )
 			{
 				LL_WARNS() << "non-finite constraint target direction" << LL_ENDL;
-				delete mJointMotionList;
-				return FALSE;
+				return NULL;
 			}
 
 			if (!constraintp->mTargetConstraintDir.isExactlyZero())
@@ -1830,39 +1791,118 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
 			if (!dp.unpackF32(constraintp->mEaseInStartTime, "ease_in_start") || !llfinite(constraintp->mEaseInStartTime))
 			{
 				LL_WARNS() << "can't read constraint ease in start time" << LL_ENDL;
-				delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
-				return FALSE;
+				return NULL;
 			}
 
 			if (!dp.unpackF32(constraintp->mEaseInStopTime, "ease_in_stop") || !llfinite(constraintp->mEaseInStopTime))
 			{
 				LL_WARNS() << "can't read constraint ease in stop time" << LL_ENDL;
-				delete mJointMotionList;
-				return FALSE;
+				return NULL;
 			}
 
 			if (!dp.unpackF32(constraintp->mEaseOutStartTime, "ease_out_start") || !llfinite(constraintp->mEaseOutStartTime))
 			{
 				LL_WARNS() << "can't read constraint ease out start time" << LL_ENDL;
-				delete mJointMotionList;
-				return FALSE;
+				return NULL;
 			}
 
 			if (!dp.unpackF32(constraintp->mEaseOutStopTime, "ease_out_stop") || !llfinite(constraintp->mEaseOutStopTime))
 			{
 				LL_WARNS() << "can't read constraint ease out stop time" << LL_ENDL;
-				delete mJointMotionList;
-				return FALSE;
+				return NULL;
+			}
+
+			joint_motion_list->mConstraints.push_front(constraintp.release());
+		}
+	}
+
+	return joint_motion_list;
+}
+
+//-----------------------------------------------------------------------------
+// deserialize()
+//-----------------------------------------------------------------------------
+BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
+{
+	LLPointer<JointMotionList> joint_motion_list = parseJointMotionList(dp, mID);
+	if (joint_motion_list.isNull())
+	{
+		return FALSE;
+	}
+
+	if (!bindJointMotionList(joint_motion_list))
+	{
+		return FALSE;
+	}
+
+	LLKeyframeDataCache::addKeyframeData(getID(), joint_motion_list);
+	return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// bindJointMotionList()
+// Attaches decoded keyframe data to this motion's character. Must be called
+// from the main thread.
+//-----------------------------------------------------------------------------
+BOOL LLKeyframeMotion::bindJointMotionList(JointMotionList* joint_motion_list)
+{
+	llassert(joint_motion_list && mCharacter);
+
+	mJointMotionList = joint_motion_list;
+	mJointStates.clear();
+	mJointStates.reserve(mJointMotionList->getNumJointMotions());
+
+	// set up joint states to point to character joints
+	for (U32 i = 0; i < mJointMotionList->getNumJointMotions(); i++)
+	{
+		JointMotion* joint_motion = mJointMotionList->getJointMotion(i);
+		LLJoint* joint = mCharacter->getJoint(joint_motion->mJointName);
+		if (joint)
+		{
+			S32 joint_num = joint->getJointNum();
+			if ((joint_num >= (S32)LL_CHARACTER_MAX_ANIMATED_JOINTS) || (joint_num < 0))
+			{
+				LL_WARNS() << "Joint will be omitted from animation: joint_num " << joint_num << " is outside of legal range [0-"
+						   << LL_CHARACTER_MAX_ANIMATED_JOINTS << ") for joint " << joint->getName() << LL_ENDL;
+				joint = NULL;
+			}
+		}
+		else
+		{
+			LL_DEBUGS("Animation") << "joint not found: " << joint_motion->mJointName << LL_ENDL;
+		}
+
+		// add joint state even when there is no associated joint, indices must match the motion list
+		LLPointer<LLJointState> joint_state = new LLJointState;
+		mJointStates.push_back(joint_state);
+		joint_state->setJoint(joint); // note: can accept NULL
+		joint_state->setUsage(joint_motion->mUsage);
+		joint_state->setPriority(joint_motion->mPriority);
+	}
+
+	// constraint volumes are resolved against the first skeleton the data is bound to,
+	// cached motion lists are shared by all avatars
+	if (!mJointMotionList->mConstraintsBound)
+	{
+		for (JointMotionList::constraint_list_t::iterator iter = mJointMotionList->mConstraints.begin();
+			 iter != mJointMotionList->mConstraints.end(); ++iter)
+		{
+			JointConstraintSharedData* constraintp = *iter;
+			constraintp->mSourceConstraintVolume = mCharacter->getCollisionVolumeID(constraintp->mSourceConstraintVolumeName);
+			if (constraintp->mConstraintTargetType == CONSTRAINT_TARGET_TYPE_BODY)
+			{
+				constraintp->mTargetConstraintVolume = mCharacter->getCollisionVolumeID(constraintp->mTargetConstraintVolumeName);
 			}
 
 			LLJoint* joint = mCharacter->findCollisionVolume(constraintp->mSourceConstraintVolume);
 			// get joint to which this collision volume is attached
 			if (!joint)
 			{
-				delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
+				mJointMotionList = NULL;
 				return FALSE;
 			}
 
+			delete [] constraintp->mJointStateIndices;
 			constraintp->mJointStateIndices = new S32[constraintp->mChainLength + 1]; // note: mChainLength is size-limited - comes from a byte
 
 			for (S32 i = 0; i < constraintp->mChainLength + 1; i++)
@@ -1872,7 +1912,7 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
 				{
 					LL_WARNS() << "Joint with no parent: " << joint->getName()
 							<< " Emote: " << mJointMotionList->mEmoteName << LL_ENDL;
-					delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
+					mJointMotionList = NULL;
 					return FALSE;
 				}
 				joint = parent;
@@ -1880,14 +1920,14 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
 				for (U32 j = 0; j < mJointMotionList->getNumJointMotions(); j++)
 				{
 					LLJoint* constraint_joint = getJoint(j);
-					
+
 					if ( !constraint_joint )
 					{
 						LL_WARNS() << "Invalid joint " << j << LL_ENDL;
-						delete mJointMotionList; // <FS:Ansariel> Mem-leak fix by Drake Arconis
+						mJointMotionList = NULL;
 						return FALSE;
 					}
-					
+
 					if(constraint_joint == joint)
 					{
 						constraintp->mJointStateIndices[i] = (S32)j;
@@ -1897,22 +1937,15 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp)
 				if (constraintp->mJointStateIndices[i] < 0 )
 				{
 					LL_WARNS() << "No joint index for constraint " << i << LL_ENDL;
-					// <FS:Ansariel> Mem-leak fix by Drake Arconis
-					//delete constraintp;
-					delete mJointMotionList;
-					// </FS:Ansariel>
+					mJointMotionList = NULL;
 					return FALSE;
 				}
 			}
-
-			mJointMotionList->mConstraints.push_front(constraintp.release());
 		}
+		mJointMotionList->mConstraintsBound = TRUE;
 	}
 
-	// *FIX: support cleanup of old keyframe data
-	LLKeyframeDataCache::addKeyframeData(getID(),  mJointMotionList);
 	mAssetStatus = ASSET_LOADED;
-
 	setupPose();
 
 	return TRUE;
@@ -2297,11 +2330,12 @@ void LLKeyframeMotion::onLoadComplete(LLVFS *vfs,
 	{
 		if (0 == status)
 		{
-			if (motionp->mAssetStatus == ASSET_LOADED)
+			if (motionp->mAssetStatus == ASSET_LOADED || motionp->mAssetStatus == ASSET_DECODING)
 			{
-				// asset already loaded
+				// asset already loaded or on its way
 				return;
 			}
+
 			LLVFile file(vfs, asset_uuid, type, LLVFile::READ);
 			S32 size = file.getSize();
 			
@@ -2309,7 +2343,13 @@ void LLKeyframeMotion::onLoadComplete(LLVFS *vfs,
 			file.read((U8*)buffer, size);	/*Flawfinder: ignore*/
 
 			LL_DEBUGS("Animation") << "Loading keyframe data for: " << motionp->getName() << ":" << motionp->getID() << " (" << size << " bytes)" << LL_ENDL;
-			
+
+			if (motionp->requestDecode(buffer, size))
+			{
+				// decode thread owns buffer now
+				return;
+			}
+
 			LLDataPackerBinaryBuffer dp(buffer, size);
 			if (motionp->deserialize(dp))
 			{
@@ -2335,6 +2375,119 @@ void LLKeyframeMotion::onLoadComplete(LLVFS *vfs,
 	}
 }
 
+//-----------------------------------------------------------------------------
+// requestDecode()
+//-----------------------------------------------------------------------------
+BOOL LLKeyframeMotion::requestDecode(U8* data, S32 size)
+{
+	if (!sDecodeThread || !mCharacter)
+	{
+		return FALSE;
+	}
+
+	mAssetStatus = ASSET_DECODING;
+
+	// several avatars may wait on the same asset, only decode it once
+	pending_decode_map_t::iterator iter = sPendingDecodes.find(mID);
+	if (iter != sPendingDecodes.end())
+	{
+		iter->second.push_back(mCharacter->getID());
+		delete [] data;
+		return TRUE;
+	}
+
+	sPendingDecodes[mID].push_back(mCharacter->getID());
+	sDecodeThread->decodeMotion(mID, data, size);
+	return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// onDecodeComplete()
+//-----------------------------------------------------------------------------
+void LLKeyframeMotion::onDecodeComplete(const LLUUID& asset_id, JointMotionList* joint_motion_list)
+{
+	pending_decode_map_t::iterator iter = sPendingDecodes.find(asset_id);
+	if (iter == sPendingDecodes.end())
+	{
+		return;
+	}
+	uuid_vec_t character_ids;
+	character_ids.swap(iter->second);
+	sPendingDecodes.erase(iter);
+
+	BOOL cached = FALSE;
+	for (uuid_vec_t::iterator id_iter = character_ids.begin(); id_iter != character_ids.end(); ++id_iter)
+	{
+		LLCharacter* character = NULL;
+		for (std::vector<LLCharacter*>::iterator char_iter = LLCharacter::sInstances.begin();
+			 char_iter != LLCharacter::sInstances.end(); ++char_iter)
+		{
+			if ((*char_iter)->getID() == *id_iter)
+			{
+				character = *char_iter;
+				break;
+			}
+		}
+		if (!character)
+		{
+			continue;
+		}
+
+		LLKeyframeMotion* motionp = dynamic_cast<LLKeyframeMotion*>(character->findMotion(asset_id));
+		if (!motionp || motionp->mAssetStatus != ASSET_DECODING)
+		{
+			continue;
+		}
+
+		if (joint_motion_list && motionp->bindJointMotionList(joint_motion_list))
+		{
+			if (!cached)
+			{
+				LLKeyframeDataCache::addKeyframeData(asset_id, joint_motion_list);
+				cached = TRUE;
+			}
+		}
+		else
+		{
+			LL_WARNS() << "Failed to decode asset for animation " << motionp->getName() << ":" << asset_id << LL_ENDL;
+			motionp->mAssetStatus = ASSET_FETCH_FAILED;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// initDecodeThread()
+//-----------------------------------------------------------------------------
+void LLKeyframeMotion::initDecodeThread(bool threaded)
+{
+	if (!sDecodeThread)
+	{
+		sDecodeThread = new LLKeyframeDecodeThread(threaded);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// updateDecodeThread()
+//-----------------------------------------------------------------------------
+S32 LLKeyframeMotion::updateDecodeThread(F32 max_time_ms)
+{
+	return sDecodeThread ? sDecodeThread->update(max_time_ms) : 0;
+}
+
+//-----------------------------------------------------------------------------
+// cleanupDecodeThread()
+//-----------------------------------------------------------------------------
+void LLKeyframeMotion::cleanupDecodeThread()
+{
+	if (sDecodeThread)
+	{
+		sDecodeThread->shutdown();
+		delete sDecodeThread;
+		sDecodeThread = NULL;
+	}
+	sPendingDecodes.clear();
+}
+
 //--------------------------------------------------------------------
 // LLKeyframeDataCache::dumpDiagInfo()
 //--------------------------------------------------------------------
@@ -2355,7 +2508,7 @@ void LLKeyframeDataCache::dumpDiagInfo()
 	{
 		U32 joint_motion_kb;
 
-		LLKeyframeMotion::JointMotionList *motion_list_p = map_it->second;
+		LLKeyframeMotion::JointMotionList *motion_list_p = map_it->second.mJointMotionList;
 
 		LL_INFOS() << "Motion: " << map_it->first << LL_ENDL;
 
@@ -2369,6 +2522,13 @@ void LLKeyframeDataCache::dumpDiagInfo()
 	snprintf(buf, sizeof(buf), "%d\t\t%d bytes", (S32)sKeyframeDataMap.size(), total_size );		/* Flawfinder: ignore */
 	LL_INFOS() << buf << LL_ENDL;
 	LL_INFOS() << "-----------------------------------------------------" << LL_ENDL;
+	U32 lookups = sHits + sMisses;
+	LL_INFOS() << "Hits: " << sHits << " Misses: " << sMisses
+			   << " Hit rate: " << (lookups ? (100.f * sHits / lookups) : 0.f) << "%"
+			   << " Evictions: " << sEvictions << LL_ENDL;
+	LL_INFOS() << "Decodes: " << sDecodes << " Average decode time: "
+			   << (sDecodes ? (sTotalDecodeTimeMs / sDecodes) : 0.0) << " ms" << LL_ENDL;
+	LL_INFOS() << "-----------------------------------------------------" << LL_ENDL;
 }
 
 
@@ -2377,7 +2537,18 @@ void LLKeyframeDataCache::dumpDiagInfo()
 //--------------------------------------------------------------------
 void LLKeyframeDataCache::addKeyframeData(const LLUUID& id, LLKeyframeMotion::JointMotionList* joint_motion_listp)
 {
-	sKeyframeDataMap[id] = joint_motion_listp;
+	removeKeyframeData(id);
+
+	CacheEntry& entry = sKeyframeDataMap[id];
+	entry.mJointMotionList = joint_motion_listp;
+	entry.mSize = joint_motion_listp->getSizeInBytes();
+	entry.mLRUIter = sLRUList.insert(sLRUList.begin(), id);
+	sCurrentSize += entry.mSize;
+
+	if (sMaxSize)
+	{
+		evict(sMaxSize);
+	}
 }
 
 //--------------------------------------------------------------------
@@ -2388,11 +2559,47 @@ void LLKeyframeDataCache::removeKeyframeData(const LLUUID& id)
 	keyframe_data_map_t::iterator found_data = sKeyframeDataMap.find(id);
 	if (found_data != sKeyframeDataMap.end())
 	{
-		delete found_data->second;
+		sCurrentSize -= found_data->second.mSize;
+		sLRUList.erase(found_data->second.mLRUIter);
 		sKeyframeDataMap.erase(found_data);
 	}
 }
 
+//--------------------------------------------------------------------
+// LLKeyframeDataCache::evict()
+//--------------------------------------------------------------------
+void LLKeyframeDataCache::evict(U64 max_bytes)
+{
+	// always keep the most recently added entry
+	while (sCurrentSize > max_bytes && sLRUList.size() > 1)
+	{
+		removeKeyframeData(sLRUList.back());
+		++sEvictions;
+	}
+}
+
+//--------------------------------------------------------------------
+// LLKeyframeDataCache::setMaxSize()
+//--------------------------------------------------------------------
+void LLKeyframeDataCache::setMaxSize(U64 max_bytes)
+{
+	sMaxSize = max_bytes;
+	if (sMaxSize)
+	{
+		evict(sMaxSize);
+	}
+}
+
+//--------------------------------------------------------------------
+// LLKeyframeDataCache::recordDecode()
+//--------------------------------------------------------------------
+void LLKeyframeDataCache::recordDecode(F64 decode_time_ms)
+{
+	++sDecodes;
+	sTotalDecodeTimeMs += decode_time_ms;
+	record(sKeyframeDecodeTime, F64Milliseconds(decode_time_ms));
+}
+
 //--------------------------------------------------------------------
 // LLKeyframeDataCache::getKeyframeData()
 //--------------------------------------------------------------------
@@ -2401,9 +2608,16 @@ LLKeyframeMotion::JointMotionList* LLKeyframeDataCache::getKeyframeData(const LL
 	keyframe_data_map_t::iterator found_data = sKeyframeDataMap.find(id);
 	if (found_data == sKeyframeDataMap.end())
 	{
+		++sMisses;
+		add(sKeyframeCacheMisses, 1);
 		return NULL;
 	}
-	return found_data->second;
+	++sHits;
+	add(sKeyframeCacheHits, 1);
+
+	// move to the front of the LRU list
+	sLRUList.splice(sLRUList.begin(), sLRUList, found_data->second.mLRUIter);
+	return found_data->second.mJointMotionList;
 }
 
 //--------------------------------------------------------------------
@@ -2419,8 +2633,9 @@ LLKeyframeDataCache::~LLKeyframeDataCache()
 //-----------------------------------------------------------------------------
 void LLKeyframeDataCache::clear()
 {
-	for_each(sKeyframeDataMap.begin(), sKeyframeDataMap.end(), DeletePairedPointer());
 	sKeyframeDataMap.clear();
+	sLRUList.clear();
+	sCurrentSize = 0;
 }
 
 //-----------------------------------------------------------------------------
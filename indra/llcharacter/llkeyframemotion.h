@@ -40,6 +40,8 @@
 #include "v3dmath.h"
 #include "v3math.h"
 #include "llbvhconsts.h"
+#include "llpointer.h"
+#include "llrefcount.h"
 
 class LLKeyframeDataCache;
 class LLVFS;
@@ -214,8 +216,10 @@ protected:
 		~JointConstraintSharedData() { delete [] mJointStateIndices; }
 
 		S32						mSourceConstraintVolume;
+		std::string				mSourceConstraintVolumeName;
 		LLVector3				mSourceConstraintOffset;
 		S32						mTargetConstraintVolume;
+		std::string				mTargetConstraintVolumeName;
 		LLVector3				mTargetConstraintOffset;
 		LLVector3				mTargetConstraintDir;
 		S32						mChainLength;
@@ -267,7 +271,7 @@ protected:
 	BOOL	setupPose();
 
 public:
-	enum AssetStatus { ASSET_LOADED, ASSET_FETCHED, ASSET_NEEDS_FETCH, ASSET_FETCH_FAILED, ASSET_UNDEFINED };
+	enum AssetStatus { ASSET_LOADED, ASSET_FETCHED, ASSET_DECODING, ASSET_NEEDS_FETCH, ASSET_FETCH_FAILED, ASSET_UNDEFINED };
 
 	enum InterpolationType { IT_STEP, IT_LINEAR, IT_SPLINE };
 
@@ -385,8 +389,10 @@ public:
 	
 	//-------------------------------------------------------------------------
 	// JointMotionList
+	// Decoded keyframe data, shared between all motions (and avatars) playing
+	// the same animation asset through LLKeyframeDataCache.
 	//-------------------------------------------------------------------------
-	class JointMotionList
+	class JointMotionList : public LLThreadSafeRefCount
 	{
 	public:
 		std::vector<JointMotion*> mJointMotionArray;
@@ -406,22 +412,47 @@ public:
 		// TODO: LLKeyframeDataCache::getKeyframeData should probably return a class containing 
 		// JointMotionList and mEmoteName, see LLKeyframeMotion::onInitialize.
 		std::string				mEmoteName; 
+		// TRUE once constraint volume names have been resolved against a skeleton
+		BOOL					mConstraintsBound;
 	public:
 		JointMotionList();
-		~JointMotionList();
+	protected:
+		~JointMotionList(); // use unref()
+	public:
 		U32 dumpDiagInfo();
+		// approximate memory footprint, used to bound LLKeyframeDataCache
+		U32 getSizeInBytes() const;
 		JointMotion* getJointMotion(U32 index) const { llassert(index < mJointMotionArray.size()); return mJointMotionArray[index]; }
 		U32 getNumJointMotions() const { return mJointMotionArray.size(); }
 	};
 
 
+	// Decodes an animation asset without touching any character state.
+	// Thread safe, returns NULL on malformed data.
+	static LLPointer<JointMotionList> parseJointMotionList(LLDataPacker& dp, const LLUUID& asset_id);
+
+	// Asynchronous decoding of fetched animation assets on LLKeyframeDecodeThread.
+	static void initDecodeThread(bool threaded);
+	static S32 updateDecodeThread(F32 max_time_ms);
+	static void cleanupDecodeThread();
+	static void onDecodeComplete(const LLUUID& asset_id, JointMotionList* joint_motion_list);
+
 protected:
+	// binds decoded data to mCharacter's skeleton, main thread only
+	BOOL bindJointMotionList(JointMotionList* joint_motion_list);
+
+	// hands the raw asset over to the decode thread, takes ownership of data
+	BOOL requestDecode(U8* data, S32 size);
+
 	static LLVFS*				sVFS;
 
+	typedef std::map<LLUUID, uuid_vec_t> pending_decode_map_t;
+	static pending_decode_map_t	sPendingDecodes; // asset id -> waiting character ids
+
 	//-------------------------------------------------------------------------
 	// Member Data
 	//-------------------------------------------------------------------------
-	JointMotionList*				mJointMotionList;
+	LLPointer<JointMotionList>		mJointMotionList;
 	std::vector<LLPointer<LLJointState> > mJointStates;
 	LLJoint*						mPelvisp;
 	LLCharacter*					mCharacter;
@@ -433,6 +464,12 @@ protected:
 	AssetStatus						mAssetStatus;
 };
 
+//-----------------------------------------------------------------------------
+// class LLKeyframeDataCache
+// Size bounded, least recently used cache of decoded keyframe data keyed by
+// asset id. Evicting an entry only drops the cache's reference, motions that
+// are still using the data keep it alive.
+//-----------------------------------------------------------------------------
 class LLKeyframeDataCache
 {
 public:
@@ -440,7 +477,14 @@ public:
 	LLKeyframeDataCache(){};
 	~LLKeyframeDataCache();
 
-	typedef std::map<LLUUID, class LLKeyframeMotion::JointMotionList*> keyframe_data_map_t; 
+	typedef std::list<LLUUID> lru_list_t;
+	struct CacheEntry
+	{
+		LLPointer<LLKeyframeMotion::JointMotionList>	mJointMotionList;
+		lru_list_t::iterator							mLRUIter;
+		U32												mSize;
+	};
+	typedef std::map<LLUUID, CacheEntry> keyframe_data_map_t; 
 	static keyframe_data_map_t sKeyframeDataMap;
 
 	static void addKeyframeData(const LLUUID& id, LLKeyframeMotion::JointMotionList*);
@@ -448,9 +492,30 @@ public:
 
 	static void removeKeyframeData(const LLUUID& id);
 
+	// 0 means unbounded
+	static void setMaxSize(U64 max_bytes);
+	static U64 getMaxSize() { return sMaxSize; }
+	static U64 getSize() { return sCurrentSize; }
+
+	static void recordDecode(F64 decode_time_ms);
+
 	//print out diagnostic info
 	static void dumpDiagInfo();
 	static void clear();
+
+private:
+	static void evict(U64 max_bytes);
+
+	static lru_list_t	sLRUList; // most recently used at the front
+	static U64			sMaxSize;
+	static U64			sCurrentSize;
+
+	// statistics
+	static U32			sHits;
+	static U32			sMisses;
+	static U32			sEvictions;
+	static U32			sDecodes;
+	static F64			sTotalDecodeTimeMs;
 };
 
 #endif // LL_LLKEYFRAMEMOTION_H
@@ -42,6 +42,9 @@
 // This is why LL_CHARACTER_MAX_ANIMATED_JOINTS needs to be a multiple of 4.
 const S32 NUM_JOINT_SIGNATURE_STRIDES = LL_CHARACTER_MAX_ANIMATED_JOINTS / 4;
 const U32 MAX_MOTION_INSTANCES = 32;
+// <polarity> weight of the newest sample in the running update cost average
+const F32 UPDATE_COST_SMOOTHING = 0.1f;
+// </polarity>
 
 //-----------------------------------------------------------------------------
 // Constants and statics
@@ -141,7 +144,12 @@ LLMotionController::LLMotionController()
 	  mTimeStep(0.f),
 	  mTimeStepCount(0),
 	  mLastInterp(0.f),
-	  mIsSelf(FALSE)
+	  mIsSelf(FALSE),
+	  mThreadedUpdate(false),
+	  mVisualParamsDirty(false),
+	  mAnimationLOD(ANIM_LOD_FULL),
+	  mLastUpdateCost(0.f),
+	  mAverageUpdateCost(0.f)
 {
 }
 
@@ -396,6 +404,15 @@ LLMotion* LLMotionController::createMotion( const LLUUID &id )
 //-----------------------------------------------------------------------------
 BOOL LLMotionController::startMotion(const LLUUID &id, F32 start_offset)
 {
+	// <polarity> Parallel avatar update
+	// creating a motion may initialize it from the asset system, leave that to the main thread
+	if (mThreadedUpdate)
+	{
+		mDeferredStarts.push_back(std::make_pair(id, start_offset));
+		return TRUE;
+	}
+	// </polarity>
+
 	// do we have an instance of this motion for this character?
 	LLMotion *motion = findMotion(id);
 
@@ -813,6 +830,7 @@ void LLMotionController::updateLoadingMotions()
 //-----------------------------------------------------------------------------
 void LLMotionController::updateMotions(bool force_update)
 {
+	const U64 start_time = LLTimer::getTotalTime(); // <polarity/>
 	BOOL use_quantum = (mTimeStep != 0.f);
 
 	// Always update mPrevTimerElapsed
@@ -822,7 +840,13 @@ void LLMotionController::updateMotions(bool force_update)
 	mLastTime = mAnimTime;
 
 	// Always cap the number of loaded motions
-	purgeExcessMotions();
+	// <polarity> Parallel avatar update
+	// already done by prepareThreadedUpdate() on the main thread
+	if (!mThreadedUpdate)
+	{
+		purgeExcessMotions();
+	}
+	// </polarity>
 		
 	// Update timing info for this time step.
 	if (!mPaused)
@@ -844,8 +868,14 @@ void LLMotionController::updateMotions(bool force_update)
 					mLastInterp = interp;
 				}
 
-				updateLoadingMotions();
+				// <polarity> Parallel avatar update
+				if (!mThreadedUpdate)
+				{
+					updateLoadingMotions();
+				}
+				// </polarity>
 				
+				recordUpdateCost(start_time); // <polarity/>
 				return;
 			}
 			
@@ -863,7 +893,12 @@ void LLMotionController::updateMotions(bool force_update)
 		}
 	}
 
-	updateLoadingMotions();
+	// <polarity> Parallel avatar update
+	if (!mThreadedUpdate)
+	{
+		updateLoadingMotions();
+	}
+	// </polarity>
 	
 	resetJointSignatures();
 
@@ -892,6 +927,7 @@ void LLMotionController::updateMotions(bool force_update)
 	}
 
 	mHasRunOnce = TRUE;
+	recordUpdateCost(start_time); // <polarity/>
 //	LL_INFOS() << "Motion controller time " << motionTimer.getElapsedTimeF32() << LL_ENDL;
 }
 
@@ -901,6 +937,8 @@ void LLMotionController::updateMotions(bool force_update)
 //-----------------------------------------------------------------------------
 void LLMotionController::updateMotionsMinimal()
 {
+	const U64 start_time = LLTimer::getTotalTime(); // <polarity/>
+
 	// Always update mPrevTimerElapsed
 	mPrevTimerElapsed = mTimer.getElapsedTimeF32();
 
@@ -911,7 +949,72 @@ void LLMotionController::updateMotionsMinimal()
 	deactivateStoppedMotions();
 
 	mHasRunOnce = TRUE;
+	recordUpdateCost(start_time); // <polarity/>
+}
+
+// <polarity> Parallel avatar update
+//-----------------------------------------------------------------------------
+// prepareThreadedUpdate()
+//-----------------------------------------------------------------------------
+void LLMotionController::prepareThreadedUpdate()
+{
+	purgeExcessMotions();
+	updateLoadingMotions();
+	mThreadedUpdate = true;
+}
+
+//-----------------------------------------------------------------------------
+// finishThreadedUpdate()
+//-----------------------------------------------------------------------------
+void LLMotionController::finishThreadedUpdate()
+{
+	mThreadedUpdate = false;
+
+	if (!mDeferredStarts.empty())
+	{
+		deferred_start_list_t deferred_starts;
+		deferred_starts.swap(mDeferredStarts);
+		for (deferred_start_list_t::const_iterator iter = deferred_starts.begin();
+			 iter != deferred_starts.end(); ++iter)
+		{
+			startMotion(iter->first, iter->second);
+		}
+	}
+
+	if (mVisualParamsDirty)
+	{
+		mVisualParamsDirty = false;
+		mCharacter->updateVisualParams();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// requestVisualParamsUpdate()
+//-----------------------------------------------------------------------------
+void LLMotionController::requestVisualParamsUpdate()
+{
+	if (mThreadedUpdate)
+	{
+		mVisualParamsDirty = true;
+	}
+	else
+	{
+		mCharacter->updateVisualParams();
+	}
+}
+// </polarity>
+
+// <polarity> Animation level of detail
+//-----------------------------------------------------------------------------
+// recordUpdateCost()
+// folds the time spent since start_time (microseconds) into the cost figures
+//-----------------------------------------------------------------------------
+void LLMotionController::recordUpdateCost(U64 start_time)
+{
+	mLastUpdateCost = (F32)(LLTimer::getTotalTime() - start_time) / 1000.f;
+	mAverageUpdateCost = lerp(mAverageUpdateCost, mLastUpdateCost, UPDATE_COST_SMOOTHING);
 }
+// </polarity>
 
 //-----------------------------------------------------------------------------
 // activateMotionInstance()
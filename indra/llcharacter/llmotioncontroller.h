@@ -82,6 +82,20 @@ public:
 	typedef std::list<LLMotion*> motion_list_t;
 	typedef std::set<LLMotion*> motion_set_t;
 	BOOL mIsSelf;
+
+	// <polarity> Animation level of detail
+	// chosen by the owning character from its screen-space size.
+	// coarser levels are expected to come with a larger time step,
+	// and ANIM_LOD_LOW also stops evaluating extended (face, hand,
+	// tail, wing) joints, leaving them at their last blended pose.
+	enum EAnimationLOD
+	{
+		ANIM_LOD_FULL = 0,
+		ANIM_LOD_REDUCED,
+		ANIM_LOD_LOW,
+		ANIM_LOD_COUNT
+	};
+	// </polarity>
 	
 public:
 	// Constructor
@@ -131,6 +145,21 @@ public:
 	// minimal update (e.g. while hidden)
 	void updateMotionsMinimal();
 
+	// <polarity> Parallel avatar update
+	// Splits updateMotions() so it can run off the main thread. Call
+	// prepareThreadedUpdate() on the main thread first: it purges and loads
+	// motions, which reach into the asset system and shared caches. Motions
+	// started while the threaded update is in flight are queued and started
+	// by finishThreadedUpdate(), again on the main thread.
+	void prepareThreadedUpdate();
+	void finishThreadedUpdate();
+
+	// Motions call this rather than LLCharacter::updateVisualParams(), which
+	// reaches past the character into the render pipeline. During a threaded
+	// update the params are applied by finishThreadedUpdate().
+	void requestVisualParamsUpdate();
+	// </polarity>
+
 	void clearBlenders() { mPoseBlender.clearBlenders(); }
 
 	// flush motions
@@ -146,6 +175,17 @@ public:
 	BOOL isPaused() const { return mPaused; }
 
 	void setTimeStep(F32 step);
+	F32 getTimeStep() const { return mTimeStep; }
+
+	// <polarity> Animation level of detail
+	void setAnimationLOD(EAnimationLOD lod) { mAnimationLOD = lod; }
+	EAnimationLOD getAnimationLOD() const { return mAnimationLOD; }
+	bool skipExtendedJoints() const { return mAnimationLOD >= ANIM_LOD_LOW; }
+
+	// wall clock cost of the last update and a running average, in milliseconds
+	F32 getLastUpdateCost() const { return mLastUpdateCost; }
+	F32 getAverageUpdateCost() const { return mAverageUpdateCost; }
+	// </polarity>
 
 	void setTimeFactor(F32 time_factor);
 	F32 getTimeFactor() const { return mTimeFactor; }
@@ -183,6 +223,7 @@ protected:
 	void updateIdleActiveMotions();
 	void purgeExcessMotions();
 	void deactivateStoppedMotions();
+	void recordUpdateCost(U64 start_time); // <polarity/>
 
 protected:
 	F32					mTimeFactor;			// 1.f for normal speed
@@ -220,6 +261,19 @@ protected:
 	F32					mLastInterp;
 
 	U8					mJointSignature[2][LL_CHARACTER_MAX_ANIMATED_JOINTS];
+
+	// <polarity> Parallel avatar update
+	typedef std::vector<std::pair<LLUUID, F32> > deferred_start_list_t;
+	deferred_start_list_t	mDeferredStarts;
+	bool				mThreadedUpdate;
+	bool				mVisualParamsDirty;
+	// </polarity>
+
+	// <polarity> Animation level of detail
+	EAnimationLOD		mAnimationLOD;
+	F32					mLastUpdateCost;
+	F32					mAverageUpdateCost;
+	// </polarity>
 };
 
 //-----------------------------------------------------------------------------
@@ -41,9 +41,14 @@
 #include "llerror.h"
 #include "stringize.h"
 #include "llexception.h"
+#include "lltrace.h" // <polarity/>
 
 namespace {
-void no_op() {}
+//void no_op() {}
+// <polarity> Pooled coroutine stacks
+LLTrace::SampleStatHandle<> sLiveCoros("coroutines", "coroutines launched and not cleaned up yet");
+LLTrace::SampleStatHandle<F64Kilobytes> sCoroStackMem("coroutine_stacks", "memory of coroutine stacks, pooled ones included");
+// </polarity>
 } // anonymous namespace
 
 // Do nothing, when we need nothing done. This is a static member of LLCoros
@@ -87,10 +92,16 @@ LLCoros::Current::Current()
         // CoroData's constructor in fact initializes its mCoro with a
         // coroutine with that stack size, no one ever actually enters it by
         // calling mCoro().
-        sCurrent.reset(new CoroData(0,  // no prev
-                                    "", // not a named coroutine
-                                    no_op,  // no-op callable
-                                    1024)); // stacksize moot
+//      sCurrent.reset(new CoroData(0,  // no prev
+//                                  "", // not a named coroutine
+//                                  no_op,  // no-op callable
+//                                  1024)); // stacksize moot
+        // <polarity> Pooled coroutine stacks
+        // no coroutine at all, so no stack either
+        sCurrent.reset(new CoroData(0,      // no prev
+                                    "",     // not a named coroutine
+                                    NULL)); // no worker
+        // </polarity>
     }
 
     mCurrent = &sCurrent;
@@ -153,23 +164,129 @@ LLCoros::LLCoros():
     // Previously we used
     // boost::context::guarded_stack_allocator::default_stacksize();
     // empirically this is 64KB on Windows and Linux. Try quadrupling.
-    mStackSize(256*1024)
+    mStackSize(256*1024),
+    // <polarity> Pooled coroutine stacks
+    mStackPoolSize(16),
+    mLiveWorkers(0),
+    mPeakCoros(0),
+    mStackBytes(0),
+    mPeakStackBytes(0),
+    mLaunches(0),
+    mReuses(0)
+    // </polarity>
 {
     // Register our cleanup() method for "mainloop" ticks
     LLEventPumps::instance().obtain("mainloop").listen(
         "LLCoros", boost::bind(&LLCoros::cleanup, this, _1));
 }
 
+// <polarity> Pooled coroutine stacks
+LLCoros::~LLCoros()
+{
+    // Pooled workers are waiting in toplevel() for their next launch(), a
+    // coroutine destroyed there just unwinds. mCoros deletes the others.
+    for (WorkerPool::iterator iter = mIdleWorkers.begin(); iter != mIdleWorkers.end(); ++iter)
+    {
+        for (std::vector<Worker*>::iterator worker = iter->second.begin(); worker != iter->second.end(); ++worker)
+        {
+            delete *worker;
+        }
+    }
+}
+
+LLCoros::CoroData::~CoroData()
+{
+    // only still set when killed or at shutdown: ends the coroutine
+    delete mWorker;
+}
+
+LLCoros::Worker* LLCoros::obtainWorker(S32 stacksize)
+{
+    ++mLaunches;
+    std::vector<Worker*>& idle = mIdleWorkers[stacksize];
+    if (! idle.empty())
+    {
+        Worker* worker = idle.back();
+        idle.pop_back();
+        ++mReuses;
+        return worker;
+    }
+    Worker* worker = new Worker(stacksize);
+    ++mLiveWorkers;
+    mStackBytes += stacksize;
+    mPeakStackBytes = llmax(mPeakStackBytes, mStackBytes);
+    return worker;
+}
+
+void LLCoros::releaseWorker(Worker* worker)
+{
+    worker->mData = NULL;
+    std::vector<Worker*>& idle = mIdleWorkers[worker->mStackSize];
+    if (idle.size() < mStackPoolSize)
+    {
+        idle.push_back(worker);
+    }
+    else
+    {
+        deleteWorker(worker);
+    }
+}
+
+void LLCoros::deleteWorker(Worker* worker)
+{
+    --mLiveWorkers;
+    mStackBytes -= worker->mStackSize;
+    delete worker;
+}
+
+void LLCoros::updateCoroStats()
+{
+    mPeakCoros = llmax(mPeakCoros, (U32)mCoros.size());
+    LLTrace::sample(sLiveCoros, (F64)mCoros.size());
+    LLTrace::sample(sCoroStackMem, F64Bytes((F64)mStackBytes));
+}
+
+void LLCoros::setStackPoolSize(U32 size)
+{
+    LL_DEBUGS("LLCoros") << "Keeping up to " << size << " idle coroutine stacks per size" << LL_ENDL;
+    mStackPoolSize = size;
+    for (WorkerPool::iterator iter = mIdleWorkers.begin(); iter != mIdleWorkers.end(); ++iter)
+    {
+        while (iter->second.size() > mStackPoolSize)
+        {
+            deleteWorker(iter->second.back());
+            iter->second.pop_back();
+        }
+    }
+    updateCoroStats();
+}
+
+void LLCoros::logStackStats() const
+{
+    U32 idle = 0;
+    for (WorkerPool::const_iterator iter = mIdleWorkers.begin(); iter != mIdleWorkers.end(); ++iter)
+    {
+        idle += (U32)iter->second.size();
+    }
+    LL_INFOS("LLCoros") << mLaunches << " coroutines launched, " << mReuses << " on a pooled stack; "
+                        << mCoros.size() << " live, " << mPeakCoros << " at most; "
+                        << mLiveWorkers << " stacks (" << idle << " idle) in " << (mStackBytes / 1024) << " KB, "
+                        << (mPeakStackBytes / 1024) << " KB at most" << LL_ENDL;
+}
+// </polarity>
+
 bool LLCoros::cleanup(const LLSD&)
 {
     static std::string previousName;
     static int previousCount = 0;
+    bool cleaned = false; // <polarity/>
     // Walk the mCoros map, checking and removing completed coroutines.
     for (CoroMap::iterator mi(mCoros.begin()), mend(mCoros.end()); mi != mend; )
     {
         // Has this coroutine exited (normal return, exception, exit() call)
         // since last tick?
-        if (mi->second->mCoro.exited())
+//      if (mi->second->mCoro.exited())
+        if (mi->second->mDone) // <polarity/>
         {
             if (previousName != mi->first)
             { 
@@ -189,6 +306,11 @@ bool LLCoros::cleanup(const LLSD&)
                     LL_DEBUGS("LLCoros") << "LLCoros: cleaning up coroutine " << mi->first << "("<< previousCount << ")" << LL_ENDL;
 
             }
+            // <polarity> Pooled coroutine stacks
+            releaseWorker(mi->second->mWorker);
+            mi->second->mWorker = NULL;
+            cleaned = true;
+            // </polarity>
             // The erase() call will invalidate its passed iterator value --
             // so increment mi FIRST -- but pass its original value to
             // erase(). This is what postincrement is all about.
@@ -201,6 +323,12 @@ bool LLCoros::cleanup(const LLSD&)
             ++mi;
         }
     }
+    // <polarity> Pooled coroutine stacks
+    if (cleaned)
+    {
+        updateCoroStats();
+    }
+    // </polarity>
     return false;
 }
 
@@ -259,7 +387,21 @@ bool LLCoros::kill(const std::string& name)
     // Because this is a boost::ptr_map, erasing the map entry also destroys
     // the referenced heap object, in this case the boost::coroutine object,
     // which will terminate the coroutine.
+    // <polarity> Pooled coroutine stacks
+    // one that is already done can still go back to the pool
+    CoroData* data = found->second;
+    if (data->mDone)
+    {
+        releaseWorker(data->mWorker);
+    }
+    else
+    {
+        deleteWorker(data->mWorker);
+    }
+    data->mWorker = NULL;
+    // </polarity>
     mCoros.erase(found);
+    updateCoroStats(); // <polarity/>
     return true;
 }
 
@@ -299,11 +441,35 @@ void LLCoros::toplevel(coro::self& self, CoroData* data, const callable_t& calla
         // crash, hopefully informatively.
         CRASH_ON_UNHANDLED_EXCEPTION(STRINGIZE("coroutine " << data->mName));
     }
+    data->mDone = true; // <polarity/>
     // This cleanup isn't perfectly symmetrical with the way we initially set
     // data->mPrev, but this is our last chance to reset Current.
     Current().reset(data->mPrev);
 }
 
+// <polarity> Pooled coroutine stacks
+// The worker's coroutine: runs one launch() after another on the same stack.
+void LLCoros::workerloop(coro::self& self, Worker* worker)
+{
+    while (true)
+    {
+        {
+            // dropped before the worker waits, as when the coroutine ended
+            callable_t callable;
+            callable.swap(worker->mCallable);
+            toplevel(self, worker->mData, callable);
+        }
+        // Wait for cleanup() to pool this and launch() to hand it the next
+        // one. Anything else resuming it, such as a callback left over from
+        // the last one, finds nothing to do.
+        do
+        {
+            self.yield();
+        } while (! worker->mData || worker->mData->mDone);
+    }
+}
+// </polarity>
+
 /*****************************************************************************
 *   MUST BE LAST
 *****************************************************************************/
@@ -319,31 +485,61 @@ void LLCoros::toplevel(coro::self& self, CoroData* data, const callable_t& calla
 #pragma optimize("", off)
 #endif // LL_MSVC
 
-LLCoros::CoroData::CoroData(CoroData* prev, const std::string& name,
-                            const callable_t& callable, S32 stacksize):
+//LLCoros::CoroData::CoroData(CoroData* prev, const std::string& name,
+//                          const callable_t& callable, S32 stacksize):
+LLCoros::CoroData::CoroData(CoroData* prev, const std::string& name, Worker* worker): // <polarity/>
     mPrev(prev),
     mName(name),
     // Wrap the caller's callable in our toplevel() function so we can manage
     // Current appropriately at startup and shutdown of each coroutine.
-    mCoro(boost::bind(toplevel, _1, this, callable), stacksize),
+//  mCoro(boost::bind(toplevel, _1, this, callable), stacksize),
+    // <polarity> Pooled coroutine stacks
+    mWorker(worker),
+    mDone(false),
+    // </polarity>
     // don't consume events unless specifically directed
     mConsuming(false),
     mSelf(0)
 {
 }
 
+// <polarity> Pooled coroutine stacks
+LLCoros::Worker::Worker(S32 stacksize):
+    mStackSize(stacksize),
+    mData(NULL),
+    // workerloop() runs each callable through toplevel()
+    mCoro(boost::bind(workerloop, _1, this), stacksize)
+{
+}
+// </polarity>
+
 std::string LLCoros::launch(const std::string& prefix, const callable_t& callable)
 {
+    // <polarity> Pooled coroutine stacks
+    return launch(prefix, callable, mStackSize);
+}
+
+std::string LLCoros::launch(const std::string& prefix, const callable_t& callable, S32 stacksize)
+{
+    // </polarity>
     std::string name(generateDistinctName(prefix));
     Current current;
     // pass the current value of Current as previous context
-    CoroData* newCoro = new CoroData(current, name, callable, mStackSize);
+//  CoroData* newCoro = new CoroData(current, name, callable, mStackSize);
+    // <polarity> Pooled coroutine stacks
+    Worker* worker = obtainWorker(stacksize);
+    CoroData* newCoro = new CoroData(current, name, worker);
+    worker->mData = newCoro;
+    worker->mCallable = callable;
+    // </polarity>
     // Store it in our pointer map
     mCoros.insert(name, newCoro);
+    updateCoroStats(); // <polarity/>
     // also set it as current
     current.reset(newCoro);
     /* Run the coroutine until its first wait, then return here */
-    (newCoro->mCoro)(std::nothrow);
+//  (newCoro->mCoro)(std::nothrow);
+    (worker->mCoro)(std::nothrow); // <polarity/>
     return name;
 }
 
@@ -36,7 +36,9 @@
 #include <boost/function.hpp>
 #include <boost/thread/tss.hpp>
 #include <boost/noncopyable.hpp>
+#include <map>      // <polarity/>
 #include <string>
+#include <vector>   // <polarity/>
 #include <stdexcept>
 #include "llcoro_get_id.h"          // for friend declaration
 
@@ -86,6 +88,7 @@ class Suspending;
 class LL_COMMON_API LLCoros: public LLSingleton<LLCoros>
 {
     LLSINGLETON(LLCoros);
+    ~LLCoros(); // <polarity/>
 public:
     /// Canonical boost::dcoroutines::coroutine signature we use
     typedef boost::dcoroutines::coroutine<void()> coro;
@@ -131,6 +134,22 @@ public:
      */
     std::string launch(const std::string& prefix, const callable_t& callable);
 
+    // <polarity> Pooled coroutine stacks
+    /**
+     * launch() with a stack of other than the setStackSize() size.
+     *
+     * A coroutine that returned is not destroyed: its stack goes back to a
+     * pool, one per stack size, and the next launch() with that size runs
+     * on it instead of allocating a new one. A killed coroutine is always
+     * destroyed, its stack may still be in use.
+     */
+    std::string launch(const std::string& prefix, const callable_t& callable, S32 stacksize);
+
+    /// idle stacks kept per stack size, 0 to free each one as before
+    void setStackPoolSize(U32 size);
+    void logStackStats() const;
+    // </polarity>
+
     /**
      * Abort a running coroutine by name. Normally, when a coroutine either
      * runs to completion or terminates with an exception, LLCoros quietly
@@ -187,11 +206,47 @@ private:
 
     S32 mStackSize;
 
+    // <polarity> Pooled coroutine stacks
+    // A coroutine instance and its stack, running one launch() after
+    // another. Between two it waits in toplevel() for the next.
+    struct Worker
+    {
+        Worker(S32 stacksize);
+
+        const S32 mStackSize;
+        // the launch() it runs, NULL while in the pool
+        CoroData* mData;
+        // what mData is to run, toplevel() takes it
+        callable_t mCallable;
+        LLCoros::coro mCoro;
+    };
+    static void workerloop(coro::self& self, Worker* worker);
+    Worker* obtainWorker(S32 stacksize);
+    // back to the pool, or deleted if that is full
+    void releaseWorker(Worker* worker);
+    void deleteWorker(Worker* worker);
+    void updateCoroStats();
+
+    typedef std::map<S32, std::vector<Worker*> > WorkerPool;
+    WorkerPool mIdleWorkers;
+    U32 mStackPoolSize;
+    U32 mLiveWorkers;       // running or idle, i.e. stacks allocated
+    U32 mPeakCoros;
+    U64 mStackBytes;        // of all mLiveWorkers
+    U64 mPeakStackBytes;
+    U64 mLaunches;
+    U64 mReuses;
+    // </polarity>
+
     // coroutine-local storage, as it were: one per coro we track
     struct CoroData
     {
-        CoroData(CoroData* prev, const std::string& name,
-                 const callable_t& callable, S32 stacksize);
+//      CoroData(CoroData* prev, const std::string& name,
+//               const callable_t& callable, S32 stacksize);
+        // <polarity> Pooled coroutine stacks
+        CoroData(CoroData* prev, const std::string& name, Worker* worker);
+        ~CoroData();
+        // </polarity>
 
         // The boost::dcoroutines library supports asymmetric coroutines. Every
         // time we context switch out of a coroutine, we pass control to the
@@ -202,7 +257,14 @@ private:
         // tweaked name of the current coroutine
         const std::string mName;
         // the actual coroutine instance
-        LLCoros::coro mCoro;
+//      LLCoros::coro mCoro;
+        // <polarity> Pooled coroutine stacks
+        // the coroutine running this one, owned until cleanup() takes it
+        // back; NULL for a thread's "main coroutine"
+        Worker* mWorker;
+        // the callable returned or threw, mWorker is free to go
+        bool mDone;
+        // </polarity>
         // set_consuming() state
         bool mConsuming;
         // When the dcoroutine library calls a top-level callable, it implicitly
@@ -32,6 +32,7 @@
 #include "llerror.h"
 #include "llerrorcontrol.h"
 
+#include <atomic> // <polarity/>
 #include <cctype>
 #ifdef __GNUC__
 # include <cxxabi.h>
@@ -47,12 +48,15 @@
 #include "llapr.h"
 #include "llfile.h"
 #include "lllivefile.h"
+#include "llmutex.h" // <polarity/>
 #include "llsd.h"
 #include "llsdserialize.h"
 #include "llsingleton.h"
 #include "llstl.h"
 #include "lltimer.h"
 
+#include <boost/thread/tss.hpp> // <polarity/>
+
 namespace {
 #if LL_WINDOWS
 	void debugger_print(const std::string& s)
@@ -413,6 +417,8 @@ namespace
 	}
 }
 
+extern LLMutex gLogMutex; // <polarity/>
+
 namespace LLError
 {
 	class SettingsConfig : public LLRefCount
@@ -857,6 +863,10 @@ namespace LLError
 		{
 			return;
 		}
+		// <polarity> Asynchronous logging
+		// the log writer thread goes through the recorders under gLogMutex
+		LLMutexLock lock(&gLogMutex);
+		// </polarity>
 		SettingsConfigPtr s = Settings::getInstance()->getSettingsConfig();
 		s->mRecorders.push_back(recorder);
 	}
@@ -867,6 +877,7 @@ namespace LLError
 		{
 			return;
 		}
+		LLMutexLock lock(&gLogMutex); // <polarity/>
 		SettingsConfigPtr s = Settings::getInstance()->getSettingsConfig();
 		s->mRecorders.erase(std::remove(s->mRecorders.begin(), s->mRecorders.end(), recorder),
 							s->mRecorders.end());
@@ -923,7 +934,25 @@ namespace LLError
 
 namespace
 {
-	void writeToRecorders(const LLError::CallSite& site, const std::string& message, bool show_location = true, bool show_time = true, bool show_tags = true, bool show_level = true, bool show_function = true)
+	// <polarity> Asynchronous logging
+	std::string format_utc_time(time_t when)
+	{
+		const size_t BUF_SIZE = 64;
+		char time_str[BUF_SIZE];	/* Flawfinder: ignore */
+		
+		size_t chars = strftime(time_str, BUF_SIZE, 
+								  "%Y-%m-%dT%H:%M:%SZ",
+								  gmtime(&when));
+
+		return chars ? time_str : "time error";
+	}
+
+	//void writeToRecorders(const LLError::CallSite& site, const std::string& message, bool show_location = true, bool show_time = true, bool show_tags = true, bool show_level = true, bool show_function = true)
+	// message_time is when a queued message was logged, the default time
+	// function is the only one that can be asked about the past
+	void writeToRecorders(const LLError::CallSite& site, const std::string& message, bool show_location = true, bool show_time = true, bool show_tags = true, bool show_level = true, bool show_function = true,
+						  const time_t* message_time = NULL)
+	// </polarity>
 	{
 		LLError::ELevel level = site.mLevel;
 		LLError::SettingsConfigPtr s = LLError::Settings::getInstance()->getSettingsConfig();
@@ -938,7 +967,12 @@ namespace
 
 			if (show_time && r->wantsTime() && s->mTimeFunction != NULL)
 			{
-				message_stream << s->mTimeFunction() << " ";
+				// <polarity> Asynchronous logging
+				//message_stream << s->mTimeFunction() << " ";
+				message_stream << (message_time && s->mTimeFunction == LLError::utcTime
+								   ? format_utc_time(*message_time)
+								   : s->mTimeFunction()) << " ";
+				// </polarity>
 			}
 
 			if (show_level && r->wantsLevel())
@@ -1014,7 +1048,11 @@ namespace {
 	class LogLock
 	{
 	public:
-		LogLock();
+		// <polarity> Asynchronous logging
+		//LogLock();
+		// wait: block until the lock is there, for what must not be dropped
+		LogLock(bool wait = false);
+		// </polarity>
 		~LogLock();
 		bool ok() const { return mOK; }
 	private:
@@ -1022,9 +1060,23 @@ namespace {
 		bool mOK;
 	};
 	
-	LogLock::LogLock()
+	// <polarity> Asynchronous logging
+	//LogLock::LogLock()
+	LogLock::LogLock(bool wait)
+	// </polarity>
 		: mLocked(false), mOK(false)
 	{
+		// <polarity> Asynchronous logging
+		// The log writer thread holds the mutex for a batch of messages at a
+		// time, a fatal message waits that out instead of being skipped.
+		if (wait)
+		{
+			gLogMutex.lock();
+			mLocked = true;
+			mOK = true;
+			return;
+		}
+		// </polarity>
 		const int MAX_RETRIES = 5;
 		for (int attempts = 0; attempts < MAX_RETRIES; ++attempts)
 		{
@@ -1055,11 +1107,336 @@ namespace {
 	}
 }
 
+// <polarity> Asynchronous logging
+namespace
+{
+	// Applies the print once rule and hands the message to the recorders.
+	// Returns false when the rule held it back, written gets what the
+	// recorders got. Call with gLogMutex held.
+	bool write_log_message(const LLError::CallSite& site, const std::string& message, const time_t* message_time,
+						   std::string& written)
+	{
+		LLError::SettingsConfigPtr s = LLError::Settings::getInstance()->getSettingsConfig();
+
+		std::ostringstream message_stream;
+
+		if (site.mPrintOnce)
+		{
+			std::map<std::string, unsigned int>::iterator messageIter = s->mUniqueLogMessages.find(message);
+			if (messageIter != s->mUniqueLogMessages.end())
+			{
+				messageIter->second++;
+				unsigned int num_messages = messageIter->second;
+				if (num_messages == 10 || num_messages == 50 || (num_messages % 100) == 0)
+				{
+					message_stream << "ONCE (" << num_messages << "th time seen): ";
+				} 
+				else
+				{
+					return false;
+				}
+			}
+			else 
+			{
+				message_stream << "ONCE: ";
+				s->mUniqueLogMessages[message] = 1;
+			}
+		}
+		
+		message_stream << message;
+		written = message_stream.str();
+		
+		writeToRecorders(site, written, true, true, true, true, true, message_time);
+		return true;
+	}
+
+	// In async mode each thread logs into its own stream and queue instead
+	// of taking gLogMutex. Only the thread a queue belongs to adds to it,
+	// only whoever holds gLogMutex takes from it, so neither side locks.
+	// The log writer thread empties the queues every LOG_WRITER_INTERVAL_MS,
+	// or sooner when one is half full, and does the formatting, the level
+	// and print once bookkeeping and the writing.
+	const U32 LOG_QUEUE_SIZE = 1024;
+	const U32 LOG_QUEUE_MASK = LOG_QUEUE_SIZE - 1;
+	const U32 LOG_WRITER_INTERVAL_MS = 20;
+	const U32 LOG_WRITER_CHUNK = 64;
+	// a warning waits this long for room in a full queue, anything less
+	// important is dropped right away
+	const U32 LOG_QUEUE_WARNING_WAIT_MS = 100;
+
+	struct QueuedLogMessage
+	{
+		const LLError::CallSite*	mSite;		// sites are statics in the macros
+		U64							mSequence;	// keeps the order across threads
+		time_t						mTime;
+		std::string					mMessage;
+	};
+
+	bool sort_by_sequence(const QueuedLogMessage& a, const QueuedLogMessage& b)
+	{
+		return a.mSequence < b.mSequence;
+	}
+
+	// Slots outlive their threads, a queue may still hold messages when
+	// its thread ends. The log writer frees a retired slot once it has
+	// taken the last of them.
+	struct LogThreadSlot
+	{
+		LogThreadSlot(U32 index)
+		:	mIndex(index),
+			mStreamInUse(false),
+			mRetired(false),
+			mQueue(new QueuedLogMessage[LOG_QUEUE_SIZE]),
+			mWritten(0),
+			mRead(0),
+			mDropped(0)
+		{
+		}
+
+		~LogThreadSlot()
+		{
+			delete[] mQueue;
+		}
+
+		U32					mIndex;
+		std::ostringstream	mStream;		// this thread's Globals::messageStream
+		bool				mStreamInUse;
+		bool				mRetired;		// its thread has ended, under sLogSlotsMutex
+		QueuedLogMessage*	mQueue;
+		std::atomic<U32>	mWritten;
+		std::atomic<U32>	mRead;
+		std::atomic<U32>	mDropped;
+	};
+
+	std::atomic<bool> sAsyncLogging(false);
+	std::atomic<U64> sLogSequence(0);
+	std::atomic<U64> sDroppedLogMessages(0);
+	std::atomic<U32> sLogSlotCount(0);		// slots ever made, also their index
+	LL_THREAD_LOCAL LogThreadSlot* sLogThreadSlot = NULL;
+
+	// never destroyed, threads may still log during static destruction
+	LLMutex* sLogSlotsMutex = new LLMutex();
+	std::vector<LogThreadSlot*>* sLogSlots = new std::vector<LogThreadSlot*>();
+
+	LLMutex* sLogWriterControlMutex = new LLMutex();
+	LLCondition* sLogWriterCondition = new LLCondition();
+	boost::thread* sLogWriterThread = NULL;
+	bool sLogWriterStop = false;			// under sLogWriterCondition
+
+	void retire_log_thread_slot(LogThreadSlot* slot)
+	{
+		LLMutexLock lock(sLogSlotsMutex);
+		slot->mRetired = true;
+		if (slot == sLogThreadSlot)
+		{
+			sLogThreadSlot = NULL;
+		}
+	}
+
+	LogThreadSlot* get_log_thread_slot()
+	{
+		if (!sLogThreadSlot)
+		{
+			// only there to retire the slot when its thread ends, the main
+			// thread never gets there and keeps its slot for static destruction
+			static boost::thread_specific_ptr<LogThreadSlot>* sSlotOwner
+				= new boost::thread_specific_ptr<LogThreadSlot>(&retire_log_thread_slot);
+
+			LLMutexLock lock(sLogSlotsMutex);
+			sLogThreadSlot = new LogThreadSlot(sLogSlotCount.load(std::memory_order_relaxed));
+			sLogSlots->push_back(sLogThreadSlot);
+			sLogSlotCount.fetch_add(1, std::memory_order_release);
+			sSlotOwner->reset(sLogThreadSlot);
+		}
+		return sLogThreadSlot;
+	}
+
+	void wake_log_writer()
+	{
+		sLogWriterCondition->signal();
+	}
+
+	// Gives back the calling thread's stream and what was logged into it,
+	// false when out is some other stream.
+	bool release_thread_stream(std::ostringstream* out, std::string& message)
+	{
+		LogThreadSlot* slot = sLogThreadSlot;
+		if (!slot || out != &slot->mStream)
+		{
+			return false;
+		}
+		message = out->str();
+		out->clear();
+		out->str("");
+		slot->mStreamInUse = false;
+		return true;
+	}
+
+	// Takes message's contents, or counts it as dropped.
+	void queue_log_message(const LLError::CallSite& site, std::string& message)
+	{
+		LogThreadSlot* slot = get_log_thread_slot();
+		const U32 written = slot->mWritten.load(std::memory_order_relaxed);
+		U32 waited_ms = 0;
+		while (written - slot->mRead.load(std::memory_order_acquire) >= LOG_QUEUE_SIZE)
+		{
+			if (site.mLevel < LLError::LEVEL_WARN || waited_ms >= LOG_QUEUE_WARNING_WAIT_MS)
+			{
+				slot->mDropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			wake_log_writer();
+			ms_sleep(1);
+			++waited_ms;
+		}
+
+		QueuedLogMessage& queued = slot->mQueue[written & LOG_QUEUE_MASK];
+		queued.mSite = &site;
+		queued.mSequence = sLogSequence.fetch_add(1, std::memory_order_relaxed);
+		queued.mTime = time(NULL);
+		queued.mMessage.swap(message);
+		slot->mWritten.store(written + 1, std::memory_order_release);
+
+		if (written + 1 - slot->mRead.load(std::memory_order_relaxed) == LOG_QUEUE_SIZE / 2)
+		{
+			wake_log_writer();
+		}
+	}
+
+	// Messages taken off the queues and not written yet, in the order they
+	// were logged. Under gLogMutex.
+	std::vector<QueuedLogMessage>* sPendingLogMessages = new std::vector<QueuedLogMessage>();
+	size_t sPendingLogPosition = 0;
+	bool sWritingQueuedLogMessages = false;
+
+	void take_queued_log_messages()
+	{
+		LLMutexLock lock(sLogSlotsMutex);
+		for (std::vector<LogThreadSlot*>::iterator iter = sLogSlots->begin(); iter != sLogSlots->end(); )
+		{
+			LogThreadSlot* slot = *iter;
+			const U32 written = slot->mWritten.load(std::memory_order_acquire);
+			for (U32 read = slot->mRead.load(std::memory_order_relaxed); read != written; ++read)
+			{
+				QueuedLogMessage& queued = slot->mQueue[read & LOG_QUEUE_MASK];
+				sPendingLogMessages->push_back(QueuedLogMessage());
+				QueuedLogMessage& pending = sPendingLogMessages->back();
+				pending.mSite = queued.mSite;
+				pending.mSequence = queued.mSequence;
+				pending.mTime = queued.mTime;
+				pending.mMessage.swap(queued.mMessage);
+			}
+			slot->mRead.store(written, std::memory_order_release);
+
+			const U32 dropped = slot->mDropped.exchange(0, std::memory_order_relaxed);
+			if (dropped)
+			{
+				// not through LL_WARNS, that could end up back in here
+				static const char* tags[] = { "Logging" };
+				static LLError::CallSite dropped_site(LLError::LEVEL_WARN, __FILE__, __LINE__,
+													  typeid(LLError::NoClassInfo), __FUNCTION__, false, tags, 1);
+				sDroppedLogMessages.fetch_add(dropped, std::memory_order_relaxed);
+				sPendingLogMessages->push_back(QueuedLogMessage());
+				QueuedLogMessage& pending = sPendingLogMessages->back();
+				pending.mSite = &dropped_site;
+				pending.mSequence = sLogSequence.fetch_add(1, std::memory_order_relaxed);
+				pending.mTime = time(NULL);
+				pending.mMessage = llformat("Log queue of thread %u was full, dropped %u messages", slot->mIndex, dropped);
+			}
+
+			// its thread is gone, nothing more can have been queued
+			if (slot->mRetired)
+			{
+				delete slot;
+				iter = sLogSlots->erase(iter);
+			}
+			else
+			{
+				++iter;
+			}
+		}
+		std::sort(sPendingLogMessages->begin(), sPendingLogMessages->end(), sort_by_sequence);
+	}
+
+	// Writes out queued messages in the order they were logged, everything
+	// queued so far unless max_messages runs out first. Returns true when
+	// it did. Call with gLogMutex held.
+	bool write_queued_log_messages(U32 max_messages = U32_MAX)
+	{
+		if (sWritingQueuedLogMessages || !sLogSlotCount.load(std::memory_order_acquire))
+		{
+			// a recorder that logs, its message waits for the next round
+			return false;
+		}
+		sWritingQueuedLogMessages = true;
+
+		bool took = false;
+		bool more = false;
+		std::string written;
+		U32 count = 0;
+		while (true)
+		{
+			if (sPendingLogPosition == sPendingLogMessages->size())
+			{
+				sPendingLogMessages->clear();
+				sPendingLogPosition = 0;
+				if (took)
+				{
+					break;
+				}
+				take_queued_log_messages();
+				took = true;
+				continue;
+			}
+			if (count >= max_messages)
+			{
+				more = true;
+				break;
+			}
+			const QueuedLogMessage& pending = (*sPendingLogMessages)[sPendingLogPosition++];
+			write_log_message(*pending.mSite, pending.mMessage, &pending.mTime, written);
+			++count;
+		}
+
+		sWritingQueuedLogMessages = false;
+		return more;
+	}
+
+	void log_writer_loop()
+	{
+		bool stop = false;
+		while (!stop)
+		{
+			sLogWriterCondition->lock();
+			if (!sLogWriterStop)
+			{
+				sLogWriterCondition->timed_wait(*sLogWriterCondition,
+												boost::posix_time::milliseconds(LOG_WRITER_INTERVAL_MS));
+			}
+			stop = sLogWriterStop;
+			sLogWriterCondition->unlock();
+
+			// a few at a time, LogLock only waits a few milliseconds for the
+			// other threads' turn, fatal messages wait as long as it takes
+			bool more = true;
+			while (more)
+			{
+				LLMutexLock lock(&gLogMutex);
+				more = write_queued_log_messages(LOG_WRITER_CHUNK);
+			}
+		}
+	}
+}
+// </polarity>
+
 namespace LLError
 {
 	bool Log::shouldLog(CallSite& site)
 	{
-		LogLock lock;
+		// <polarity> Asynchronous logging
+		//LogLock lock;
+		LogLock lock(site.mLevel == LEVEL_ERROR);
+		// </polarity>
 		if (!lock.ok())
 		{
 			return false;
@@ -1102,6 +1479,18 @@ namespace LLError
 
 	std::ostringstream* Log::out()
 	{
+		// <polarity> Asynchronous logging
+		if (sAsyncLogging.load(std::memory_order_relaxed))
+		{
+			LogThreadSlot* slot = get_log_thread_slot();
+			if (!slot->mStreamInUse)
+			{
+				slot->mStreamInUse = true;
+				return &slot->mStream;
+			}
+			return new std::ostringstream;
+		}
+		// </polarity>
 		LogLock lock;
 		if (lock.ok())
 		{
@@ -1119,6 +1508,15 @@ namespace LLError
 	
 	void Log::flush(std::ostringstream* out, char* message)
     {
+       // <polarity> Asynchronous logging
+       std::string thread_message;
+       if (release_thread_stream(out, thread_message))
+       {
+           strncpy(message, thread_message.c_str(), 127);
+           message[127] = '\0';
+           return;
+       }
+       // </polarity>
        LogLock lock;
        if (!lock.ok())
        {
@@ -1151,17 +1549,43 @@ namespace LLError
 
 	void Log::flush(std::ostringstream* out, const CallSite& site)
 	{
-		LogLock lock;
+		// <polarity> Asynchronous logging
+		// Messages from the thread's own stream go on its queue. Fatal ones
+		// can't wait, they write out everything queued before them and then
+		// themselves right here.
+		std::string thread_message;
+		const bool thread_stream = release_thread_stream(out, thread_message);
+		if (thread_stream && site.mLevel != LEVEL_ERROR && sAsyncLogging.load(std::memory_order_relaxed))
+		{
+			queue_log_message(site, thread_message);
+			return;
+		}
+		// </polarity>
+
+		// <polarity> Asynchronous logging
+		//LogLock lock;
+		LogLock lock(site.mLevel == LEVEL_ERROR);
+		// </polarity>
 		if (!lock.ok())
 		{
 			return;
 		}
 		
+		write_queued_log_messages(); // <polarity/>
+
 		Globals* g = Globals::getInstance();
 		SettingsConfigPtr s = Settings::getInstance()->getSettingsConfig();
 
-		std::string message = out->str();
-		if (out == &g->messageStream)
+		// <polarity> Asynchronous logging
+		//std::string message = out->str();
+		//if (out == &g->messageStream)
+		std::string message = thread_stream ? thread_message : out->str();
+		if (thread_stream)
+		{
+			// already given back by release_thread_stream()
+		}
+		else if (out == &g->messageStream)
+		// </polarity>
 		{
 			g->messageStream.clear();
 			g->messageStream.str("");
@@ -1177,40 +1601,73 @@ namespace LLError
 			writeToRecorders(site, "error", true, true, true, false, false);
 		}
 		
-		std::ostringstream message_stream;
-
-		if (site.mPrintOnce)
+		// <polarity> Asynchronous logging
+		// The print once rule and the writing moved into write_log_message(),
+		// the log writer thread needs them too.
+		std::string written;
+		if (!write_log_message(site, message, NULL, written))
 		{
-			std::map<std::string, unsigned int>::iterator messageIter = s->mUniqueLogMessages.find(message);
-			if (messageIter != s->mUniqueLogMessages.end())
-			{
-				messageIter->second++;
-				unsigned int num_messages = messageIter->second;
-				if (num_messages == 10 || num_messages == 50 || (num_messages % 100) == 0)
-				{
-					message_stream << "ONCE (" << num_messages << "th time seen): ";
-				} 
-				else
-				{
-					return;
-				}
-			}
-			else 
-			{
-				message_stream << "ONCE: ";
-				s->mUniqueLogMessages[message] = 1;
-			}
+			return;
 		}
 		
-		message_stream << message;
-		
-		writeToRecorders(site, message_stream.str());
-		
 		if (site.mLevel == LEVEL_ERROR  &&  s->mCrashFunction)
 		{
-			s->mCrashFunction(message_stream.str());
+			//s->mCrashFunction(message_stream.str());
+			s->mCrashFunction(written);
+		}
+		// </polarity>
+	}
+
+	// <polarity> Asynchronous logging
+	void setAsyncLogging(bool async)
+	{
+		LLMutexLock control_lock(sLogWriterControlMutex);
+		if (async == sAsyncLogging.load(std::memory_order_relaxed))
+		{
+			return;
+		}
+
+		if (async)
+		{
+			sLogWriterStop = false;
+			sLogWriterThread = new boost::thread(&log_writer_loop);
+			sAsyncLogging.store(true, std::memory_order_relaxed);
+			return;
 		}
+
+		sAsyncLogging.store(false, std::memory_order_relaxed);
+		sLogWriterCondition->lock();
+		sLogWriterStop = true;
+		sLogWriterCondition->signal();
+		sLogWriterCondition->unlock();
+		sLogWriterThread->join();
+		delete sLogWriterThread;
+		sLogWriterThread = NULL;
+
+		// whatever got queued while the writer was on its way out
+		LLMutexLock lock(&gLogMutex);
+		write_queued_log_messages();
+	}
+
+	bool getAsyncLogging()
+	{
+		return sAsyncLogging.load(std::memory_order_relaxed);
 	}
+
+	void flushAsyncLogging()
+	{
+		LogLock lock;
+		if (lock.ok())
+		{
+			write_queued_log_messages();
+		}
+	}
+
+	U64 getDroppedLogMessages()
+	{
+		return sDroppedLogMessages.load(std::memory_order_relaxed);
+	}
+	// </polarity>
 }
 
 namespace LLError
@@ -1297,15 +1754,18 @@ namespace LLError
 
 	std::string utcTime()
 	{
-		time_t now = time(NULL);
-		const size_t BUF_SIZE = 64;
-		char time_str[BUF_SIZE];	/* Flawfinder: ignore */
-		
-		size_t chars = strftime(time_str, BUF_SIZE, 
-								  "%Y-%m-%dT%H:%M:%SZ",
-								  gmtime(&now));
-
-		return chars ? time_str : "time error";
+		// <polarity> Asynchronous logging
+		//time_t now = time(NULL);
+		//const size_t BUF_SIZE = 64;
+		//char time_str[BUF_SIZE];	/* Flawfinder: ignore */
+		//
+		//size_t chars = strftime(time_str, BUF_SIZE, 
+		//						  "%Y-%m-%dT%H:%M:%SZ",
+		//						  gmtime(&now));
+		//
+		//return chars ? time_str : "time error";
+		return format_utc_time(time(NULL));
+		// </polarity>
 	}
 }
 
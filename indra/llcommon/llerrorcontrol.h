@@ -177,6 +177,24 @@ namespace LLError
 	LL_COMMON_API std::string logFileName();
 		// returns name of current logging file, empty string if none
 
+	// <polarity> Asynchronous logging
+	LL_COMMON_API void setAsyncLogging(bool);
+	LL_COMMON_API bool getAsyncLogging();
+		// When on, a message is only put on a queue owned by the thread that
+		// logged it, without taking the log lock. A writer thread adds the
+		// time, level, tags and location, applies the print once rule and
+		// passes it to the recorders, in the order the messages were logged.
+		// LEVEL_ERROR messages still go out right away, after everything
+		// queued before them.
+		// When a thread's queue is full, debug and info messages are dropped
+		// and warnings wait up to 100 ms for room; the writer logs how many
+		// went missing. Turning it off writes out whatever is left.
+	LL_COMMON_API void flushAsyncLogging();
+		// writes out everything queued so far, for crash handlers
+	LL_COMMON_API U64 getDroppedLogMessages();
+		// total dropped from full queues
+	// </polarity>
+
 
 	/*
 		Utilities for use by the unit tests of LLError itself.
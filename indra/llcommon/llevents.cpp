@@ -271,11 +271,26 @@ LLEventPumps::~LLEventPumps()
 #endif
 const std::string LLEventPump::ANONYMOUS = std::string();
 
+// <polarity> Flat event dispatch
+namespace
+{
+    // connection only reports its state through calls that lock the body's
+    // mutex, twice for connected() and blocked(); this keeps the body itself
+    class ConnectionBodyAccess : public boost::signals2::connection
+    {
+    public:
+        ConnectionBodyAccess(const boost::signals2::connection& connection) : boost::signals2::connection(connection) {}
+        boost::shared_ptr<boost::signals2::detail::connection_body_base> body() const { return _weak_connection_body.lock(); }
+    };
+}
+// </polarity>
+
 
 LLEventPump::LLEventPump(const std::string& name, bool tweak):
     // Register every new instance with LLEventPumps
     mName(LLEventPumps::instance().registerNew(*this, name, tweak)),
     mSignal(new LLStandardSignal()),
+    mFlatListeners(new FlatListenerList()), // <polarity/>
     mEnabled(true)
 {}
 
@@ -304,6 +319,7 @@ std::string LLEventPump::inventName(const std::string& pfx)
 void LLEventPump::reset()
 {
     mSignal.reset();
+    mFlatListeners.reset(new FlatListenerList()); // <polarity/>
     mConnections.clear();
     //mDeps.clear();
 }
@@ -460,6 +476,14 @@ LLBoundListener LLEventPump::listen_impl(const std::string& name, const LLEventL
     // Now that newNode has a value that places it appropriately in mSignal,
     // connect it.
     LLBoundListener bound = mSignal->connect(nodePosition, listener);
+    // <polarity> Flat event dispatch
+    FlatListener added;
+    added.mPosition = nodePosition;
+    added.mBody = ConnectionBodyAccess(bound).body();
+    added.mListener.reset(new LLEventListener(listener));
+    added.mTracked = !listener.tracked_objects().empty();
+    updateFlatListeners(&added);
+    // </polarity>
     
     if (!name.empty())
     {   // note that we are not tracking anonymous listeners here either.
@@ -489,6 +513,7 @@ void LLEventPump::stopListening(const std::string& name)
     {
         found->second.disconnect();
         mConnections.erase(found);
+        updateFlatListeners(NULL); // <polarity/>
     }
     // We intentionally do NOT remove this name from mDeps. It may happen that
     // the same listener with the same name and dependencies will jump on and
@@ -496,6 +521,96 @@ void LLEventPump::stopListening(const std::string& name)
     // avoid a new dependency sort in such cases.
 }
 
+// <polarity> Flat event dispatch
+bool LLEventPump::sFastDispatch = true;
+
+void LLEventPump::updateFlatListeners(const FlatListener* added) const
+{
+    boost::shared_ptr<FlatListenerList> listeners(new FlatListenerList());
+    listeners->reserve(mFlatListeners->size() + 1);
+    for (FlatListenerList::const_iterator iter = mFlatListeners->begin(); iter != mFlatListeners->end(); ++iter)
+    {
+        // a listener connected later in the same group runs later, as
+        // with mSignal
+        if (added && added->mPosition < iter->mPosition)
+        {
+            listeners->push_back(*added);
+            added = NULL;
+        }
+        if (iter->mBody->nolock_nograb_connected())
+        {
+            listeners->push_back(*iter);
+        }
+    }
+    if (added)
+    {
+        listeners->push_back(*added);
+    }
+    mFlatListeners = listeners;
+}
+
+bool LLEventPump::dispatch(const LLSD& event) const
+{
+    if (!sFastDispatch)
+    {
+        // see LLEventStream::post() about the local copy
+        boost::shared_ptr<LLStandardSignal> signal(mSignal);
+        return (*signal)(event);
+    }
+
+    // A connection dropped without stopListening() stays in the list until
+    // something rebuilds it, so prune here while no listener has run yet.
+    for (FlatListenerList::const_iterator iter = mFlatListeners->begin(); iter != mFlatListeners->end(); ++iter)
+    {
+        if (!iter->mBody->nolock_nograb_connected())
+        {
+            updateFlatListeners(NULL);
+            break;
+        }
+    }
+
+    // Holding the list holds every listener in it, for the same reason.
+    // Connections dropped since it was made are skipped.
+    boost::shared_ptr<const FlatListenerList> listeners(mFlatListeners);
+    for (FlatListenerList::const_iterator iter = listeners->begin(); iter != listeners->end(); ++iter)
+    {
+        const FlatListener& entry = *iter;
+        // also true once disconnected
+        if (entry.mBody->nolock_nograb_blocked())
+        {
+            continue;
+        }
+        try
+        {
+            if (entry.mTracked)
+            {
+                // what mSignal would do: skip the listener once a tracked
+                // object is gone, keep them alive while it runs
+                if (entry.mListener->expired())
+                {
+                    continue;
+                }
+                LLEventListener::locked_container_type tracked(entry.mListener->lock());
+                if (entry.mListener->slot_function()(event))
+                {
+                    return true;
+                }
+            }
+            else if (entry.mListener->slot_function()(event))
+            {
+                return true;
+            }
+        }
+        catch (const LLContinueError&)
+        {
+            // see LLStopWhenHandled
+            LOG_UNHANDLED_EXCEPTION("LLEventPump");
+        }
+    }
+    return false;
+}
+// </polarity>
+
 /*****************************************************************************
 *   LLEventStream
 *****************************************************************************/
@@ -516,11 +631,12 @@ bool LLEventStream::post(const LLSD& event)
     // *stack* instance of the shared_ptr, ensuring that our heap
     // LLStandardSignal object will live at least until post() returns, even
     // if 'this' gets destroyed during the call.
-    boost::shared_ptr<LLStandardSignal> signal(mSignal);
+//  boost::shared_ptr<LLStandardSignal> signal(mSignal);
     // Let caller know if any one listener handled the event. This is mostly
     // useful when using LLEventStream as a listener for an upstream
     // LLEventPump.
-    return (*signal)(event);
+//  return (*signal)(event);
+    return dispatch(event); // <polarity/>
 }
 
 /*****************************************************************************
@@ -586,8 +702,12 @@ void LLEventQueue::flush()
     // -- rather like an EventStream. Instead, copy mEventQueue and clear it,
     // so that any new events posted to this LLEventQueue during flush() will
     // be processed in the *next* flush() call.
-    EventQueue queue(mEventQueue);
-    mEventQueue.clear();
+//  EventQueue queue(mEventQueue);
+//  mEventQueue.clear();
+    // <polarity> swap, don't copy every queued event
+    EventQueue queue;
+    queue.swap(mEventQueue);
+    // </polarity>
     // NOTE NOTE NOTE: Any new access to member data beyond this point should
     // cause us to move our LLStandardSignal object to a pimpl class along
     // with said member data. Then the local shared_ptr will preserve both.
@@ -564,6 +564,19 @@ public:
     /// Generate a distinct name for a listener -- see listen()
     static std::string inventName(const std::string& pfx="listener");
 
+    // <polarity> Flat event dispatch
+    /**
+     * With fast dispatch on (the default), posting walks a flat copy of the
+     * listener list and calls each listener's function directly with the
+     * caller's LLSD, rather than going through mSignal's invocation and
+     * combiner machinery. The listeners, their order, blocking, tracked
+     * objects and the stop-when-handled rule are the same either way; the
+     * switch is there to compare the two.
+     */
+    static void setFastDispatch(bool fast) { sFastDispatch = fast; }
+    static bool getFastDispatch() { return sFastDispatch; }
+    // </polarity>
+
 private:
     friend class LLEventPumps;
     /// flush queued events
@@ -591,6 +604,35 @@ protected:
     /// implement the dispatching
     boost::shared_ptr<LLStandardSignal> mSignal;
 
+    // <polarity> Flat event dispatch
+    /// Call the listeners until one returns true. Subclasses post through
+    /// this instead of calling *mSignal. Like the signal, this may outlive
+    /// 'this': it touches no member data once the first listener runs.
+    bool dispatch(const LLSD& event) const;
+
+private:
+    struct FlatListener
+    {
+        float mPosition;    // mSignal group, keeps the same order
+        /// the connection's own state, read without its mutex: listeners
+        /// are only connected, blocked and posted to on one thread
+        boost::shared_ptr<boost::signals2::detail::connection_body_base> mBody;
+        boost::shared_ptr<const LLEventListener> mListener;
+        bool mTracked;      // has objects to check and hold during the call
+    };
+    typedef std::vector<FlatListener> FlatListenerList;
+    /// Copy on write: listen() and stopListening() swap in a new list, with
+    /// disconnected listeners left out, so a post() in progress keeps
+    /// walking the one it started with. dispatch() does the same for
+    /// listeners disconnected through their own connection.
+    mutable boost::shared_ptr<const FlatListenerList> mFlatListeners;
+    void updateFlatListeners(const FlatListener* added) const;
+
+    static bool sFastDispatch;
+
+protected:
+    // </polarity>
+
     /// valve open?
     bool mEnabled;
     /// Map of named listeners. This tracks the listeners that actually exist
@@ -29,6 +29,7 @@
 
 #include "llinstancetracker.h"
 #include "lltrace.h"
+#include "lltraceeventcapture.h" // <polarity/>
 #include "lltreeiterators.h"
 
 #define LL_FAST_TIMER_ON 1
@@ -322,10 +323,21 @@ LL_FORCE_INLINE BlockTimer::BlockTimer(BlockTimerStatHandle& timer)
 LL_FORCE_INLINE BlockTimer::~BlockTimer()
 {
 #if LL_FAST_TIMER_ON
-	U64 total_time = getCPUClockCount64() - mStartTime;
+	// <polarity> Timer event capture
+	//U64 total_time = getCPUClockCount64() - mStartTime;
+	const U64 end_time = getCPUClockCount64();
+	U64 total_time = end_time - mStartTime;
+	// </polarity>
 	BlockTimerStackRecord* cur_timer_data = LLThreadLocalSingletonPointer<BlockTimerStackRecord>::getInstance();
 	if (!cur_timer_data) return;
 
+	// <polarity> Timer event capture
+	if (BlockTimerEventCapture::isCapturing())
+	{
+		BlockTimerEventCapture::record(cur_timer_data->mTimeBlock, mStartTime, end_time);
+	}
+	// </polarity>
+
 	TimeBlockAccumulator& accumulator = cur_timer_data->mTimeBlock->getCurrentAccumulator();
 
 	accumulator.mCalls++;
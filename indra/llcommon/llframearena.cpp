@@ -0,0 +1,187 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/**
+ * @file llframearena.cpp
+ * @brief Per thread scratch memory that is dropped once a frame.
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llframearena.h"
+
+#include <boost/thread/tss.hpp>
+
+#include "llmemory.h"
+#include "lltrace.h"
+
+namespace
+{
+	const size_t FIRST_BLOCK_SIZE = 256 * 1024;
+	// a grown arena is remade in steps of this
+	const size_t BLOCK_GRANULARITY = 64 * 1024;
+
+	LLTrace::SampleStatHandle<F64Kilobytes> sFrameArenaUsed("frame_arena", "frame arena memory the last frame took");
+
+	LLTrace::MemStatHandle& arena_mem_stat()
+	{
+		// leaked: threads can end while statics are being destroyed
+		static LLTrace::MemStatHandle* sArenaMemStat = new LLTrace::MemStatHandle("LLFrameArena");
+		return *sArenaMemStat;
+	}
+
+	LL_THREAD_LOCAL LLFrameArena* sThreadArena = NULL;
+}
+
+// only there to delete the arena when its thread ends
+struct LLFrameArenaOwner
+{
+	static void release(LLFrameArena* arena)
+	{
+		if (arena == sThreadArena)
+		{
+			sThreadArena = NULL;
+		}
+		delete arena;
+	}
+
+	static LLFrameArena* create()
+	{
+		static boost::thread_specific_ptr<LLFrameArena>* sArenaOwner
+			= new boost::thread_specific_ptr<LLFrameArena>(&release);
+
+		LLFrameArena* arena = new LLFrameArena();
+		sArenaOwner->reset(arena);
+		sThreadArena = arena;
+		return arena;
+	}
+};
+
+LLFrameArena::LLFrameArena()
+:	mBlocks(NULL),
+	mTop(NULL),
+	mEnd(NULL),
+	mFullBlockBytes(0)
+{
+	memset(&mStats, 0, sizeof(mStats));
+	addBlock(FIRST_BLOCK_SIZE);
+}
+
+LLFrameArena::~LLFrameArena()
+{
+	freeBlocks();
+}
+
+// static
+LLFrameArena* LLFrameArena::getThreadArena()
+{
+	return sThreadArena;
+}
+
+// static
+void LLFrameArena::newFrame()
+{
+	LLFrameArena* arena = sThreadArena;
+	if (!arena)
+	{
+		LLFrameArenaOwner::create();
+		return;
+	}
+	arena->reset();
+}
+
+void* LLFrameArena::allocateSlow(size_t size, size_t alignment)
+{
+	mFullBlockBytes += mTop - blockStart(mBlocks);
+	addBlock(llmax(mBlocks->mSize * 2, size + alignment));
+	return allocate(size, alignment);
+}
+
+void LLFrameArena::addBlock(size_t size)
+{
+	Block* block = (Block*)ll_aligned_malloc_16(sizeof(Block) + BLOCK_PADDING + size);
+	if (!block)
+	{
+		LL_ERRS("FrameArena") << "Out of memory for a " << size << " byte frame arena block" << LL_ENDL;
+	}
+	block->mNext = mBlocks;
+	block->mSize = size;
+	mBlocks = block;
+	mTop = blockStart(block);
+	mEnd = mTop + size;
+	mStats.mReservedBytes += size;
+	LLTrace::claim_alloc(arena_mem_stat(), (S32)size);
+}
+
+void LLFrameArena::freeBlocks()
+{
+	while (mBlocks)
+	{
+		Block* next = mBlocks->mNext;
+		LLTrace::disclaim_alloc(arena_mem_stat(), (S32)mBlocks->mSize);
+		ll_aligned_free_16(mBlocks);
+		mBlocks = next;
+	}
+	mStats.mReservedBytes = 0;
+	mTop = NULL;
+	mEnd = NULL;
+}
+
+void LLFrameArena::reset()
+{
+	const U64 used = mFullBlockBytes + (mTop - blockStart(mBlocks));
+	mStats.mLastFrameBytes = used;
+	mStats.mPeakFrameBytes = llmax(mStats.mPeakFrameBytes, used);
+	++mStats.mFrames;
+	LLTrace::sample(sFrameArenaUsed, F64Bytes((F64)used));
+
+	if (mBlocks->mNext)
+	{
+		// the next frame likely needs as much, have it in one piece
+		++mStats.mGrownFrames;
+		const size_t size = (size_t)((mStats.mReservedBytes + BLOCK_GRANULARITY - 1) / BLOCK_GRANULARITY * BLOCK_GRANULARITY);
+		freeBlocks();
+		addBlock(size);
+	}
+	mTop = blockStart(mBlocks);
+	mFullBlockBytes = 0;
+}
+
+// static
+void LLFrameArena::getStats(Stats& stats)
+{
+	if (sThreadArena)
+	{
+		stats = sThreadArena->mStats;
+	}
+	else
+	{
+		memset(&stats, 0, sizeof(stats));
+	}
+}
+
+// static
+void LLFrameArena::logStats()
+{
+	Stats stats;
+	getStats(stats);
+	LL_INFOS("FrameArena") << stats.mFrames << " frames, " << (stats.mPeakFrameBytes / 1024) << " KB at most in one, "
+						   << stats.mGrownFrames << " needed to grow it; " << (stats.mReservedBytes / 1024) << " KB reserved" << LL_ENDL;
+}
@@ -0,0 +1,187 @@
+/**
+ * @file llframearena.h
+ * @brief Per thread scratch memory that is dropped once a frame.
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLFRAMEARENA_H
+#define LL_LLFRAMEARENA_H
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <utility>
+
+#include "llpreprocessor.h"
+#include "stdtypes.h"
+
+// Scratch memory for the frame being drawn. Allocating is a pointer bump in
+// the calling thread's arena, freeing does nothing unless it is the newest
+// allocation, which is taken back, and newFrame() drops everything at once.
+// So whatever lives in the arena must be gone by the next newFrame(): use it
+// for containers local to a function that returns within the frame, never
+// for anything that is kept.
+//
+// Only threads that call newFrame() have an arena. The arena starts with
+// 256 KB; a frame that needs more chains bigger blocks, and the next
+// newFrame() swaps them for a single block of what that frame took.
+class LL_COMMON_API LLFrameArena
+{
+public:
+	// the calling thread's arena, NULL until it called newFrame()
+	static LLFrameArena* getThreadArena();
+
+	// Drops everything allocated on the calling thread since the last call
+	// and samples how much that was.
+	static void newFrame();
+
+	void* allocate(size_t size, size_t alignment);
+	void deallocate(void* ptr, size_t size);
+
+	struct Stats
+	{
+		U64	mLastFrameBytes;	// taken by the frame before the last newFrame()
+		U64	mPeakFrameBytes;
+		U64	mReservedBytes;
+		U32	mFrames;
+		U32	mGrownFrames;		// frames that needed another block
+	};
+	// of the calling thread's arena, all zero if it has none
+	static void getStats(Stats& stats);
+	static void logStats();
+
+private:
+	friend struct LLFrameArenaOwner;
+
+	LLFrameArena();
+	~LLFrameArena();
+
+	struct Block
+	{
+		Block*	mNext;
+		size_t	mSize;			// bytes after the header
+	};
+
+	void* allocateSlow(size_t size, size_t alignment);
+	void addBlock(size_t size);
+	void freeBlocks();
+	void reset();
+	static char* blockStart(Block* block)	{ return (char*)block + sizeof(Block) + BLOCK_PADDING; }
+
+	static const size_t BLOCK_PADDING = (16 - sizeof(Block) % 16) % 16;
+
+	Block*	mBlocks;			// newest first, allocations go to that one
+	char*	mTop;
+	char*	mEnd;
+	U64		mFullBlockBytes;	// what this frame took of the older blocks
+	Stats	mStats;
+};
+
+inline void* LLFrameArena::allocate(size_t size, size_t alignment)
+{
+	char* ptr = (char*)(((uintptr_t)mTop + alignment - 1) & ~(uintptr_t)(alignment - 1));
+	if (LL_LIKELY(size <= (size_t)(mEnd - ptr)))
+	{
+		mTop = ptr + size;
+		return ptr;
+	}
+	return allocateSlow(size, alignment);
+}
+
+inline void LLFrameArena::deallocate(void* ptr, size_t size)
+{
+	if ((char*)ptr + size == mTop)
+	{
+		mTop = (char*)ptr;
+	}
+}
+
+// STL allocator taking from the arena of the thread it was made on, or from
+// the heap if that thread has none. Containers using it follow the rule
+// above, e.g.
+//	std::vector<LLVector3, LLFrameAllocator<LLVector3> > points;
+template<typename T>
+class LLFrameAllocator
+{
+public:
+	typedef T				value_type;
+	typedef T*				pointer;
+	typedef const T*		const_pointer;
+	typedef T&				reference;
+	typedef const T&		const_reference;
+	typedef size_t			size_type;
+	typedef ptrdiff_t		difference_type;
+
+	template<typename U> struct rebind { typedef LLFrameAllocator<U> other; };
+
+	LLFrameAllocator() : mArena(LLFrameArena::getThreadArena()) {}
+	template<typename U>
+	LLFrameAllocator(const LLFrameAllocator<U>& other) : mArena(other.getArena()) {}
+
+	T* allocate(size_type count, const void* = NULL)
+	{
+		if (count > max_size())
+		{
+			throw std::bad_alloc();
+		}
+		if (!mArena)
+		{
+			return static_cast<T*>(::operator new(count * sizeof(T)));
+		}
+		return static_cast<T*>(mArena->allocate(count * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* ptr, size_type count)
+	{
+		if (!mArena)
+		{
+			::operator delete(ptr);
+		}
+		else
+		{
+			mArena->deallocate(ptr, count * sizeof(T));
+		}
+	}
+
+	template<typename U, typename... ARGS>
+	void construct(U* ptr, ARGS&&... args)	{ ::new((void*)ptr) U(std::forward<ARGS>(args)...); }
+	template<typename U>
+	void destroy(U* ptr)					{ ptr->~U(); }
+
+	size_type max_size() const				{ return std::numeric_limits<size_type>::max() / sizeof(T); }
+	LLFrameArena* getArena() const			{ return mArena; }
+
+private:
+	LLFrameArena* mArena;
+};
+
+template<typename T, typename U>
+inline bool operator==(const LLFrameAllocator<T>& lhs, const LLFrameAllocator<U>& rhs)
+{
+	return lhs.getArena() == rhs.getArena();
+}
+
+template<typename T, typename U>
+inline bool operator!=(const LLFrameAllocator<T>& lhs, const LLFrameAllocator<U>& rhs)
+{
+	return lhs.getArena() != rhs.getArena();
+}
+
+#endif // LL_LLFRAMEARENA_H
@@ -302,6 +302,15 @@ public:
 	 */
 	LLSDXMLParser(bool emit_errors=true);
 
+	// <polarity> Fast LLSD XML reader
+	/**
+	 * @brief Whether well formed documents that are already in the
+	 * stream's buffer are read without expat. On by default.
+	 */
+	static void setFastParse(bool fast) { sFastParse = fast; }
+	static bool getFastParse() { return sFastParse; }
+	// </polarity>
+
 protected:
 	/** 
 	 * @brief Call this method to parse a stream for LLSD.
@@ -330,6 +339,8 @@ private:
 
 	void parsePart(const char* buf, int len);
 	friend class LLSDSerialize;
+
+	static bool sFastParse; // <polarity/> Fast LLSD XML reader
 };
 
 /** 
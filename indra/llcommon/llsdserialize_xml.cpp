@@ -36,6 +36,18 @@
 #include <boost/regex.hpp>
 #include <stack>
 
+// <polarity> Fast LLSD XML reader
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LL_SDXML_SSE2 1
+#include <emmintrin.h>
+#if LL_WINDOWS
+#include <intrin.h>
+#endif
+#else
+#define LL_SDXML_SSE2 0
+#endif
+// </polarity>
+
 extern "C"
 {
 #ifdef LL_USESYSTEMLIBS
@@ -305,6 +317,13 @@ private:
 	static Element readElement(const XML_Char* name);
 	
 	static const XML_Char* findAttribute(const XML_Char* name, const XML_Char** pairs);
+
+	// <polarity> Fast LLSD XML reader
+	class FastReader;
+	bool fastParse(std::istream& input, LLSD& data, bool lines, S32& count);
+
+	bool mExpatFed;					// parsePart() gave expat the start of the document
+	// </polarity>
 	
 	bool mEmitErrors;
 
@@ -371,6 +390,14 @@ static unsigned get_till_eol(std::istream& input, char *buf, unsigned bufsize)
 
 S32 LLSDXMLParser::Impl::parse(std::istream& input, LLSD& data)
 {
+	// <polarity> Fast LLSD XML reader
+	S32 fast_count;
+	if (fastParse(input, data, false, fast_count))
+	{
+		return fast_count;
+	}
+	// </polarity>
+
 	XML_Status status;
 	
 	static const int BUFFER_SIZE = 1024;
@@ -442,6 +469,14 @@ S32 LLSDXMLParser::Impl::parseLines(std::istream& input, LLSD& data)
 	// Must get rid of any leading \n, otherwise the stream gets into an error/eof state
 	clear_eol(input);
 
+	// <polarity> Fast LLSD XML reader
+	S32 fast_count;
+	if (fastParse(input, data, true, fast_count))
+	{
+		return fast_count;
+	}
+	// </polarity>
+
 	while( !mGracefullStop
 		&& input.good() 
 		&& !input.eof())
@@ -525,6 +560,7 @@ void LLSDXMLParser::Impl::reset()
 	mSkipping = false;
 	
 	mCurrentKey.clear();
+	mExpatFed = false; // <polarity/> Fast LLSD XML reader
 	
 	XML_ParserReset(mParser, "utf-8");
 	XML_SetUserData(mParser, this);
@@ -558,6 +594,7 @@ void LLSDXMLParser::Impl::parsePart(const char* buf, int len)
 	if ( buf != NULL 
 		&& len > 0 )
 	{
+		mExpatFed = true; // <polarity/> Fast LLSD XML reader
 		XML_Status status = XML_Parse(mParser, buf, len, false);
 		if (status == XML_STATUS_ERROR)
 		{
@@ -936,9 +973,904 @@ LLSDXMLParser::Impl::Element LLSDXMLParser::Impl::readElement(const XML_Char* na
 
 
 
+// <polarity> Fast LLSD XML reader
+namespace
+{
+	const S32 MAX_FAST_DEPTH = 256;		// deeper than this goes to expat, which doesn't recurse
+
+	// names of Impl::Element, in that order
+	const char* const ELEMENT_NAMES[] =
+	{
+		"llsd", "undef", "boolean", "integer", "real", "string", "uuid",
+		"date", "uri", "binary", "map", "array", "key"
+	};
+
+	inline bool is_xml_space(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+	}
+
+	// what the reader takes for element and attribute names, anything
+	// else in there goes to expat
+	inline bool is_name_char(char c)
+	{
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+			|| c == '_' || c == '-' || c == '.' || c == ':';
+	}
+
+	inline bool is_digit(char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	inline bool is_xml_char(U32 c)
+	{
+		return (c >= 0x20 && c <= 0xd7ff) || c == 0x9 || c == 0xa || c == 0xd
+			|| (c >= 0xe000 && c <= 0xfffd) || (c >= 0x10000 && c <= 0x10ffff);
+	}
+
+	// length of the UTF-8 sequence starting with a non-ASCII byte, 0 if it
+	// isn't well formed or isn't an XML character
+	size_t utf8_length(const char* text, const char* end)
+	{
+		const U8* in = (const U8*)text;
+		const size_t available = end - text;
+		U32 c = in[0];
+		size_t length;
+		if (c >= 0xc2 && c < 0xe0)
+		{
+			length = 2;
+			c &= 0x1f;
+		}
+		else if (c >= 0xe0 && c < 0xf0)
+		{
+			length = 3;
+			c &= 0x0f;
+		}
+		else if (c >= 0xf0 && c < 0xf5)
+		{
+			length = 4;
+			c &= 0x07;
+		}
+		else
+		{
+			return 0;
+		}
+		if (available < length)
+		{
+			return 0;
+		}
+		for (size_t i = 1; i < length; ++i)
+		{
+			if ((in[i] & 0xc0) != 0x80)
+			{
+				return 0;
+			}
+			c = (c << 6) | (in[i] & 0x3f);
+		}
+		// no overlong forms
+		static const U32 SMALLEST[] = { 0, 0, 0x80, 0x800, 0x10000 };
+		return (c >= SMALLEST[length] && is_xml_char(c)) ? length : 0;
+	}
+
+	void append_utf8(std::string& out, U32 c)
+	{
+		if (c < 0x80)
+		{
+			out += (char)c;
+		}
+		else if (c < 0x800)
+		{
+			out += (char)(0xc0 | (c >> 6));
+			out += (char)(0x80 | (c & 0x3f));
+		}
+		else if (c < 0x10000)
+		{
+			out += (char)(0xe0 | (c >> 12));
+			out += (char)(0x80 | ((c >> 6) & 0x3f));
+			out += (char)(0x80 | (c & 0x3f));
+		}
+		else
+		{
+			out += (char)(0xf0 | (c >> 18));
+			out += (char)(0x80 | ((c >> 12) & 0x3f));
+			out += (char)(0x80 | ((c >> 6) & 0x3f));
+			out += (char)(0x80 | (c & 0x3f));
+		}
+	}
+
+	// First character in [text, end) that character data can't simply be
+	// copied past: '<', '&', ']', a control character other than tab and
+	// newline, or a non-ASCII byte. end if there is none.
+	const char* find_markup(const char* text, const char* end)
+	{
+#if LL_SDXML_SSE2
+		const __m128i less = _mm_set1_epi8('<');
+		const __m128i amp = _mm_set1_epi8('&');
+		const __m128i bracket = _mm_set1_epi8(']');
+		const __m128i space = _mm_set1_epi8(' ');
+		const __m128i tab = _mm_set1_epi8('\t');
+		const __m128i newline = _mm_set1_epi8('\n');
+		while (end - text >= 16)
+		{
+			const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text));
+			// bytes are signed, so non-ASCII ones are below ' ' as well
+			const __m128i control = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi8(chars, tab), _mm_cmpeq_epi8(chars, newline)),
+													 _mm_cmplt_epi8(chars, space));
+			const __m128i markup = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chars, less), _mm_cmpeq_epi8(chars, amp)),
+												_mm_or_si128(_mm_cmpeq_epi8(chars, bracket), control));
+			const U32 mask = (U32)_mm_movemask_epi8(markup);
+			if (mask)
+			{
+#if LL_WINDOWS
+				unsigned long first;
+				_BitScanForward(&first, mask);
+				return text + first;
+#else
+				return text + __builtin_ctz(mask);
+#endif
+			}
+			text += 16;
+		}
+#endif
+		for (; text < end; ++text)
+		{
+			const U8 c = (U8)*text;
+			if (c == '<' || c == '&' || c == ']' || (c < ' ' && c != '\t' && c != '\n') || c >= 0x80)
+			{
+				break;
+			}
+		}
+		return text;
+	}
+
+	// Exact powers of ten a double holds
+	const F64 POWERS_OF_TEN[] =
+	{
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	// Character data handed to a std::istream without copying it
+	class TextStreamBuf : public std::streambuf
+	{
+	public:
+		void setText(const char* text, size_t length)
+		{
+			char* start = const_cast<char*>(text);
+			setg(start, start, start + length);
+		}
+	};
+
+	// The get area of a stream buffer, through its protected accessors
+	struct GetArea : public std::streambuf
+	{
+		static void find(std::streambuf* buf, const char*& begin, const char*& end)
+		{
+			char* (std::streambuf::*get_ptr)() const = &GetArea::gptr;
+			char* (std::streambuf::*end_ptr)() const = &GetArea::egptr;
+			begin = (buf->*get_ptr)();
+			end = (buf->*end_ptr)();
+		}
+	};
+}
+
+// Reads a whole LLSD document out of memory the way the expat handlers
+// would have built it, giving up on anything they would see differently:
+// comments, CDATA, DOCTYPE, a byte order mark, unknown elements, stray text,
+// keys with no value, characters expat rejects, or a document that doesn't
+// end in the buffer. The caller then parses the same text with expat, so
+// giving up only costs the time spent so far.
+//
+// Character data is scanned 16 bytes at a time and is only copied when it
+// has entities or carriage returns to replace.
+class LLSDXMLParser::Impl::FastReader
+{
+public:
+	FastReader(const char* begin, const char* end)
+	:	mCur(begin),
+		mEnd(end),
+		mParseCount(0),
+		mRealStream(&mRealBuf)
+	{
+	}
+
+	bool read(LLSD& data);
+
+	const char* getEnd() const		{ return mCur; }	// just past </llsd>
+	S32 getParseCount() const		{ return mParseCount; }
+
+private:
+	bool readValue(LLSD& value, S32 depth);
+	bool readMap(LLSD& map, S32 depth);
+	bool readArray(LLSD& array, S32 depth);
+	bool readStartTag(Element& element, bool& empty);
+	bool readEndTag(Element element);
+	bool readText(const char*& text, size_t& length);
+	bool readEntity();
+	void setValue(Element element, const char* text, size_t length, LLSD& value);
+	F64 readReal(const char* text, size_t length);
+	static S32 readInteger(const char* text, size_t length);
+	static Element findElement(const char* name, size_t length);
+
+	bool skipSpace()
+	{
+		const char* start = mCur;
+		while (mCur < mEnd && is_xml_space(*mCur))
+		{
+			++mCur;
+		}
+		return mCur != start;
+	}
+
+	// at '<' followed by c
+	bool atTag(char c) const
+	{
+		return mEnd - mCur >= 2 && mCur[0] == '<' && mCur[1] == c;
+	}
+
+	const char*		mCur;
+	const char*		mEnd;
+	S32				mParseCount;
+	std::string		mText;		// character data with its entities replaced
+	std::string		mKey;
+	std::string		mString;
+	TextStreamBuf	mRealBuf;
+	std::istream	mRealStream;
+};
+
+bool LLSDXMLParser::Impl::FastReader::read(LLSD& data)
+{
+	// The declaration is skipped: the parser is made for UTF-8 and expat
+	// ignores what the document says. Anywhere but at the very start it is
+	// an error.
+	if (mEnd - mCur > 6 && !memcmp(mCur, "<?xml", 5) && is_xml_space(mCur[5]))
+	{
+		for (mCur += 6; ; ++mCur)
+		{
+			mCur = (const char*)memchr(mCur, '?', mEnd - mCur);
+			if (!mCur || mEnd - mCur < 2)
+			{
+				return false;
+			}
+			if (mCur[1] == '>')
+			{
+				mCur += 2;
+				break;
+			}
+		}
+	}
+	skipSpace();
+
+	Element element;
+	bool empty;
+	if (mEnd - mCur < 2 || mCur[0] != '<' || !is_name_char(mCur[1]) || !readStartTag(element, empty) || element != ELEMENT_LLSD)
+	{
+		return false;
+	}
+	if (empty)
+	{
+		return true;
+	}
+	skipSpace();
+	if (!atTag('/'))
+	{
+		if (!readValue(data, 0))
+		{
+			return false;
+		}
+		skipSpace();
+	}
+	return atTag('/') && readEndTag(ELEMENT_LLSD);
+}
+
+bool LLSDXMLParser::Impl::FastReader::readValue(LLSD& value, S32 depth)
+{
+	Element element;
+	bool empty;
+	if (depth > MAX_FAST_DEPTH || mEnd - mCur < 2 || mCur[0] != '<' || !is_name_char(mCur[1]) || !readStartTag(element, empty))
+	{
+		return false;
+	}
+
+	switch (element)
+	{
+		case ELEMENT_LLSD:
+		case ELEMENT_KEY:
+			return false;
+
+		case ELEMENT_MAP:
+			++mParseCount;
+			value = LLSD::emptyMap();
+			return empty || readMap(value, depth);
+
+		case ELEMENT_ARRAY:
+			++mParseCount;
+			value = LLSD::emptyArray();
+			return empty || readArray(value, depth);
+
+		default:
+			break;
+	}
+
+	++mParseCount;
+	const char* text = mCur;
+	size_t length = 0;
+	if (!empty && (!readText(text, length) || !readEndTag(element)))
+	{
+		return false;
+	}
+	setValue(element, text, length, value);
+	return true;
+}
+
+bool LLSDXMLParser::Impl::FastReader::readMap(LLSD& map, S32 depth)
+{
+	while (true)
+	{
+		skipSpace();
+		if (atTag('/'))
+		{
+			return readEndTag(ELEMENT_MAP);
+		}
+
+		Element element;
+		bool empty;
+		const char* key;
+		size_t key_length;
+		// an empty key makes the expat handlers skip the value
+		if (mEnd - mCur < 2 || mCur[0] != '<' || !is_name_char(mCur[1])
+			|| !readStartTag(element, empty) || element != ELEMENT_KEY || empty
+			|| !readText(key, key_length) || !key_length || !readEndTag(ELEMENT_KEY))
+		{
+			return false;
+		}
+		mKey.assign(key, key_length);
+
+		skipSpace();
+		if (!readValue(map[mKey], depth + 1))
+		{
+			return false;
+		}
+	}
+}
+
+bool LLSDXMLParser::Impl::FastReader::readArray(LLSD& array, S32 depth)
+{
+	while (true)
+	{
+		skipSpace();
+		if (atTag('/'))
+		{
+			return readEndTag(ELEMENT_ARRAY);
+		}
+
+		array.append(LLSD());
+		if (!readValue(array[array.size() - 1], depth + 1))
+		{
+			return false;
+		}
+	}
+}
+
+bool LLSDXMLParser::Impl::FastReader::readStartTag(Element& element, bool& empty)
+{
+	const char* name = ++mCur;
+	while (mCur < mEnd && is_name_char(*mCur))
+	{
+		++mCur;
+	}
+	element = findElement(name, mCur - name);
+	if (ELEMENT_UNKNOWN == element)
+	{
+		return false;
+	}
+
+	// encoding="base64" on <binary> is the only attribute the expat
+	// handlers look at, there should be no more than that one
+	bool attribute = false;
+	while (true)
+	{
+		const bool spaced = skipSpace();
+		if (mCur == mEnd)
+		{
+			return false;
+		}
+		if (*mCur == '>')
+		{
+			++mCur;
+			empty = false;
+			return true;
+		}
+		if (*mCur == '/')
+		{
+			if (mEnd - mCur < 2 || mCur[1] != '>')
+			{
+				return false;
+			}
+			mCur += 2;
+			empty = true;
+			return true;
+		}
+		if (attribute || !spaced)
+		{
+			return false;
+		}
+		attribute = true;
+
+		const char* attribute_name = mCur;
+		while (mCur < mEnd && is_name_char(*mCur))
+		{
+			++mCur;
+		}
+		const size_t attribute_length = mCur - attribute_name;
+		skipSpace();
+		if (!attribute_length || mCur == mEnd || *mCur != '=')
+		{
+			return false;
+		}
+		++mCur;
+		skipSpace();
+		if (mCur == mEnd || (*mCur != '"' && *mCur != '\''))
+		{
+			return false;
+		}
+		const char* value = mCur + 1;
+		const char* value_end = (const char*)memchr(value, *mCur, mEnd - value);
+		if (!value_end || memchr(value, '<', value_end - value) || memchr(value, '&', value_end - value))
+		{
+			return false;
+		}
+		mCur = value_end + 1;
+		if (ELEMENT_BINARY == element && attribute_length == 8 && !memcmp(attribute_name, "encoding", 8)
+			&& !(value_end - value == 6 && !memcmp(value, "base64", 6)))
+		{
+			return false;
+		}
+	}
+}
+
+bool LLSDXMLParser::Impl::FastReader::readEndTag(Element element)
+{
+	// at '<', anything but the end of this element goes to expat
+	const char* name = mCur + 2;
+	const size_t length = strlen(ELEMENT_NAMES[element]);
+	if (!atTag('/') || (size_t)(mEnd - name) < length + 1 || memcmp(name, ELEMENT_NAMES[element], length))
+	{
+		return false;
+	}
+	mCur = name + length;
+	skipSpace();
+	if (mCur == mEnd || *mCur != '>')
+	{
+		return false;
+	}
+	++mCur;
+	return true;
+}
+
+bool LLSDXMLParser::Impl::FastReader::readText(const char*& text, size_t& length)
+{
+	const char* start = mCur;		// of what is not in mText yet
+	bool decoded = false;
+	while (true)
+	{
+		const char* markup = find_markup(mCur, mEnd);
+		if (markup == mEnd)
+		{
+			return false;
+		}
+		mCur = markup;
+
+		const U8 c = (U8)*markup;
+		if (c == '<')
+		{
+			break;
+		}
+		if (c >= 0x80)
+		{
+			const size_t sequence = utf8_length(markup, mEnd);
+			if (!sequence)
+			{
+				return false;
+			}
+			mCur += sequence;
+		}
+		else if (c == ']')
+		{
+			// "]]>" may not appear in character data
+			if (mEnd - mCur >= 3 && mCur[1] == ']' && mCur[2] == '>')
+			{
+				return false;
+			}
+			++mCur;
+		}
+		else if (c == '&' || c == '\r')
+		{
+			if (!decoded)
+			{
+				mText.clear();
+				decoded = true;
+			}
+			mText.append(start, mCur);
+			if (c == '&')
+			{
+				if (!readEntity())
+				{
+					return false;
+				}
+			}
+			else
+			{
+				// line ends are "\n" whatever they were in the document
+				mText += '\n';
+				if (++mCur < mEnd && *mCur == '\n')
+				{
+					++mCur;
+				}
+			}
+			start = mCur;
+		}
+		else
+		{
+			// control character
+			return false;
+		}
+	}
+
+	if (decoded)
+	{
+		mText.append(start, mCur);
+		text = mText.data();
+		length = mText.size();
+	}
+	else
+	{
+		text = start;
+		length = mCur - start;
+	}
+	return true;
+}
+
+bool LLSDXMLParser::Impl::FastReader::readEntity()
+{
+	// at '&', the longest one taken here is "&#x10FFFF;"
+	const char* name = mCur + 1;
+	const char* semicolon = (const char*)memchr(name, ';', llmin(mEnd - name, (ptrdiff_t)10));
+	if (!semicolon)
+	{
+		return false;
+	}
+	const size_t length = semicolon - name;
+	if (length == 2 && name[1] == 't' && (name[0] == 'l' || name[0] == 'g'))
+	{
+		mText += name[0] == 'l' ? '<' : '>';
+	}
+	else if (length == 3 && !memcmp(name, "amp", 3))
+	{
+		mText += '&';
+	}
+	else if (length == 4 && !memcmp(name, "quot", 4))
+	{
+		mText += '"';
+	}
+	else if (length == 4 && !memcmp(name, "apos", 4))
+	{
+		mText += '\'';
+	}
+	else if (length >= 2 && name[0] == '#')
+	{
+		const bool hex = name[1] == 'x';
+		const char* digit = name + (hex ? 2 : 1);
+		if (digit == semicolon)
+		{
+			return false;
+		}
+		U32 c = 0;
+		for (; digit < semicolon; ++digit)
+		{
+			U32 value;
+			if (is_digit(*digit))
+			{
+				value = *digit - '0';
+			}
+			else if (hex && ((*digit | 0x20) >= 'a' && (*digit | 0x20) <= 'f'))
+			{
+				value = (*digit | 0x20) - 'a' + 10;
+			}
+			else
+			{
+				return false;
+			}
+			c = c * (hex ? 16 : 10) + value;
+		}
+		if (!is_xml_char(c))
+		{
+			return false;
+		}
+		append_utf8(mText, c);
+	}
+	else
+	{
+		return false;
+	}
+	mCur = semicolon + 1;
+	return true;
+}
+
+void LLSDXMLParser::Impl::FastReader::setValue(Element element, const char* text, size_t length, LLSD& value)
+{
+	// the same conversions as endElementHandler()
+	switch (element)
+	{
+		case ELEMENT_UNDEF:
+			value.clear();
+			break;
+
+		case ELEMENT_BOOL:
+			value = (length == 4 && !memcmp(text, "true", 4)) || (length == 1 && *text == '1');
+			break;
+
+		case ELEMENT_INTEGER:
+			value = readInteger(text, length);
+			break;
+
+		case ELEMENT_REAL:
+			value = readReal(text, length);
+			break;
+
+		case ELEMENT_STRING:
+			if (text == mText.data())
+			{
+				value = mText;
+			}
+			else
+			{
+				mString.assign(text, length);
+				value = mString;
+			}
+			break;
+
+		case ELEMENT_UUID:
+			{
+				LLUUID id;
+				id.set(text, length);
+				value = id;
+			}
+			break;
+
+		case ELEMENT_DATE:
+			value = LLSD(std::string(text, length)).asDate();
+			break;
+
+		case ELEMENT_URI:
+			value = LLSD(std::string(text, length)).asURI();
+			break;
+
+		case ELEMENT_BINARY:
+			{
+				// what the regex there strips
+				mString.clear();
+				for (const char* end = text + length; text < end; ++text)
+				{
+					if (!isspace((U8)*text))
+					{
+						mString += *text;
+					}
+				}
+				S32 len = apr_base64_decode_len(mString.c_str());
+				std::vector<U8> data;
+				data.resize(len);
+				len = apr_base64_decode_binary(&data[0], mString.c_str());
+				data.resize(len);
+				value = data;
+			}
+			break;
+
+		default:
+			break;
+	}
+}
+
+// static
+S32 LLSDXMLParser::Impl::FastReader::readInteger(const char* text, size_t length)
+{
+	// what sscanf("%d") takes, nine digits at most, here
+	const char* cur = text;
+	const char* end = text + length;
+	while (cur < end && isspace((U8)*cur))
+	{
+		++cur;
+	}
+	bool negative = false;
+	if (cur < end && (*cur == '-' || *cur == '+'))
+	{
+		negative = *cur++ == '-';
+	}
+	const char* digits = cur;
+	S32 value = 0;
+	for (; cur < end && cur - digits < 9 && is_digit(*cur); ++cur)
+	{
+		value = value * 10 + (*cur - '0');
+	}
+	if (cur != digits && (cur == end || !is_digit(*cur)))
+	{
+		return negative ? -value : value;
+	}
+
+	const std::string content(text, length);
+	S32 i;
+	if (sscanf(content.c_str(), "%d", &i) == 1)
+	{
+		return i;
+	}
+	return LLSD(content).asInteger();
+}
+
+F64 LLSDXMLParser::Impl::FastReader::readReal(const char* text, size_t length)
+{
+	// Fifteen significant digits and a power of ten up to 22 either way
+	// make an exact double each, so one multiplication or division rounds
+	// the same as the stream does.
+	const char* cur = text;
+	const char* end = text + length;
+	bool negative = false;
+	if (cur < end && (*cur == '-' || *cur == '+'))
+	{
+		negative = *cur++ == '-';
+	}
+	U64 mantissa = 0;
+	S32 significant = 0;
+	S32 exponent = 0;
+	bool digits = false;
+	bool fast = true;
+	for (; cur < end && is_digit(*cur); ++cur)
+	{
+		digits = true;
+		if (mantissa || *cur != '0')
+		{
+			mantissa = mantissa * 10 + (*cur - '0');
+			fast = fast && ++significant <= 15;
+		}
+	}
+	if (cur < end && *cur == '.')
+	{
+		for (++cur; cur < end && is_digit(*cur); ++cur)
+		{
+			digits = true;
+			--exponent;
+			if (mantissa || *cur != '0')
+			{
+				mantissa = mantissa * 10 + (*cur - '0');
+				fast = fast && ++significant <= 15;
+			}
+		}
+	}
+	if (cur < end && (*cur == 'e' || *cur == 'E'))
+	{
+		bool negative_exponent = false;
+		if (++cur < end && (*cur == '-' || *cur == '+'))
+		{
+			negative_exponent = *cur++ == '-';
+		}
+		const char* exponent_digits = cur;
+		S32 value = 0;
+		for (; cur < end && is_digit(*cur) && value < 1000; ++cur)
+		{
+			value = value * 10 + (*cur - '0');
+		}
+		fast = fast && cur != exponent_digits;
+		exponent += negative_exponent ? -value : value;
+	}
+
+	if (fast && digits && cur == end && exponent >= -22 && exponent <= 22)
+	{
+		F64 value = (F64)mantissa;
+		value = exponent < 0 ? value / POWERS_OF_TEN[-exponent] : value * POWERS_OF_TEN[exponent];
+		return negative ? -value : value;
+	}
+
+	// anything else the way LLSD::asReal() reads a string, in place
+	mRealBuf.setText(text, length);
+	mRealStream.clear();
+	F64 v = 0.0;
+	mRealStream >> v;
+	int c = mRealStream.get();
+	return ((EOF == c) ? v : 0.0);
+}
+
+// static
+LLSDXMLParser::Impl::Element LLSDXMLParser::Impl::FastReader::findElement(const char* name, size_t length)
+{
+	for (S32 element = ELEMENT_LLSD; element < ELEMENT_UNKNOWN; ++element)
+	{
+		const char* element_name = ELEMENT_NAMES[element];
+		if (element_name[0] == name[0] && !strncmp(element_name, name, length) && !element_name[length])
+		{
+			return (Element)element;
+		}
+	}
+	return ELEMENT_UNKNOWN;
+}
+
+bool LLSDXMLParser::Impl::fastParse(std::istream& input, LLSD& data, bool lines, S32& count)
+{
+	std::streambuf* buf = input.rdbuf();
+	if (!sFastParse || mExpatFed || !buf || !input.good())
+	{
+		return false;
+	}
+	// gets the buffer filled without taking anything out of it
+	if (std::streambuf::traits_type::eof() == buf->sgetc())
+	{
+		return false;
+	}
+	const char* begin = NULL;
+	const char* end = NULL;
+	GetArea::find(buf, begin, end);
+	if (!begin || begin >= end)
+	{
+		return false;
+	}
+
+	LLSD result;
+	FastReader reader(begin, end);
+	if (!reader.read(result))
+	{
+		return false;
+	}
+
+	// Leave the stream where the expat loop would have: past the chunk it
+	// was given when </llsd> came up, up to 1024 characters or the end of a
+	// line, and the line ends after it.
+	static const int BUFFER_SIZE = 1024;
+	const char* doc_end = reader.getEnd();
+	const char* chunk = begin;
+	while (true)
+	{
+		const char* limit = chunk + llmin(end - chunk, (ptrdiff_t)(lines ? BUFFER_SIZE - 1 : BUFFER_SIZE));
+		const char* next = (const char*)memchr(chunk, '\n', limit - chunk);
+		if (!lines)
+		{
+			const char* cr = (const char*)memchr(chunk, '\r', (next ? next : limit) - chunk);
+			next = cr ? cr : next;
+		}
+		next = next ? next + 1 : limit;
+		if (next >= doc_end)
+		{
+			break;
+		}
+		chunk = next;
+	}
+	input.ignore(chunk - begin);
+	// the last chunk is read the way expat got it, it may go past the buffer
+	char scratch[BUFFER_SIZE];
+	if (lines)
+	{
+		input.getline(scratch, BUFFER_SIZE);
+		if (input.gcount() > 0 && !input.good())
+		{
+			input.clear();
+		}
+	}
+	else
+	{
+		get_till_eol(input, scratch, BUFFER_SIZE);
+	}
+	clear_eol(input);
+
+	data = result;
+	count = reader.getParseCount();
+	return true;
+}
+// </polarity>
+
+
 /**
  * LLSDXMLParser
  */
+bool LLSDXMLParser::sFastParse = true; // <polarity/> Fast LLSD XML reader
+
 LLSDXMLParser::LLSDXMLParser(bool emit_errors /* = true */) : impl(* new Impl(emit_errors))
 {
 }
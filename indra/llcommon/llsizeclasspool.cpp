@@ -0,0 +1,339 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/**
+ * @file llsizeclasspool.cpp
+ * @brief Thread caching pool for small, often allocated objects.
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llsizeclasspool.h"
+
+#include <boost/thread/tss.hpp>
+
+#include "llmemory.h"
+#include "llmutex.h"
+#include "lltrace.h"
+
+namespace
+{
+	// 16 byte steps up to 256, 64 up to 1024, 256 up to 4096
+	const U32 NUM_CLASSES = 40;
+	const size_t CHUNK_SIZE = 64 * 1024;
+	// a batch is about this many bytes, a thread caches up to two
+	const size_t BATCH_BYTES = 16 * 1024;
+
+	struct FreeBlock
+	{
+		FreeBlock* mNext;
+	};
+
+	U32 class_for_size(size_t size)
+	{
+		if (size <= 256)
+		{
+			return size ? (U32)((size - 1) >> 4) : 0;
+		}
+		if (size <= 1024)
+		{
+			return 16 + (U32)((size - 257) >> 6);
+		}
+		return 28 + (U32)((size - 1025) >> 8);
+	}
+
+	size_t block_size(U32 size_class)
+	{
+		if (size_class < 16)
+		{
+			return (size_class + 1) * 16;
+		}
+		if (size_class < 28)
+		{
+			return 256 + (size_class - 15) * 64;
+		}
+		return 1024 + (size_class - 27) * 256;
+	}
+
+	U32 batch_count(U32 size_class)
+	{
+		return llclamp((U32)(BATCH_BYTES / block_size(size_class)), 4U, 64U);
+	}
+
+	struct CentralClass
+	{
+		CentralClass()
+		:	mFree(NULL),
+			mCarve(NULL),
+			mCarveEnd(NULL),
+			mReservedBytes(0),
+			mBlocksOut(0),
+			mBatchFetches(0)
+		{
+		}
+
+		LLMutex		mMutex;			// guards everything below
+		FreeBlock*	mFree;
+		char*		mCarve;			// what is left of the newest chunk
+		char*		mCarveEnd;
+		U64			mReservedBytes;
+		U64			mBlocksOut;
+		U64			mBatchFetches;
+	};
+
+	// Both leaked: pooled objects can still be deleted while statics are
+	// being destroyed.
+	CentralClass* central_classes()
+	{
+		static CentralClass* sClasses = new CentralClass[NUM_CLASSES];
+		return sClasses;
+	}
+
+	LLTrace::MemStatHandle& pool_mem_stat()
+	{
+		static LLTrace::MemStatHandle* sPoolMemStat = new LLTrace::MemStatHandle("LLSizeClassPool");
+		return *sPoolMemStat;
+	}
+
+	struct ThreadCache
+	{
+		FreeBlock*	mHead[NUM_CLASSES];
+		U32			mCount[NUM_CLASSES];
+	};
+
+	LL_THREAD_LOCAL ThreadCache* sThreadCache = NULL;
+	// set once the cache went with its thread, whatever comes after goes
+	// straight to the central lists
+	LL_THREAD_LOCAL bool sThreadCacheGone = false;
+
+	// Up to count blocks of a class, linked through mNext. Returns how many,
+	// fewer only when out of memory.
+	U32 fetch_blocks(U32 size_class, U32 count, FreeBlock*& head)
+	{
+		CentralClass& central = central_classes()[size_class];
+		const size_t size = block_size(size_class);
+		head = NULL;
+		U32 fetched = 0;
+
+		LLMutexLock lock(&central.mMutex);
+		++central.mBatchFetches;
+		while (fetched < count)
+		{
+			FreeBlock* block = central.mFree;
+			if (block)
+			{
+				central.mFree = block->mNext;
+			}
+			else
+			{
+				if (central.mCarve + size > central.mCarveEnd)
+				{
+					char* chunk = (char*)ll_aligned_malloc_16(CHUNK_SIZE);
+					if (!chunk)
+					{
+						LL_WARNS("SizeClassPool") << "Out of memory for " << size << " byte blocks" << LL_ENDL;
+						break;
+					}
+					central.mCarve = chunk;
+					central.mCarveEnd = chunk + CHUNK_SIZE;
+					central.mReservedBytes += CHUNK_SIZE;
+					LLTrace::claim_alloc(pool_mem_stat(), (S32)CHUNK_SIZE);
+				}
+				block = (FreeBlock*)central.mCarve;
+				central.mCarve += size;
+			}
+			block->mNext = head;
+			head = block;
+			++fetched;
+		}
+		central.mBlocksOut += fetched;
+		return fetched;
+	}
+
+	void return_blocks(U32 size_class, FreeBlock* head, FreeBlock* tail, U32 count)
+	{
+		CentralClass& central = central_classes()[size_class];
+		LLMutexLock lock(&central.mMutex);
+		tail->mNext = central.mFree;
+		central.mFree = head;
+		central.mBlocksOut -= count;
+	}
+
+	// hands back the first count blocks of the thread's list
+	void return_from_cache(ThreadCache* cache, U32 size_class, U32 count)
+	{
+		FreeBlock* head = cache->mHead[size_class];
+		FreeBlock* tail = head;
+		for (U32 i = 1; i < count; ++i)
+		{
+			tail = tail->mNext;
+		}
+		cache->mHead[size_class] = tail->mNext;
+		cache->mCount[size_class] -= count;
+		return_blocks(size_class, head, tail, count);
+	}
+
+	void return_all_from_cache(ThreadCache* cache)
+	{
+		for (U32 size_class = 0; size_class < NUM_CLASSES; ++size_class)
+		{
+			if (cache->mCount[size_class])
+			{
+				return_from_cache(cache, size_class, cache->mCount[size_class]);
+			}
+		}
+	}
+
+	void release_thread_cache(ThreadCache* cache)
+	{
+		return_all_from_cache(cache);
+		if (cache == sThreadCache)
+		{
+			sThreadCache = NULL;
+			sThreadCacheGone = true;
+		}
+		delete cache;
+	}
+
+	ThreadCache* create_thread_cache()
+	{
+		// only there to release the cache when the thread ends
+		static boost::thread_specific_ptr<ThreadCache>* sCacheOwner
+			= new boost::thread_specific_ptr<ThreadCache>(&release_thread_cache);
+
+		ThreadCache* cache = new ThreadCache();
+		sCacheOwner->reset(cache);
+		sThreadCache = cache;
+		return cache;
+	}
+}
+
+// static
+void* LLSizeClassPool::allocate(size_t size)
+{
+	const U32 size_class = class_for_size(size);
+	ThreadCache* cache = sThreadCache;
+	if (LL_LIKELY(cache))
+	{
+		FreeBlock* block = cache->mHead[size_class];
+		if (LL_LIKELY(block))
+		{
+			cache->mHead[size_class] = block->mNext;
+			--cache->mCount[size_class];
+			return block;
+		}
+	}
+	else if (sThreadCacheGone)
+	{
+		FreeBlock* block = NULL;
+		fetch_blocks(size_class, 1, block);
+		return block;
+	}
+	else
+	{
+		cache = create_thread_cache();
+	}
+
+	FreeBlock* head = NULL;
+	const U32 fetched = fetch_blocks(size_class, batch_count(size_class), head);
+	if (!fetched)
+	{
+		return NULL;
+	}
+	cache->mHead[size_class] = head->mNext;
+	cache->mCount[size_class] = fetched - 1;
+	return head;
+}
+
+// static
+void LLSizeClassPool::deallocate(void* ptr, size_t size)
+{
+	if (!ptr)
+	{
+		return;
+	}
+	const U32 size_class = class_for_size(size);
+	FreeBlock* block = (FreeBlock*)ptr;
+	ThreadCache* cache = sThreadCache;
+	if (LL_UNLIKELY(!cache))
+	{
+		if (sThreadCacheGone)
+		{
+			return_blocks(size_class, block, block, 1);
+			return;
+		}
+		cache = create_thread_cache();
+	}
+
+	block->mNext = cache->mHead[size_class];
+	cache->mHead[size_class] = block;
+	const U32 batch = batch_count(size_class);
+	if (++cache->mCount[size_class] > batch * 2)
+	{
+		return_from_cache(cache, size_class, batch);
+	}
+}
+
+// static
+void LLSizeClassPool::flushThreadCache()
+{
+	ThreadCache* cache = sThreadCache;
+	if (!cache)
+	{
+		return;
+	}
+	return_all_from_cache(cache);
+}
+
+// static
+void LLSizeClassPool::getStats(std::vector<ClassStats>& stats)
+{
+	stats.clear();
+	for (U32 size_class = 0; size_class < NUM_CLASSES; ++size_class)
+	{
+		CentralClass& central = central_classes()[size_class];
+		LLMutexLock lock(&central.mMutex);
+		if (central.mReservedBytes)
+		{
+			ClassStats class_stats;
+			class_stats.mBlockSize = (U32)block_size(size_class);
+			class_stats.mReservedBytes = central.mReservedBytes;
+			class_stats.mBlocksOut = central.mBlocksOut;
+			class_stats.mBatchFetches = central.mBatchFetches;
+			stats.push_back(class_stats);
+		}
+	}
+}
+
+// static
+void LLSizeClassPool::logStats()
+{
+	std::vector<ClassStats> stats;
+	getStats(stats);
+	U64 reserved = 0;
+	for (std::vector<ClassStats>::const_iterator iter = stats.begin(); iter != stats.end(); ++iter)
+	{
+		reserved += iter->mReservedBytes;
+		LL_INFOS("SizeClassPool") << llformat("%5u bytes: %6llu KB reserved, %8llu blocks out, %8llu batch fetches",
+											  iter->mBlockSize, iter->mReservedBytes / 1024, iter->mBlocksOut, iter->mBatchFetches)
+								  << LL_ENDL;
+	}
+	LL_INFOS("SizeClassPool") << (reserved / 1024) << " KB reserved in " << stats.size() << " size classes" << LL_ENDL;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file llsizeclasspool.h
+ * @brief Thread caching pool for small, often allocated objects.
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLSIZECLASSPOOL_H
+#define LL_LLSIZECLASSPOOL_H
+
+#include <vector>
+
+#include "llpreprocessor.h"
+#include "stdtypes.h"
+
+// Build with this set to 0 to send everything to the heap, for tools that
+// need to see every allocation.
+#ifndef LL_USE_SIZE_CLASS_POOL
+#define LL_USE_SIZE_CLASS_POOL 1
+#endif
+
+// Blocks of up to MAX_SIZE bytes, rounded up to one of 40 size classes and
+// carved out of 64 KB chunks. Every thread keeps a short free list per
+// class and only takes the lock of a class to fetch or hand back a batch,
+// so a block freed on another thread than it came from just ends up in
+// that thread's list. Chunks are never given back to the system; what the
+// pool holds is reported through getStats() and the "LLSizeClassPool"
+// memory stat.
+//
+// Blocks are 16 byte aligned. deallocate() has to get the size that was
+// allocated, objects must be deleted through their own type or a base with
+// a virtual destructor. Use LLTrace::PoolAllocated rather than calling this
+// directly.
+class LL_COMMON_API LLSizeClassPool
+{
+public:
+	static const size_t MAX_SIZE = 4096;
+	static const size_t ALIGNMENT = 16;
+
+	static bool handles(size_t size)	{ return LL_USE_SIZE_CLASS_POOL && size <= MAX_SIZE; }
+
+	// size must be no more than MAX_SIZE
+	static void* allocate(size_t size);
+	static void deallocate(void* ptr, size_t size);
+
+	// Hands the calling thread's cached blocks back to the pool. Threads do
+	// this on their own when they end.
+	static void flushThreadCache();
+
+	struct ClassStats
+	{
+		U32	mBlockSize;
+		U64	mReservedBytes;	// chunk memory carved for this class
+		U64	mBlocksOut;		// blocks in use or in thread caches
+		U64	mBatchFetches;	// times a thread had to come back for more
+	};
+	// one entry for every class that has reserved memory
+	static void getStats(std::vector<ClassStats>& stats);
+	static void logStats();
+};
+
+#endif // LL_LLSIZECLASSPOOL_H
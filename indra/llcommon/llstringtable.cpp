@@ -30,29 +30,85 @@
 #include "linden_common.h"
 
 #include "llstringtable.h"
+#include "llmutex.h" // <polarity/>
 #include "llstl.h"
 
 LLStringTable gStringTable(32768);
 
-LLStringTableEntry::LLStringTableEntry(const char *str)
-: mString(NULL), mCount(1)
+// <polarity> Concurrent string table
+// The old single threaded implementation was replaced as a whole, see
+// llstringtable.h.
+namespace
 {
-	// Copy string
-	U32 length = (U32)strlen(str) + 1;	 /*Flawfinder: ignore*/
-	length = llmin(length, MAX_STRINGS_LENGTH);
-	mString = new char[length];
-	strncpy(mString, str, length);	 /*Flawfinder: ignore*/
-	mString[length - 1] = 0;
+	const U32 MAX_SHARDS = 16;
+	// entries and their strings are carved from blocks this big
+	const U32 ARENA_BLOCK_SIZE = 16 * 1024;
+
+	// FNV-1a, over the part of the string the table keeps
+	U32 hash_my_string(const char* str, U32& length)
+	{
+		U32 hash = 2166136261U;
+		const char* start = str;
+		const char* end = str + MAX_STRINGS_LENGTH - 1;
+		for (; str < end && *str; ++str)
+		{
+			hash = (hash ^ (U8)*str) * 16777619U;
+		}
+		length = (U32)(str - start);
+		return hash;
+	}
 }
 
-LLStringTableEntry::~LLStringTableEntry()
+struct LLStringTable::Shard
+{
+	Shard()
+	:	mBlockUsed(ARENA_BLOCK_SIZE)
+	{
+	}
+
+	~Shard()
+	{
+		for (std::vector<char*>::iterator iter = mBlocks.begin(); iter != mBlocks.end(); ++iter)
+		{
+			delete[] *iter;
+		}
+	}
+
+	// under mMutex
+	LLStringTableEntry* allocate(const char* str, U32 length, U32 hash)
+	{
+		const U32 align = (U32)sizeof(void*) - 1;
+		const U32 size = ((U32)sizeof(LLStringTableEntry) + length + 1 + align) & ~align;
+		if (mBlockUsed + size > ARENA_BLOCK_SIZE)
+		{
+			mBlocks.push_back(new char[ARENA_BLOCK_SIZE]);
+			mBlockUsed = 0;
+		}
+		char* memory = mBlocks.back() + mBlockUsed;
+		mBlockUsed += size;
+
+		char* string = memory + sizeof(LLStringTableEntry);
+		memcpy(string, str, length);	 /*Flawfinder: ignore*/
+		string[length] = 0;
+		return new (memory) LLStringTableEntry(string, length, hash);
+	}
+
+	LLMutex				mMutex;
+	std::vector<char*>	mBlocks;
+	U32					mBlockUsed;		// in mBlocks.back()
+};
+
+LLStringTableEntry::LLStringTableEntry(char* str, U32 length, U32 hash)
+:	mString(str),
+	mCount(1),
+	mLength(length),
+	mHash(hash),
+	mNext(NULL)
 {
-	delete [] mString;
-	mCount = 0;
 }
 
 LLStringTable::LLStringTable(int tablesize)
-: mUniqueEntries(0)
+:	mUniqueEntries(0)
 {
 	S32 i;
 	if (!tablesize)
@@ -71,63 +127,37 @@ LLStringTable::LLStringTable(int tablesize)
 	}
 	mMaxEntries = tablesize;
 
-#if !STRING_TABLE_HASH_MAP
-	// ALlocate strings
-	mStringList = new string_list_ptr_t[mMaxEntries];
-	// Clear strings
+	mBuckets = new std::atomic<LLStringTableEntry*>[mMaxEntries];
 	for (i = 0; i < mMaxEntries; i++)
 	{
-		mStringList[i] = NULL;
+		mBuckets[i].store(NULL, std::memory_order_relaxed);
 	}
-#endif
+	// a shard owns whole buckets, so there can't be more shards than buckets
+	mShardMask = llmin((U32)mMaxEntries, MAX_SHARDS) - 1;
+	mShards = new Shard[mShardMask + 1];
 }
 
 LLStringTable::~LLStringTable()
 {
-#if !STRING_TABLE_HASH_MAP
-	if (mStringList)
-	{
-		for (S32 i = 0; i < mMaxEntries; i++)
-		{
-			if (mStringList[i])
-			{
-				string_list_t::iterator iter;
-				for (iter = mStringList[i]->begin(); iter != mStringList[i]->end(); iter++)
-					delete *iter; // *iter = (LLStringTableEntry*)
-			}
-			delete mStringList[i];
-		}
-		delete [] mStringList;
-		mStringList = NULL;
-	}
-#else
-	// Need to clean up the string hash
-	for_each(mStringHash.begin(), mStringHash.end(), DeletePairedPointer());
-	mStringHash.clear();
-#endif
+	// the entries go with their shards' arenas
+	delete[] mShards;
+	mShards = NULL;
+	delete[] mBuckets;
+	mBuckets = NULL;
 }
 
-
-static U32 hash_my_string(const char *str, int max_entries)
+LLStringTableEntry* LLStringTable::findEntry(const char* str, U32 length, U32 hash) const
 {
-	U32 retval = 0;
-#if 0
-	while (*str)
-	{
-		retval <<= 1;
-		retval += *str++;
-	}
-#else
-	while (*str)
+	for (LLStringTableEntry* entry = mBuckets[hash & (mMaxEntries - 1)].load(std::memory_order_acquire);
+		 entry;
+		 entry = entry->mNext)
 	{
-		retval = (retval<<4) + *str;
-		U32 x = (retval & 0xf0000000);
-		if (x) retval = retval ^ (x>>24);
-		retval = retval & (~x);
-		str++;
+		if (entry->mHash == hash && entry->mLength == length && !memcmp(entry->mString, str, length))
+		{
+			return entry;
+		}
 	}
-#endif
-	return (retval & (max_entries-1)); // max_entries is gauranteed to be power of 2
+	return NULL;
 }
 
 char* LLStringTable::checkString(const std::string& str)
@@ -137,65 +167,26 @@ char* LLStringTable::checkString(const std::string& str)
 
 char* LLStringTable::checkString(const char *str)
 {
-    LLStringTableEntry* entry = checkStringEntry(str);
-    if (entry)
-    {
-	return entry->mString;
-    }
-    else
-    {
-	return NULL;
-    }
+	LLStringTableEntry* entry = checkStringEntry(str);
+	return entry ? entry->mString : NULL;
 }
 
 LLStringTableEntry* LLStringTable::checkStringEntry(const std::string& str)
 {
-    return checkStringEntry(str.c_str());
+	return checkStringEntry(str.c_str());
 }
 
 LLStringTableEntry* LLStringTable::checkStringEntry(const char *str)
 {
-	if (str)
+	if (!str)
 	{
-		char *ret_val;
-		LLStringTableEntry	*entry;
-		U32					hash_value = hash_my_string(str, mMaxEntries);
-#if STRING_TABLE_HASH_MAP
-#if 1 // Microsoft
-		string_hash_t::iterator lower = mStringHash.lower_bound(hash_value);
-		string_hash_t::iterator upper = mStringHash.upper_bound(hash_value);
-#else // stlport
-		std::pair<string_hash_t::iterator, string_hash_t::iterator> P = mStringHash.equal_range(hash_value);
-		string_hash_t::iterator lower = P.first;
-		string_hash_t::iterator upper = P.second;
-#endif
-		for (string_hash_t::iterator iter = lower; iter != upper; iter++)
-		{
-			entry = iter->second;
-			ret_val = entry->mString;
-			if (!strncmp(ret_val, str, MAX_STRINGS_LENGTH))
-			{
-				return entry;
-			}
-		}
-#else
-		string_list_t		*strlist = mStringList[hash_value];
-		if (strlist)
-		{
-			string_list_t::iterator iter;
-			for (iter = strlist->begin(); iter != strlist->end(); iter++)
-			{
-				entry = *iter;
-				ret_val = entry->mString;
-				if (!strncmp(ret_val, str, MAX_STRINGS_LENGTH))
-				{
-					return entry;
-				}
-			}
-		}
-#endif
+		return NULL;
 	}
-	return NULL;
+	U32 length;
+	const U32 hash = hash_my_string(str, length);
+	LLStringTableEntry* entry = findEntry(str, length, hash);
+	// removed strings are only kept for the pointers already handed out
+	return entry && entry->mCount.load(std::memory_order_relaxed) > 0 ? entry : NULL;
 }
 
 char* LLStringTable::addString(const std::string& str)
@@ -206,155 +197,75 @@ char* LLStringTable::addString(const std::string& str)
 
 char* LLStringTable::addString(const char *str)
 {
-
-    LLStringTableEntry* entry = addStringEntry(str);
-    if (entry)
-    {
-	return entry->mString;
-    }
-    else
-    {
-	return NULL;
-    }
+	LLStringTableEntry* entry = addStringEntry(str);
+	return entry ? entry->mString : NULL;
 }
 
 LLStringTableEntry* LLStringTable::addStringEntry(const std::string& str)
 {
-    return addStringEntry(str.c_str());
+	return addStringEntry(str.c_str());
 }
 
 LLStringTableEntry* LLStringTable::addStringEntry(const char *str)
 {
-	if (str)
+	if (!str)
 	{
-		char *ret_val = NULL;
-		LLStringTableEntry	*entry;
-		U32					hash_value = hash_my_string(str, mMaxEntries);
-#if STRING_TABLE_HASH_MAP
-#if 1 // Microsoft
-		string_hash_t::iterator lower = mStringHash.lower_bound(hash_value);
-		string_hash_t::iterator upper = mStringHash.upper_bound(hash_value);
-#else // stlport
-		std::pair<string_hash_t::iterator, string_hash_t::iterator> P = mStringHash.equal_range(hash_value);
-		string_hash_t::iterator lower = P.first;
-		string_hash_t::iterator upper = P.second;
-#endif
-		for (string_hash_t::iterator iter = lower; iter != upper; iter++)
-		{
-			entry = iter->second;
-			ret_val = entry->mString;
-			if (!strncmp(ret_val, str, MAX_STRINGS_LENGTH))
-			{
-				entry->incCount();
-				return entry;
-			}
-		}
-
-		// not found, so add!
-		LLStringTableEntry* newentry = new LLStringTableEntry(str);
-		ret_val = newentry->mString;
-		mStringHash.insert(string_hash_t::value_type(hash_value, newentry));
-#else
-		string_list_t		*strlist = mStringList[hash_value];
-
-		if (strlist)
-		{
-			string_list_t::iterator iter;
-			for (iter = strlist->begin(); iter != strlist->end(); iter++)
-			{
-				entry = *iter;
-				ret_val = entry->mString;
-				if (!strncmp(ret_val, str, MAX_STRINGS_LENGTH))
-				{
-					entry->incCount();
-					return entry;
-				}
-			}
-		}
-		else
+		return NULL;
+	}
+	U32 length;
+	const U32 hash = hash_my_string(str, length);
+	LLStringTableEntry* entry = findEntry(str, length, hash);
+	if (!entry)
+	{
+		const U32 bucket = hash & (mMaxEntries - 1);
+		Shard& shard = mShards[bucket & mShardMask];
+		LLMutexLock lock(&shard.mMutex);
+		// someone else may have added it since
+		entry = findEntry(str, length, hash);
+		if (!entry)
 		{
-			mStringList[hash_value] = new string_list_t;
-			strlist = mStringList[hash_value];
+			// not found, so add!
+			entry = shard.allocate(str, length, hash);
+			entry->mNext = mBuckets[bucket].load(std::memory_order_relaxed);
+			mBuckets[bucket].store(entry, std::memory_order_release);
+			mUniqueEntries++;
+			return entry;
 		}
-
-		// not found, so add!
-		LLStringTableEntry *newentry = new LLStringTableEntry(str);
-		//ret_val = newentry->mString;
-		strlist->push_front(newentry);
-#endif
-		mUniqueEntries++;
-		return newentry;
 	}
-	else
+
+	if (entry->incCount() == 1)
 	{
-		return NULL;
+		// back after it was removed
+		mUniqueEntries++;
 	}
+	return entry;
 }
 
 void LLStringTable::removeString(const char *str)
 {
-	if (str)
+	if (!str)
 	{
-		char *ret_val;
-		LLStringTableEntry	*entry;
-		U32					hash_value = hash_my_string(str, mMaxEntries);
-#if STRING_TABLE_HASH_MAP
-		{
-#if 1 // Microsoft
-			string_hash_t::iterator lower = mStringHash.lower_bound(hash_value);
-			string_hash_t::iterator upper = mStringHash.upper_bound(hash_value);
-#else // stlport
-			std::pair<string_hash_t::iterator, string_hash_t::iterator> P = mStringHash.equal_range(hash_value);
-			string_hash_t::iterator lower = P.first;
-			string_hash_t::iterator upper = P.second;
-#endif
-			for (string_hash_t::iterator iter = lower; iter != upper; iter++)
-			{
-				entry = iter->second;
-				ret_val = entry->mString;
-				if (!strncmp(ret_val, str, MAX_STRINGS_LENGTH))
-				{
-					if (!entry->decCount())
-					{
-						mUniqueEntries--;
-						if (mUniqueEntries < 0)
-						{
-							LL_ERRS() << "LLStringTable:removeString trying to remove too many strings!" << LL_ENDL;
-						}
-						delete iter->second;
-						mStringHash.erase(iter);
-					}
-					return;
-				}
-			}
-		}
-#else
-		string_list_t		*strlist = mStringList[hash_value];
+		return;
+	}
+	U32 length;
+	const U32 hash = hash_my_string(str, length);
+	LLStringTableEntry* entry = findEntry(str, length, hash);
+	if (!entry)
+	{
+		return;
+	}
 
-		if (strlist)
+	// a string that was removed already is as good as never added
+	S32 count = entry->mCount.load(std::memory_order_relaxed);
+	while (count > 0 && !entry->mCount.compare_exchange_weak(count, count - 1))
+	{
+	}
+	if (count == 1)
+	{
+		if (--mUniqueEntries < 0)
 		{
-			string_list_t::iterator iter;
-			for (iter = strlist->begin(); iter != strlist->end(); iter++)
-			{
-				entry = *iter;
-				ret_val = entry->mString;
-				if (!strncmp(ret_val, str, MAX_STRINGS_LENGTH))
-				{
-					if (!entry->decCount())
-					{
-						mUniqueEntries--;
-						if (mUniqueEntries < 0)
-						{
-							LL_ERRS() << "LLStringTable:removeString trying to remove too many strings!" << LL_ENDL;
-						}
-						strlist->remove(entry);
-						delete entry;
-					}
-					return;
-				}
-			}
+			LL_ERRS() << "LLStringTable:removeString trying to remove too many strings!" << LL_ENDL;
 		}
-#endif
 	}
 }
-
+// </polarity>
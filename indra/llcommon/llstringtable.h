@@ -31,32 +31,61 @@
 #include "lldefs.h"
 #include "llformat.h"
 #include "llstl.h"
+#include <atomic> // <polarity/>
 #include <list>
 #include <set>
 
-#if LL_WINDOWS
-# if (_MSC_VER >= 1300 && _MSC_VER < 1400)
-#  define STRING_TABLE_HASH_MAP 1
-# endif
-#else
-//# define STRING_TABLE_HASH_MAP 1
-#endif
+// <polarity> Concurrent string table
+//#if LL_WINDOWS
+//# if (_MSC_VER >= 1300 && _MSC_VER < 1400)
+//#  define STRING_TABLE_HASH_MAP 1
+//# endif
+//#else
+////# define STRING_TABLE_HASH_MAP 1
+//#endif
+// </polarity>
 
 const U32 MAX_STRINGS_LENGTH = 256;
 
 class LL_COMMON_API LLStringTableEntry
 {
 public:
-	LLStringTableEntry(const char *str);
-	~LLStringTableEntry();
-
-	void incCount()		{ mCount++; }
-	BOOL decCount()		{ return --mCount; }
-
-	char *mString;
-	S32  mCount;
+	// <polarity> Concurrent string table
+	//LLStringTableEntry(const char *str);
+	//~LLStringTableEntry();
+	//
+	//void incCount()		{ mCount++; }
+	//BOOL decCount()		{ return --mCount; }
+	//
+	//char *mString;
+	//S32  mCount;
+	// Entries are made by their table, in its arena, and stay put until the
+	// table goes. An entry removed as often as it was added only has its
+	// count at 0 until the string is added again, so a pointer to one never
+	// dangles and names can be compared by pointer.
+	LLStringTableEntry(char* str, U32 length, U32 hash);
+
+	S32 incCount()		{ return ++mCount; }
+	S32 decCount()		{ return --mCount; }
+
+	char*					mString;	// right behind the entry, at most MAX_STRINGS_LENGTH - 1 characters
+	std::atomic<S32>		mCount;
+	U32						mLength;
+	U32						mHash;
+	LLStringTableEntry*		mNext;		// in the same bucket, set before the entry is published
+	// </polarity>
 };
 
+// <polarity> Concurrent string table
+// Lookups never lock and may run on any thread: every bucket is a list
+// that only ever grows at its head, published with a release store, and
+// entries never move or go away. Adding a string that isn't there yet takes
+// the lock of the shard its bucket belongs to, which also owns the arena
+// the entry is carved from; adding or removing one that is only changes
+// its count.
+// Strings longer than MAX_STRINGS_LENGTH - 1 are cut down to that before
+// they are looked up or stored.
+// </polarity>
 class LL_COMMON_API LLStringTable
 {
 public:
@@ -74,21 +103,34 @@ public:
 	LLStringTableEntry *addStringEntry(const std::string& str);
 	void  removeString(const char *str);
 
-	S32 mMaxEntries;
-	S32 mUniqueEntries;
-	
-#if STRING_TABLE_HASH_MAP
-#if LL_WINDOWS
-	typedef std::hash_multimap<U32, LLStringTableEntry *> string_hash_t;
-#else
-	typedef __gnu_cxx::hash_multimap<U32, LLStringTableEntry *> string_hash_t;
-#endif
-	string_hash_t mStringHash;
-#else
-	typedef std::list<LLStringTableEntry *> string_list_t;
-	typedef string_list_t * string_list_ptr_t;
-	string_list_ptr_t	*mStringList;
-#endif	
+	// <polarity> Concurrent string table
+	//S32 mMaxEntries;
+	//S32 mUniqueEntries;
+	//
+//#if STRING_TABLE_HASH_MAP
+//#if LL_WINDOWS
+	//typedef std::hash_multimap<U32, LLStringTableEntry *> string_hash_t;
+//#else
+	//typedef __gnu_cxx::hash_multimap<U32, LLStringTableEntry *> string_hash_t;
+//#endif
+	//string_hash_t mStringHash;
+//#else
+	//typedef std::list<LLStringTableEntry *> string_list_t;
+	//typedef string_list_t * string_list_ptr_t;
+	//string_list_ptr_t	*mStringList;
+//#endif	
+	S32					mMaxEntries;		// number of buckets
+	std::atomic<S32>	mUniqueEntries;		// entries with a count above 0
+
+private:
+	struct Shard;
+
+	LLStringTableEntry* findEntry(const char* str, U32 length, U32 hash) const;
+
+	std::atomic<LLStringTableEntry*>*	mBuckets;	// [mMaxEntries]
+	Shard*								mShards;	// [mShardMask + 1], bucket i belongs to shard i & mShardMask
+	U32									mShardMask;
+	// </polarity>
 };
 
 extern LL_COMMON_API LLStringTable gStringTable;
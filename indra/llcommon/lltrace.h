@@ -37,6 +37,9 @@
 #include "lltimer.h"
 #include "llpointer.h"
 #include "llunits.h"
+#include "llsizeclasspool.h" // <polarity/>
+
+#include <new> // <polarity/>
 
 #define LL_TRACE_ENABLED 1
 
@@ -487,6 +490,89 @@ public:
 	virtual ~MemTrackable()
 	{}
 };
+
+// <polarity> Size class pool
+// Instances come from LLSizeClassPool instead of the heap, for classes
+// that get created and destroyed by the thousand; arrays and sizes the pool
+// doesn't take still go to the heap. Stats are kept as with MemTrackable,
+// under the same name. The pool aligns to 16 bytes at most.
+template<size_t ALIGNMENT>
+inline void* pool_allocate(size_t size)
+{
+	static_assert(ALIGNMENT <= LLSizeClassPool::ALIGNMENT, "LLSizeClassPool blocks are only 16 byte aligned");
+	void* ptr = LLSizeClassPool::handles(size) ? LLSizeClassPool::allocate(size) : ll_aligned_malloc<ALIGNMENT>(size);
+	if (!ptr)
+	{
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+template<size_t ALIGNMENT>
+inline void pool_deallocate(void* ptr, size_t size)
+{
+	if (LLSizeClassPool::handles(size))
+	{
+		LLSizeClassPool::deallocate(ptr, size);
+	}
+	else
+	{
+		ll_aligned_free<ALIGNMENT>(ptr);
+	}
+}
+
+template<typename DERIVED, size_t ALIGNMENT = LL_DEFAULT_HEAP_ALIGN>
+class PoolAllocatedNonVirtual : public MemTrackableNonVirtual<DERIVED, ALIGNMENT>
+{
+public:
+	PoolAllocatedNonVirtual(const char* name)
+	:	MemTrackableNonVirtual<DERIVED, ALIGNMENT>(name)
+	{}
+
+	void* operator new(size_t size)
+	{
+#if LL_TRACE_ENABLED
+		claim_alloc(MemTrackableNonVirtual<DERIVED, ALIGNMENT>::getMemStatHandle(), (S32)size);
+#endif
+		return pool_allocate<ALIGNMENT>(size);
+	}
+
+	// size is what the most derived class asked for, so deleting through a
+	// base pointer needs a virtual destructor
+	void operator delete(void* ptr, size_t size)
+	{
+#if LL_TRACE_ENABLED
+		disclaim_alloc(MemTrackableNonVirtual<DERIVED, ALIGNMENT>::getMemStatHandle(), (S32)size);
+#endif
+		pool_deallocate<ALIGNMENT>(ptr, size);
+	}
+};
+
+template<typename DERIVED, size_t ALIGNMENT = LL_DEFAULT_HEAP_ALIGN>
+class PoolAllocated : public MemTrackable<DERIVED, ALIGNMENT>
+{
+public:
+	PoolAllocated(const char* name)
+	:	MemTrackable<DERIVED, ALIGNMENT>(name)
+	{}
+
+	void* operator new(size_t size)
+	{
+#if LL_TRACE_ENABLED
+		claim_alloc(MemTrackable<DERIVED, ALIGNMENT>::getMemStatHandle(), (S32)size);
+#endif
+		return pool_allocate<ALIGNMENT>(size);
+	}
+
+	void operator delete(void* ptr, size_t size)
+	{
+#if LL_TRACE_ENABLED
+		disclaim_alloc(MemTrackable<DERIVED, ALIGNMENT>::getMemStatHandle(), (S32)size);
+#endif
+		pool_deallocate<ALIGNMENT>(ptr, size);
+	}
+};
+// </polarity>
 }
 
 #endif // LL_LLTRACE_H
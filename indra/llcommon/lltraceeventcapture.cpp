@@ -0,0 +1,236 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/**
+ * @file lltraceeventcapture.cpp
+ * @brief Records individual block timer calls for a trace viewer.
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "lltraceeventcapture.h"
+
+#include "llfasttimer.h"
+#include "llfile.h"
+#include "llmutex.h"
+
+namespace LLTrace
+{
+
+namespace
+{
+	// 24 bytes each, 768 KB per thread that ran a timer while capturing
+	const U32 RING_SIZE = 1 << 15;
+	const U32 RING_MASK = RING_SIZE - 1;
+
+	struct TimerEvent
+	{
+		const BlockTimerStatHandle*	mTimer;
+		U64							mStart;
+		U64							mEnd;
+	};
+
+	struct ThreadSlot
+	{
+		ThreadSlot(U32 index)
+		:	mName(llformat("Thread %u", index)),
+			mIndex(index),
+			mEvents(NULL),
+			mWriteCount(0)
+		{
+		}
+
+		std::string			mName;		// set on this thread, read under sSlotsMutex
+		U32					mIndex;
+		TimerEvent*			mEvents;	// RING_SIZE, allocated on the first call
+		std::atomic<U64>	mWriteCount;
+	};
+
+	// Slots outlive their threads so a dump still shows threads that ended,
+	// and they are only ever added.
+	LLMutex& slots_mutex()
+	{
+		static LLMutex sSlotsMutex;
+		return sSlotsMutex;
+	}
+
+	std::vector<ThreadSlot*>& slots()
+	{
+		static std::vector<ThreadSlot*> sSlots;
+		return sSlots;
+	}
+
+	LL_THREAD_LOCAL ThreadSlot* sThreadSlot = NULL;
+
+	ThreadSlot* get_thread_slot()
+	{
+		if (!sThreadSlot)
+		{
+			LLMutexLock lock(&slots_mutex());
+			sThreadSlot = new ThreadSlot((U32)slots().size());
+			slots().push_back(sThreadSlot);
+		}
+		return sThreadSlot;
+	}
+
+	void write_escaped(std::ostream& out, const std::string& text)
+	{
+		for (std::string::const_iterator iter = text.begin(); iter != text.end(); ++iter)
+		{
+			const char c = *iter;
+			if (c == '"' || c == '\\')
+			{
+				out << '\\' << c;
+			}
+			else if ((U8)c < 0x20)
+			{
+				out << ' ';
+			}
+			else
+			{
+				out << c;
+			}
+		}
+	}
+}
+
+std::atomic<bool> BlockTimerEventCapture::sCapturing(false);
+
+// static
+void BlockTimerEventCapture::setCapturing(bool capturing)
+{
+	sCapturing.store(capturing, std::memory_order_relaxed);
+}
+
+// static
+void BlockTimerEventCapture::setThreadName(const std::string& name)
+{
+	ThreadSlot* slot = get_thread_slot();
+	LLMutexLock lock(&slots_mutex());
+	slot->mName = name;
+}
+
+// static
+void BlockTimerEventCapture::record(const BlockTimerStatHandle* timer, U64 start, U64 end)
+{
+	ThreadSlot* slot = get_thread_slot();
+	if (!slot->mEvents)
+	{
+		TimerEvent* events = new TimerEvent[RING_SIZE];
+		LLMutexLock lock(&slots_mutex());
+		slot->mEvents = events;
+	}
+	// only this thread writes the count, the release store publishes the event
+	const U64 count = slot->mWriteCount.load(std::memory_order_relaxed);
+	// keeps the last count store ahead of the writes below, so a reader that
+	// copies any of them half written also sees the count that says so
+	std::atomic_thread_fence(std::memory_order_release);
+	TimerEvent& event = slot->mEvents[count & RING_MASK];
+	event.mTimer = timer;
+	event.mStart = start;
+	event.mEnd = end;
+	slot->mWriteCount.store(count + 1, std::memory_order_release);
+}
+
+// static
+S32 BlockTimerEventCapture::writeChromeTrace(const std::string& filename, F64 window_seconds)
+{
+	llofstream out(filename.c_str());
+	if (!out.is_open())
+	{
+		LL_WARNS("TimerTrace") << "Unable to write " << filename << LL_ENDL;
+		return -1;
+	}
+
+	const U64 now = BlockTimer::getCPUClockCount64();
+	const F64 counts_per_second = (F64)BlockTimer::countsPerSecond();
+	const U64 window = (U64)(llmax(window_seconds, 0.0) * counts_per_second);
+	const U64 cutoff = now > window ? now - window : 0;
+	const F64 counts_to_microseconds = 1000000.0 / counts_per_second;
+
+	std::vector<TimerEvent> events;
+	std::vector<std::pair<U32, std::string> > threads;
+	S32 written = 0;
+
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	LLMutexLock lock(&slots_mutex());
+	for (std::vector<ThreadSlot*>::const_iterator iter = slots().begin(); iter != slots().end(); ++iter)
+	{
+		const ThreadSlot* slot = *iter;
+		if (!slot->mEvents)
+		{
+			continue;
+		}
+
+		// copy what is there, then drop whatever the thread may have written
+		// over while we were at it
+		const U64 count = slot->mWriteCount.load(std::memory_order_acquire);
+		const U64 first = count > RING_SIZE ? count - RING_SIZE : 0;
+		events.clear();
+		for (U64 i = first; i < count; ++i)
+		{
+			events.push_back(slot->mEvents[i & RING_MASK]);
+		}
+		// the fence keeps the copies above from being read after the recount
+		std::atomic_thread_fence(std::memory_order_acquire);
+		const U64 recount = slot->mWriteCount.load(std::memory_order_relaxed);
+		const U64 overwritten = recount >= RING_SIZE ? recount - RING_SIZE + 1 : 0;
+		const size_t skip = overwritten > first ? (size_t)llmin<U64>(overwritten - first, events.size()) : 0;
+
+		bool any = false;
+		for (size_t i = skip; i < events.size(); ++i)
+		{
+			const TimerEvent& event = events[i];
+			if (event.mEnd < cutoff || event.mEnd < event.mStart)
+			{
+				continue;
+			}
+			out << (written ? ",\n" : "") << "{\"name\":\"";
+			write_escaped(out, event.mTimer->getName());
+			// calls that started before the window are cut off at its start
+			const U64 start = llmax(event.mStart, cutoff);
+			out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << slot->mIndex
+				<< llformat(",\"ts\":%.3f,\"dur\":%.3f}",
+							(F64)(start - cutoff) * counts_to_microseconds,
+							(F64)(event.mEnd - start) * counts_to_microseconds);
+			++written;
+			any = true;
+		}
+		if (any)
+		{
+			threads.push_back(std::make_pair(slot->mIndex, slot->mName));
+		}
+	}
+
+	for (std::vector<std::pair<U32, std::string> >::const_iterator iter = threads.begin(); iter != threads.end(); ++iter)
+	{
+		out << (written || iter != threads.begin() ? ",\n" : "")
+			<< "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << iter->first << ",\"args\":{\"name\":\"";
+		write_escaped(out, iter->second);
+		out << "\"}}";
+	}
+	out << "\n]}\n";
+	out.close();
+
+	LL_INFOS("TimerTrace") << "Wrote " << written << " timer calls from " << threads.size() << " threads to " << filename << LL_ENDL;
+	return written;
+}
+
+}
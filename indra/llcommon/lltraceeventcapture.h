@@ -0,0 +1,70 @@
+/**
+ * @file lltraceeventcapture.h
+ * @brief Records individual block timer calls for a trace viewer.
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLTRACEEVENTCAPTURE_H
+#define LL_LLTRACEEVENTCAPTURE_H
+
+#include <atomic>
+#include <string>
+
+#include "llpreprocessor.h"
+#include "stdtypes.h"
+
+namespace LLTrace
+{
+class BlockTimerStatHandle;
+
+// The block timers normally only add up how long each timer ran per frame.
+// While capturing, every BlockTimer also leaves its start and end time in a
+// ring buffer owned by the thread it ran on, so a trace viewer can show when
+// and where a stall happened and what the other threads were doing. Only
+// the thread a ring belongs to writes it, the dump reads it without locking
+// and drops whatever got overwritten meanwhile; the oldest calls go once a
+// ring is full.
+//
+// Threads without a ThreadRecorder don't run block timers at all, give them
+// one to have them show up.
+class LL_COMMON_API BlockTimerEventCapture
+{
+public:
+	static void setCapturing(bool capturing);
+	static bool isCapturing()	{ return sCapturing.load(std::memory_order_relaxed); }
+
+	// shown instead of "Thread n" for the calling thread
+	static void setThreadName(const std::string& name);
+
+	// called by ~BlockTimer() while capturing
+	static void record(const BlockTimerStatHandle* timer, U64 start, U64 end);
+
+	// Writes the calls that ended in the last window_seconds on every thread
+	// as Chrome trace event JSON, for chrome://tracing or Perfetto. Returns
+	// the number of calls written, or -1 when the file can't be written.
+	static S32 writeChromeTrace(const std::string& filename, F64 window_seconds);
+
+private:
+	static std::atomic<bool> sCapturing;
+};
+
+}
+
+#endif // LL_LLTRACEEVENTCAPTURE_H
@@ -42,6 +42,15 @@
 #include "lltimer.h"
 #include "llthread.h"
 
+// <polarity> UUID fast paths
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LL_UUID_SSE2 1
+#include <emmintrin.h>
+#else
+#define LL_UUID_SSE2 0
+#endif
+// </polarity>
+
 const LLUUID LLUUID::null;
 const LLTransactionID LLTransactionID::tnull;
 
@@ -50,6 +59,137 @@ LLMutex * LLUUID::mMutex = NULL;
 
 static const U8 nullUUID[UUID_BYTES] = {}; // <alchemy/>
 
+// <polarity> UUID fast paths
+// Text goes to and from all 16 bytes at once, 16 characters per SSE2
+// register, and ids compare as two 64-bit words. Every x86 build has SSE2,
+// the byte at a time versions are only there for anything else.
+namespace
+{
+	inline U64 load_big_endian(const U8* data)
+	{
+		U64 word;
+		memcpy(&word, data, sizeof(word));
+#if LL_WINDOWS
+		return _byteswap_uint64(word);
+#else
+		return __builtin_bswap64(word);
+#endif
+	}
+
+#if LL_UUID_SSE2
+	inline __m128i load_uuid(const U8* data)
+	{
+		return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+	}
+
+	// 16 nibbles to lowercase hex digits
+	inline __m128i nibbles_to_hex(__m128i nibbles)
+	{
+		const __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '0' - 10));
+		return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+	}
+
+	// 16 hex digits of either case to their values, returns a bit per
+	// character that was one
+	inline S32 hex_to_nibbles(__m128i chars, __m128i& nibbles)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i ten = _mm_set1_epi8(10);
+		// bytes are signed here, anything that wrapped around is below zero
+		const __m128i digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+		const __m128i is_digit = _mm_andnot_si128(_mm_cmplt_epi8(digit, zero), _mm_cmplt_epi8(digit, ten));
+		const __m128i letter = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+		const __m128i is_letter = _mm_andnot_si128(_mm_cmplt_epi8(letter, zero), _mm_cmplt_epi8(letter, _mm_set1_epi8(6)));
+		nibbles = _mm_or_si128(_mm_and_si128(is_digit, digit), _mm_and_si128(is_letter, _mm_add_epi8(letter, ten)));
+		return _mm_movemask_epi8(_mm_or_si128(is_digit, is_letter));
+	}
+
+	// pairs of nibbles, high one first, to 8 bytes in the low half of each 16-bit lane
+	inline __m128i pair_nibbles(__m128i nibbles)
+	{
+		const __m128i high = _mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00ff)), 4);
+		return _mm_or_si128(high, _mm_srli_epi16(nibbles, 8));
+	}
+#else
+	const char HEX_DIGITS[] = "0123456789abcdef";
+
+	inline S32 hex_value(char c)
+	{
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+		return -1;
+	}
+#endif
+
+	// 32 lowercase hex digits, no terminator
+	void encode_hex(const U8* data, char* out)
+	{
+#if LL_UUID_SSE2
+		const __m128i bytes = load_uuid(data);
+		const __m128i low_mask = _mm_set1_epi8(0x0f);
+		const __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), low_mask);
+		const __m128i low = _mm_and_si128(bytes, low_mask);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out), nibbles_to_hex(_mm_unpacklo_epi8(high, low)));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), nibbles_to_hex(_mm_unpackhi_epi8(high, low)));
+#else
+		for (S32 i = 0; i < UUID_BYTES; ++i)
+		{
+			out[i * 2] = HEX_DIGITS[data[i] >> 4];
+			out[i * 2 + 1] = HEX_DIGITS[data[i] & 0x0f];
+		}
+#endif
+	}
+
+	// 32 hex digits of either case, false when any of them isn't one
+	bool decode_hex(const char* hex, U8* data)
+	{
+#if LL_UUID_SSE2
+		__m128i first, second;
+		const S32 valid = hex_to_nibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex)), first)
+						& hex_to_nibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + 16)), second);
+		if (valid != 0xffff)
+		{
+			return false;
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(data), _mm_packus_epi16(pair_nibbles(first), pair_nibbles(second)));
+		return true;
+#else
+		for (S32 i = 0; i < UUID_BYTES; ++i)
+		{
+			const S32 high = hex_value(hex[i * 2]);
+			const S32 low = hex_value(hex[i * 2 + 1]);
+			if (high < 0 || low < 0)
+			{
+				return false;
+			}
+			data[i] = (U8)((high << 4) | low);
+		}
+		return true;
+#endif
+	}
+
+	// The 32 digits of a UUID_STR_LENGTH or UUID_WRONG_FORMAT string. The
+	// dashes are skipped, not checked, as they always were; the broken
+	// format lacks the last one.
+	void gather_hex(const char* in_string, size_t length, char* hex)
+	{
+		memcpy(hex, in_string, 8);
+		memcpy(hex + 8, in_string + 9, 4);
+		memcpy(hex + 12, in_string + 14, 4);
+		if (length == UUID_STR_LENGTH)
+		{
+			memcpy(hex + 16, in_string + 19, 4);
+			memcpy(hex + 20, in_string + 24, 12);
+		}
+		else
+		{
+			memcpy(hex + 16, in_string + 19, 16);
+		}
+	}
+}
+// </polarity>
+
 /*
 
 NOT DONE YET!!!
@@ -151,33 +291,55 @@ U32 janky_fast_random_seeded_bytes(U32 seed, U32 val)
 // Common to all UUID implementations
 void LLUUID::toString(std::string& out) const
 {
-	out = llformat(
-		"%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
-		(U8)(mData[0]),
-		(U8)(mData[1]),
-		(U8)(mData[2]),
-		(U8)(mData[3]),
-		(U8)(mData[4]),
-		(U8)(mData[5]),
-		(U8)(mData[6]),
-		(U8)(mData[7]),
-		(U8)(mData[8]),
-		(U8)(mData[9]),
-		(U8)(mData[10]),
-		(U8)(mData[11]),
-		(U8)(mData[12]),
-		(U8)(mData[13]),
-		(U8)(mData[14]),
-		(U8)(mData[15]));
+	// <polarity> UUID fast paths
+	//out = llformat(
+	//	"%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
+	//	(U8)(mData[0]),
+	//	(U8)(mData[1]),
+	//	(U8)(mData[2]),
+	//	(U8)(mData[3]),
+	//	(U8)(mData[4]),
+	//	(U8)(mData[5]),
+	//	(U8)(mData[6]),
+	//	(U8)(mData[7]),
+	//	(U8)(mData[8]),
+	//	(U8)(mData[9]),
+	//	(U8)(mData[10]),
+	//	(U8)(mData[11]),
+	//	(U8)(mData[12]),
+	//	(U8)(mData[13]),
+	//	(U8)(mData[14]),
+	//	(U8)(mData[15]));
+	char buffer[UUID_STR_SIZE];
+	toString(buffer);
+	out.assign(buffer, UUID_STR_LENGTH);
+	// </polarity>
 }
 
-// *TODO: deprecate
+// <polarity> UUID fast paths
+//// *TODO: deprecate
+//void LLUUID::toString(char *out) const
+//{
+//	std::string buffer;
+//	toString(buffer);
+//	strcpy(out,buffer.c_str()); /* Flawfinder: ignore */
+//}
 void LLUUID::toString(char *out) const
 {
-	std::string buffer;
-	toString(buffer);
-	strcpy(out,buffer.c_str()); /* Flawfinder: ignore */
+	char hex[UUID_BYTES * 2];
+	encode_hex(mData, hex);
+	memcpy(out, hex, 8);
+	out[8] = '-';
+	memcpy(out + 9, hex + 8, 4);
+	out[13] = '-';
+	memcpy(out + 14, hex + 12, 4);
+	out[18] = '-';
+	memcpy(out + 19, hex + 16, 4);
+	out[23] = '-';
+	memcpy(out + 24, hex + 20, 12);
+	out[UUID_STR_LENGTH] = '\0';
 }
+// </polarity>
 
 void LLUUID::toCompressedString(std::string& out) const
 {
@@ -206,33 +368,207 @@ std::string LLUUID::asString() const
 	return str;
 }
 
+// <polarity> UUID fast paths
+//BOOL LLUUID::set(const char* in_string, BOOL emit)
+//{
+//	return set(ll_safe_string(in_string),emit);
+//}
+//
+//BOOL LLUUID::set(const std::string& in_string, BOOL emit)
+//{
+//	BOOL broken_format = FALSE;
+//
+//	// empty strings should make NULL uuid
+//	if (in_string.empty())
+//	{
+//		setNull();
+//		return TRUE;
+//	}
+//
+//	if (in_string.length() != UUID_STR_LENGTH)
+//	{
+//		// I'm a moron.  First implementation didn't have the right UUID format.
+//		// Shouldn't see any of these any more
+//		if (in_string.length() == UUID_WRONG_FORMAT)
+//		{
+//			if(emit)
+//			{
+//				LL_WARNS() << "Warning! Using broken UUID string format" << LL_ENDL;
+//			}
+//			broken_format = TRUE;
+//		}
+//		else
+//		{
+//			// Bad UUID string.  Spam as INFO, as most cases we don't care.
+//			if(emit)
+//			{
+//				//don't spam the logs because a resident can't spell.
+//				LL_WARNS() << "Bad UUID string: " << in_string << LL_ENDL;
+//			}
+//			setNull();
+//			return FALSE;
+//		}
+//	}
+//
+//	U8 cur_pos = 0;
+//	S32 i;
+//	for (i = 0; i < UUID_BYTES; i++)
+//	{
+//		if ((i == 4) || (i == 6) || (i == 8) || (i == 10))
+//		{
+//			cur_pos++;
+//			if (broken_format && (i==10))
+//			{
+//				// Missing - in the broken format
+//				cur_pos--;
+//			}
+//		}
+//
+//		mData[i] = 0;
+//
+//		if ((in_string[cur_pos] >= '0') && (in_string[cur_pos] <= '9'))
+//		{
+//			mData[i] += (U8)(in_string[cur_pos] - '0');
+//		}
+//		else if ((in_string[cur_pos] >= 'a') && (in_string[cur_pos] <='f'))
+//		{
+//			mData[i] += (U8)(10 + in_string[cur_pos] - 'a');
+//		}
+//		else if ((in_string[cur_pos] >= 'A') && (in_string[cur_pos] <='F'))
+//		{
+//			mData[i] += (U8)(10 + in_string[cur_pos] - 'A');
+//		}
+//		else
+//		{
+//			if(emit)
+//			{							
+//				LL_WARNS() << "Invalid UUID string character" << LL_ENDL;
+//			}
+//			setNull();
+//			return FALSE;
+//		}
+//
+//		mData[i] = mData[i] << 4;
+//		cur_pos++;
+//
+//		if ((in_string[cur_pos] >= '0') && (in_string[cur_pos] <= '9'))
+//		{
+//			mData[i] += (U8)(in_string[cur_pos] - '0');
+//		}
+//		else if ((in_string[cur_pos] >= 'a') && (in_string[cur_pos] <='f'))
+//		{
+//			mData[i] += (U8)(10 + in_string[cur_pos] - 'a');
+//		}
+//		else if ((in_string[cur_pos] >= 'A') && (in_string[cur_pos] <='F'))
+//		{
+//			mData[i] += (U8)(10 + in_string[cur_pos] - 'A');
+//		}
+//		else
+//		{
+//			if(emit)
+//			{
+//				LL_WARNS() << "Invalid UUID string character" << LL_ENDL;
+//			}
+//			setNull();
+//			return FALSE;
+//		}
+//		cur_pos++;
+//	}
+//
+//	return TRUE;
+//}
+//
+//BOOL LLUUID::validate(const std::string& in_string)
+//{
+//	BOOL broken_format = FALSE;
+//	if (in_string.length() != UUID_STR_LENGTH)
+//	{
+//		// I'm a moron.  First implementation didn't have the right UUID format.
+//		if (in_string.length() == UUID_WRONG_FORMAT)
+//		{
+//			broken_format = TRUE;
+//		}
+//		else
+//		{
+//			return FALSE;
+//		}
+//	}
+//
+//	U8 cur_pos = 0;
+//	for (U32 i = 0; i < 16; i++)
+//	{
+//		if ((i == 4) || (i == 6) || (i == 8) || (i == 10))
+//		{
+//			cur_pos++;
+//			if (broken_format && (i==10))
+//			{
+//				// Missing - in the broken format
+//				cur_pos--;
+//			}
+//		}
+//
+//		if ((in_string[cur_pos] >= '0') && (in_string[cur_pos] <= '9'))
+//		{
+//		}
+//		else if ((in_string[cur_pos] >= 'a') && (in_string[cur_pos] <='f'))
+//		{
+//		}
+//		else if ((in_string[cur_pos] >= 'A') && (in_string[cur_pos] <='F'))
+//		{
+//		}
+//		else
+//		{
+//			return FALSE;
+//		}
+//
+//		cur_pos++;
+//
+//		if ((in_string[cur_pos] >= '0') && (in_string[cur_pos] <= '9'))
+//		{
+//		}
+//		else if ((in_string[cur_pos] >= 'a') && (in_string[cur_pos] <='f'))
+//		{
+//		}
+//		else if ((in_string[cur_pos] >= 'A') && (in_string[cur_pos] <='F'))
+//		{
+//		}
+//		else
+//		{
+//			return FALSE;
+//		}
+//		cur_pos++;
+//	}
+//	return TRUE;
+//}
 BOOL LLUUID::set(const char* in_string, BOOL emit)
 {
-	return set(ll_safe_string(in_string),emit);
+	return set(in_string, in_string ? strlen(in_string) : 0, emit);
 }
 
 BOOL LLUUID::set(const std::string& in_string, BOOL emit)
 {
-	BOOL broken_format = FALSE;
+	return set(in_string.data(), in_string.length(), emit);
+}
 
+BOOL LLUUID::set(const char* in_string, size_t length, BOOL emit)
+{
 	// empty strings should make NULL uuid
-	if (in_string.empty())
+	if (!length)
 	{
 		setNull();
 		return TRUE;
 	}
 
-	if (in_string.length() != UUID_STR_LENGTH)
+	if (length != UUID_STR_LENGTH)
 	{
 		// I'm a moron.  First implementation didn't have the right UUID format.
 		// Shouldn't see any of these any more
-		if (in_string.length() == UUID_WRONG_FORMAT)
+		if (length == UUID_WRONG_FORMAT)
 		{
 			if(emit)
 			{
 				LL_WARNS() << "Warning! Using broken UUID string format" << LL_ENDL;
 			}
-			broken_format = TRUE;
 		}
 		else
 		{
@@ -240,143 +576,39 @@ BOOL LLUUID::set(const std::string& in_string, BOOL emit)
 			if(emit)
 			{
 				//don't spam the logs because a resident can't spell.
-				LL_WARNS() << "Bad UUID string: " << in_string << LL_ENDL;
+				LL_WARNS() << "Bad UUID string: " << std::string(in_string, length) << LL_ENDL;
 			}
 			setNull();
 			return FALSE;
 		}
 	}
 
-	U8 cur_pos = 0;
-	S32 i;
-	for (i = 0; i < UUID_BYTES; i++)
+	char hex[UUID_BYTES * 2];
+	gather_hex(in_string, length, hex);
+	if (!decode_hex(hex, mData))
 	{
-		if ((i == 4) || (i == 6) || (i == 8) || (i == 10))
-		{
-			cur_pos++;
-			if (broken_format && (i==10))
-			{
-				// Missing - in the broken format
-				cur_pos--;
-			}
-		}
-
-		mData[i] = 0;
-
-		if ((in_string[cur_pos] >= '0') && (in_string[cur_pos] <= '9'))
-		{
-			mData[i] += (U8)(in_string[cur_pos] - '0');
-		}
-		else if ((in_string[cur_pos] >= 'a') && (in_string[cur_pos] <='f'))
-		{
-			mData[i] += (U8)(10 + in_string[cur_pos] - 'a');
-		}
-		else if ((in_string[cur_pos] >= 'A') && (in_string[cur_pos] <='F'))
+		if(emit)
 		{
-			mData[i] += (U8)(10 + in_string[cur_pos] - 'A');
+			LL_WARNS() << "Invalid UUID string character" << LL_ENDL;
 		}
-		else
-		{
-			if(emit)
-			{							
-				LL_WARNS() << "Invalid UUID string character" << LL_ENDL;
-			}
-			setNull();
-			return FALSE;
-		}
-
-		mData[i] = mData[i] << 4;
-		cur_pos++;
-
-		if ((in_string[cur_pos] >= '0') && (in_string[cur_pos] <= '9'))
-		{
-			mData[i] += (U8)(in_string[cur_pos] - '0');
-		}
-		else if ((in_string[cur_pos] >= 'a') && (in_string[cur_pos] <='f'))
-		{
-			mData[i] += (U8)(10 + in_string[cur_pos] - 'a');
-		}
-		else if ((in_string[cur_pos] >= 'A') && (in_string[cur_pos] <='F'))
-		{
-			mData[i] += (U8)(10 + in_string[cur_pos] - 'A');
-		}
-		else
-		{
-			if(emit)
-			{
-				LL_WARNS() << "Invalid UUID string character" << LL_ENDL;
-			}
-			setNull();
-			return FALSE;
-		}
-		cur_pos++;
+		setNull();
+		return FALSE;
 	}
-
 	return TRUE;
 }
 
 BOOL LLUUID::validate(const std::string& in_string)
 {
-	BOOL broken_format = FALSE;
-	if (in_string.length() != UUID_STR_LENGTH)
-	{
-		// I'm a moron.  First implementation didn't have the right UUID format.
-		if (in_string.length() == UUID_WRONG_FORMAT)
-		{
-			broken_format = TRUE;
-		}
-		else
-		{
-			return FALSE;
-		}
-	}
-
-	U8 cur_pos = 0;
-	for (U32 i = 0; i < 16; i++)
+	if (in_string.length() != UUID_STR_LENGTH && in_string.length() != UUID_WRONG_FORMAT)
 	{
-		if ((i == 4) || (i == 6) || (i == 8) || (i == 10))
-		{
-			cur_pos++;
-			if (broken_format && (i==10))
-			{
-				// Missing - in the broken format
-				cur_pos--;
-			}
-		}
-
-		if ((in_string[cur_pos] >= '0') && (in_string[cur_pos] <= '9'))
-		{
-		}
-		else if ((in_string[cur_pos] >= 'a') && (in_string[cur_pos] <='f'))
-		{
-		}
-		else if ((in_string[cur_pos] >= 'A') && (in_string[cur_pos] <='F'))
-		{
-		}
-		else
-		{
-			return FALSE;
-		}
-
-		cur_pos++;
-
-		if ((in_string[cur_pos] >= '0') && (in_string[cur_pos] <= '9'))
-		{
-		}
-		else if ((in_string[cur_pos] >= 'a') && (in_string[cur_pos] <='f'))
-		{
-		}
-		else if ((in_string[cur_pos] >= 'A') && (in_string[cur_pos] <='F'))
-		{
-		}
-		else
-		{
-			return FALSE;
-		}
-		cur_pos++;
+		return FALSE;
 	}
-	return TRUE;
+	char hex[UUID_BYTES * 2];
+	U8 data[UUID_BYTES];
+	gather_hex(in_string.data(), in_string.length(), hex);
+	return decode_hex(hex, data);
 }
+// </polarity>
 
 const LLUUID& LLUUID::operator^=(const LLUUID& rhs)
 {
@@ -414,9 +646,14 @@ LLUUID LLUUID::combine(const LLUUID &other) const
 
 std::ostream& operator<<(std::ostream& s, const LLUUID &uuid)
 {
-	std::string uuid_str;
+	// <polarity> UUID fast paths
+	//std::string uuid_str;
+	//uuid.toString(uuid_str);
+	//s << uuid_str;
+	char uuid_str[UUID_STR_SIZE];
 	uuid.toString(uuid_str);
-	s << uuid_str;
+	s.write(uuid_str, UUID_STR_LENGTH);
+	// </polarity>
 	return s;
 }
 
@@ -429,7 +666,8 @@ std::istream& operator>>(std::istream &s, LLUUID &uuid)
 		s >> uuid_str[i];
 	}
 	uuid_str[i] = '\0';
-	uuid.set(std::string(uuid_str));
+	uuid.set(uuid_str, UUID_STR_LENGTH); // <polarity/>
+	//uuid.set(std::string(uuid_str));
 	return s;
 }
 
@@ -985,13 +1223,23 @@ LLUUID::LLUUID()
 // Compare
  bool LLUUID::operator==(const LLUUID& rhs) const
 {
-	return !memcmp(mData, rhs.mData, sizeof(mData)); // <alchemy/>
+	// <polarity> UUID fast paths
+	//return !memcmp(mData, rhs.mData, sizeof(mData)); // <alchemy/>
+#if LL_UUID_SSE2
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(load_uuid(mData), load_uuid(rhs.mData))) == 0xffff;
+#else
+	return !memcmp(mData, rhs.mData, sizeof(mData));
+#endif
+	// </polarity>
 }
 
 
  bool LLUUID::operator!=(const LLUUID& rhs) const
 {
-	return !!memcmp(mData, rhs.mData, sizeof(mData)); // <alchemy/>
+	// <polarity> UUID fast paths
+	//return !!memcmp(mData, rhs.mData, sizeof(mData)); // <alchemy/>
+	return !(*this == rhs);
+	// </polarity>
 }
 
 /*
@@ -1006,14 +1254,24 @@ LLUUID::LLUUID()
 
  BOOL LLUUID::notNull() const
 {
-	return !!memcmp(mData, nullUUID, sizeof(mData)); // <alchemy/>
+	// <polarity> UUID fast paths
+	//return !!memcmp(mData, nullUUID, sizeof(mData)); // <alchemy/>
+	return !isNull();
+	// </polarity>
 }
 
 // Faster than == LLUUID::null because doesn't require
 // as much memory access.
  BOOL LLUUID::isNull() const
 {
-	return !memcmp(mData, nullUUID, sizeof(mData)); // <alchemy/>
+	// <polarity> UUID fast paths
+	//return !memcmp(mData, nullUUID, sizeof(mData)); // <alchemy/>
+#if LL_UUID_SSE2
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(load_uuid(mData), _mm_setzero_si128())) == 0xffff;
+#else
+	return !memcmp(mData, nullUUID, sizeof(mData));
+#endif
+	// </polarity>
 }
 
 // Copy constructor
@@ -1058,30 +1316,45 @@ LLUUID::LLUUID()
 
 // IW: DON'T "optimize" these w/ U32s or you'll scoogie the sort order
 // IW: this will make me very sad
+// <polarity> UUID fast paths
+// Big endian 64-bit words sort the same as the bytes they are made of.
+// </polarity>
  bool LLUUID::operator<(const LLUUID &rhs) const
 {
-	U32 i;
-	for( i = 0; i < (UUID_BYTES - 1); i++ )
+	// <polarity> UUID fast paths
+	//U32 i;
+	//for( i = 0; i < (UUID_BYTES - 1); i++ )
+	//{
+	//	if( mData[i] != rhs.mData[i] )
+	//	{
+	//		return (mData[i] < rhs.mData[i]);
+	//	}
+	//}
+	//return (mData[UUID_BYTES - 1] < rhs.mData[UUID_BYTES - 1]);
+	const U64 high = load_big_endian(mData);
+	const U64 rhs_high = load_big_endian(rhs.mData);
+	if (high != rhs_high)
 	{
-		if( mData[i] != rhs.mData[i] )
-		{
-			return (mData[i] < rhs.mData[i]);
-		}
+		return high < rhs_high;
 	}
-	return (mData[UUID_BYTES - 1] < rhs.mData[UUID_BYTES - 1]);
+	return load_big_endian(mData + 8) < load_big_endian(rhs.mData + 8);
+	// </polarity>
 }
 
  bool LLUUID::operator>(const LLUUID &rhs) const
 {
-	U32 i;
-	for( i = 0; i < (UUID_BYTES - 1); i++ )
-	{
-		if( mData[i] != rhs.mData[i] )
-		{
-			return (mData[i] > rhs.mData[i]);
-		}
-	}
-	return (mData[UUID_BYTES - 1] > rhs.mData[UUID_BYTES - 1]);
+	// <polarity> UUID fast paths
+	//U32 i;
+	//for( i = 0; i < (UUID_BYTES - 1); i++ )
+	//{
+	//	if( mData[i] != rhs.mData[i] )
+	//	{
+	//		return (mData[i] > rhs.mData[i]);
+	//	}
+	//}
+	//return (mData[UUID_BYTES - 1] > rhs.mData[UUID_BYTES - 1]);
+	return rhs < *this;
+	// </polarity>
 }
 
  U16 LLUUID::getCRC16() const
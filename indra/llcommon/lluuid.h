@@ -26,6 +26,7 @@
 #ifndef LL_LLUUID_H
 #define LL_LLUUID_H
 
+#include <cstring> // <polarity/>
 #include <iostream>
 #include <set>
 #include <vector>
@@ -74,6 +75,7 @@ public:
 
 	BOOL	set(const char *in_string, BOOL emit = TRUE);	// Convert from string, if emit is FALSE, do not emit warnings
 	BOOL	set(const std::string& in_string, BOOL emit = TRUE);	// Convert from string, if emit is FALSE, do not emit warnings
+	BOOL	set(const char* in_string, size_t length, BOOL emit = TRUE); // <polarity/> Same, without making a std::string first
 	void	setNull();					// Faster than setting to LLUUID::null.
 
     S32     cmpTime(uuid_time_t *t1, uuid_time_t *t2);
@@ -112,7 +114,10 @@ public:
 	friend LL_COMMON_API std::ostream&	 operator<<(std::ostream& s, const LLUUID &uuid);
 	friend LL_COMMON_API std::istream&	 operator>>(std::istream& s, LLUUID &uuid);
 
-	void toString(char *out) const;		// Does not allocate memory, needs 36 characters (including \0)
+	// <polarity> UUID fast paths
+	//void toString(char *out) const;		// Does not allocate memory, needs 36 characters (including \0)
+	void toString(char *out) const;		// Does not allocate memory, needs UUID_STR_SIZE (37) characters (including \0)
+	// </polarity>
 	void toString(std::string& out) const;
 	void toCompressedString(char *out) const;	// Does not allocate memory, needs 17 characters (including \0)
 	void toCompressedString(std::string& out) const;
@@ -125,17 +130,31 @@ public:
 
 	inline size_t hash() const
 	{
-		size_t seed = 0;
-		// I have a feeling that making this number memsize-type will break LLUUID
-		constexpr auto kMagicConstant = 0x9e3779b9; //-V104
-		for (U8 i = 0; i < 4; ++i) //-V112
-		{
-			seed ^= static_cast<size_t>(mData[i * 4]) + kMagicConstant + (seed << 6) + (seed >> 2);
-			seed ^= static_cast<size_t>(mData[i * 4 + 1]) + kMagicConstant + (seed << 6) + (seed >> 2);
-			seed ^= static_cast<size_t>(mData[i * 4 + 2]) + kMagicConstant + (seed << 6) + (seed >> 2);
-			seed ^= static_cast<size_t>(mData[i * 4 + 3]) + kMagicConstant + (seed << 6) + (seed >> 2);
-		}
-		return seed;
+		// <polarity> UUID fast paths
+		//size_t seed = 0;
+		//// I have a feeling that making this number memsize-type will break LLUUID
+		//constexpr auto kMagicConstant = 0x9e3779b9; //-V104
+		//for (U8 i = 0; i < 4; ++i) //-V112
+		//{
+		//	seed ^= static_cast<size_t>(mData[i * 4]) + kMagicConstant + (seed << 6) + (seed >> 2);
+		//	seed ^= static_cast<size_t>(mData[i * 4 + 1]) + kMagicConstant + (seed << 6) + (seed >> 2);
+		//	seed ^= static_cast<size_t>(mData[i * 4 + 2]) + kMagicConstant + (seed << 6) + (seed >> 2);
+		//	seed ^= static_cast<size_t>(mData[i * 4 + 3]) + kMagicConstant + (seed << 6) + (seed >> 2);
+		//}
+		//return seed;
+		// Both halves through the murmur3 finalizer: a few multiplies instead
+		// of sixteen dependent steps, and every bit of the id reaches every
+		// bit of the result.
+		U64 words[2];
+		memcpy(words, mData, sizeof(words));
+		U64 hash = words[0] ^ (words[1] * 0x9e3779b97f4a7c15ULL);
+		hash ^= hash >> 33;
+		hash *= 0xff51afd7ed558ccdULL;
+		hash ^= hash >> 33;
+		hash *= 0xc4ceb9fe1a85ec53ULL;
+		hash ^= hash >> 33;
+		return (size_t)hash;
+		// </polarity>
 	}
 
 	static BOOL validate(const std::string& in_string); // Validate that the UUID string is legal.
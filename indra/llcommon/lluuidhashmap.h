@@ -0,0 +1,354 @@
+/**
+ * @file lluuidhashmap.h
+ * @brief Open addressed hash map keyed on LLUUID.
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLUUIDHASHMAP_H
+#define LL_LLUUIDHASHMAP_H
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "lluuid.h"
+
+//-----------------------------------------------------------------------------
+// class LLUUIDHashMap
+// Drop-in replacement for std::map<LLUUID, T> where nothing depends on the
+// iteration order. Entries live in one flat array and are found by linear
+// probing from the key's hash, so a lookup is usually a single cache miss
+// instead of a walk down a red-black tree of separately allocated nodes.
+// Erasing shifts the rest of the probe run back, so there are no tombstones
+// and lookups never slow down after lots of removals. Iteration starts just
+// after a free slot, so no probe run is split between its end and its start,
+// and erase(iterator) can hand back the next entry like std::map's does.
+//
+// Differences from std::map worth knowing about:
+// - iteration order is unspecified and changes when the table grows,
+// - inserting may invalidate every iterator, reference and pointer into
+//   the map, erasing invalidates those at and after the erased slot except
+//   for the iterator erase() returns,
+// - T must be default constructible and cheap to default construct, since
+//   empty slots hold a T too.
+//-----------------------------------------------------------------------------
+template <typename T>
+class LLUUIDHashMap
+{
+public:
+	typedef LLUUID key_type;
+	typedef T mapped_type;
+	typedef std::pair<LLUUID, T> value_type;	// the key must not be changed through an iterator
+	typedef size_t size_type;
+
+private:
+	// mPosition counts slots from mStart, the end is at capacity
+	template <typename MAP, typename VALUE>
+	class iterator_base
+	{
+		friend class LLUUIDHashMap;
+
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef typename std::remove_const<VALUE>::type value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef VALUE* pointer;
+		typedef VALUE& reference;
+
+		iterator_base() : mMap(NULL), mPosition(0) {}
+		// iterator converts to const_iterator
+		template <typename OMAP, typename OVALUE>
+		iterator_base(const iterator_base<OMAP, OVALUE>& other) : mMap(other.mMap), mPosition(other.mPosition) {}
+
+		VALUE& operator*() const	{ return mMap->mSlots[mMap->slotAt(mPosition)]; }
+		VALUE* operator->() const	{ return &mMap->mSlots[mMap->slotAt(mPosition)]; }
+
+		iterator_base& operator++()
+		{
+			mPosition = mMap->nextUsed(mPosition + 1);
+			return *this;
+		}
+		iterator_base operator++(int)
+		{
+			iterator_base old(*this);
+			++*this;
+			return old;
+		}
+
+		template <typename OMAP, typename OVALUE>
+		bool operator==(const iterator_base<OMAP, OVALUE>& other) const { return mPosition == other.mPosition; }
+		template <typename OMAP, typename OVALUE>
+		bool operator!=(const iterator_base<OMAP, OVALUE>& other) const { return mPosition != other.mPosition; }
+
+	private:
+		template <typename OMAP, typename OVALUE> friend class iterator_base;
+
+		iterator_base(MAP* map, size_t position) : mMap(map), mPosition(position) {}
+
+		MAP*	mMap;
+		size_t	mPosition;
+	};
+
+public:
+	typedef iterator_base<LLUUIDHashMap, value_type> iterator;
+	typedef iterator_base<const LLUUIDHashMap, const value_type> const_iterator;
+
+	LLUUIDHashMap() : mSize(0), mMask(0), mStart(0) {}
+
+	iterator begin()				{ return iterator(this, nextUsed(0)); }
+	iterator end()					{ return iterator(this, mSlots.size()); }
+	const_iterator begin() const	{ return const_iterator(this, nextUsed(0)); }
+	const_iterator end() const		{ return const_iterator(this, mSlots.size()); }
+
+	size_type size() const			{ return mSize; }
+	bool empty() const				{ return mSize == 0; }
+
+	// make room for count entries without growing again
+	void reserve(size_type count)
+	{
+		size_t capacity = MIN_CAPACITY;
+		while (count > maxLoad(capacity))
+		{
+			capacity <<= 1;
+		}
+		if (capacity > mSlots.size())
+		{
+			rehash(capacity);
+		}
+	}
+
+	void clear()
+	{
+		std::vector<value_type>().swap(mSlots);
+		std::vector<U8>().swap(mUsed);
+		mSize = 0;
+		mMask = 0;
+		mStart = 0;
+	}
+
+	void swap(LLUUIDHashMap& other)
+	{
+		mSlots.swap(other.mSlots);
+		mUsed.swap(other.mUsed);
+		std::swap(mSize, other.mSize);
+		std::swap(mMask, other.mMask);
+		std::swap(mStart, other.mStart);
+	}
+
+	iterator find(const LLUUID& key)
+	{
+		return iterator(this, positionOf(findIndex(key)));
+	}
+
+	const_iterator find(const LLUUID& key) const
+	{
+		return const_iterator(this, positionOf(findIndex(key)));
+	}
+
+	size_type count(const LLUUID& key) const
+	{
+		return findIndex(key) != mSlots.size() ? 1 : 0;
+	}
+
+	std::pair<iterator, bool> insert(const value_type& value)
+	{
+		bool inserted;
+		size_t index = findOrInsert(value.first, inserted);
+		if (inserted)
+		{
+			mSlots[index].second = value.second;
+		}
+		return std::make_pair(iterator(this, positionOf(index)), inserted);
+	}
+
+	T& operator[](const LLUUID& key)
+	{
+		bool inserted;
+		return mSlots[findOrInsert(key, inserted)].second;
+	}
+
+	size_type erase(const LLUUID& key)
+	{
+		size_t index = findIndex(key);
+		if (index == mSlots.size())
+		{
+			return 0;
+		}
+		eraseIndex(index);
+		return 1;
+	}
+
+	// returns the entry after iter, which may have been moved into its slot
+	iterator erase(iterator iter)
+	{
+		eraseIndex(slotAt(iter.mPosition));
+		return iterator(this, nextUsed(iter.mPosition));
+	}
+
+	// the ids are random, so mixing two words of it is all the hashing it needs
+	static size_t hash(const LLUUID& key)
+	{
+		U64 words[2];
+		memcpy(words, key.mData, sizeof(words));
+		U64 h = (words[0] ^ (words[1] * 0x9e3779b97f4a7c15ULL)) * 0xff51afd7ed558ccdULL;
+		return (size_t)(h ^ (h >> 32));
+	}
+
+private:
+	enum { MIN_CAPACITY = 16 };
+
+	// at most 3/4 full, linear probing degrades quickly past that
+	static size_t maxLoad(size_t capacity) { return capacity - (capacity >> 2); }
+
+	size_t slotAt(size_t position) const { return (mStart + position) & mMask; }
+
+	// the end stays at capacity
+	size_t positionOf(size_t index) const { return index == mSlots.size() ? index : (index - mStart) & mMask; }
+
+	size_t nextUsed(size_t position) const
+	{
+		const size_t capacity = mUsed.size();
+		while (position < capacity && !mUsed[slotAt(position)])
+		{
+			++position;
+		}
+		return position;
+	}
+
+	// start iterating just after the free slot at or after index
+	void moveStart(size_t index)
+	{
+		while (mUsed[index])
+		{
+			index = (index + 1) & mMask;
+		}
+		mStart = (index + 1) & mMask;
+	}
+
+	size_t findIndex(const LLUUID& key) const
+	{
+		if (mSize == 0)
+		{
+			return mSlots.size();
+		}
+		for (size_t index = hash(key) & mMask; mUsed[index]; index = (index + 1) & mMask)
+		{
+			if (mSlots[index].first == key)
+			{
+				return index;
+			}
+		}
+		return mSlots.size();
+	}
+
+	size_t findOrInsert(const LLUUID& key, bool& inserted)
+	{
+		if (mSize + 1 > maxLoad(mSlots.size()))
+		{
+			rehash(mSlots.empty() ? (size_t)MIN_CAPACITY : mSlots.size() << 1);
+		}
+		size_t index = hash(key) & mMask;
+		for (; mUsed[index]; index = (index + 1) & mMask)
+		{
+			if (mSlots[index].first == key)
+			{
+				inserted = false;
+				return index;
+			}
+		}
+		mUsed[index] = 1;
+		mSlots[index].first = key;
+		++mSize;
+		inserted = true;
+		if (index == ((mStart - 1) & mMask))
+		{
+			moveStart(index);
+		}
+		return index;
+	}
+
+	void eraseIndex(size_t hole)
+	{
+		// pull back every entry of the run that would not be found from
+		// its home slot any more once the hole is there
+		for (size_t index = (hole + 1) & mMask; mUsed[index]; index = (index + 1) & mMask)
+		{
+			const size_t home = hash(mSlots[index].first) & mMask;
+			if (((index - home) & mMask) >= ((index - hole) & mMask))
+			{
+				mSlots[hole] = mSlots[index];
+				hole = index;
+			}
+		}
+		mUsed[hole] = 0;
+		mSlots[hole] = value_type();
+		--mSize;
+	}
+
+	void rehash(size_t capacity)
+	{
+		std::vector<value_type> old_slots(capacity);
+		std::vector<U8> old_used(capacity, 0);
+		old_slots.swap(mSlots);
+		old_used.swap(mUsed);
+		mMask = capacity - 1;
+
+		for (size_t i = 0; i < old_used.size(); ++i)
+		{
+			if (old_used[i])
+			{
+				size_t index = hash(old_slots[i].first) & mMask;
+				while (mUsed[index])
+				{
+					index = (index + 1) & mMask;
+				}
+				mUsed[index] = 1;
+				mSlots[index].first = old_slots[i].first;
+				std::swap(mSlots[index].second, old_slots[i].second);
+			}
+		}
+		moveStart(0);
+	}
+
+	std::vector<value_type>	mSlots;
+	std::vector<U8>			mUsed;
+	size_t					mSize;
+	size_t					mMask;	// capacity - 1, capacity is a power of two
+	size_t					mStart;	// where iteration starts, the slot before it is free
+};
+
+// llstl.h helpers for the same lookups
+template <typename T>
+inline T* get_ptr_in_map(const LLUUIDHashMap<T*>& inmap, const LLUUID& key)
+{
+	typename LLUUIDHashMap<T*>::const_iterator iter = inmap.find(key);
+	return iter == inmap.end() ? NULL : iter->second;
+}
+
+template <typename T>
+inline bool is_in_map(const LLUUIDHashMap<T>& inmap, const LLUUID& key)
+{
+	return inmap.find(key) != inmap.end();
+}
+
+#endif // LL_LLUUIDHASHMAP_H
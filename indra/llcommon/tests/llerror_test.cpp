@@ -35,6 +35,9 @@
 
 #include "../llerrorcontrol.h"
 #include "../llsd.h"
+#include "../lltimer.h" // <polarity/>
+#include <boost/bind.hpp> // <polarity/>
+#include <boost/thread.hpp> // <polarity/>
 
 #include "../test/lltut.h"
 
@@ -769,6 +772,90 @@ namespace tut
 		ensure_message_contains(8, "big easy");
 		ensure_message_count(9);
 	}
+
+	template<> template<>
+		// asynchronous logging keeps the order and writes out before fatal messages
+	void ErrorTestObject::test<17>()
+	{
+		LLError::setAsyncLogging(true);
+		LL_INFOS() << "first" << LL_ENDL;
+		for (int i = 0; i < 3; ++i)
+		{
+			LL_INFOS_ONCE() << "once" << LL_ENDL;
+		}
+		LL_WARNS() << "second" << LL_ENDL;
+		LL_ERRS() << "third" << LL_ENDL;
+		ensure_message_contains(0, "first");
+		ensure_message_contains(1, "ONCE: once");
+		ensure_message_contains(2, "second");
+		ensure_message_contains(3, "error");
+		ensure_message_contains(4, "third");
+		ensure_message_count(5);
+
+		LL_DEBUGS() << "fourth" << LL_ENDL;
+		LLError::setAsyncLogging(false);
+		ensure_message_contains(5, "fourth");
+		ensure_message_count(6);
+		ensure("async off", !LLError::getAsyncLogging());
+	}
+
+	// takes its time over every message, the log writer thread holds the
+	// log mutex all the while
+	class SlowRecorder : public LLError::Recorder
+	{
+	public:
+		SlowRecorder() { mWantsTime = false; }
+
+		virtual void recordMessage(LLError::ELevel level, const std::string& message)
+		{
+			ms_sleep(20);
+		}
+	};
+
+	template<> template<>
+		// a fatal message waits for the log writer thread instead of being dropped
+	void ErrorTestObject::test<18>()
+	{
+		LLError::RecorderPtr slow(new SlowRecorder());
+		LLError::addRecorder(slow);
+		LLError::setAsyncLogging(true);
+		for (int i = 0; i < 10; ++i)
+		{
+			LL_INFOS() << "queued " << i << LL_ENDL;
+		}
+		// the writer is well into the batch by now
+		ms_sleep(60);
+		LL_ERRS() << "fatal" << LL_ENDL;
+		ensure("fatal function called", fatalWasCalled);
+		ensure_message_contains(9, "queued 9");
+		ensure_message_contains(11, "fatal");
+		ensure_message_count(12);
+
+		LLError::setAsyncLogging(false);
+		LLError::removeRecorder(slow);
+	}
+
+	void log_from_thread(int i)
+	{
+		LL_INFOS() << "from thread " << i << LL_ENDL;
+	}
+
+	template<> template<>
+		// what a thread queued is still written out after the thread ends
+	void ErrorTestObject::test<19>()
+	{
+		LLError::setAsyncLogging(true);
+		for (int i = 0; i < 3; ++i)
+		{
+			boost::thread thread(boost::bind(log_from_thread, i));
+			thread.join();
+		}
+		LLError::setAsyncLogging(false);
+		ensure_message_contains(0, "from thread 0");
+		ensure_message_contains(1, "from thread 1");
+		ensure_message_contains(2, "from thread 2");
+		ensure_message_count(3);
+	}
 }
 
 /* Tests left:
@@ -792,6 +792,50 @@ namespace tut
     }
 }
 
+// <polarity> Pooled coroutine stacks
+namespace tut
+{
+    void recordStack(void** where)
+    {
+        int local = 0;
+        *where = &local;
+        suspendUntilEventOn("pooled");
+    }
+
+    template<> template<>
+    void object::test<24>()
+    {
+        set_test_name("pooled stacks");
+        LLEventPump& pooled(LLEventPumps::instance().obtain("pooled"));
+        LLEventPump& mainloop(LLEventPumps::instance().obtain("mainloop"));
+        // start with an empty pool, whatever earlier tests left behind
+        mainloop.post(LLSD());
+        LLCoros::instance().setStackPoolSize(0);
+        LLCoros::instance().setStackPoolSize(4);
+
+        void* first = NULL;
+        void* second = NULL;
+        LLCoros::instance().launch("pooled", boost::bind(recordStack, &first));
+        LLCoros::instance().launch("pooled", boost::bind(recordStack, &second));
+        ensure("both running", first && second);
+        ensure("own stacks", first != second);
+        pooled.post(LLSD());
+        // cleanup() pools the stacks on the next tick
+        mainloop.post(LLSD());
+
+        void* third = NULL;
+        LLCoros::instance().launch("pooled", boost::bind(recordStack, &third), 512*1024);
+        void* fourth = NULL;
+        LLCoros::instance().launch("pooled", boost::bind(recordStack, &fourth));
+        ensure("other size, other stack", third != first && third != second);
+        ensure("reused", fourth == first || fourth == second);
+        pooled.post(LLSD());
+        mainloop.post(LLSD());
+        LLCoros::instance().logStackStats();
+    }
+} // namespace tut
+// </polarity>
+
 /*==========================================================================*|
 #include <boost/context/guarded_stack_allocator.hpp>
 
@@ -0,0 +1,194 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/**
+ * @file llframearena_test.cpp
+ * @brief Test and timings of LLFrameArena
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include <iostream>
+#include <list>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+#include "../llframearena.h"
+#include "../lltimer.h"
+
+#include "../test/lltut.h"
+
+namespace
+{
+	typedef std::vector<F32, LLFrameAllocator<F32> > frame_vector_t;
+	typedef std::list<U64, LLFrameAllocator<U64> > frame_list_t;
+
+	void check_no_arena(bool* no_arena)
+	{
+		*no_arena = LLFrameArena::getThreadArena() == NULL && LLFrameAllocator<F32>().getArena() == NULL;
+		// falls back to the heap
+		frame_vector_t values(1000, 1.f);
+		*no_arena = *no_arena && values[999] == 1.f;
+	}
+
+	// what a frame of the deferred light loop does
+	template<typename VECTOR, typename LIST>
+	F32 fill_frame(S32 lights)
+	{
+		VECTOR points;
+		LIST colors;
+		for (S32 i = 0; i < lights; ++i)
+		{
+			points.push_back((F32)i);
+			colors.push_back(i);
+		}
+		F32 sum = 0.f;
+		for (typename VECTOR::const_iterator iter = points.begin(); iter != points.end(); ++iter)
+		{
+			sum += *iter;
+		}
+		return sum + (F32)colors.size();
+	}
+}
+
+namespace tut
+{
+	struct llframearena_data
+	{
+	};
+	typedef test_group<llframearena_data> llframearena_group;
+	typedef llframearena_group::object object;
+	llframearena_group framearenagrp("llframearena");
+
+	template<> template<>
+	void object::test<1>()
+	{
+		set_test_name("allocations are aligned and taken back on newFrame()");
+
+		LLFrameArena::newFrame();
+		LLFrameArena* arena = LLFrameArena::getThreadArena();
+		ensure("arena", arena != NULL);
+		LLFrameArena::newFrame();
+
+		char* first = (char*)arena->allocate(3, 1);
+		char* second = (char*)arena->allocate(8, 8);
+		ensure("aligned", ((uintptr_t)second & 7) == 0);
+		ensure("bumped", second >= first + 3 && second < first + 16);
+		char* wide = (char*)arena->allocate(16, 64);
+		ensure("aligned wide", ((uintptr_t)wide & 63) == 0);
+
+		// only the newest one comes back
+		arena->deallocate(second, 8);
+		ensure("not the newest", arena->allocate(1, 1) > wide);
+		arena->deallocate(wide, 16);
+
+		LLFrameArena::newFrame();
+		ensure("reset", arena->allocate(3, 1) == first);
+		LLFrameArena::newFrame();
+		LLFrameArena::Stats stats;
+		LLFrameArena::getStats(stats);
+		ensure_equals("last frame", stats.mLastFrameBytes, (U64)3);
+	}
+
+	template<> template<>
+	void object::test<2>()
+	{
+		set_test_name("a frame bigger than the arena");
+
+		LLFrameArena::newFrame();
+		LLFrameArena::Stats before;
+		LLFrameArena::getStats(before);
+
+		const size_t big = (size_t)before.mReservedBytes;
+		for (S32 i = 0; i < 3; ++i)
+		{
+			memset(LLFrameArena::getThreadArena()->allocate(big, 16), i, big);
+		}
+		LLFrameArena::newFrame();
+		LLFrameArena::Stats grown;
+		LLFrameArena::getStats(grown);
+		ensure_equals("grew once", grown.mGrownFrames, before.mGrownFrames + 1);
+		ensure("took it all", grown.mLastFrameBytes >= 3 * big);
+		ensure("one block for all of it", grown.mReservedBytes >= grown.mLastFrameBytes);
+
+		// fits now
+		for (S32 i = 0; i < 3; ++i)
+		{
+			LLFrameArena::getThreadArena()->allocate(big, 16);
+		}
+		LLFrameArena::newFrame();
+		LLFrameArena::getStats(grown);
+		ensure_equals("did not grow again", grown.mGrownFrames, before.mGrownFrames + 1);
+	}
+
+	template<> template<>
+	void object::test<3>()
+	{
+		set_test_name("containers");
+
+		LLFrameArena::newFrame();
+		frame_vector_t values;
+		for (S32 i = 0; i < 10000; ++i)
+		{
+			values.push_back((F32)i);
+		}
+		frame_list_t list(values.begin(), values.end());
+		frame_vector_t copy(values);
+		ensure_equals("size", list.size(), (size_t)10000);
+		ensure("same arena", copy.get_allocator() == values.get_allocator());
+		ensure_equals("last", copy.back(), 9999.f);
+		ensure_equals("list last", list.back(), (U64)9999);
+
+		bool no_arena = false;
+		boost::thread other(boost::bind(&check_no_arena, &no_arena));
+		other.join();
+		ensure("heap on a thread without an arena", no_arena);
+	}
+
+	template<> template<>
+	void object::test<4>()
+	{
+		set_test_name("frame timings");
+
+		const S32 FRAMES = 20000;
+		const S32 LIGHTS = 64;
+		F64 sum = 0.0;
+
+		LLTimer timer;
+		for (S32 frame = 0; frame < FRAMES; ++frame)
+		{
+			sum += fill_frame<std::vector<F32>, std::list<U64> >(LIGHTS);
+		}
+		const F64 heap = timer.getElapsedTimeAndResetF64();
+		for (S32 frame = 0; frame < FRAMES; ++frame)
+		{
+			LLFrameArena::newFrame();
+			sum -= fill_frame<frame_vector_t, frame_list_t>(LIGHTS);
+		}
+		const F64 arena = timer.getElapsedTimeF64();
+		ensure_equals("same work", sum, 0.0);
+
+		std::cout << "\n" << FRAMES << " frames of " << LIGHTS << " lights: heap " << heap * 1000.0
+				  << " ms, frame arena " << arena * 1000.0 << " ms" << std::endl;
+		LLFrameArena::logStats();
+	}
+}
@@ -56,6 +56,7 @@ using namespace boost::phoenix;
 #include "../llsdserialize.h"
 #include "llsdutil.h"
 #include "../llformat.h"
+#include "../lltimer.h" // <polarity/> Fast LLSD XML reader
 
 #include "../test/lltut.h"
 #include "../test/namedtempfile.h"
@@ -715,6 +716,238 @@ namespace tut
 			expected,
 			1);
 	}
+	// <polarity> Fast LLSD XML reader
+	namespace
+	{
+		struct XMLParseResult
+		{
+			LLSD		mData;
+			S32			mCount;
+			std::string	mRest;		// what is left in the stream
+			bool		mGood;
+		};
+
+		XMLParseResult parse_xml(const std::string& xml, bool fast, bool lines)
+		{
+			const bool was_fast = LLSDXMLParser::getFastParse();
+			LLSDXMLParser::setFastParse(fast);
+			std::istringstream input(xml);
+			LLPointer<LLSDXMLParser> parser = new LLSDXMLParser;
+			XMLParseResult result;
+			result.mCount = lines ? parser->parseLines(input, result.mData) : parser->parse(input, result.mData, (S32)xml.size());
+			result.mGood = input.good();
+			if (input.good())
+			{
+				result.mRest.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+			}
+			LLSDXMLParser::setFastParse(was_fast);
+			return result;
+		}
+
+		// an inventory response about the size of a big AIS fetch
+		LLSD make_inventory(S32 items)
+		{
+			LLSD folder;
+			folder["name"] = "Objects";
+			folder["folder_id"] = LLUUID("4dc7e3e2-3e2a-4b52-8cd5-70f2db1e5a51");
+			folder["version"] = 1234;
+			LLSD& contents = folder["items"];
+			for (S32 i = 0; i < items; ++i)
+			{
+				LLSD item;
+				item["name"] = llformat("Item %d <copy> & \"more\"", i);
+				item["desc"] = "(No Description)";
+				item["item_id"] = LLUUID::generateNewID();
+				item["asset_id"] = LLUUID::generateNewID();
+				item["type"] = 6;
+				item["inv_type"] = 6;
+				item["flags"] = (S32)(i * 7919);
+				item["created_at"] = 1500000000 + i;
+				item["sale_price"] = 10.0 + i * 0.25;
+				item["permissions"]["owner_mask"] = (S32)0x7fffffff;
+				item["permissions"]["is_owner_group"] = false;
+				contents.append(item);
+			}
+			return folder;
+		}
+	}
+
+	template<> template<>
+	void TestLLSDXMLParsingObject::test<5>()
+	{
+		// the fast reader and expat agree, on what they return and on where
+		// they leave the stream, whichever of them ends up reading
+		static const char* const DOCUMENTS[] =
+		{
+			"",
+			"\n\n",
+			"<llsd/>",
+			"<llsd></llsd>\n<llsd><integer>2</integer></llsd>",
+			"<llsd><undef/></llsd>",
+			"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<llsd>\n<map>\n<key>a</key>\n<integer>1</integer>\n</map>\n</llsd>\n",
+			" <?xml version=\"1.0\"?><llsd><integer>1</integer></llsd>",
+			"<llsd><map><key>amy</key><integer>23</integer><key>bob</key><bigint>9</bigint></map></llsd>",
+			"<llsd><map><key>amy</key><integer>23</integer><string>ha ha</string></map></llsd>",
+			"<llsd><map><key></key><integer>23</integer><key>b</key><integer>1</integer></map></llsd>",
+			"<llsd><map><key>a</key></map></llsd>",
+			"<llsd><array><integer>1</integer><llsd><integer>2</integer></llsd></array></llsd>",
+			"<llsd><integer>1</integer><integer>2</integer></llsd>",
+			"<llsd>text<integer>1</integer></llsd>",
+			"<string>ha ha</string>",
+			"<llsd><string>ha ha</string>",
+			"<llsd><string>ha ha</str></llsd>",
+			"<llsd><string>a <b>c</b></string></llsd>",
+			"<llsd><!-- note --><integer>1</integer></llsd>",
+			"<llsd><string><![CDATA[<x>]]></string></llsd>",
+			"<!DOCTYPE llsd><llsd><integer>1</integer></llsd>",
+			"\xef\xbb\xbf<llsd><integer>1</integer></llsd>",
+			"<llsd><string>a]]>b</string></llsd>",
+			"<llsd><string>a]]b]></string></llsd>",
+			"<llsd><string>&lt;&gt;&amp;&apos;&quot;&#65;&#x42;&#x20AC;&#128512;</string></llsd>",
+			"<llsd><string>&nbsp;</string></llsd>",
+			"<llsd><string>&#0;</string></llsd>",
+			"<llsd><string>&#xD800;</string></llsd>",
+			"<llsd><string>a\r\nb\rc\nd\te</string></llsd>",
+			"<llsd><string>a\x01" "b</string></llsd>",
+			"<llsd><string>caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80</string></llsd>",
+			"<llsd><string>bad \xc3</string></llsd>",
+			"<llsd><string>overlong \xc0\xaf</string></llsd>",
+			"<llsd><string>surrogate \xed\xa0\x80</string></llsd>",
+			"<llsd><string>\xef\xbf\xbe</string></llsd>",
+			"<llsd><string/></llsd>",
+			"<llsd><string  >a</string  ></llsd>",
+			"<llsd><array><boolean>true</boolean><boolean>1</boolean><boolean>TRUE</boolean><boolean> true</boolean><boolean/></array></llsd>",
+			"<llsd><array><integer>12</integer><integer>-7</integer><integer>+7</integer><integer>  42</integer><integer>2147483647</integer>"
+				"<integer>2147483648</integer><integer>-2147483648</integer><integer>12abc</integer><integer>abc</integer><integer>0x10</integer>"
+				"<integer>007</integer><integer>1234567890</integer><integer/><integer>1.5</integer></array></llsd>",
+			"<llsd><array><real>1.23</real><real>-0</real><real>0.1</real><real>1e22</real><real>1e23</real><real>1e-22</real><real>1e400</real>"
+				"<real>123456789012345678</real><real>.5</real><real>5.</real><real> 1.5</real><real>1.5 </real><real>abc</real><real>1e</real>"
+				"<real>-</real><real/><real>3.1415926535897931159979634685441851615905761718750</real><real>0.30000000000000004</real>"
+				"<real>+2.5E+3</real><real>1.7976931348623157e308</real><real>4.9e-324</real><real>000000000000000000001.5</real></array></llsd>",
+			"<llsd><array><uuid>4dc7e3e2-3e2a-4b52-8cd5-70f2db1e5a51</uuid><uuid/><uuid>nonsense</uuid>"
+				"<uuid>4DC7E3E2-3E2A-4B52-8CD5-70F2DB1E5A51</uuid></array></llsd>",
+			"<llsd><array><date>2018-05-06T07:08:09Z</date><date>2018-05-06T07:08:09.25Z</date><date/><date>never</date>"
+				"<uri>http://example.com/?a=1&amp;b=2</uri><uri/></array></llsd>",
+			"<llsd><binary encoding=\"base64\">aGVs\n bG8=</binary></llsd>",
+			"<llsd><binary encoding='base64'>aGVsbG8=</binary></llsd>",
+			"<llsd><binary>aGVsbG8=</binary></llsd>",
+			"<llsd><binary encoding=\"base85\">aGVsbG8=</binary></llsd>",
+			"<llsd><binary encoding=\"base64\" x=\"1\">aGVsbG8=</binary></llsd>",
+			"<llsd><binary/></llsd>",
+			"<llsd><map extra=\"a &amp; b\"><key>a</key><integer>1</integer></map></llsd>",
+			"<llsd><map extra=\"a < b\"><key>a</key><integer>1</integer></map></llsd>",
+			"<llsd><array><array><array/></array><map/></array></llsd>",
+			"<llsd><map><key>a</key><map><key>b</key><array><integer>1</integer></array></map></map></llsd>",
+			"<llsd><map>\n\t<key>a &amp; b</key>\n\t<integer>1</integer>\n\t<key>a</key>\n\t<integer>2</integer>\n\t<key>a</key>\n\t<integer>3</integer>\n</map>\n</llsd>\r\n\r\n<llsd><integer>4</integer></llsd>",
+			"<llsd><integer>1</integer></llsd>trailing junk",
+			"<llsd><integer>1</integer></llsd>\r\n\n\r<llsd><integer>2</integer></llsd>",
+			"<llsd><Integer>1</Integer></llsd>",
+			"<LLSD><integer>1</integer></LLSD>",
+			"<llsd ><integer >1</integer></llsd >",
+			"<llsd><integer>1</integer ></llsd>",
+			"<llsd><integer>1</integerx></llsd>",
+		};
+
+		std::vector<std::string> documents(DOCUMENTS, DOCUMENTS + LL_ARRAY_SIZE(DOCUMENTS));
+		// longer than the chunks the parser reads, on one line and on many
+		std::string deep;
+		for (S32 i = 0; i < 300; ++i)
+		{
+			deep += "<array>";
+		}
+		deep += "<integer>1</integer>";
+		for (S32 i = 0; i < 300; ++i)
+		{
+			deep += "</array>";
+		}
+		documents.push_back("<llsd>" + deep + "</llsd>");
+		std::ostringstream flat;
+		LLSDSerialize::toXML(make_inventory(100), flat);
+		documents.push_back(flat.str() + "\n" + flat.str());
+		// and where the document ends in the middle of a long line
+		std::string line = flat.str();
+		line.erase(line.find_last_not_of("\r\n") + 1);
+		for (S32 i = 0; i < 100; ++i)
+		{
+			line += "<llsd><integer>1</integer></llsd>";
+		}
+		documents.push_back(line);
+		std::ostringstream pretty;
+		LLSDSerialize::toPrettyXML(make_inventory(100), pretty);
+		documents.push_back(pretty.str() + pretty.str());
+		documents.push_back(pretty.str().substr(0, pretty.str().size() / 2));
+		std::string crlf = pretty.str();
+		for (size_t pos = crlf.find('\n'); pos != std::string::npos; pos = crlf.find('\n', pos + 2))
+		{
+			crlf.replace(pos, 1, "\r\n");
+		}
+		documents.push_back(crlf + "<llsd><integer>1</integer></llsd>");
+
+		for (size_t i = 0; i < documents.size(); ++i)
+		{
+			for (S32 lines = 0; lines < 2; ++lines)
+			{
+				const std::string msg = llformat("document %d%s", (S32)i, lines ? " by lines" : "");
+				const XMLParseResult expat = parse_xml(documents[i], false, lines);
+				const XMLParseResult fast = parse_xml(documents[i], true, lines);
+				ensure_equals(msg, fast.mData, expat.mData);
+				ensure_equals(msg + " (count)", fast.mCount, expat.mCount);
+				ensure_equals(msg + " (stream state)", fast.mGood, expat.mGood);
+				ensure_equals(msg + " (rest)", fast.mRest, expat.mRest);
+			}
+		}
+
+		// expat took over from the start, nothing was lost
+		LLSD expected = make_inventory(3);
+		std::ostringstream commented;
+		LLSDSerialize::toXML(expected, commented);
+		std::string xml = commented.str();
+		xml.insert(xml.find("<map>"), "<!-- from the inventory -->");
+		ensure_equals("after a comment", parse_xml(xml, true, false).mData, expected);
+	}
+
+	template<> template<>
+	void TestLLSDXMLParsingObject::test<6>()
+	{
+		// timings, on inventory and on settings like documents
+		const S32 RUNS = 20;
+		std::ostringstream inventory;
+		LLSDSerialize::toPrettyXML(make_inventory(2000), inventory);
+
+		LLSD settings;
+		for (S32 i = 0; i < 2000; ++i)
+		{
+			LLSD& setting = settings[llformat("Setting%d", i)];
+			setting["Comment"] = "What the setting does, in a sentence or two of text.";
+			setting["Persist"] = 1;
+			setting["Type"] = i % 2 ? "Boolean" : "F32";
+			setting["Value"] = i % 2 ? LLSD(1) : LLSD(0.5 + i);
+		}
+		std::ostringstream settings_xml;
+		LLSDSerialize::toPrettyXML(settings, settings_xml);
+
+		const std::string documents[] = { inventory.str(), settings_xml.str() };
+		const char* const names[] = { "inventory", "settings" };
+		std::cout << "\n";
+		for (S32 doc = 0; doc < 2; ++doc)
+		{
+			F64 seconds[2];
+			for (S32 fast = 0; fast < 2; ++fast)
+			{
+				LLTimer timer;
+				for (S32 run = 0; run < RUNS; ++run)
+				{
+					ensure("parsed", parse_xml(documents[doc], fast, false).mCount > 0);
+				}
+				seconds[fast] = timer.getElapsedTimeF64() / RUNS;
+			}
+			ensure_equals("same result", parse_xml(documents[doc], true, false).mData, parse_xml(documents[doc], false, false).mData);
+			std::cout << names[doc] << ", " << documents[doc].size() / 1024 << " KB: expat " << seconds[0] * 1000.0
+					  << " ms, fast " << seconds[1] * 1000.0 << " ms" << std::endl;
+		}
+	}
+	// </polarity>
+
 	/*
 	TODO:
 		test XML parsing
@@ -0,0 +1,262 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/**
+ * @file llsizeclasspool_test.cpp
+ * @brief Test and churn benchmark of LLSizeClassPool
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include <iostream>
+#include <set>
+
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+#include "../llsizeclasspool.h"
+#include "../lltimer.h"
+#include "../lltrace.h"
+
+#include "../test/lltut.h"
+
+namespace
+{
+	class Pooled : public LLTrace::PoolAllocated<Pooled, 16>
+	{
+	public:
+		Pooled() : LLTrace::PoolAllocated<Pooled, 16>("Pooled") { memset(mData, 0xab, sizeof(mData)); }
+		U8 mData[300];
+	};
+
+	class BigPooled : public Pooled
+	{
+	public:
+		U8 mMore[LLSizeClassPool::MAX_SIZE];
+	};
+
+	U64 blocks_out()
+	{
+		std::vector<LLSizeClassPool::ClassStats> stats;
+		LLSizeClassPool::getStats(stats);
+		U64 out = 0;
+		for (size_t i = 0; i < stats.size(); ++i)
+		{
+			out += stats[i].mBlocksOut;
+		}
+		return out;
+	}
+
+	void allocate_blocks(std::vector<void*>* blocks, size_t size, S32 count)
+	{
+		for (S32 i = 0; i < count; ++i)
+		{
+			blocks->push_back(LLSizeClassPool::allocate(size));
+		}
+	}
+
+	void free_blocks(std::vector<void*>* blocks, size_t size)
+	{
+		for (size_t i = 0; i < blocks->size(); ++i)
+		{
+			LLSizeClassPool::deallocate((*blocks)[i], size);
+		}
+	}
+
+	// Keeps a working set of objects the sizes of the viewer's hot classes
+	// and keeps replacing them in random order, like a region crossing.
+	class Churn
+	{
+	public:
+		Churn(bool pooled, U32 seed) : mPooled(pooled), mState(seed | 1) {}
+
+		void run(S32 working_set, S32 replacements)
+		{
+			static const size_t SIZES[] = { 96, 304, 416, 640, 912, 1200 };
+			std::vector<std::pair<void*, size_t> > live(working_set, std::make_pair((void*)NULL, (size_t)0));
+			for (S32 i = 0; i < working_set + replacements; ++i)
+			{
+				std::pair<void*, size_t>& slot = live[next() % working_set];
+				if (slot.first)
+				{
+					release(slot.first, slot.second);
+				}
+				slot.second = SIZES[next() % LL_ARRAY_SIZE(SIZES)];
+				slot.first = acquire(slot.second);
+				*(U32*)slot.first = i;
+			}
+			for (S32 i = 0; i < working_set; ++i)
+			{
+				release(live[i].first, live[i].second);
+			}
+		}
+
+	private:
+		U32 next()
+		{
+			mState ^= mState << 13;
+			mState ^= mState >> 17;
+			mState ^= mState << 5;
+			return mState;
+		}
+
+		void* acquire(size_t size)
+		{
+			return mPooled ? LLSizeClassPool::allocate(size) : ll_aligned_malloc_16(size);
+		}
+
+		void release(void* ptr, size_t size)
+		{
+			if (mPooled)
+			{
+				LLSizeClassPool::deallocate(ptr, size);
+			}
+			else
+			{
+				ll_aligned_free_16(ptr);
+			}
+		}
+
+		bool	mPooled;
+		U32		mState;
+	};
+
+	void run_churn(bool pooled, U32 seed, S32 working_set, S32 replacements)
+	{
+		Churn(pooled, seed).run(working_set, replacements);
+	}
+
+	F64 time_churn(bool pooled, S32 threads, S32 working_set, S32 replacements)
+	{
+		LLTimer timer;
+		boost::thread_group group;
+		for (S32 i = 0; i < threads; ++i)
+		{
+			group.create_thread(boost::bind(&run_churn, pooled, 1234 + i, working_set, replacements));
+		}
+		group.join_all();
+		return timer.getElapsedTimeF64();
+	}
+}
+
+namespace tut
+{
+	struct llsizeclasspool_data
+	{
+	};
+	typedef test_group<llsizeclasspool_data> llsizeclasspool_group;
+	typedef llsizeclasspool_group::object object;
+	llsizeclasspool_group sizeclasspoolgrp("llsizeclasspool");
+
+	template<> template<>
+	void object::test<1>()
+	{
+		set_test_name("every size is aligned and big enough");
+
+		std::vector<void*> blocks;
+		std::set<void*> distinct;
+		for (size_t size = 1; size <= LLSizeClassPool::MAX_SIZE; ++size)
+		{
+			void* block = LLSizeClassPool::allocate(size);
+			ensure("allocated", block != NULL);
+			ensure("aligned", ((uintptr_t)block & (LLSizeClassPool::ALIGNMENT - 1)) == 0);
+			memset(block, (int)size, size);
+			blocks.push_back(block);
+			distinct.insert(block);
+		}
+		ensure_equals("distinct", distinct.size(), blocks.size());
+		for (size_t size = 1; size <= LLSizeClassPool::MAX_SIZE; ++size)
+		{
+			const U8* block = (const U8*)blocks[size - 1];
+			ensure("untouched", block[0] == (U8)size && block[size - 1] == (U8)size);
+			LLSizeClassPool::deallocate(blocks[size - 1], size);
+		}
+	}
+
+	template<> template<>
+	void object::test<2>()
+	{
+		set_test_name("a freed block comes back first");
+
+		void* block = LLSizeClassPool::allocate(200);
+		LLSizeClassPool::deallocate(block, 200);
+		ensure("same size", LLSizeClassPool::allocate(200) == block);
+		// 193 to 208 bytes share a class
+		LLSizeClassPool::deallocate(block, 208);
+		ensure("same class", LLSizeClassPool::allocate(193) == block);
+		LLSizeClassPool::deallocate(block, 193);
+	}
+
+	template<> template<>
+	void object::test<3>()
+	{
+		set_test_name("blocks freed on another thread");
+
+		LLSizeClassPool::flushThreadCache();
+		const U64 before = blocks_out();
+
+		std::vector<void*> blocks;
+		boost::thread allocator(boost::bind(&allocate_blocks, &blocks, 96, 10000));
+		allocator.join();
+		ensure("handed out", blocks_out() >= before + 10000);
+		boost::thread freer(boost::bind(&free_blocks, &blocks, 96));
+		freer.join();
+
+		// both threads gave their caches back when they ended
+		ensure_equals("all back", blocks_out(), before);
+	}
+
+	template<> template<>
+	void object::test<4>()
+	{
+		set_test_name("PoolAllocated");
+
+		LLSizeClassPool::flushThreadCache();
+		const U64 before = blocks_out();
+		Pooled* pooled = new Pooled;
+		ensure("aligned", ((uintptr_t)pooled & 15) == 0);
+		ensure("from the pool", blocks_out() > before);
+		delete pooled;
+
+		// too big for the pool, still the right delete through the base
+		Pooled* big = new BigPooled;
+		delete big;
+		LLSizeClassPool::flushThreadCache();
+		ensure_equals("all back", blocks_out(), before);
+	}
+
+	template<> template<>
+	void object::test<5>()
+	{
+		set_test_name("churn timings");
+
+		const S32 WORKING_SET = 50000;
+		const S32 REPLACEMENTS = 1000000;
+		std::cout << "\n" << REPLACEMENTS << " replacements in a working set of " << WORKING_SET << ":\n";
+		for (S32 threads = 1; threads <= 4; threads *= 2)
+		{
+			const F64 heap = time_churn(false, threads, WORKING_SET, REPLACEMENTS);
+			const F64 pool = time_churn(true, threads, WORKING_SET, REPLACEMENTS);
+			std::cout << "  " << threads << " thread(s): heap " << heap * 1000.0 << " ms, pool " << pool * 1000.0 << " ms\n";
+		}
+		std::cout << std::flush;
+		LLSizeClassPool::logStats();
+	}
+}
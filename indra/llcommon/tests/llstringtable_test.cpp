@@ -0,0 +1,117 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/**
+ * @file llstringtable_test.cpp
+ * @brief LLStringTable unit tests
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include <boost/bind.hpp>
+
+#include "../llstringtable.h"
+#include "../llmutex.h"
+
+#include "../test/lltut.h"
+
+namespace
+{
+	const S32 NAMES = 2000;
+	const S32 ADDS_PER_THREAD = 10000;
+
+	void add_names(LLStringTable* table, std::vector<LLStringTableEntry*>* entries)
+	{
+		for (S32 i = 0; i < ADDS_PER_THREAD; ++i)
+		{
+			entries->push_back(table->addStringEntry(llformat("name%d", i % NAMES)));
+		}
+	}
+}
+
+namespace tut
+{
+	struct string_table
+	{
+	};
+
+	typedef test_group<string_table> string_table_group_t;
+	typedef string_table_group_t::object string_table_t;
+	tut::string_table_group_t string_table_group("llstringtable");
+
+	// adding, finding and removing
+	template<> template<>
+	void string_table_t::test<1>()
+	{
+		LLStringTable table(16);
+		LLStringTableEntry* entry = table.addStringEntry("font");
+		ensure_equals("string", std::string(entry->mString), "font");
+		ensure("same entry", table.addStringEntry(std::string("font")) == entry);
+		ensure("found", table.checkStringEntry("font") == entry);
+		ensure("not found", table.checkStringEntry("fonts") == NULL);
+		ensure_equals("unique", (S32)table.mUniqueEntries, 1);
+
+		table.removeString("font");
+		ensure("still there", table.checkStringEntry("font") == entry);
+		table.removeString("font");
+		ensure("removed", table.checkStringEntry("font") == NULL);
+		ensure_equals("none left", (S32)table.mUniqueEntries, 0);
+		table.removeString("font");
+		ensure_equals("removing too often does nothing", (S32)table.mUniqueEntries, 0);
+
+		// the handle stays good
+		ensure("added again", table.addStringEntry("font") == entry);
+		ensure_equals("count", (S32)entry->mCount, 1);
+	}
+
+	// long strings are cut down the same way every time
+	template<> template<>
+	void string_table_t::test<2>()
+	{
+		LLStringTable table(16);
+		std::string name(MAX_STRINGS_LENGTH + 100, 'x');
+		LLStringTableEntry* entry = table.addStringEntry(name);
+		ensure_equals("length", entry->mLength, MAX_STRINGS_LENGTH - 1);
+		name[MAX_STRINGS_LENGTH + 50] = 'y';
+		ensure("same entry", table.addStringEntry(name) == entry);
+	}
+
+	// threads adding the same names end up with the same entries
+	template<> template<>
+	void string_table_t::test<3>()
+	{
+		LLStringTable table(64);
+		const S32 THREADS = 4;
+		std::vector<std::vector<LLStringTableEntry*> > entries(THREADS);
+		boost::thread_group threads;
+		for (S32 i = 0; i < THREADS; ++i)
+		{
+			threads.create_thread(boost::bind(&add_names, &table, &entries[i]));
+		}
+		threads.join_all();
+
+		ensure_equals("unique", (S32)table.mUniqueEntries, NAMES);
+		for (S32 i = 1; i < THREADS; ++i)
+		{
+			ensure("same entries", entries[i] == entries[0]);
+		}
+		ensure_equals("count", (S32)table.checkStringEntry("name1")->mCount, THREADS * ADDS_PER_THREAD / NAMES);
+	}
+}
@@ -0,0 +1,279 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/**
+ * @file lluuid_test.cpp
+ * @brief Test and benchmark of LLUUID text conversion, comparison and hashing
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include <set>
+#include <sstream>
+
+#include "../lluuid.h"
+#include "../lltimer.h"
+
+#include "../test/lltut.h"
+
+namespace
+{
+	// predictable ids, some with runs of equal bytes so the compares have
+	// to look past the first word
+	class IdSource
+	{
+	public:
+		IdSource() : mState(0x2545f4914f6cdd1dULL) {}
+
+		LLUUID next()
+		{
+			LLUUID id;
+			for (S32 i = 0; i < UUID_BYTES; ++i)
+			{
+				mState ^= mState << 13;
+				mState ^= mState >> 7;
+				mState ^= mState << 17;
+				id.mData[i] = (U8)mState;
+			}
+			return id;
+		}
+
+	private:
+		U64 mState;
+	};
+
+	// what LLUUID did before, byte at a time
+	std::string reference_string(const LLUUID& id)
+	{
+		return llformat("%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
+						id.mData[0], id.mData[1], id.mData[2], id.mData[3], id.mData[4], id.mData[5],
+						id.mData[6], id.mData[7], id.mData[8], id.mData[9], id.mData[10], id.mData[11],
+						id.mData[12], id.mData[13], id.mData[14], id.mData[15]);
+	}
+
+	bool reference_less(const LLUUID& lhs, const LLUUID& rhs)
+	{
+		return memcmp(lhs.mData, rhs.mData, UUID_BYTES) < 0;
+	}
+
+	bool reference_parse(const std::string& in, LLUUID& id)
+	{
+		S32 pos = 0;
+		for (S32 i = 0; i < UUID_BYTES; ++i)
+		{
+			if (i == 4 || i == 6 || i == 8 || i == 10)
+			{
+				++pos;
+			}
+			S32 value = 0;
+			for (S32 j = 0; j < 2; ++j, ++pos)
+			{
+				const char c = in[pos];
+				value <<= 4;
+				if (c >= '0' && c <= '9') value += c - '0';
+				else if (c >= 'a' && c <= 'f') value += c - 'a' + 10;
+				else if (c >= 'A' && c <= 'F') value += c - 'A' + 10;
+				else return false;
+			}
+			id.mData[i] = (U8)value;
+		}
+		return true;
+	}
+}
+
+namespace tut
+{
+	struct lluuid_data
+	{
+	};
+	typedef test_group<lluuid_data> lluuid_group;
+	typedef lluuid_group::object object;
+	lluuid_group lluuidgrp("lluuid");
+
+	template<> template<>
+	void object::test<1>()
+	{
+		set_test_name("text round trip");
+
+		IdSource ids;
+		for (S32 i = 0; i < 1000; ++i)
+		{
+			const LLUUID id = ids.next();
+			const std::string text = id.asString();
+			ensure_equals("formatted", text, reference_string(id));
+
+			char buffer[UUID_STR_SIZE];
+			id.toString(buffer);
+			ensure_equals("into a buffer", std::string(buffer), text);
+
+			std::ostringstream out;
+			out << id;
+			ensure_equals("streamed", out.str(), text);
+
+			std::string upper = text;
+			LLStringUtil::toUpper(upper);
+			LLUUID parsed;
+			ensure("parsed", parsed.set(upper));
+			ensure("same id", parsed == id);
+			ensure("valid", LLUUID::validate(upper));
+		}
+	}
+
+	template<> template<>
+	void object::test<2>()
+	{
+		set_test_name("bad strings");
+
+		LLUUID id;
+		ensure("empty is null", id.set("") && id.isNull());
+		ensure("short", !id.set("01234567-89ab", FALSE) && id.isNull());
+		const char* good = "01234567-89ab-cdef-0123-456789abcdef";
+		ensure("good", id.set(good) && id.asString() == good);
+		// the 35 character format from before the last dash
+		ensure("broken format", id.set("01234567-89ab-cdef-0123456789abcdef", FALSE) && id.asString() == good);
+
+		// characters just outside the digit and letter ranges
+		const char* bad_characters = "/:@G`g \xe6";
+		for (const char* c = bad_characters; *c; ++c)
+		{
+			std::string bad(good);
+			bad[30] = *c;
+			ensure(std::string("rejected ") + *c, !id.set(bad, FALSE) && id.isNull());
+			ensure(std::string("not valid ") + *c, !LLUUID::validate(bad));
+		}
+	}
+
+	template<> template<>
+	void object::test<3>()
+	{
+		set_test_name("ordering and equality");
+
+		IdSource ids;
+		LLUUID previous = ids.next();
+		for (S32 i = 0; i < 10000; ++i)
+		{
+			LLUUID id = ids.next();
+			if (i % 3 == 0)
+			{
+				// same first 15 bytes
+				memcpy(id.mData, previous.mData, UUID_BYTES - 1);
+			}
+			ensure_equals("less", id < previous, reference_less(id, previous));
+			ensure_equals("greater", id > previous, reference_less(previous, id));
+			ensure_equals("equal", id == previous, !memcmp(id.mData, previous.mData, UUID_BYTES));
+			ensure("not equal to itself", !(id != id));
+			previous = id;
+		}
+		ensure("null", LLUUID::null.isNull() && !LLUUID::null.notNull());
+		ensure("not null", previous.notNull() && !previous.isNull());
+	}
+
+	template<> template<>
+	void object::test<4>()
+	{
+		set_test_name("hash spreads ids that differ in one byte");
+
+		// ids that only differ in one byte should still fill the buckets
+		const U32 BUCKETS = 1024;
+		std::set<size_t> buckets;
+		LLUUID id;
+		for (S32 byte = 0; byte < UUID_BYTES; ++byte)
+		{
+			for (S32 value = 0; value < 256; ++value)
+			{
+				id.setNull();
+				id.mData[byte] = (U8)value;
+				buckets.insert(std::hash<LLUUID>()(id) & (BUCKETS - 1));
+			}
+		}
+		ensure("buckets used", buckets.size() > BUCKETS * 9 / 10);
+	}
+
+	template<> template<>
+	void object::test<5>()
+	{
+		set_test_name("timings");
+
+		const S32 COUNT = 200000;
+		IdSource ids;
+		std::vector<LLUUID> id_list;
+		std::vector<std::string> strings;
+		for (S32 i = 0; i < COUNT; ++i)
+		{
+			id_list.push_back(ids.next());
+			strings.push_back(reference_string(id_list.back()));
+		}
+
+		LLTimer timer;
+		size_t length = 0;
+		for (S32 i = 0; i < COUNT; ++i)
+		{
+			length += reference_string(id_list[i]).length();
+		}
+		const F64 format_reference = timer.getElapsedTimeAndResetF64();
+		char buffer[UUID_STR_SIZE];
+		for (S32 i = 0; i < COUNT; ++i)
+		{
+			id_list[i].toString(buffer);
+			length += buffer[i % UUID_STR_LENGTH] != 0;
+		}
+		const F64 format = timer.getElapsedTimeAndResetF64();
+
+		LLUUID parsed;
+		S32 parsed_count = 0;
+		for (S32 i = 0; i < COUNT; ++i)
+		{
+			parsed_count += reference_parse(strings[i], parsed);
+		}
+		const F64 parse_reference = timer.getElapsedTimeAndResetF64();
+		for (S32 i = 0; i < COUNT; ++i)
+		{
+			parsed_count += parsed.set(strings[i]);
+		}
+		const F64 parse = timer.getElapsedTimeAndResetF64();
+		ensure_equals("all parsed", parsed_count, COUNT * 2);
+
+		std::vector<LLUUID> sorted(id_list);
+		timer.reset();
+		std::sort(sorted.begin(), sorted.end(), reference_less);
+		const F64 sort_reference = timer.getElapsedTimeAndResetF64();
+		sorted = id_list;
+		timer.reset();
+		std::sort(sorted.begin(), sorted.end());
+		const F64 sort = timer.getElapsedTimeAndResetF64();
+
+		size_t hashes = 0;
+		for (S32 pass = 0; pass < 10; ++pass)
+		{
+			for (S32 i = 0; i < COUNT; ++i)
+			{
+				hashes += id_list[i].hash();
+			}
+		}
+		const F64 hash = timer.getElapsedTimeF64();
+
+		std::cout << "\n" << COUNT << " ids:\n"
+				  << "  toString:  llformat " << format_reference * 1000.0 << " ms, LLUUID " << format * 1000.0 << " ms\n"
+				  << "  set:       byte loop " << parse_reference * 1000.0 << " ms, LLUUID " << parse * 1000.0 << " ms\n"
+				  << "  sort:      memcmp " << sort_reference * 1000.0 << " ms, operator< " << sort * 1000.0 << " ms\n"
+				  << "  hash x10:  " << hash * 1000.0 << " ms (" << (hashes & 1) << ")" << std::endl;
+		ensure("lengths", length > 0);
+	}
+}
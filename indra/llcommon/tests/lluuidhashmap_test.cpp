@@ -0,0 +1,308 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/**
+ * @file   lluuidhashmap_test.cpp
+ * @brief  Test and benchmark of lluuidhashmap.h
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+// Precompiled header
+#include "linden_common.h"
+// associated header
+#include "../lluuidhashmap.h"
+// STL headers
+#include <iostream>
+#include <map>
+#include <set>
+#include <vector>
+// other Linden headers
+#include "../lltimer.h"
+#include "../test/lltut.h"
+
+namespace
+{
+	// deterministic ids, so a failure can be reproduced
+	struct IdSource
+	{
+		IdSource() : mState(0x2545f4914f6cdd1dULL) {}
+
+		LLUUID next()
+		{
+			LLUUID id;
+			for (S32 i = 0; i < UUID_BYTES; i += 8)
+			{
+				mState ^= mState << 13;
+				mState ^= mState >> 7;
+				mState ^= mState << 17;
+				memcpy(id.mData + i, &mState, 8);
+			}
+			return id;
+		}
+
+		U64 mState;
+	};
+
+	// shape of a large inventory: a few thousand folders hanging off older
+	// ones, with the items spread over all of them
+	template <typename CAT_MAP, typename CHILD_MAP>
+	struct SyntheticInventory
+	{
+		typedef std::vector<LLUUID> id_vec_t;
+
+		SyntheticInventory(S32 folders, S32 items)
+		{
+			IdSource ids;
+			mRoot = ids.next();
+			mFolders[mRoot] = LLUUID::null;
+			mChildren[mRoot] = new id_vec_t;
+			id_vec_t folder_ids(1, mRoot);
+			for (S32 i = 1; i < folders; ++i)
+			{
+				LLUUID id = ids.next();
+				// parents are always older folders, the root gets a shallow fan out
+				LLUUID parent = folder_ids[(i * 7919) % (i < 16 ? 1 : i)];
+				mFolders[id] = parent;
+				mChildren[id] = new id_vec_t;
+				mChildren[parent]->push_back(id);
+				folder_ids.push_back(id);
+			}
+			for (S32 i = 0; i < items; ++i)
+			{
+				LLUUID id = ids.next();
+				LLUUID parent = folder_ids[(size_t)((U64)i * 104729 % folders)];
+				mItems[id] = parent;
+				mChildren[parent]->push_back(id);
+				mItemIds.push_back(id);
+			}
+		}
+
+		~SyntheticInventory()
+		{
+			for (typename CHILD_MAP::iterator iter = mChildren.begin(); iter != mChildren.end(); ++iter)
+			{
+				delete iter->second;
+			}
+		}
+
+		// what LLInventoryModel::collectDescendentsIf() does, one lookup
+		// per folder for its children and one per child to classify it
+		size_t collectDescendents(const LLUUID& id) const
+		{
+			size_t count = 0;
+			const id_vec_t* children = get_ptr_in_map(mChildren, id);
+			if (children)
+			{
+				for (id_vec_t::const_iterator iter = children->begin(); iter != children->end(); ++iter)
+				{
+					if (mItems.find(*iter) != mItems.end())
+					{
+						++count;
+					}
+					else if (mFolders.find(*iter) != mFolders.end())
+					{
+						count += 1 + collectDescendents(*iter);
+					}
+				}
+			}
+			return count;
+		}
+
+		LLUUID		mRoot;
+		CAT_MAP		mFolders;	// id -> parent
+		CAT_MAP		mItems;		// id -> parent
+		CHILD_MAP	mChildren;
+		id_vec_t	mItemIds;
+	};
+
+	typedef SyntheticInventory<std::map<LLUUID, LLUUID>, std::map<LLUUID, std::vector<LLUUID>*> > tree_inventory_t;
+	typedef SyntheticInventory<LLUUIDHashMap<LLUUID>, LLUUIDHashMap<std::vector<LLUUID>*> > hash_inventory_t;
+
+	template <typename INVENTORY>
+	F64 time_lookups(const INVENTORY& inventory, size_t& found)
+	{
+		LLTimer timer;
+		found = 0;
+		for (S32 pass = 0; pass < 5; ++pass)
+		{
+			for (size_t i = 0; i < inventory.mItemIds.size(); ++i)
+			{
+				// every item and its parent folder, like getItem() followed by getCategory()
+				LLUUID id = inventory.mItemIds[(i * 7) % inventory.mItemIds.size()];
+				if (inventory.mItems.find(id) != inventory.mItems.end()
+					&& inventory.mFolders.find(inventory.mItems.find(id)->second) != inventory.mFolders.end())
+				{
+					++found;
+				}
+			}
+		}
+		return timer.getElapsedTimeF64();
+	}
+
+	template <typename INVENTORY>
+	F64 time_collect(const INVENTORY& inventory, size_t& found)
+	{
+		LLTimer timer;
+		found = 0;
+		for (S32 pass = 0; pass < 5; ++pass)
+		{
+			found += inventory.collectDescendents(inventory.mRoot);
+		}
+		return timer.getElapsedTimeF64();
+	}
+}
+
+/*****************************************************************************
+*   TUT
+*****************************************************************************/
+namespace tut
+{
+	struct lluuidhashmap_data
+	{
+	};
+	typedef test_group<lluuidhashmap_data> lluuidhashmap_group;
+	typedef lluuidhashmap_group::object object;
+	lluuidhashmap_group lluuidhashmapgrp("LLUUIDHashMap");
+
+	template<> template<>
+	void object::test<1>()
+	{
+		set_test_name("insert, find, erase");
+
+		LLUUIDHashMap<S32> map;
+		ensure("starts empty", map.empty());
+		ensure("find in empty map", map.find(LLUUID::null) == map.end());
+
+		IdSource ids;
+		std::vector<LLUUID> keys;
+		for (S32 i = 0; i < 1000; ++i)
+		{
+			keys.push_back(ids.next());
+			map[keys.back()] = i;
+		}
+		// the null id is a valid key, the inventory uses it for the root's parent
+		keys.push_back(LLUUID::null);
+		ensure("insert null", map.insert(std::make_pair(LLUUID::null, 1000)).second);
+		ensure_equals("size", map.size(), keys.size());
+		ensure("no duplicate insert", !map.insert(std::make_pair(keys[0], 42)).second);
+		ensure_equals("duplicate insert keeps value", map[keys[0]], 0);
+
+		for (S32 i = 0; i < (S32)keys.size(); ++i)
+		{
+			LLUUIDHashMap<S32>::const_iterator iter = map.find(keys[i]);
+			ensure("found", iter != map.end());
+			ensure_equals("value", iter->second, i);
+		}
+
+		// remove every other key, the rest must still be reachable past the holes
+		for (size_t i = 0; i < keys.size(); i += 2)
+		{
+			ensure_equals("erase", map.erase(keys[i]), 1U);
+		}
+		ensure_equals("erase missing", map.erase(keys[0]), 0U);
+		ensure_equals("size after erase", map.size(), keys.size() / 2);
+		for (size_t i = 0; i < keys.size(); ++i)
+		{
+			ensure_equals("count after erase", map.count(keys[i]), (size_t)(i % 2));
+		}
+
+		map.clear();
+		ensure("empty after clear", map.empty() && map.begin() == map.end());
+	}
+
+	template<> template<>
+	void object::test<2>()
+	{
+		set_test_name("iteration visits every entry once");
+
+		LLUUIDHashMap<S32> map;
+		std::set<LLUUID> keys;
+		IdSource ids;
+		map.reserve(300);
+		for (S32 i = 0; i < 300; ++i)
+		{
+			LLUUID id = ids.next();
+			keys.insert(id);
+			map[id] = i;
+		}
+
+		std::set<LLUUID> seen;
+		for (LLUUIDHashMap<S32>::iterator iter = map.begin(); iter != map.end(); ++iter)
+		{
+			ensure("visited once", seen.insert(iter->first).second);
+		}
+		ensure("visited all", seen == keys);
+
+		// erasing on the way still visits each entry once, one pulled back
+		// into the erased slot comes next
+		seen.clear();
+		size_t kept = 0;
+		for (LLUUIDHashMap<S32>::iterator iter = map.begin(); iter != map.end(); )
+		{
+			ensure("visited once while erasing", seen.insert(iter->first).second);
+			if (iter->second % 3)
+			{
+				iter = map.erase(iter);
+			}
+			else
+			{
+				++kept;
+				++iter;
+			}
+		}
+		ensure("visited all while erasing", seen == keys);
+		ensure_equals("kept", map.size(), kept);
+
+		// pointer values, the way the inventory keeps its child arrays
+		LLUUIDHashMap<S32*> ptrs;
+		S32 value = 5;
+		ptrs[*keys.begin()] = &value;
+		ensure_equals("get_ptr_in_map", get_ptr_in_map(ptrs, *keys.begin()), &value);
+		ensure("get_ptr_in_map missing", get_ptr_in_map(ptrs, LLUUID::null) == NULL);
+		ensure("is_in_map", is_in_map(ptrs, *keys.begin()) && !is_in_map(ptrs, LLUUID::null));
+	}
+
+	template<> template<>
+	void object::test<3>()
+	{
+		set_test_name("synthetic 200k item inventory");
+
+		const S32 FOLDERS = 5000;
+		const S32 ITEMS = 200000;
+		tree_inventory_t tree(FOLDERS, ITEMS);
+		hash_inventory_t hash(FOLDERS, ITEMS);
+
+		size_t tree_found, hash_found;
+		F64 tree_lookup = time_lookups(tree, tree_found);
+		F64 hash_lookup = time_lookups(hash, hash_found);
+		ensure_equals("lookups agree", hash_found, tree_found);
+		ensure_equals("every item found", hash_found, (size_t)ITEMS * 5);
+
+		F64 tree_collect = time_collect(tree, tree_found);
+		F64 hash_collect = time_collect(hash, hash_found);
+		ensure_equals("descendents agree", hash_found, tree_found);
+		ensure_equals("every descendent found", hash_found, (size_t)(FOLDERS - 1 + ITEMS) * 5);
+
+		std::cout << "\n" << ITEMS << " items in " << FOLDERS << " folders, 5 passes:\n"
+				  << "  item + parent lookups:  std::map " << tree_lookup * 1000.0
+				  << " ms, LLUUIDHashMap " << hash_lookup * 1000.0 << " ms\n"
+				  << "  collect descendents:    std::map " << tree_collect * 1000.0
+				  << " ms, LLUUIDHashMap " << hash_collect * 1000.0 << " ms" << std::endl;
+	}
+}
@@ -30,6 +30,7 @@
 
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
+#include <memory> // <polarity/>
 
 #include "_httpoperation.h"
 #include "_httprequestqueue.h"
@@ -40,6 +41,10 @@
 
 #include "lltimer.h"
 #include "llthread.h"
+// <polarity> Timer event capture
+#include "llfasttimer.h"
+#include "lltracethreadrecorder.h"
+// </polarity>
 
 
 namespace
@@ -47,6 +52,11 @@ namespace
 
 static const char * const LOG_CORE("CoreHttp");
 
+// <polarity> Timer event capture
+LLTrace::BlockTimerStatHandle FTM_HTTP_POLICY("HTTP Policy");
+LLTrace::BlockTimerStatHandle FTM_HTTP_TRANSPORT("HTTP Transport");
+// </polarity>
+
 } // end anonymous namespace
 
 
@@ -304,6 +314,16 @@ void HttpService::shutdown()
 void HttpService::threadRun(LLCoreInt::HttpThread * thread)
 {
 	boost::this_thread::disable_interruption di;
+
+	// <polarity> Timer event capture
+	// Block timers only run on threads with a recorder, like LLThreads have.
+	std::unique_ptr<LLTrace::ThreadRecorder> recorder;
+	if (LLTrace::get_master_thread_recorder())
+	{
+		recorder.reset(new LLTrace::ThreadRecorder(*LLTrace::get_master_thread_recorder()));
+	}
+	LLTrace::BlockTimerEventCapture::setThreadName("HTTP");
+	// </polarity>
 	
 	ELoopSpeed loop(REQUEST_SLEEP);
 	while (! mExitRequested)
@@ -311,11 +331,24 @@ void HttpService::threadRun(LLCoreInt::HttpThread * thread)
 		loop = processRequestQueue(loop);
 
 		// Process ready queue issuing new requests as needed
-		ELoopSpeed new_loop = mPolicy->processReadyQueue();
+		// <polarity> Timer event capture
+		//ELoopSpeed new_loop = mPolicy->processReadyQueue();
+		ELoopSpeed new_loop;
+		{
+			LL_RECORD_BLOCK_TIME(FTM_HTTP_POLICY);
+			new_loop = mPolicy->processReadyQueue();
+		}
+		// </polarity>
 		loop = (std::min)(loop, new_loop);
 		
 		// Give libcurl some cycles
-		new_loop = mTransport->processTransport();
+		// <polarity> Timer event capture
+		//new_loop = mTransport->processTransport();
+		{
+			LL_RECORD_BLOCK_TIME(FTM_HTTP_TRANSPORT);
+			new_loop = mTransport->processTransport();
+		}
+		// </polarity>
 		loop = (std::min)(loop, new_loop);
 		
 		// Determine whether to spin, sleep briefly or sleep for next request
@@ -71,6 +71,7 @@ public:
 	// implementation to implement a buffer-free adapter.
 	// Changes here will likely need to be reflected there.
 	friend class BufferArrayStreamBuf;
+	friend class BufferArrayInStreamBuf;	// <polarity/>
 	
 	BufferArray();
 
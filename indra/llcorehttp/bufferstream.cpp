@@ -280,6 +280,85 @@ BufferArrayStream::~BufferArrayStream()
 {}
 	
 
+// <polarity> Read-only stream getting whole blocks
+BufferArrayInStreamBuf::BufferArrayInStreamBuf(BufferArray * array)
+	: mBufferArray(array),
+	  mReadCurBlock(-1),
+	  mReadBlockPos(0)
+{
+	if (array)
+	{
+		array->addRef();
+	}
+}
+
+
+BufferArrayInStreamBuf::~BufferArrayInStreamBuf()
+{
+	if (mBufferArray)
+	{
+		mBufferArray->release();
+		mBufferArray = NULL;
+	}
+}
+
+
+BufferArrayInStreamBuf::int_type BufferArrayInStreamBuf::underflow()
+{
+	if (! mBufferArray)
+	{
+		return traits_type::eof();
+	}
+
+	if (gptr() == egptr())
+	{
+		const char * new_begin(NULL), * new_end(NULL);
+		int new_cur_block(mReadCurBlock + 1);
+
+		// skip empty blocks, stay on the last one at the end
+		while (mBufferArray->getBlockStartEnd(new_cur_block, &new_begin, &new_end))
+		{
+			if (new_begin != new_end)
+			{
+				break;
+			}
+			++new_cur_block;
+		}
+		if (new_begin == new_end)
+		{
+			return traits_type::eof();
+		}
+
+		mReadBlockPos += egptr() - eback();
+		mReadCurBlock = new_cur_block;
+		setg(const_cast<char *>(new_begin), const_cast<char *>(new_begin), const_cast<char *>(new_end));
+	}
+
+	return traits_type::to_int_type(*gptr());
+}
+
+
+std::streamsize BufferArrayInStreamBuf::showmanyc()
+{
+	if (! mBufferArray)
+	{
+		return -1;
+	}
+	return mBufferArray->mLen - (mReadBlockPos + (gptr() - eback()));
+}
+
+
+BufferArrayInStream::BufferArrayInStream(BufferArray * ba)
+	: std::istream(&mStreamBuf),
+	  mStreamBuf(ba)
+{}
+
+
+BufferArrayInStream::~BufferArrayInStream()
+{}
+// </polarity>
+
+
 }  // end namespace LLCore
 
 
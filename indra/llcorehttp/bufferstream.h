@@ -148,6 +148,66 @@ protected:
 }; // end class BufferArrayStream
 
 
+// <polarity> Read-only stream getting whole blocks
+// =====================================================
+// BufferArrayInStreamBuf
+// =====================================================
+
+/// Read-only std::streambuf on a BufferArray that hands
+/// each block to the stream as its get area, so reading
+/// (get(), read(), getline()) stays inline in the stream
+/// and only calls underflow() once per block.  Nothing is
+/// copied.  Meant for the parsers of response bodies; the
+/// BufferArray must not change while it is being read.
+///
+class BufferArrayInStreamBuf : public std::streambuf
+{
+public:
+	BufferArrayInStreamBuf(BufferArray * array);
+	virtual ~BufferArrayInStreamBuf();
+
+protected:
+	BufferArrayInStreamBuf(const BufferArrayInStreamBuf &);
+	void operator=(const BufferArrayInStreamBuf &);
+
+protected:
+	int_type underflow();
+	std::streamsize showmanyc();
+
+protected:
+	BufferArray *		mBufferArray;
+	int					mReadCurBlock;
+	size_t				mReadBlockPos;		// of the current block in the array
+}; // end class BufferArrayInStreamBuf
+
+
+// =====================================================
+// BufferArrayInStream
+// =====================================================
+
+/// std::istream over a BufferArrayInStreamBuf, e.g.
+///
+///   BufferArrayInStream bis(response->getBody());
+///   LLSDSerialize::fromBinary(llsd, bis, body->size());
+
+class BufferArrayInStream : public std::istream
+{
+public:
+	/// Constructor increments the reference count on the
+	/// BufferArray argument and calls release() on destruction.
+	BufferArrayInStream(BufferArray * ba);
+	~BufferArrayInStream();
+
+protected:
+	BufferArrayInStream(const BufferArrayInStream &);
+	void operator=(const BufferArrayInStream &);
+
+protected:
+	BufferArrayInStreamBuf		mStreamBuf;
+}; // end class BufferArrayInStream
+// </polarity>
+
+
 }  // end namespace LLCore
 
 #endif	// _LLCORE_BUFFER_STREAM_H_
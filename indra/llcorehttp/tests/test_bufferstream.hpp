@@ -33,6 +33,10 @@
 #include "test_allocator.h"
 #include "llsd.h"
 #include "llsdserialize.h"
+// <polarity> Binary LLSD over HTTP
+#include "llformat.h"
+#include "lltimer.h"
+// </polarity>
 
 
 using namespace LLCore;
@@ -53,6 +57,161 @@ typedef BufferStreamTestGroupType::object BufferStreamTestObjectType;
 BufferStreamTestGroupType BufferStreamTestGroup("BufferStream Tests");
 typedef BufferArrayStreamBuf::traits_type tst_traits_t;
 
+// <polarity> Binary LLSD over HTTP
+// Bodies shaped like the capability responses the viewer gets most.
+LLSD make_test_uuid(S32 i, S32 kind)
+{
+	LLUUID id;
+	for (S32 j = 0; j < UUID_BYTES; ++j)
+	{
+		id.mData[j] = (U8)(i * 31 + j * 7 + kind);
+	}
+	return LLSD::UUID(id);
+}
+
+LLSD make_permissions(S32 i)
+{
+	LLSD perms = LLSD::emptyMap();
+	perms["base_mask"] = LLSD::Integer(0x7fffffff);
+	perms["everyone_mask"] = LLSD::Integer(0);
+	perms["group_mask"] = LLSD::Integer(0);
+	perms["next_owner_mask"] = LLSD::Integer(0x82000);
+	perms["owner_mask"] = LLSD::Integer(0x7fffffff);
+	perms["creator_id"] = make_test_uuid(i, 1);
+	perms["owner_id"] = make_test_uuid(0, 2);
+	perms["last_owner_id"] = make_test_uuid(i, 3);
+	perms["group_id"] = LLSD::UUID();
+	perms["is_owner_group"] = LLSD::Boolean(false);
+	return perms;
+}
+
+// AIS category fetch, items embedded
+LLSD make_ais_response(S32 items)
+{
+	LLSD embedded_items = LLSD::emptyMap();
+	for (S32 i = 0; i < items; ++i)
+	{
+		LLSD item = LLSD::emptyMap();
+		item["item_id"] = make_test_uuid(i, 4);
+		item["parent_id"] = make_test_uuid(0, 5);
+		item["asset_id"] = make_test_uuid(i, 6);
+		item["name"] = LLSD::String(llformat("Object %d from the marketplace", i));
+		item["desc"] = LLSD::String("(No Description)");
+		item["type"] = LLSD::Integer(6);
+		item["inv_type"] = LLSD::Integer(6);
+		item["flags"] = LLSD::Integer(i & 0xff);
+		item["created_at"] = LLSD::Integer(1500000000 + i);
+		item["permissions"] = make_permissions(i);
+		LLSD sale = LLSD::emptyMap();
+		sale["sale_price"] = LLSD::Integer(10);
+		sale["sale_type"] = LLSD::Integer(0);
+		item["sale_info"] = sale;
+		LLSD links = LLSD::emptyMap();
+		links["self"]["href"] = LLSD::String(llformat("/item/%s", item["item_id"].asString().c_str()));
+		item["_links"] = links;
+		embedded_items[item["item_id"].asString()] = item;
+	}
+	LLSD response = LLSD::emptyMap();
+	response["category_id"] = make_test_uuid(0, 5);
+	response["name"] = LLSD::String("Objects");
+	response["type_default"] = LLSD::Integer(6);
+	response["version"] = LLSD::Integer(1234);
+	response["_embedded"]["items"] = embedded_items;
+	response["_embedded"]["categories"] = LLSD::emptyMap();
+	return response;
+}
+
+// RenderMaterials, unzipped
+LLSD make_material_response(S32 materials)
+{
+	LLSD response = LLSD::emptyArray();
+	for (S32 i = 0; i < materials; ++i)
+	{
+		LLSD material = LLSD::emptyMap();
+		material["NormMap"] = make_test_uuid(i, 7);
+		material["NormOffsetX"] = LLSD::Integer(0);
+		material["NormOffsetY"] = LLSD::Integer(0);
+		material["NormRepeatX"] = LLSD::Integer(10000);
+		material["NormRepeatY"] = LLSD::Integer(10000);
+		material["NormRotation"] = LLSD::Real(0.5);
+		material["SpecMap"] = make_test_uuid(i, 8);
+		material["SpecOffsetX"] = LLSD::Integer(0);
+		material["SpecOffsetY"] = LLSD::Integer(0);
+		material["SpecRepeatX"] = LLSD::Integer(10000);
+		material["SpecRepeatY"] = LLSD::Integer(10000);
+		material["SpecRotation"] = LLSD::Real(0.0);
+		LLSD color = LLSD::emptyArray();
+		color.append(LLSD::Integer(255));
+		color.append(LLSD::Integer(255));
+		color.append(LLSD::Integer(255));
+		color.append(LLSD::Integer(255));
+		material["SpecColor"] = color;
+		material["SpecExp"] = LLSD::Integer(51);
+		material["EnvIntensity"] = LLSD::Integer(0);
+		material["AlphaMaskCutoff"] = LLSD::Integer(0);
+		material["DiffuseAlphaMode"] = LLSD::Integer(1);
+
+		LLSD entry = LLSD::emptyMap();
+		entry["ID"] = make_test_uuid(i, 9);
+		entry["Material"] = material;
+		response.append(entry);
+	}
+	return response;
+}
+
+// GetObjectCost and friends, one map per object
+LLSD make_object_response(S32 objects)
+{
+	LLSD response = LLSD::emptyMap();
+	for (S32 i = 0; i < objects; ++i)
+	{
+		LLSD object = LLSD::emptyMap();
+		object["linked_set_resource_cost"] = LLSD::Real(1.25 * (i % 8));
+		object["resource_cost"] = LLSD::Real(0.5 * (i % 16));
+		object["physics_cost"] = LLSD::Real(0.25 * (i % 4));
+		object["linked_set_physics_cost"] = LLSD::Real(2.0);
+		object["resource_limiting_type"] = LLSD::String("legacy");
+		object["name"] = LLSD::String(llformat("Prim %d", i));
+		object["owner_id"] = make_test_uuid(0, 2);
+		object["permissions"] = make_permissions(i);
+		response[make_test_uuid(i, 10).asString()] = object;
+	}
+	return response;
+}
+
+// parses the body the number of times and returns seconds taken
+F64 time_llsd_parse(BufferArray * ba, S32 format, S32 count, LLSD & result)
+{
+	LLTimer timer;
+	for (S32 i = 0; i < count; ++i)
+	{
+		result.clear();
+		switch (format)
+		{
+		case 0:
+			{
+				BufferArrayStream bas(ba);
+				LLSDSerialize::fromXML(result, bas);
+			}
+			break;
+		case 1:
+			{
+				BufferArrayStream bas(ba);
+				LLSDSerialize::fromBinary(result, bas, (S32)ba->size());
+			}
+			break;
+		default:
+			{
+				BufferArrayInStream bis(ba);
+				LLSDSerialize::fromBinary(result, bis, (S32)ba->size());
+			}
+			break;
+		}
+	}
+	return timer.getElapsedTimeF64();
+}
+// </polarity>
+
 
 template <> template <>
 void BufferStreamTestObjectType::test<1>()
@@ -298,6 +457,102 @@ void BufferStreamTestObjectType::test<7>()
 }
 
 
+// <polarity> Binary LLSD over HTTP
+template <> template <>
+void BufferStreamTestObjectType::test<8>()
+{
+	set_test_name("BufferArrayInStream reading across blocks");
+
+	BufferArray * ba = new BufferArray;
+	std::string expected;
+	for (size_t i = 0; i < 3 * BufferArray::BLOCK_ALLOC_SIZE; ++i)
+	{
+		expected += (char)('a' + i % 26);
+	}
+	ba->append(expected.data(), expected.size());
+
+	{
+		BufferArrayInStream bis(ba);
+		ensure_equals("Nothing read yet", bis.rdbuf()->in_avail(), (std::streamsize) expected.size());
+		std::string first(BufferArray::BLOCK_ALLOC_SIZE, '\0');
+		bis.read(&first[0], first.size());
+		ensure_equals("First block read", bis.rdbuf()->in_avail(), (std::streamsize) (expected.size() - first.size()));
+
+		std::string rest(expected.size() - first.size(), '\0');
+		bis.read(&rest[0], rest.size());
+		ensure("Read everything", bis.good());
+		ensure("Same bytes", first + rest == expected);
+		ensure("EOF", bis.get() == tst_traits_t::eof());
+	}
+
+	{
+		BufferArray * empty = new BufferArray;
+		BufferArrayInStream bis(empty);
+		ensure("EOF on empty", bis.get() == tst_traits_t::eof());
+		empty->release();
+	}
+
+	ba->release();
+}
+
+
+template <> template <>
+void BufferStreamTestObjectType::test<9>()
+{
+	set_test_name("XML and binary LLSD response timings");
+
+	struct
+	{
+		const char *	mName;
+		LLSD			mLLSD;
+		S32				mCount;
+	} responses[] =
+	{
+		{ "AIS category",		make_ais_response(400),			20 },
+		{ "materials",			make_material_response(100),	100 },
+		{ "object costs",		make_object_response(50),		200 },
+	};
+
+	std::cout << "\n";
+	for (size_t i = 0; i < LL_ARRAY_SIZE(responses); ++i)
+	{
+		BufferArray * xml = new BufferArray;
+		BufferArray * binary = new BufferArray;
+		{
+			BufferArrayStream bas(xml);
+			LLSDSerialize::toXML(responses[i].mLLSD, bas);
+		}
+		{
+			BufferArrayStream bas(binary);
+			LLSDSerialize::toBinary(responses[i].mLLSD, bas);
+		}
+
+		LLSD from_xml, from_binary, from_blocks;
+		const F64 xml_secs = time_llsd_parse(xml, 0, responses[i].mCount, from_xml);
+		const F64 binary_secs = time_llsd_parse(binary, 1, responses[i].mCount, from_binary);
+		const F64 blocks_secs = time_llsd_parse(binary, 2, responses[i].mCount, from_blocks);
+
+		std::ostringstream original, xml_parsed, binary_parsed, blocks_parsed;
+		LLSDSerialize::toNotation(responses[i].mLLSD, original);
+		LLSDSerialize::toNotation(from_xml, xml_parsed);
+		LLSDSerialize::toNotation(from_binary, binary_parsed);
+		LLSDSerialize::toNotation(from_blocks, blocks_parsed);
+		ensure_equals(std::string(responses[i].mName) + " from XML", xml_parsed.str(), original.str());
+		ensure_equals(std::string(responses[i].mName) + " from binary", binary_parsed.str(), original.str());
+		ensure_equals(std::string(responses[i].mName) + " from blocks", blocks_parsed.str(), original.str());
+
+		const F64 count = responses[i].mCount;
+		std::cout << responses[i].mName << ": XML " << xml->size() << " bytes " << xml_secs * 1000.0 / count
+				  << " ms, binary " << binary->size() << " bytes " << binary_secs * 1000.0 / count
+				  << " ms, binary from blocks " << blocks_secs * 1000.0 / count << " ms per parse" << std::endl;
+
+		xml->release();
+		binary->release();
+	}
+}
+// </polarity>
+
+
 }  // end namespace tut
 
 
@@ -30,6 +30,7 @@
 
 #include "llimageworker.h"
 #include "llimagedxt.h"
+#include "llfasttimer.h" // <polarity/>
 
 //----------------------------------------------------------------------------
 
@@ -118,9 +119,12 @@ LLImageDecodeThread::ImageRequest::~ImageRequest()
 //----------------------------------------------------------------------------
 
 
+static LLTrace::BlockTimerStatHandle FTM_IMAGE_DECODE("Image Decode"); // <polarity/> Timer event capture
+
 // Returns true when done, whether or not decode was successful.
 bool LLImageDecodeThread::ImageRequest::processRequest()
 {
+	LL_RECORD_BLOCK_TIME(FTM_IMAGE_DECODE); // <polarity/> Timer event capture
 	const F32 decode_time_slice = .1f;
 	bool done = true;
 	if (!mDecodedRaw && mFormattedImage.notNull())
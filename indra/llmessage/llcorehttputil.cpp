@@ -65,6 +65,12 @@ namespace
         return mBoolSettingGet(HTTP_LOGBODY_KEY);
     }
 
+    // <polarity> Binary LLSD over HTTP
+    // spelled out, the content type constants live in another library
+    const std::string   HTTP_ACCEPT_LLSD_BINARY_OR_XML("application/llsd+binary, application/llsd+xml;q=0.9");
+
+    bool                sAcceptBinaryLLSD(false);
+    // </polarity>
 }
 
 void setPropertyMethods(BoolSettingQuery_t queryfn, BoolSettingUpdate_t updatefn)
@@ -120,7 +126,49 @@ bool responseToLLSD(HttpResponse * response, bool log, LLSD & out_llsd)
         return false;
     }
 
-    LLCore::BufferArrayStream bas(body);
+    // <polarity> Binary LLSD over HTTP
+    if (isBinaryLLSDContentType(response->getContentType()))
+    {
+        // Read straight from the body's blocks, the binary parser
+        // takes a byte at a time.
+        LLCore::BufferArrayInStream bis(body);
+        if (bis.peek() == '<')
+        {
+            // "<? LLSD/Binary ?>" header, no binary value starts with '<'
+            bis.ignore(body->size(), '\n');
+        }
+        LLSD body_llsd;
+        if (LLSDParser::PARSE_FAILURE == LLSDSerialize::fromBinary(body_llsd, bis, (S32)body->size()))
+        {
+            if (log)
+            {
+                LL_INFOS() << "Failed to parse binary LLSD response from " << response->getRequestURL() << LL_ENDL;
+            }
+            return false;
+        }
+        out_llsd = body_llsd;
+        return true;
+    }
+    // </polarity>
+
+    // <polarity> Fast LLSD XML reader
+    // The XML parser reads a document in place when all of it is in the
+    // stream's buffer, here a block of the body. A body bigger than a block
+    // is copied into one of its size first, which costs far less than
+    // having expat read it.
+    //LLCore::BufferArrayStream bas(body);
+    BufferArray * xml_body(body);
+    if (body->size() > BufferArray::BLOCK_ALLOC_SIZE)
+    {
+        xml_body = new BufferArray();
+        body->read(0, xml_body->appendBufferAlloc(body->size()), body->size());
+    }
+    LLCore::BufferArrayInStream bas(xml_body);
+    if (xml_body != body)
+    {
+        xml_body->release();
+    }
+    // </polarity>
     LLSD body_llsd;
     S32 parse_status(LLSDSerialize::fromXML(body_llsd, bas, log));
     if (LLSDParser::PARSE_FAILURE == parse_status){
@@ -131,6 +179,28 @@ bool responseToLLSD(HttpResponse * response, bool log, LLSD & out_llsd)
 }
 
 
+// <polarity> Binary LLSD over HTTP
+void setAcceptBinaryLLSD(bool accept)
+{
+    sAcceptBinaryLLSD = accept;
+}
+
+bool getAcceptBinaryLLSD()
+{
+    return sAcceptBinaryLLSD;
+}
+
+bool isBinaryLLSDContentType(const std::string & content_type)
+{
+    // may come with parameters, "application/llsd+binary; charset=..."
+    return !content_type.compare(0, HTTP_CONTENT_LLSD_BINARY.size(), HTTP_CONTENT_LLSD_BINARY) &&
+        (content_type.size() == HTTP_CONTENT_LLSD_BINARY.size() ||
+         content_type[HTTP_CONTENT_LLSD_BINARY.size()] == ';' ||
+         content_type[HTTP_CONTENT_LLSD_BINARY.size()] == ' ');
+}
+// </polarity>
+
+
 HttpHandle requestPostWithLLSD(HttpRequest * request,
     HttpRequest::policy_t policy_id,
     HttpRequest::priority_t priority,
@@ -441,7 +511,10 @@ LLSD HttpCoroLLSDHandler::handleSuccess(LLCore::HttpResponse * response, LLCore:
         LLCore::HttpHeaders::ptr_t headers(response->getHeaders());
         const std::string *contentType = (headers) ? headers->find(HTTP_IN_HEADER_CONTENT_TYPE) : NULL;
 
-        if (contentType && (HTTP_CONTENT_LLSD_XML == *contentType))
+        // <polarity> Binary LLSD over HTTP
+        //if (contentType && (HTTP_CONTENT_LLSD_XML == *contentType))
+        if (contentType && ((HTTP_CONTENT_LLSD_XML == *contentType) || isBinaryLLSDContentType(*contentType)))
+        // </polarity>
         {
             std::string thebody = LLCoreHttpUtil::responseToString(response);
             LL_WARNS() << "Failed to deserialize . " << response->getRequestURL() << " [status:" << response->getStatus().toString() << "] "
@@ -1166,7 +1239,10 @@ void HttpCoroutineAdapter::checkDefaultHeaders(LLCore::HttpHeaders::ptr_t &heade
         headers.reset(new LLCore::HttpHeaders);
     if (!headers->find(HTTP_OUT_HEADER_ACCEPT))
     {
-        headers->append(HTTP_OUT_HEADER_ACCEPT, HTTP_CONTENT_LLSD_XML);
+        // <polarity> Binary LLSD over HTTP
+        //headers->append(HTTP_OUT_HEADER_ACCEPT, HTTP_CONTENT_LLSD_XML);
+        headers->append(HTTP_OUT_HEADER_ACCEPT, sAcceptBinaryLLSD ? HTTP_ACCEPT_LLSD_BINARY_OR_XML : HTTP_CONTENT_LLSD_XML);
+        // </polarity>
     }
     if (!headers->find(HTTP_OUT_HEADER_CONTENT_TYPE))
     {
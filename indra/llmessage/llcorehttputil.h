@@ -90,6 +90,20 @@ bool responseToLLSD(LLCore::HttpResponse * response,
 					bool log,
 					LLSD & out_llsd);
 
+// <polarity> Binary LLSD over HTTP
+/// Whether requests made through HttpCoroutineAdapter offer
+/// to take application/llsd+binary responses (XML is still
+/// accepted, with a lower quality).  Off by default: the
+/// response is parsed by its content type either way, this
+/// only changes what the server is asked for.
+void setAcceptBinaryLLSD(bool accept);
+bool getAcceptBinaryLLSD();
+
+/// True for a content type of application/llsd+binary,
+/// parameters ignored.
+bool isBinaryLLSDContentType(const std::string & content_type);
+// </polarity>
+
 /// Create a std::string representation of a response object
 /// suitable for logging.  Mainly intended for logging of
 /// failures and debug information.  This won't be fast,
@@ -64,7 +64,10 @@ void LLHttpSDHandler::onCompleted(LLCore::HttpHandle handle, LLCore::HttpRespons
 			LLCore::HttpHeaders::ptr_t headers(response->getHeaders());
 			const std::string *contentType = (headers) ? headers->find(HTTP_IN_HEADER_CONTENT_TYPE) : NULL;
 
-			if (contentType && (HTTP_CONTENT_LLSD_XML == *contentType))
+			// <polarity> Binary LLSD over HTTP
+			//if (contentType && (HTTP_CONTENT_LLSD_XML == *contentType))
+			if (contentType && ((HTTP_CONTENT_LLSD_XML == *contentType) || LLCoreHttpUtil::isBinaryLLSDContentType(*contentType)))
+			// </polarity>
 			{
 				std::string thebody = LLCoreHttpUtil::responseToString(response);
 
@@ -110,6 +110,7 @@ LLFontFreetype::LLFontFreetype()
 	mFTFace(NULL),
 	mRenderGlyphCount(0),
 	mAddGlyphCount(0),
+	mGlyphGeneration(0), // <polarity/>
 	mStyle(0),
 	mPointSize(0)
 {
@@ -489,6 +490,7 @@ void LLFontFreetype::insertGlyphInfo(llwchar wch, LLFontGlyphInfo* gi) const
 	{
 		delete iter->second;
 		iter->second = gi;
+		++mGlyphGeneration; // <polarity/>
 	}
 	else
 	{
@@ -546,6 +548,7 @@ void LLFontFreetype::resetBitmapCache()
 		delete it->second;
 	}
 	mCharGlyphInfoMap.clear();
+	++mGlyphGeneration; // <polarity/>
 	disclaimMem(mFontBitmapCachep);
 	mFontBitmapCachep->reset();
 
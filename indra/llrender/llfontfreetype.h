@@ -139,6 +139,11 @@ public:
 	void setStyle(U8 style);
 	U8 getStyle() const;
 
+	// <polarity> Glyph run cache
+	// changes whenever glyph infos handed out earlier may have been freed
+	U32 getGlyphGeneration() const { return mGlyphGeneration; }
+	// </polarity>
+
 private:
 	void resetBitmapCache();
 	void setSubImageLuminanceAlpha(U32 x, U32 y, U32 bitmap_num, U32 width, U32 height, U8 *data, S32 stride = 0) const;
@@ -174,6 +179,7 @@ private:
 
 	mutable S32 mRenderGlyphCount;
 	mutable S32 mAddGlyphCount;
+	mutable U32 mGlyphGeneration; // <polarity/>
 };
 
 #endif // LL_FONTFREETYPE_H
@@ -53,6 +53,7 @@ F32 LLFontGL::sScaleX = 1.f;
 F32 LLFontGL::sScaleY = 1.f;
 BOOL LLFontGL::sDisplayFont = TRUE ;
 std::string LLFontGL::sAppDir;
+bool LLFontGL::sUseGlyphRunCache = true; // <polarity/>
 
 LLColor4 LLFontGL::sShadowColor(0.f, 0.f, 0.f, 1.f);
 LLFontRegistry* LLFontGL::sFontRegistry = NULL;
@@ -62,9 +63,14 @@ F32 LLFontGL::sCurDepth;
 std::vector<std::pair<LLCoordGL, F32> > LLFontGL::sOriginStack;
 
 const F32 PAD_UVY = 0.5f; // half of vertical padding between glyphs in the glyph texture
+// <polarity> Glyph run cache
+const S32 MAX_GLYPH_RUN_CHARS = 256;	// labels and text segments, not whole documents
+const size_t MAX_GLYPH_RUNS = 1024;		// per font, before the least recently used half is dropped
+// </polarity>
 const F32 DROP_SHADOW_SOFT_STRENGTH = 0.3f;
 
 LLFontGL::LLFontGL()
+:	mGlyphRunGeneration(0) // <polarity/>
 {
 }
 
@@ -256,6 +262,11 @@ S32 LLFontGL::render(const LLWString &wstr, S32 begin_offset, F32 x, F32 y, cons
 
 	const LLFontGlyphInfo* next_glyph = NULL;
 
+	// <polarity> Glyph run cache
+	// fetched after the width measurements above, which may evict runs
+	const GlyphRun* run = getGlyphRun(wstr.c_str() + begin_offset, length);
+	// </polarity>
+
 	const S32 GLYPH_BATCH_SIZE = 30;
 	LLVector4a vertices[GLYPH_BATCH_SIZE * 4];
 	LLVector2 uvs[GLYPH_BATCH_SIZE * 4];
@@ -271,6 +282,12 @@ S32 LLFontGL::render(const LLWString &wstr, S32 begin_offset, F32 x, F32 y, cons
 
 		const LLFontGlyphInfo* fgi = next_glyph;
 		next_glyph = NULL;
+		// <polarity> Glyph run cache
+		if (run)
+		{
+			fgi = run->mGlyphs[i - begin_offset];
+		}
+		// </polarity>
 		if(!fgi)
 		{
 			fgi = mFontFreetype->getGlyphInfo(wch);
@@ -337,6 +354,13 @@ S32 LLFontGL::render(const LLWString &wstr, S32 begin_offset, F32 x, F32 y, cons
 		cur_y += fgi->mYAdvance;
 
 		llwchar next_char = wstr[i+1];
+		// <polarity> Glyph run cache
+		if (run && next_char && (next_char < LAST_CHARACTER) && (i + 1 < begin_offset + length))
+		{
+			cur_x += run->mKerning[i - begin_offset];
+		}
+		else
+		// </polarity>
 		if (next_char && (next_char < LAST_CHARACTER))
 		{
 			// Kern this puppy.
@@ -485,6 +509,23 @@ F32 LLFontGL::getWidthF32(const llwchar* wchars, S32 begin_offset, S32 max_chars
 {
 	const S32 LAST_CHARACTER = LLFontFreetype::LAST_CHAR_FULL;
 
+	// <polarity> Glyph run cache
+	if (sUseGlyphRunCache)
+	{
+		S32 length = 0;
+		const S32 max_length = llmin(max_chars, MAX_GLYPH_RUN_CHARS + 1);
+		while (length < max_length && wchars[begin_offset + length])
+		{
+			++length;
+		}
+		const GlyphRun* run = getGlyphRun(wchars + begin_offset, length);
+		if (run)
+		{
+			return run->mWidth / sScaleX;
+		}
+	}
+	// </polarity>
+
 	F32 cur_x = 0;
 	const S32 max_index = begin_offset + max_chars;
 
@@ -553,7 +594,24 @@ S32 LLFontGL::maxDrawableChars(const llwchar* wchars, F32 max_pixels, S32 max_ch
 	F32 scaled_max_pixels =	max_pixels * sScaleX;
 	F32 width_padding = 0.f;
 	
-	LLFontGlyphInfo* next_glyph = NULL;
+	// <polarity> Glyph run cache
+	//LLFontGlyphInfo* next_glyph = NULL;
+	const LLFontGlyphInfo* next_glyph = NULL;
+
+	// only worth it when the whole text is short, this is also called with
+	// entire documents and stops at the first line's end
+	const GlyphRun* run = NULL;
+	if (sUseGlyphRunCache)
+	{
+		S32 length = 0;
+		const S32 max_length = llmin(max_chars, MAX_GLYPH_RUN_CHARS + 1);
+		while (length < max_length && wchars[length])
+		{
+			++length;
+		}
+		run = getGlyphRun(wchars, length);
+	}
+	// </polarity>
 
 	S32 i;
 	for (i=0; (i < max_chars); i++)
@@ -597,7 +655,10 @@ S32 LLFontGL::maxDrawableChars(const llwchar* wchars, F32 max_pixels, S32 max_ch
 			}
 		}
 		
-		LLFontGlyphInfo* fgi = next_glyph;
+		// <polarity> Glyph run cache
+		//LLFontGlyphInfo* fgi = next_glyph;
+		const LLFontGlyphInfo* fgi = run ? run->mGlyphs[i] : next_glyph;
+		// </polarity>
 		next_glyph = NULL;
 		if(!fgi)
 		{
@@ -625,9 +686,18 @@ S32 LLFontGL::maxDrawableChars(const llwchar* wchars, F32 max_pixels, S32 max_ch
 
 		if (((i+1) < max_chars) && wchars[i+1])
 		{
+			// <polarity> Glyph run cache
+			if (run)
+			{
+				cur_x += run->mKerning[i];
+			}
+			else
+			{
+			// </polarity>
 			// Kern this puppy.
 			next_glyph = mFontFreetype->getGlyphInfo(wchars[i+1]);
 			cur_x += mFontFreetype->getXKerning(fgi, next_glyph);
+			} // <polarity/>
 		}
 
 		// Round after kerning.
@@ -735,6 +805,20 @@ S32 LLFontGL::charFromPixelOffset(const llwchar* wchars, S32 begin_offset, F32 t
 	
 	const LLFontGlyphInfo* next_glyph = NULL;
 
+	// <polarity> Glyph run cache
+	const GlyphRun* run = NULL;
+	if (sUseGlyphRunCache)
+	{
+		S32 length = 0;
+		const S32 max_length = llmin(max_index - begin_offset, MAX_GLYPH_RUN_CHARS + 1);
+		while (length < max_length && wchars[begin_offset + length])
+		{
+			++length;
+		}
+		run = getGlyphRun(wchars + begin_offset, length);
+	}
+	// </polarity>
+
 	S32 pos;
 	for (pos = begin_offset; pos < max_index; pos++)
 	{
@@ -744,7 +828,10 @@ S32 LLFontGL::charFromPixelOffset(const llwchar* wchars, S32 begin_offset, F32 t
 			break; // done
 		}
 		
-		const LLFontGlyphInfo* glyph = next_glyph;
+		// <polarity> Glyph run cache
+		//const LLFontGlyphInfo* glyph = next_glyph;
+		const LLFontGlyphInfo* glyph = run ? run->mGlyphs[pos - begin_offset] : next_glyph;
+		// </polarity>
 		next_glyph = NULL;
 		if(!glyph)
 		{
@@ -777,9 +864,18 @@ S32 LLFontGL::charFromPixelOffset(const llwchar* wchars, S32 begin_offset, F32 t
 		if (((pos + 1) < max_index)
 			&& (wchars[(pos + 1)]))
 		{
+			// <polarity> Glyph run cache
+			if (run)
+			{
+				cur_x += run->mKerning[pos - begin_offset];
+			}
+			else
+			{
+			// </polarity>
 			// Kern this puppy.
 			next_glyph = mFontFreetype->getGlyphInfo(wchars[pos + 1]);
 			cur_x += mFontFreetype->getXKerning(glyph, next_glyph);
+			} // <polarity/>
 		}
 
 
@@ -790,6 +886,109 @@ S32 LLFontGL::charFromPixelOffset(const llwchar* wchars, S32 begin_offset, F32 t
 	return llmin(max_chars, pos - begin_offset);
 }
 
+// <polarity> Glyph run cache
+static LLTrace::CountStatHandle<> sGlyphRunHits("fontglyphrunhits", "Text layouts reused from the font glyph run cache");
+static LLTrace::CountStatHandle<> sGlyphRunMisses("fontglyphrunmisses", "Text layouts added to the font glyph run cache");
+
+const LLFontGL::GlyphRun* LLFontGL::getGlyphRun(const llwchar* wchars, S32 length) const
+{
+	if (!sUseGlyphRunCache || length <= 0 || length > MAX_GLYPH_RUN_CHARS)
+	{
+		return NULL;
+	}
+
+	const U32 glyph_generation = mFontFreetype->getGlyphGeneration();
+	if (mGlyphRunGeneration != glyph_generation)
+	{
+		mGlyphRuns.clear();
+		mOldGlyphRuns.clear();
+		mGlyphRunGeneration = glyph_generation;
+	}
+
+	// FNV-1a, the text is compared as well so a collision only costs a rebuild
+	U64 hash = 0xcbf29ce484222325ULL;
+	for (S32 i = 0; i < length; ++i)
+	{
+		hash = (hash ^ (U64)wchars[i]) * 0x100000001b3ULL;
+	}
+
+	glyph_run_map_t::iterator iter = mGlyphRuns.find(hash);
+	if (iter != mGlyphRuns.end() && iter->second.mText.compare(0, LLWString::npos, wchars, length) == 0)
+	{
+		add(sGlyphRunHits, 1);
+		return &iter->second;
+	}
+
+	GlyphRun run;
+	glyph_run_map_t::iterator old_iter = mOldGlyphRuns.find(hash);
+	if (old_iter != mOldGlyphRuns.end() && old_iter->second.mText.compare(0, LLWString::npos, wchars, length) == 0)
+	{
+		add(sGlyphRunHits, 1);
+		run.mText.swap(old_iter->second.mText);
+		run.mGlyphs.swap(old_iter->second.mGlyphs);
+		run.mKerning.swap(old_iter->second.mKerning);
+		run.mWidth = old_iter->second.mWidth;
+		mOldGlyphRuns.erase(old_iter);
+	}
+	else
+	{
+		add(sGlyphRunMisses, 1);
+		const S32 LAST_CHARACTER = LLFontFreetype::LAST_CHAR_FULL;
+
+		run.mText.assign(wchars, length);
+		run.mGlyphs.resize(length);
+		for (S32 i = 0; i < length; ++i)
+		{
+			run.mGlyphs[i] = mFontFreetype->getGlyphInfo(wchars[i]);
+			if (!run.mGlyphs[i])
+			{
+				return NULL;
+			}
+		}
+		run.mKerning.resize(length - 1);
+		for (S32 i = 0; i + 1 < length; ++i)
+		{
+			run.mKerning[i] = mFontFreetype->getXKerning(run.mGlyphs[i], run.mGlyphs[i + 1]);
+		}
+		if (mFontFreetype->getGlyphGeneration() != glyph_generation)
+		{
+			// adding a glyph replaced one looked up earlier
+			return NULL;
+		}
+
+		// same steps as getWidthF32()
+		F32 cur_x = 0.f;
+		F32 width_padding = 0.f;
+		for (S32 i = 0; i < length; ++i)
+		{
+			const LLFontGlyphInfo* fgi = run.mGlyphs[i];
+			F32 advance = mFontFreetype->getXAdvance(fgi);
+			width_padding = llmax(0.f, width_padding - advance, (F32)(fgi->mWidth + fgi->mXBearing) - advance);
+			cur_x += advance;
+			if (i + 1 < length && wchars[i + 1] && wchars[i + 1] < LAST_CHARACTER)
+			{
+				cur_x += run.mKerning[i];
+			}
+			cur_x = (F32)ll_round(cur_x);
+		}
+		run.mWidth = cur_x + width_padding;
+	}
+
+	// keep the runs used since the last turnover, drop the rest
+	if (mGlyphRuns.size() >= MAX_GLYPH_RUNS)
+	{
+		mOldGlyphRuns.swap(mGlyphRuns);
+		mGlyphRuns.clear();
+	}
+	GlyphRun& entry = mGlyphRuns[hash];
+	entry.mText.swap(run.mText);
+	entry.mGlyphs.swap(run.mGlyphs);
+	entry.mKerning.swap(run.mKerning);
+	entry.mWidth = run.mWidth;
+	return &entry;
+}
+// </polarity>
+
 const LLFontDescriptor& LLFontGL::getFontDesc() const
 {
 	return mFontDescriptor;
@@ -35,10 +35,13 @@
 #include "llrect.h"
 #include "v2math.h"
 
+#include <boost/unordered_map.hpp> // <polarity/>
+
 class LLColor4;
 // Key used to request a font.
 class LLFontDescriptor;
 class LLFontFreetype;
+struct LLFontGlyphInfo; // <polarity/>
 
 // Structure used to store previously requested fonts.
 class LLFontRegistry;
@@ -209,6 +212,7 @@ public:
 	static F32 sScaleY;
 	static BOOL sDisplayFont ;
 	static std::string sAppDir;			// For loading fonts
+	static bool sUseGlyphRunCache;		// <polarity/> see getGlyphRun()
 
 private:
 	friend class LLFontRegistry;
@@ -224,6 +228,29 @@ private:
 	void renderQuad(LLVector4a* vertex_out, LLVector2* uv_out, LLColor4U* colors_out, const LLRectf& screen_rect, const LLRectf& uv_rect, const LLColor4U& color, F32 slant_amt) const;
 	void drawGlyph(S32& glyph_count, LLVector4a* vertex_out, LLVector2* uv_out, LLColor4U* colors_out, const LLRectf& screen_rect, const LLRectf& uv_rect, const LLColor4U& color, U8 style, ShadowType shadow, F32 drop_shadow_fade) const;
 
+	// <polarity> Glyph run cache
+	// The glyph infos and kerning of a piece of text, looked up once and
+	// reused by every later render() or measurement of the same text. UI
+	// labels are redrawn every frame, and each pass used to cost a glyph map
+	// lookup and a kerning lookup per character.
+	struct GlyphRun
+	{
+		LLWString							mText;
+		std::vector<const LLFontGlyphInfo*>	mGlyphs;
+		std::vector<F32>					mKerning;	// between each glyph and the next, whatever the characters
+		F32									mWidth;		// getWidthF32() of the whole text, before scaling
+	};
+
+	// NULL when the text is too long to be worth caching or a glyph is
+	// missing. Only good until the next call, which may evict it.
+	const GlyphRun* getGlyphRun(const llwchar* wchars, S32 length) const;
+
+	typedef boost::unordered_map<U64, GlyphRun> glyph_run_map_t;
+	mutable glyph_run_map_t mGlyphRuns;
+	mutable glyph_run_map_t mOldGlyphRuns;		// last generation, moved back on use
+	mutable U32 mGlyphRunGeneration;			// LLFontFreetype::getGlyphGeneration() the runs were built with
+	// </polarity>
+
 	// Registry holds all instantiated fonts.
 	static LLFontRegistry* sFontRegistry;
 };
@@ -36,14 +36,21 @@
 #include "llcontrol.h"
 #include "lldir.h"
 #include "llwindow.h"
-#include "llxmlnode.h"
+// <polarity> Font files are only read, keep them in an arena tree
+//#include "llxmlnode.h"
+#include "llxmlarenatree.h"
+// </polarity>
 #include "llstring.h"
 
 using std::string;
 using std::map;
 
-bool font_desc_init_from_xml(LLXMLNodePtr node, LLFontDescriptor& desc);
-bool init_from_xml(LLFontRegistry* registry, LLXMLNodePtr node);
+// <polarity> Font files are only read, keep them in an arena tree
+//bool font_desc_init_from_xml(LLXMLNodePtr node, LLFontDescriptor& desc);
+//bool init_from_xml(LLFontRegistry* registry, LLXMLNodePtr node);
+bool font_desc_init_from_xml(const LLXmlArenaTree& tree, LLXmlArenaTree::node_t node, LLFontDescriptor& desc);
+bool init_from_xml(LLFontRegistry* registry, const LLXmlArenaTree& tree, LLXmlArenaTree::node_t node);
+// </polarity>
 
 LLFontDescriptor::LLFontDescriptor():
 	mStyle(0)
@@ -181,26 +188,36 @@ bool LLFontRegistry::parseFontInfo(const std::string& xml_filename)
 		 path_it != xml_paths.end();
 		 ++path_it)
 	{
-		LLXMLNodePtr root;
-		bool parsed_file = LLXMLNode::parseFile(*path_it, root, NULL);
+		// <polarity> Font files are only read, keep them in an arena tree
+		//LLXMLNodePtr root;
+		//bool parsed_file = LLXMLNode::parseFile(*path_it, root, NULL);
+		LLXmlArenaTree tree;
+		bool parsed_file = tree.parseFile(*path_it);
 
 		if (!parsed_file)
+		{
+			LL_WARNS() << tree.getErrorString() << LL_ENDL;
 			continue;
+		}
 
-		if ( root.isNull() || ! root->hasName( "fonts" ) )
+		const LLXmlArenaTree::node_t root = tree.getRoot();
+		//if ( root.isNull() || ! root->hasName( "fonts" ) )
+		if (!tree.hasName(root, "fonts"))
 		{
 			LL_WARNS() << "Bad font info file: " << *path_it << LL_ENDL;
 			continue;
 		}
 
-		std::string root_name;
-		root->getAttributeString("name",root_name);
-		if (root->hasName("fonts"))
-		{
-			// Expect a collection of children consisting of "font" or "font_size" entries
-			bool init_succ = init_from_xml(this, root);
-			success = success || init_succ;
-		}
+		//std::string root_name;
+		//root->getAttributeString("name",root_name);
+		//if (root->hasName("fonts"))
+		//{
+		// the root was checked above. Expect a collection of children
+		// consisting of "font" or "font_size" entries
+		bool init_succ = init_from_xml(this, tree, root);
+		success = success || init_succ;
+		//}
+		// </polarity>
 	}
 	//if (success)
 	//	dump();
@@ -221,18 +238,20 @@ std::string currentOsName()
 #endif
 }
 
-bool font_desc_init_from_xml(LLXMLNodePtr node, LLFontDescriptor& desc)
+// <polarity> Font files are only read, keep them in an arena tree
+//bool font_desc_init_from_xml(LLXMLNodePtr node, LLFontDescriptor& desc)
+bool font_desc_init_from_xml(const LLXmlArenaTree& tree, LLXmlArenaTree::node_t node, LLFontDescriptor& desc)
 {
-	if (node->hasName("font"))
+	if (tree.hasName(node, "font"))
 	{
 		std::string attr_name;
-		if (node->getAttributeString("name",attr_name))
+		if (tree.getAttributeString(node, "name", attr_name))
 		{
 			desc.setName(attr_name);
 		}
 
 		std::string attr_style;
-		if (node->getAttributeString("font_style",attr_style))
+		if (tree.getAttributeString(node, "font_style", attr_style))
 		{
 			desc.setStyle(LLFontGL::getStyleFromString(attr_style));
 		}
@@ -240,39 +259,34 @@ bool font_desc_init_from_xml(LLXMLNodePtr node, LLFontDescriptor& desc)
 		desc.setSize(s_template_string);
 	}
 
-	LLXMLNodePtr child;	
-	for (child = node->getFirstChild(); child.notNull(); child = child->getNextSibling())
+	for (LLXmlArenaTree::node_t child = tree.getFirstChild(node); child != LLXmlArenaTree::NO_NODE; child = tree.getNextSibling(child))
 	{
-		std::string child_name;
-		child->getAttributeString("name",child_name);
-		if (child->hasName("file"))
+		if (tree.hasName(child, "file"))
 		{
-			std::string font_file_name = child->getTextContents();
+			std::string font_file_name = tree.getTextContents(child);
 			desc.getFileNames().push_back(font_file_name);
 		}
-		else if (child->hasName("os"))
+		else if (tree.hasName(child, "os"))
 		{
-			if (child_name == currentOsName())
+			const char* child_name = tree.getAttribute(child, "name");
+			if (child_name && currentOsName() == child_name)
 			{
-				font_desc_init_from_xml(child, desc);
+				font_desc_init_from_xml(tree, child, desc);
 			}
 		}
 	}
 	return true;
 }
 
-bool init_from_xml(LLFontRegistry* registry, LLXMLNodePtr node)
+//bool init_from_xml(LLFontRegistry* registry, LLXMLNodePtr node)
+bool init_from_xml(LLFontRegistry* registry, const LLXmlArenaTree& tree, LLXmlArenaTree::node_t node)
 {
-	LLXMLNodePtr child;
-	
-	for (child = node->getFirstChild(); child.notNull(); child = child->getNextSibling())
+	for (LLXmlArenaTree::node_t child = tree.getFirstChild(node); child != LLXmlArenaTree::NO_NODE; child = tree.getNextSibling(child))
 	{
-		std::string child_name;
-		child->getAttributeString("name",child_name);
-		if (child->hasName("font"))
+		if (tree.hasName(child, "font"))
 		{
 			LLFontDescriptor desc;
-			bool font_succ = font_desc_init_from_xml(child, desc);
+			bool font_succ = font_desc_init_from_xml(tree, child, desc);
 			LLFontDescriptor norm_desc = desc.normalize();
 			if (font_succ)
 			{
@@ -302,12 +316,12 @@ bool init_from_xml(LLFontRegistry* registry, LLXMLNodePtr node)
 				}
 			}
 		}
-		else if (child->hasName("font_size"))
+		else if (tree.hasName(child, "font_size"))
 		{
 			std::string size_name;
 			F32 size_value;
-			if (child->getAttributeString("name",size_name) &&
-				child->getAttributeF32("size",size_value))
+			if (tree.getAttributeString(child, "name", size_name) &&
+				tree.getAttributeF32(child, "size", size_value))
 			{
 				registry->mFontSizes[size_name] = size_value;
 			}
@@ -316,6 +330,7 @@ bool init_from_xml(LLFontRegistry* registry, LLXMLNodePtr node)
 	}
 	return true;
 }
+// </polarity>
 
 bool LLFontRegistry::nameToSize(const std::string& size_name, F32& size)
 {
@@ -65,7 +65,10 @@ private:
 class LLFontRegistry
 {
 public:
-	friend bool init_from_xml(LLFontRegistry*, LLPointer<class LLXMLNode>);
+	// <polarity> Font files are only read, keep them in an arena tree
+	//friend bool init_from_xml(LLFontRegistry*, LLPointer<class LLXMLNode>);
+	friend bool init_from_xml(LLFontRegistry*, const class LLXmlArenaTree&, U32);
+	// </polarity>
 	// create_gl_textures - set to false for test apps with no OpenGL window,
 	// such as llui_libtest
 	LLFontRegistry(bool create_gl_textures);
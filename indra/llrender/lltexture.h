@@ -42,7 +42,8 @@ class LLFontGL ;
 //
 //this is an abstract class as the parent for the class LLGLTexture
 //
-class LLTexture : public virtual LLRefCount, public LLTrace::MemTrackable<LLTexture>
+//class LLTexture : public virtual LLRefCount, public LLTrace::MemTrackable<LLTexture>
+class LLTexture : public virtual LLRefCount, public LLTrace::PoolAllocated<LLTexture> // <polarity/>
 {
 	friend class LLTexUnit ;
 	friend class LLFontGL ;
@@ -52,7 +53,8 @@ protected:
 
 public:
 	LLTexture()
-	:	LLTrace::MemTrackable<LLTexture>("LLTexture")
+//	:	LLTrace::MemTrackable<LLTexture>("LLTexture")
+	:	LLTrace::PoolAllocated<LLTexture>("LLTexture") // <polarity/>
 	{}
 
 	//
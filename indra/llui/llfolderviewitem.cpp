@@ -958,7 +958,8 @@ LLFolderViewFolder::LLFolderViewFolder( const LLFolderViewItem::Params& p ):
 	mTargetHeight(0.f),
 	mAutoOpenCountdown(0.f),
 	mLastArrangeGeneration( -1 ),
-	mLastCalculatedWidth(0)
+	mLastCalculatedWidth(0),
+	mVirtualRowsWidth(0) // <polarity/>
 {
 	// folder might have children that are not loaded yet. Mark it as incomplete until chance to check it.
 	mIsFolderComplete = false;
@@ -1072,11 +1073,25 @@ S32 LLFolderViewFolder::arrange( S32* width, S32* height )
 		// set last arrange generation first, in case children are animating
 		// and need to be arranged again
 		mLastArrangeGeneration = getRoot()->getArrangeGeneration();
+		mVirtualRows.clear(); // <polarity/>
 		if (isOpen())
 		{
 			// Add sizes of children
 			S32 parent_item_height = getRect().getHeight();
 
+			// <polarity> Virtualised rows
+			// Past this many items, only stack the rows here and leave arranging
+			// them to drawVirtualRows(), which only does the ones on screen. The
+			// root draws its children through LLView, so it is never virtualised.
+			static LLUICachedControl<S32> virtual_rows_threshold("PVUI_FolderVirtualRowsThreshold", 0);
+			const bool virtual_rows = virtual_rows_threshold > 0 && getRoot() != this
+				&& mItems.size() >= (size_t)virtual_rows_threshold;
+			if (virtual_rows)
+			{
+				*width = llmax(*width, mVirtualRowsWidth);
+			}
+			// </polarity>
+
 			for(folders_t::iterator fit = mFolders.begin(); fit != mFolders.end(); ++fit)
 			{
 				LLFolderViewFolder* folderp = (*fit);
@@ -1107,9 +1122,27 @@ S32 LLFolderViewFolder::arrange( S32* width, S32* height )
 					S32 child_height = 0;
 					S32 child_top = parent_item_height - ll_round(running_height);
 
-					target_height += itemp->arrange( &child_width, &child_height );
-					// don't change width, as this item is as wide as its parent folder by construction
-					itemp->reshape( itemp->getRect().getWidth(), child_height);
+					// <polarity> Virtualised rows
+					//target_height += itemp->arrange( &child_width, &child_height );
+					//// don't change width, as this item is as wide as its parent folder by construction
+					//itemp->reshape( itemp->getRect().getWidth(), child_height);
+					if (virtual_rows)
+					{
+						child_height = itemp->getItemHeight();
+						target_height += child_height;
+						if (itemp->getRect().getHeight() != child_height)
+						{
+							itemp->reshape(itemp->getRect().getWidth(), child_height);
+						}
+						mVirtualRows.push_back(itemp);
+					}
+					else
+					{
+						target_height += itemp->arrange( &child_width, &child_height );
+						// don't change width, as this item is as wide as its parent folder by construction
+						itemp->reshape( itemp->getRect().getWidth(), child_height);
+					}
+					// </polarity>
 
 					running_height += (F32)child_height;
 					*width = llmax(*width, child_width);
@@ -1577,6 +1610,7 @@ void LLFolderViewFolder::extractItem( LLFolderViewItem* item )
 	}
 	else
 	{
+		mVirtualRows.clear(); // <polarity/> drawn the usual way until the next arrange
 		mItems.erase(it);
 	}
 	//item has been removed, need to update filter
@@ -1965,12 +1999,79 @@ void LLFolderViewFolder::draw()
 	// draw children if root folder, or any other folder that is open or animating to closed state
 	if( getRoot() == this || (isOpen() || mCurHeight != mTargetHeight ))
 	{
-		LLView::draw();
+		// <polarity> Virtualised rows
+		//LLView::draw();
+		if (!mVirtualRows.empty())
+		{
+			drawVirtualRows();
+		}
+		else
+		{
+			LLView::draw();
+		}
+		// </polarity>
 	}
 
 	mExpanderHighlighted = FALSE;
 }
 
+// <polarity> Virtualised rows
+static LLTrace::BlockTimerStatHandle FTM_DRAW_VIRTUAL_ROWS("Draw Virtual Folder Rows");
+
+namespace
+{
+	// rows run top down, so the ones above the view come first
+	struct RowAboveView
+	{
+		bool operator()(const LLFolderViewItem* row, S32 view_top) const
+		{
+			return row->getRect().mBottom >= view_top;
+		}
+	};
+}
+
+void LLFolderViewFolder::drawVirtualRows()
+{
+	LL_RECORD_BLOCK_TIME(FTM_DRAW_VIRTUAL_ROWS);
+
+	for (folders_t::iterator fit = mFolders.begin(); fit != mFolders.end(); ++fit)
+	{
+		drawChild(*fit);
+	}
+
+	LLRect view_rect;
+	LLFolderView* root = getRoot();
+	root->localRectToOtherView(root->getVisibleRect(), &view_rect, this);
+
+	bool width_changed = false;
+	std::vector<LLFolderViewItem*>::iterator row_it = std::lower_bound(mVirtualRows.begin(), mVirtualRows.end(), view_rect.mTop, RowAboveView());
+	for (; row_it != mVirtualRows.end() && (*row_it)->getRect().mTop > view_rect.mBottom; ++row_it)
+	{
+		LLFolderViewItem* row = *row_it;
+		// the closing animation hides rows without arranging again
+		if (!row->getVisible())
+		{
+			continue;
+		}
+		S32 row_width = 0;
+		S32 row_height = 0;
+		row->arrange(&row_width, &row_height);
+		if (row_width > mVirtualRowsWidth)
+		{
+			mVirtualRowsWidth = row_width;
+			width_changed = true;
+		}
+		drawChild(row);
+	}
+
+	// let the folder view grow for the longer labels that scrolled in
+	if (width_changed)
+	{
+		requestArrange();
+	}
+}
+// </polarity>
+
 // this does prefix traversal, as folders are listed above their contents
 LLFolderViewItem* LLFolderViewFolder::getNextFromChild( LLFolderViewItem* item, BOOL include_children )
 {
@@ -328,6 +328,18 @@ protected:
 	S32			mLastArrangeGeneration;
 	S32			mLastCalculatedWidth;
 	bool		mNeedsSort;
+	// <polarity> Virtualised rows
+	// Visible items of a very large folder, top to bottom. arrange() only
+	// positions them, the ones inside the scroll view are arranged and
+	// drawn by drawVirtualRows(). This only culls layout and drawing:
+	// every item still has its widget, which selection, keyboard
+	// navigation, drag and drop and the filter all go through, and
+	// arrange() still walks them all for visibility and position.
+	std::vector<LLFolderViewItem*> mVirtualRows;
+	S32			mVirtualRowsWidth;	// widest row arranged so far
+
+	void drawVirtualRows();
+	// </polarity>
 
 public:
 	typedef enum e_recurse_type
@@ -83,9 +83,12 @@ struct SortScrollListItem
 
 			S32 order = sort_ascending ? 1 : -1; // ascending or descending sort for this column?
 
-			const LLScrollListCell *cell1 = i1->getColumn(col_idx);
-			const LLScrollListCell *cell2 = i2->getColumn(col_idx);
-			if (cell1 && cell2)
+			// <polarity> Lazy cells
+			//const LLScrollListCell *cell1 = i1->getColumn(col_idx);
+			//const LLScrollListCell *cell2 = i2->getColumn(col_idx);
+			//if (cell1 && cell2)
+			if (i1->hasColumn(col_idx) && i2->hasColumn(col_idx))
+			// </polarity>
 			{
 				if(mSortSignal)
 				{
@@ -93,7 +96,10 @@ struct SortScrollListItem
 				}
 				else
 				{
-					sort_result = order * LLStringUtil::compareDict(cell1->getValue().asString(), cell2->getValue().asString());
+					// <polarity> Lazy cells
+					//sort_result = order * LLStringUtil::compareDict(cell1->getValue().asString(), cell2->getValue().asString());
+					sort_result = order * LLStringUtil::compareDict(i1->getColumnValue(col_idx).asString(), i2->getColumnValue(col_idx).asString());
+					// </polarity>
 				}
 				if (sort_result != 0)
 				{
@@ -132,6 +138,7 @@ LLScrollListCtrl::Params::Params()
 	sort_ascending("sort_ascending", true),
 	persist_sort_order("persist_sort_order", false),	// <FS:Ansariel> Persists sort order of scroll lists
 	primary_sort_only("primary_sort_only", false),		// <FS:Ansariel> Option to only sort by one column
+	lazy_cells("lazy_cells", false),					// <polarity/>
 	mouse_wheel_opaque("mouse_wheel_opaque", false),
 	commit_on_keyboard_movement("commit_on_keyboard_movement", true),
 	heading_height("heading_height"),
@@ -182,6 +189,8 @@ LLScrollListCtrl::LLScrollListCtrl(const LLScrollListCtrl::Params& p)
 	mTotalStaticColumnWidth(0),
 	mTotalColumnPadding(0),
 	mSorted(false),
+	mSortedCount(0), // <polarity/>
+	mLazyCells(p.lazy_cells), // <polarity/>
 	mDirty(false),
 	mOriginalSelection(-1),
 	mLastSelected(NULL),
@@ -407,7 +416,10 @@ S32 LLScrollListCtrl::getItemCount() const
 		for(iter = mItemList.begin(); iter != mItemList.end(); iter++)
 		{
 			LLScrollListItem* item  = *iter;
-			std::string filterColumnValue = item->getColumn(mFilterColumn)->getValue().asString();
+			// <polarity> Lazy cells
+			//std::string filterColumnValue = item->getColumn(mFilterColumn)->getValue().asString();
+			std::string filterColumnValue = item->getColumnValue(mFilterColumn).asString();
+			// </polarity>
 			std::transform(filterColumnValue.begin(), filterColumnValue.end(), filterColumnValue.begin(), ::tolower);
 			if (filterColumnValue.find(mFilterString) == std::string::npos)
 			{
@@ -427,6 +439,7 @@ void LLScrollListCtrl::clearRows()
 {
 	std::for_each(mItemList.begin(), mItemList.end(), DeletePointer());
 	mItemList.clear();
+	mSortedCount = 0; // <polarity/>
 	//mItemCount = 0;
 
 	// Scroll the bar back up to the top.
@@ -644,8 +657,13 @@ BOOL LLScrollListCtrl::addItem( LLScrollListItem* item, EAddPosition pos, BOOL r
 	
 		case ADD_DEFAULT:
 		case ADD_BOTTOM:
+			// <polarity> Incremental sort
+			// keeps mSortedCount, so updateSort() only has to sort the new
+			// rows and merge them in
 			mItemList.push_back(item);
-			setNeedsSort();
+			//setNeedsSort();
+			mSorted = false;
+			// </polarity>
 			break;
 	
 		default:
@@ -665,14 +683,21 @@ BOOL LLScrollListCtrl::addItem( LLScrollListItem* item, EAddPosition pos, BOOL r
 			addColumn(col_params);
 		}
 
-		S32 num_cols = item->getNumColumns();
-		S32 i = 0;
-		for (LLScrollListCell* cell = item->getColumn(i); i < num_cols; cell = item->getColumn(++i))
+		// <polarity> Lazy cells
+		//S32 num_cols = item->getNumColumns();
+		//S32 i = 0;
+		//for (LLScrollListCell* cell = item->getColumn(i); i < num_cols; cell = item->getColumn(++i))
+		//{
+		//	if (i >= (S32)mColumnsIndexed.size()) break;
+		//
+		//	cell->setWidth(mColumnsIndexed[i]->getWidth());
+		//}
+		S32 num_cols = llmin(item->getNumColumns(), (S32)mColumnsIndexed.size());
+		for (S32 i = 0; i < num_cols; ++i)
 		{
-			if (i >= (S32)mColumnsIndexed.size()) break;
-
-			cell->setWidth(mColumnsIndexed[i]->getWidth());
+			item->setColumnWidth(i, mColumnsIndexed[i]->getWidth());
 		}
+		// </polarity>
 
 		updateLineHeightInsert(item);
 
@@ -705,10 +730,15 @@ S32 LLScrollListCtrl::calcMaxContentWidth()
 			item_list::iterator iter;
 			for (iter = mItemList.begin(); iter != mItemList.end(); iter++)
 			{
-				LLScrollListCell* cellp = (*iter)->getColumn(column->mIndex);
-				if (!cellp) continue;
-
-				column->mMaxContentWidth = llmax(LLFontGL::getFontSansSerifSmall()->getWidth(cellp->getValue().asString()) + mColumnPadding + COLUMN_TEXT_PADDING, column->mMaxContentWidth);
+				// <polarity> Lazy cells
+				//LLScrollListCell* cellp = (*iter)->getColumn(column->mIndex);
+				//if (!cellp) continue;
+				//
+				//column->mMaxContentWidth = llmax(LLFontGL::getFontSansSerifSmall()->getWidth(cellp->getValue().asString()) + mColumnPadding + COLUMN_TEXT_PADDING, column->mMaxContentWidth);
+				if (!(*iter)->hasColumn(column->mIndex)) continue;
+
+				column->mMaxContentWidth = llmax(LLFontGL::getFontSansSerifSmall()->getWidth((*iter)->getColumnValue(column->mIndex).asString()) + mColumnPadding + COLUMN_TEXT_PADDING, column->mMaxContentWidth);
+				// </polarity>
 			}
 		}
 		max_item_width += column->mMaxContentWidth;
@@ -761,12 +791,15 @@ void LLScrollListCtrl::updateLineHeight()
 	for (iter = mItemList.begin(); iter != mItemList.end(); iter++)
 	{
 		LLScrollListItem *itemp = *iter;
-		S32 num_cols = itemp->getNumColumns();
-		S32 i = 0;
-		for (const LLScrollListCell* cell = itemp->getColumn(i); i < num_cols; cell = itemp->getColumn(++i))
-		{
-			mLineHeight = llmax( mLineHeight, cell->getHeight() + SCROLL_LIST_ROW_PAD );
-		}
+		// <polarity> Lazy cells
+		//S32 num_cols = itemp->getNumColumns();
+		//S32 i = 0;
+		//for (const LLScrollListCell* cell = itemp->getColumn(i); i < num_cols; cell = itemp->getColumn(++i))
+		//{
+		//	mLineHeight = llmax( mLineHeight, cell->getHeight() + SCROLL_LIST_ROW_PAD );
+		//}
+		updateLineHeightInsert(itemp);
+		// </polarity>
 	}
 }
 
@@ -774,11 +807,17 @@ void LLScrollListCtrl::updateLineHeight()
 void LLScrollListCtrl::updateLineHeightInsert(LLScrollListItem* itemp)
 {
 	S32 num_cols = itemp->getNumColumns();
-	S32 i = 0;
-	for (const LLScrollListCell* cell = itemp->getColumn(i); i < num_cols; cell = itemp->getColumn(++i))
+	// <polarity> Lazy cells
+	//S32 i = 0;
+	//for (const LLScrollListCell* cell = itemp->getColumn(i); i < num_cols; cell = itemp->getColumn(++i))
+	//{
+	//	mLineHeight = llmax( mLineHeight, cell->getHeight() + SCROLL_LIST_ROW_PAD );
+	//}
+	for (S32 i = 0; i < num_cols; ++i)
 	{
-		mLineHeight = llmax( mLineHeight, cell->getHeight() + SCROLL_LIST_ROW_PAD );
+		mLineHeight = llmax( mLineHeight, itemp->getColumnHeight(i) + SCROLL_LIST_ROW_PAD );
 	}
+	// </polarity>
 }
 
 
@@ -846,14 +885,21 @@ void LLScrollListCtrl::updateColumns(bool force_update)
 		for (iter = mItemList.begin(); iter != mItemList.end(); iter++)
 		{
 			LLScrollListItem *itemp = *iter;
-			S32 num_cols = itemp->getNumColumns();
-			S32 i = 0;
-			for (LLScrollListCell* cell = itemp->getColumn(i); i < num_cols; cell = itemp->getColumn(++i))
+			// <polarity> Lazy cells
+			//S32 num_cols = itemp->getNumColumns();
+			//S32 i = 0;
+			//for (LLScrollListCell* cell = itemp->getColumn(i); i < num_cols; cell = itemp->getColumn(++i))
+			//{
+			//	if (i >= (S32)mColumnsIndexed.size()) break;
+			//
+			//	cell->setWidth(mColumnsIndexed[i]->getWidth());
+			//}
+			S32 num_cols = llmin(itemp->getNumColumns(), (S32)mColumnsIndexed.size());
+			for (S32 i = 0; i < num_cols; ++i)
 			{
-				if (i >= (S32)mColumnsIndexed.size()) break;
-
-				cell->setWidth(mColumnsIndexed[i]->getWidth());
+				itemp->setColumnWidth(i, mColumnsIndexed[i]->getWidth());
 			}
+			// </polarity>
 		}
 	}
 }
@@ -938,6 +984,7 @@ BOOL LLScrollListCtrl::selectItemRange( S32 first_index, S32 last_index )
 		LLScrollListItem *itemp = *iter;
 		if(!itemp)
 		{
+			onItemErased(iter - mItemList.begin()); // <polarity/>
 			iter = mItemList.erase(iter);
 			continue ;
 		}
@@ -987,6 +1034,10 @@ void LLScrollListCtrl::swapWithNext(S32 index)
 	LLScrollListItem *cur_itemp = mItemList[index];
 	mItemList[index] = mItemList[index + 1];
 	mItemList[index + 1] = cur_itemp;
+	// <polarity> Incremental sort
+	// rows moved by hand are out of sort order, so nothing can be merged into them
+	mSortedCount = 0;
+	// </polarity>
 }
 
 
@@ -1001,6 +1052,10 @@ void LLScrollListCtrl::swapWithPrevious(S32 index)
 	LLScrollListItem *cur_itemp = mItemList[index];
 	mItemList[index] = mItemList[index - 1];
 	mItemList[index - 1] = cur_itemp;
+	// <polarity> Incremental sort
+	// rows moved by hand are out of sort order, so nothing can be merged into them
+	mSortedCount = 0;
+	// </polarity>
 }
 
 
@@ -1020,6 +1075,7 @@ void LLScrollListCtrl::deleteSingleItem(S32 target_index)
 		mLastSelected = NULL;
 	}
 	delete itemp;
+	onItemErased(target_index); // <polarity/>
 	mItemList.erase(mItemList.begin() + target_index);
 	dirtyColumns();
 }
@@ -1038,6 +1094,7 @@ void LLScrollListCtrl::deleteItems(const LLSD& sd)
 				mLastSelected = NULL;
 			}
 			delete itemp;
+			onItemErased(iter - mItemList.begin()); // <polarity/>
 			iter = mItemList.erase(iter);
 		}
 		else
@@ -1058,6 +1115,7 @@ void LLScrollListCtrl::deleteSelectedItems()
 		if (itemp->getSelected())
 		{
 			delete itemp;
+			onItemErased(iter - mItemList.begin()); // <polarity/>
 			iter = mItemList.erase(iter);
 		}
 		else
@@ -2674,15 +2732,128 @@ void  LLScrollListCtrl::sortByColumnIndex(U32 column, BOOL ascending)
 	updateSort();
 }
 
+// <polarity> Incremental sort
+static LLTrace::BlockTimerStatHandle FTM_SORT_SCROLL_LIST("Sort Scroll List");
+
+namespace
+{
+	// orders row indices by sort keys taken out of the rows once, instead of
+	// fetching and converting two cell values for every comparison
+	struct SortScrollListKeys
+	{
+		typedef std::vector<std::pair<S32, BOOL> > sort_order_t;
+
+		SortScrollListKeys(const sort_order_t& sort_orders, const std::vector<std::string>& keys, const std::vector<U8>& has_keys)
+		:	mSortOrders(sort_orders),
+			mKeys(keys),
+			mHasKeys(has_keys)
+		{}
+
+		// same rules as SortScrollListItem
+		bool operator()(U32 row1, U32 row2) const
+		{
+			const size_t num_keys = mSortOrders.size();
+			S32 sort_result = 0;
+			for (size_t key = num_keys; key-- > 0; )
+			{
+				const size_t key1 = row1 * num_keys + key;
+				const size_t key2 = row2 * num_keys + key;
+				if (mHasKeys[key1] && mHasKeys[key2])
+				{
+					sort_result = (mSortOrders[key].second ? 1 : -1) * LLStringUtil::compareDict(mKeys[key1], mKeys[key2]);
+					if (sort_result != 0)
+					{
+						break;
+					}
+				}
+			}
+			return sort_result < 0;
+		}
+
+		const sort_order_t& mSortOrders;
+		const std::vector<std::string>& mKeys;
+		const std::vector<U8>& mHasKeys;
+	};
+}
+
+// Sorts a range of rows through a permutation of their indices. Without a
+// sort callback, every row's sort keys are read once up front. Rows are
+// only moved once, at the end.
+void LLScrollListCtrl::sortRange(item_list::iterator begin, item_list::iterator end, const std::vector<std::pair<S32, BOOL> >& sort_columns) const
+{
+	const size_t num_rows = end - begin;
+	if (num_rows < 2)
+	{
+		return;
+	}
+
+	std::vector<U32> order(num_rows);
+	for (size_t row = 0; row < num_rows; ++row)
+	{
+		order[row] = row;
+	}
+
+	if (mSortCallback)
+	{
+		std::vector<LLScrollListItem*> rows(begin, end);
+		SortScrollListItem compare(sort_columns, mSortCallback);
+		std::stable_sort(order.begin(), order.end(), [&](U32 row1, U32 row2) { return compare(rows[row1], rows[row2]); });
+	}
+	else
+	{
+		const size_t num_keys = sort_columns.size();
+		std::vector<std::string> keys(num_rows * num_keys);
+		std::vector<U8> has_keys(num_rows * num_keys, 0);
+		for (size_t row = 0; row < num_rows; ++row)
+		{
+			const LLScrollListItem* item = *(begin + row);
+			for (size_t key = 0; key < num_keys; ++key)
+			{
+				if (item->hasColumn(sort_columns[key].first))
+				{
+					keys[row * num_keys + key] = item->getColumnValue(sort_columns[key].first).asString();
+					has_keys[row * num_keys + key] = 1;
+				}
+			}
+		}
+		std::stable_sort(order.begin(), order.end(), SortScrollListKeys(sort_columns, keys, has_keys));
+	}
+
+	std::vector<LLScrollListItem*> sorted(num_rows);
+	for (size_t row = 0; row < num_rows; ++row)
+	{
+		sorted[row] = *(begin + order[row]);
+	}
+	std::copy(sorted.begin(), sorted.end(), begin);
+}
+// </polarity>
+
 void LLScrollListCtrl::updateSort() const
 {
 	if (hasSortOrder() && !isSorted())
 	{
+		// <polarity> Incremental sort
 		// do stable sort to preserve any previous sorts
-		std::stable_sort(
-			mItemList.begin(), 
-			mItemList.end(), 
-			SortScrollListItem(mSortColumns,mSortCallback));
+		//std::stable_sort(
+		//	mItemList.begin(), 
+		//	mItemList.end(), 
+		//	SortScrollListItem(mSortColumns,mSortCallback));
+		LL_RECORD_BLOCK_TIME(FTM_SORT_SCROLL_LIST);
+		const S32 sorted_count = llclamp(mSortedCount, 0, (S32)mItemList.size());
+		if (sorted_count > 0)
+		{
+			// only rows were added at the bottom, sort those and merge them
+			// in, which keeps the order a full stable sort would give
+			item_list::iterator middle = mItemList.begin() + sorted_count;
+			sortRange(middle, mItemList.end(), mSortColumns);
+			std::inplace_merge(mItemList.begin(), middle, mItemList.end(), SortScrollListItem(mSortColumns, mSortCallback));
+		}
+		else
+		{
+			sortRange(mItemList.begin(), mItemList.end(), mSortColumns);
+		}
+		mSortedCount = mItemList.size();
+		// </polarity>
 
 		mSorted = true;
 	}
@@ -2695,10 +2866,15 @@ void LLScrollListCtrl::sortOnce(S32 column, BOOL ascending)
 	sort_column.push_back(std::make_pair(column, ascending));
 
 	// do stable sort to preserve any previous sorts
-	std::stable_sort(
-		mItemList.begin(), 
-		mItemList.end(), 
-		SortScrollListItem(sort_column,mSortCallback));
+	// <polarity> Incremental sort
+	//std::stable_sort(
+	//	mItemList.begin(), 
+	//	mItemList.end(), 
+	//	SortScrollListItem(sort_column,mSortCallback));
+	sortRange(mItemList.begin(), mItemList.end(), sort_column);
+	// no longer in the permanent order, so nothing can be merged into it
+	mSortedCount = 0;
+	// </polarity>
 }
 
 void LLScrollListCtrl::dirtyColumns() 
@@ -3161,6 +3337,20 @@ LLScrollListItem* LLScrollListCtrl::addRow(LLScrollListItem *new_item, const LLS
 			cell_p.width = columnp->getWidth();
 		}
 
+		// <polarity> Lazy cells
+		// text cells wait until they are drawn or asked for, anything else is
+		// cheap enough to build now and may have a value of another type
+		if (mLazyCells && cell_p.type() != "icon" && cell_p.type() != "checkbox" && cell_p.type() != "date")
+		{
+			new_item->setPendingColumn(index, cell_p);
+			if (columnp->mHeader && !cell_p.value().asString().empty())
+			{
+				columnp->mHeader->setHasResizableElement(TRUE);
+			}
+			col_index++;
+			continue;
+		}
+		// </polarity>
 		LLScrollListCell* cell = LLScrollListCell::create(cell_p);
 
 		if (cell)
@@ -3207,7 +3397,10 @@ LLScrollListItem* LLScrollListCtrl::addRow(LLScrollListItem *new_item, const LLS
 	for (column_map_t::iterator column_it = mColumns.begin(); column_it != mColumns.end(); ++column_it)
 	{
 		S32 column_idx = column_it->second->mIndex;
-		if (new_item->getColumn(column_idx) == NULL)
+		// <polarity> Lazy cells
+		//if (new_item->getColumn(column_idx) == NULL)
+		if (!new_item->hasColumn(column_idx))
+		// </polarity>
 		{
 			LLScrollListColumn* column_ptr = column_it->second;
 			LLScrollListCell::Params cell_p;
@@ -3351,7 +3544,10 @@ bool LLScrollListCtrl::isFiltered(const LLScrollListItem* item) const
 {
 	if (mIsFiltered)
 	{
-		std::string filterColumnValue = item->getColumn(mFilterColumn)->getValue().asString();
+		// <polarity> Lazy cells
+		//std::string filterColumnValue = item->getColumn(mFilterColumn)->getValue().asString();
+		std::string filterColumnValue = item->getColumnValue(mFilterColumn).asString();
+		// </polarity>
 		std::transform(filterColumnValue.begin(), filterColumnValue.end(), filterColumnValue.begin(), ::tolower);
 		if (filterColumnValue.find(mFilterString) == std::string::npos)
 		{
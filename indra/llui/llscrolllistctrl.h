@@ -116,6 +116,7 @@ public:
 		Optional<bool>	sort_ascending;
 		Optional<bool>	persist_sort_order; 	// <FS:Ansariel> Persists sort order of scroll lists
 		Optional<bool>	primary_sort_only;		// <FS:Ansariel> Option to only sort by one column
+		Optional<bool>	lazy_cells;				// <polarity/> create text cells when first needed
 
 		// colors
 		Optional<LLUIColor>	fg_unselected_color,
@@ -403,7 +404,10 @@ public:
 	void			sortOnce(S32 column, BOOL ascending);
 
 	// manually call this whenever editing list items in place to flag need for resorting
-	void			setNeedsSort(bool val = true) { mSorted = !val; }
+	// <polarity> Incremental sort
+	//void			setNeedsSort(bool val = true) { mSorted = !val; }
+	void			setNeedsSort(bool val = true) { mSorted = !val; mSortedCount = 0; }
+	// </polarity>
 	void			dirtyColumns(); // some operation has potentially affected column layout or ordering
 
 	boost::signals2::connection setSortCallback(sort_signal_t::slot_type cb )
@@ -541,6 +545,15 @@ private:
 	bool			mPrimarySortOnly;
 
 	mutable bool	mSorted;
+	// <polarity> Incremental sort
+	// rows at the front of mItemList that are still in order, rows added
+	// at the bottom since the last sort are merged in after them
+	mutable S32		mSortedCount;
+	bool			mLazyCells;
+
+	void			sortRange(item_list::iterator begin, item_list::iterator end, const std::vector<std::pair<S32, BOOL> >& sort_columns) const;
+	void			onItemErased(S32 index) { if (index < mSortedCount) --mSortedCount; }
+	// </polarity>
 	
 	typedef std::map<std::string, LLScrollListColumn*> column_map_t;
 	column_map_t mColumns;
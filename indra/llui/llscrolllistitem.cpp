@@ -53,6 +53,7 @@ LLScrollListItem::~LLScrollListItem()
 {
 	std::for_each(mColumns.begin(), mColumns.end(), DeletePointer());
 	mColumns.clear();
+	std::for_each(mPendingColumns.begin(), mPendingColumns.end(), DeletePointer()); // <polarity/>
 }
 
 void LLScrollListItem::addColumn(const LLScrollListCell::Params& p)
@@ -66,6 +67,13 @@ void LLScrollListItem::setNumColumns(S32 columns)
 	if (columns < prev_columns)
 	{
 		std::for_each(mColumns.begin()+columns, mColumns.end(), DeletePointer());
+		// <polarity> Lazy cells
+		if (columns < (S32)mPendingColumns.size())
+		{
+			std::for_each(mPendingColumns.begin() + columns, mPendingColumns.end(), DeletePointer());
+			mPendingColumns.resize(columns);
+		}
+		// </polarity>
 	}
 	
 	mColumns.resize(columns);
@@ -82,6 +90,13 @@ void LLScrollListItem::setColumn( S32 column, LLScrollListCell *cell )
 	{
 		delete mColumns[column];
 		mColumns[column] = cell;
+		// <polarity> Lazy cells
+		if (column < (S32)mPendingColumns.size())
+		{
+			delete mPendingColumns[column];
+			mPendingColumns[column] = NULL;
+		}
+		// </polarity>
 	}
 	else
 	{
@@ -99,11 +114,83 @@ LLScrollListCell* LLScrollListItem::getColumn(const S32 i) const
 {
 	if (0 <= i && i < (S32)mColumns.size())
 	{
+		// <polarity> Lazy cells
+		if (i < (S32)mPendingColumns.size() && mPendingColumns[i])
+		{
+			mColumns[i] = LLScrollListCell::create(*mPendingColumns[i]);
+			delete mPendingColumns[i];
+			mPendingColumns[i] = NULL;
+		}
+		// </polarity>
 		return mColumns[i];
 	} 
 	return NULL;
 }
 
+// <polarity> Lazy cells
+void LLScrollListItem::setPendingColumn(S32 column, const LLScrollListCell::Params& p)
+{
+	if (column < 0 || column >= (S32)mColumns.size())
+	{
+		LL_ERRS() << "LLScrollListItem::setPendingColumn: bad column: " << column << LL_ENDL;
+		return;
+	}
+	delete mColumns[column];
+	mColumns[column] = NULL;
+	if (mPendingColumns.size() < mColumns.size())
+	{
+		mPendingColumns.resize(mColumns.size(), NULL);
+	}
+	delete mPendingColumns[column];
+	mPendingColumns[column] = new LLScrollListCell::Params(p);
+}
+
+bool LLScrollListItem::hasColumn(S32 column) const
+{
+	if (column < 0 || column >= (S32)mColumns.size())
+	{
+		return false;
+	}
+	return mColumns[column] || (column < (S32)mPendingColumns.size() && mPendingColumns[column]);
+}
+
+// only text cells are deferred, and a text cell's value is its params'
+// value as a string
+LLSD LLScrollListItem::getColumnValue(S32 column) const
+{
+	if (0 <= column && column < (S32)mPendingColumns.size() && mPendingColumns[column])
+	{
+		return LLSD(mPendingColumns[column]->value().asString());
+	}
+	const LLScrollListCell* cell = getColumn(column);
+	return cell ? cell->getValue() : LLSD();
+}
+
+S32 LLScrollListItem::getColumnHeight(S32 column) const
+{
+	if (0 <= column && column < (S32)mPendingColumns.size() && mPendingColumns[column])
+	{
+		return mPendingColumns[column]->font()->getLineHeight();
+	}
+	const LLScrollListCell* cell = getColumn(column);
+	return cell ? cell->getHeight() : 0;
+}
+
+void LLScrollListItem::setColumnWidth(S32 column, S32 width)
+{
+	if (0 <= column && column < (S32)mPendingColumns.size() && mPendingColumns[column])
+	{
+		mPendingColumns[column]->width = width;
+		return;
+	}
+	LLScrollListCell* cell = getColumn(column);
+	if (cell)
+	{
+		cell->setWidth(width);
+	}
+}
+// </polarity>
+
 std::string LLScrollListItem::getContentsCSV() const
 {
 	std::string ret;
@@ -105,6 +105,18 @@ public:
 
 	LLScrollListCell *getColumn(const S32 i) const;
 
+	// <polarity> Lazy cells
+	// Rows of a list with lazy_cells set keep the params of their text cells
+	// and only create a cell when getColumn() asks for it, which for most
+	// rows of a long list is when they are first scrolled into view. These
+	// answer for a cell without creating it.
+	void	setPendingColumn(S32 column, const LLScrollListCell::Params& p);
+	bool	hasColumn(S32 column) const;
+	LLSD	getColumnValue(S32 column) const;
+	S32		getColumnHeight(S32 column) const;
+	void	setColumnWidth(S32 column, S32 width);
+	// </polarity>
+
 	std::string getContentsCSV() const;
 
 	virtual void draw(const LLRect& rect, const LLColor4& fg_color, const LLColor4& bg_color, const LLColor4& highlight_color, S32 column_padding);
@@ -118,7 +130,8 @@ private:
 	BOOL	mEnabled;
 	void*	mUserdata;
 	LLSD	mItemValue;
-	std::vector<LLScrollListCell *> mColumns;
+	mutable std::vector<LLScrollListCell *> mColumns; // <polarity/> filled in by getColumn()
+	mutable std::vector<LLScrollListCell::Params *> mPendingColumns; // <polarity/> NULL once the cell exists
 	LLRect  mRectangle;
 };
 
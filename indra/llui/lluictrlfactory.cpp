@@ -45,6 +45,7 @@
 
 // this library includes
 #include "llpanel.h"
+#include "pvxuibundle.h" // <polarity/>
 
 LLTrace::BlockTimerStatHandle FTM_WIDGET_CONSTRUCTION("Widget Construction");
 LLTrace::BlockTimerStatHandle FTM_INIT_FROM_PARAMS("Widget InitFromParams");
@@ -178,7 +179,23 @@ bool LLUICtrlFactory::getLayeredXMLNode(const std::string &xui_filename, LLXMLNo
 		paths.push_back(xui_filename);
 	}
 
-	return LLXMLNode::getLayeredXMLNode(root, paths);
+	// <polarity> Binary XUI bundle
+	// return LLXMLNode::getLayeredXMLNode(root, paths);
+	static LLUICachedControl<bool> use_xui_bundle("PVUI_XUIBinaryBundle", true);
+	if (use_xui_bundle && PVXUIBundle::instance().find(paths, root))
+	{
+		return true;
+	}
+	if (!LLXMLNode::getLayeredXMLNode(root, paths))
+	{
+		return false;
+	}
+	if (use_xui_bundle)
+	{
+		PVXUIBundle::instance().add(paths, root);
+	}
+	return true;
+	// </polarity>
 }
 
 
@@ -0,0 +1,524 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/**
+ * @file pvxuibundle.cpp
+ * @brief Binary bundle of merged XUI trees.
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "pvxuibundle.h"
+
+#include "llfasttimer.h"
+#include "llfile.h"
+#include "llstringtable.h"
+
+static LLTrace::BlockTimerStatHandle FTM_XUI_BUNDLE_LOAD("XUI Bundle Load");
+static LLTrace::BlockTimerStatHandle FTM_XUI_BUNDLE_READ("XUI Bundle Read");
+
+static const char BUNDLE_MAGIC[4] = { 'P', 'V', 'X', 'B' };
+// bump whenever the record layout below changes
+static const U32 BUNDLE_FORMAT_VERSION = 1;
+// far deeper than any XUI file, only there to stop a damaged record
+static const S32 MAX_NODE_DEPTH = 256;
+
+namespace
+{
+	// Everything is stored in host order, the bundle never leaves the machine.
+	//
+	// A node record is
+	//   U32 name index, U8 is attribute, U8 type, U8 encoding,
+	//   U32 version major, U32 version minor, U32 length, U32 precision,
+	//   S32 line number, string id, string value,
+	//   U32 attribute count, attribute records,
+	//   U32 child count, child records in document order
+	// and a string is a U32 length followed by the bytes.
+	class Writer
+	{
+	public:
+		Writer(std::vector<U8>& buffer) : mBuffer(buffer) {}
+
+		template <typename T>
+		void put(const T& value)
+		{
+			const U8* bytes = (const U8*)&value;
+			mBuffer.insert(mBuffer.end(), bytes, bytes + sizeof(T));
+		}
+
+		void putString(const std::string& str)
+		{
+			put((U32)str.size());
+			mBuffer.insert(mBuffer.end(), str.begin(), str.end());
+		}
+
+		void putBytes(const std::vector<U8>& bytes)
+		{
+			put((U32)bytes.size());
+			mBuffer.insert(mBuffer.end(), bytes.begin(), bytes.end());
+		}
+
+	private:
+		std::vector<U8>& mBuffer;
+	};
+
+	// Every read is bounds checked, a short or damaged file just turns ok() off.
+	class Reader
+	{
+	public:
+		Reader(const U8* data, size_t size) : mPos(data), mEnd(data + size), mOk(true) {}
+
+		template <typename T>
+		T get()
+		{
+			T value = T();
+			if (mOk && remaining() >= sizeof(T))
+			{
+				memcpy(&value, mPos, sizeof(T));
+				mPos += sizeof(T);
+			}
+			else
+			{
+				mOk = false;
+			}
+			return value;
+		}
+
+		void getString(std::string& str)
+		{
+			const U32 length = get<U32>();
+			if (mOk && remaining() >= length)
+			{
+				str.assign((const char*)mPos, length);
+				mPos += length;
+			}
+			else
+			{
+				mOk = false;
+				str.clear();
+			}
+		}
+
+		void getBytes(std::vector<U8>& bytes)
+		{
+			const U32 length = get<U32>();
+			if (mOk && remaining() >= length)
+			{
+				bytes.assign(mPos, mPos + length);
+				mPos += length;
+			}
+			else
+			{
+				mOk = false;
+				bytes.clear();
+			}
+		}
+
+		// a count of items of at least item_size bytes each, checked against
+		// what is left so a damaged count cannot ask for a huge allocation
+		U32 getCount(size_t item_size)
+		{
+			const U32 count = get<U32>();
+			if (mOk && count > remaining() / item_size)
+			{
+				mOk = false;
+			}
+			return mOk ? count : 0;
+		}
+
+		size_t remaining() const	{ return (size_t)(mEnd - mPos); }
+		bool ok() const				{ return mOk; }
+
+	private:
+		const U8*	mPos;
+		const U8*	mEnd;
+		bool		mOk;
+	};
+
+	typedef std::map<const LLStringTableEntry*, U32> name_index_t;
+
+	bool write_node(Writer& writer, const LLXMLNode* node, name_index_t& name_index, std::vector<std::string>& names)
+	{
+		const LLStringTableEntry* name = node->getName();
+		if (!name)
+		{
+			// a null node has no string table entry to come back to
+			return false;
+		}
+		name_index_t::iterator name_iter = name_index.find(name);
+		if (name_iter == name_index.end())
+		{
+			name_iter = name_index.insert(std::make_pair(name, (U32)names.size())).first;
+			names.push_back(name->mString);
+		}
+
+		writer.put(name_iter->second);
+		writer.put((U8)(node->mIsAttribute ? 1 : 0));
+		writer.put((U8)node->getType());
+		writer.put((U8)node->mEncoding);
+		writer.put(node->mVersionMajor);
+		writer.put(node->mVersionMinor);
+		writer.put(node->getLength());
+		writer.put(node->getPrecision());
+		writer.put(node->mLineNumber);
+		writer.putString(node->mID);
+		writer.putString(node->getValue());
+
+		writer.put((U32)node->mAttributes.size());
+		for (LLXMLAttribList::const_iterator iter = node->mAttributes.begin(); iter != node->mAttributes.end(); ++iter)
+		{
+			if (!write_node(writer, iter->second, name_index, names))
+			{
+				return false;
+			}
+		}
+
+		U32 child_count = 0;
+		for (LLXMLNode* child = node->mChildren.notNull() ? node->mChildren->head.get() : NULL; child; child = child->mNext)
+		{
+			++child_count;
+		}
+		writer.put(child_count);
+		for (LLXMLNode* child = node->mChildren.notNull() ? node->mChildren->head.get() : NULL; child; child = child->mNext)
+		{
+			if (!write_node(writer, child, name_index, names))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Builds top down, each node is attached before its own children are read
+	// so addChild() never walks a subtree.
+	LLXMLNodePtr read_node(Reader& reader, const std::vector<LLStringTableEntry*>& names, LLXMLNode* parent, S32 depth)
+	{
+		const U32 name = reader.get<U32>();
+		const U8 is_attribute = reader.get<U8>();
+		const U8 type = reader.get<U8>();
+		const U8 encoding = reader.get<U8>();
+		const U32 version_major = reader.get<U32>();
+		const U32 version_minor = reader.get<U32>();
+		const U32 length = reader.get<U32>();
+		const U32 precision = reader.get<U32>();
+		const S32 line_number = reader.get<S32>();
+		std::string id;
+		std::string value;
+		reader.getString(id);
+		reader.getString(value);
+		if (!reader.ok() || name >= names.size() || depth > MAX_NODE_DEPTH
+			|| type > LLXMLNode::TYPE_NODEREF || encoding > LLXMLNode::ENCODING_HEX)
+		{
+			return NULL;
+		}
+
+		LLXMLNodePtr node = new LLXMLNode(names[name], is_attribute ? TRUE : FALSE);
+		node->mID = id;
+		node->mVersionMajor = version_major;
+		node->mVersionMinor = version_minor;
+		node->setLineNumber(line_number);
+		node->setValue(value);
+		node->setAttributes((LLXMLNode::ValueType)type, precision, (LLXMLNode::Encoding)encoding, length);
+		if (parent)
+		{
+			parent->addChild(node);
+		}
+
+		// the smallest record is 43 bytes, an empty id and value and no nodes under it
+		const U32 attribute_count = reader.getCount(43);
+		for (U32 i = 0; i < attribute_count; ++i)
+		{
+			if (read_node(reader, names, node, depth + 1).isNull())
+			{
+				return NULL;
+			}
+		}
+		const U32 child_count = reader.getCount(43);
+		for (U32 i = 0; i < child_count; ++i)
+		{
+			if (read_node(reader, names, node, depth + 1).isNull())
+			{
+				return NULL;
+			}
+		}
+		return reader.ok() ? node : LLXMLNodePtr(NULL);
+	}
+}
+
+PVXUIBundle::PVXUIBundle()
+:	mReadOnly(true),
+	mDirty(false)
+{
+}
+
+PVXUIBundle::~PVXUIBundle()
+{
+}
+
+//static
+std::string PVXUIBundle::makeKey(const std::vector<std::string>& paths)
+{
+	std::string key;
+	for (std::vector<std::string>::const_iterator iter = paths.begin(); iter != paths.end(); ++iter)
+	{
+		key += *iter;
+		key += '\n';
+	}
+	return key;
+}
+
+//static
+bool PVXUIBundle::stampLayers(const std::vector<std::string>& paths, std::vector<U64>& stamps)
+{
+	stamps.clear();
+	stamps.reserve(paths.size() * 2);
+	for (std::vector<std::string>::const_iterator iter = paths.begin(); iter != paths.end(); ++iter)
+	{
+		llstat stat_data;
+		if (LLFile::stat(*iter, &stat_data) != 0)
+		{
+			return false;
+		}
+		stamps.push_back((U64)stat_data.st_size);
+		stamps.push_back((U64)stat_data.st_mtime);
+	}
+	return true;
+}
+
+void PVXUIBundle::load(const std::string& filename, bool read_only)
+{
+	LL_RECORD_BLOCK_TIME(FTM_XUI_BUNDLE_LOAD);
+
+	mFilename = filename;
+	mReadOnly = read_only;
+	mDirty = false;
+	mEntries.clear();
+
+	LLFILE* fp = LLFile::fopen(filename, "rb");
+	if (!fp)
+	{
+		// first run, or the cache was purged
+		return;
+	}
+	std::vector<U8> buffer;
+	if (fseek(fp, 0, SEEK_END) == 0)
+	{
+		const long size = ftell(fp);
+		if (size > 0 && fseek(fp, 0, SEEK_SET) == 0)
+		{
+			buffer.resize((size_t)size);
+			if (fread(&buffer[0], 1, buffer.size(), fp) != buffer.size())
+			{
+				buffer.clear();
+			}
+		}
+	}
+	fclose(fp);
+
+	Reader reader(buffer.empty() ? NULL : &buffer[0], buffer.size());
+	char magic[4];
+	for (S32 i = 0; i < 4; ++i)
+	{
+		magic[i] = reader.get<char>();
+	}
+	const U32 format_version = reader.get<U32>();
+	if (!reader.ok() || memcmp(magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC)) != 0 || format_version != BUNDLE_FORMAT_VERSION)
+	{
+		LL_INFOS("XUIBundle") << "XUI bundle " << filename << " is from another version, rebuilding" << LL_ENDL;
+		mDirty = true;
+		return;
+	}
+
+	const U32 entry_count = reader.getCount(16);
+	for (U32 i = 0; i < entry_count && reader.ok(); ++i)
+	{
+		std::string key;
+		reader.getString(key);
+		Entry& entry = mEntries[key];
+		const U32 stamp_count = reader.getCount(sizeof(U64));
+		entry.mStamps.resize(stamp_count);
+		for (U32 j = 0; j < stamp_count; ++j)
+		{
+			entry.mStamps[j] = reader.get<U64>();
+		}
+		const U32 name_count = reader.getCount(sizeof(U32));
+		entry.mNames.resize(name_count);
+		for (U32 j = 0; j < name_count; ++j)
+		{
+			reader.getString(entry.mNames[j]);
+		}
+		reader.getBytes(entry.mNodes);
+	}
+	if (!reader.ok() || reader.remaining() != 0)
+	{
+		LL_WARNS("XUIBundle") << "XUI bundle " << filename << " is corrupt, rebuilding" << LL_ENDL;
+		mEntries.clear();
+		mDirty = true;
+		return;
+	}
+	LL_INFOS("XUIBundle") << "Loaded " << mEntries.size() << " XUI records from " << filename << LL_ENDL;
+}
+
+void PVXUIBundle::save()
+{
+	if (!mDirty || mReadOnly || mFilename.empty())
+	{
+		return;
+	}
+
+	std::vector<U8> buffer;
+	Writer writer(buffer);
+	buffer.insert(buffer.end(), BUNDLE_MAGIC, BUNDLE_MAGIC + sizeof(BUNDLE_MAGIC));
+	writer.put(BUNDLE_FORMAT_VERSION);
+
+	// records whose layers changed since would only be rebuilt on their next
+	// use, and may never have one after a skin or language switch
+	std::vector<const entry_map_t::value_type*> current;
+	current.reserve(mEntries.size());
+	for (entry_map_t::const_iterator iter = mEntries.begin(); iter != mEntries.end(); ++iter)
+	{
+		std::vector<std::string> paths;
+		std::string::size_type start = 0;
+		std::string::size_type end;
+		while ((end = iter->first.find('\n', start)) != std::string::npos)
+		{
+			paths.push_back(iter->first.substr(start, end - start));
+			start = end + 1;
+		}
+		std::vector<U64> stamps;
+		if (stampLayers(paths, stamps) && stamps == iter->second.mStamps)
+		{
+			current.push_back(&*iter);
+		}
+	}
+
+	writer.put((U32)current.size());
+	for (size_t i = 0; i < current.size(); ++i)
+	{
+		const Entry& entry = current[i]->second;
+		writer.putString(current[i]->first);
+		writer.put((U32)entry.mStamps.size());
+		for (size_t j = 0; j < entry.mStamps.size(); ++j)
+		{
+			writer.put(entry.mStamps[j]);
+		}
+		writer.put((U32)entry.mNames.size());
+		for (size_t j = 0; j < entry.mNames.size(); ++j)
+		{
+			writer.putString(entry.mNames[j]);
+		}
+		writer.putBytes(entry.mNodes);
+	}
+
+	// write next to the real file and swap it in, a crash mid-write must not
+	// leave a bundle that loads but lies
+	const std::string temp_filename = mFilename + ".tmp";
+	LLFILE* fp = LLFile::fopen(temp_filename, "wb");
+	if (!fp)
+	{
+		LL_WARNS("XUIBundle") << "unable to save XUI bundle to: " << temp_filename << LL_ENDL;
+		return;
+	}
+	const size_t written = fwrite(&buffer[0], 1, buffer.size(), fp);
+	fclose(fp);
+	if (written != buffer.size())
+	{
+		LL_WARNS("XUIBundle") << "short write saving XUI bundle to: " << temp_filename << LL_ENDL;
+		LLFile::remove(temp_filename);
+		return;
+	}
+	LLFile::remove(mFilename, ENOENT);
+	if (LLFile::rename(temp_filename, mFilename) != 0)
+	{
+		LLFile::remove(temp_filename);
+		return;
+	}
+	mDirty = false;
+	LL_INFOS("XUIBundle") << "Saved " << current.size() << " XUI records to " << mFilename << LL_ENDL;
+}
+
+bool PVXUIBundle::find(const std::vector<std::string>& paths, LLXMLNodePtr& root)
+{
+	if (mFilename.empty())
+	{
+		return false;
+	}
+	entry_map_t::iterator iter = mEntries.find(makeKey(paths));
+	if (iter == mEntries.end())
+	{
+		return false;
+	}
+	Entry& entry = iter->second;
+	std::vector<U64> stamps;
+	if (!stampLayers(paths, stamps) || stamps != entry.mStamps || entry.mNodes.empty())
+	{
+		// out of date, add() replaces it once the files are parsed again
+		return false;
+	}
+
+	LL_RECORD_BLOCK_TIME(FTM_XUI_BUNDLE_READ);
+	if (entry.mNameEntries.empty())
+	{
+		// entries are never removed from gStringTable, so the pointers can be
+		// kept for the next time this file is built
+		entry.mNameEntries.reserve(entry.mNames.size());
+		for (size_t i = 0; i < entry.mNames.size(); ++i)
+		{
+			entry.mNameEntries.push_back(gStringTable.addStringEntry(entry.mNames[i]));
+		}
+	}
+
+	Reader reader(&entry.mNodes[0], entry.mNodes.size());
+	LLXMLNodePtr node = read_node(reader, entry.mNameEntries, NULL, 0);
+	if (node.isNull() || !reader.ok() || reader.remaining() != 0)
+	{
+		LL_WARNS("XUIBundle") << "Dropping damaged XUI record for " << paths.front() << LL_ENDL;
+		mEntries.erase(iter);
+		mDirty = true;
+		return false;
+	}
+	root = node;
+	return true;
+}
+
+void PVXUIBundle::add(const std::vector<std::string>& paths, LLXMLNode* root)
+{
+	if (mFilename.empty() || !root)
+	{
+		return;
+	}
+	Entry entry;
+	if (!stampLayers(paths, entry.mStamps))
+	{
+		return;
+	}
+	name_index_t name_index;
+	Writer writer(entry.mNodes);
+	if (!write_node(writer, root, name_index, entry.mNames))
+	{
+		return;
+	}
+	Entry& slot = mEntries[makeKey(paths)];
+	slot.mStamps.swap(entry.mStamps);
+	slot.mNames.swap(entry.mNames);
+	slot.mNameEntries.clear();
+	slot.mNodes.swap(entry.mNodes);
+	mDirty = true;
+}
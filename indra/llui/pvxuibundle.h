@@ -0,0 +1,77 @@
+/**
+ * @file pvxuibundle.h
+ * @brief Binary bundle of merged XUI trees.
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef PV_PVXUIBUNDLE_H
+#define PV_PVXUIBUNDLE_H
+
+#include <boost/unordered_map.hpp>
+
+#include "llsingleton.h"
+#include "llxmlnode.h"
+
+// Keeps the result of LLXMLNode::getLayeredXMLNode(), the XUI file with its
+// skin and language layers merged in, as a compact binary record in a file
+// in the cache folder. Building a floater or panel whose record is there
+// skips expat and the layer merge, the tree is rebuilt straight from the
+// record. The widgets are still made from that tree by LLXUIParser as usual.
+//
+// A record is keyed on the layer paths, which carry the skin and language,
+// and is only used while every layer file has the size and modification time
+// it had when the record was made. Editing a skin file or updating the viewer
+// just rebuilds the records it touched on the next load.
+class PVXUIBundle : public LLSingleton<PVXUIBundle>
+{
+	LLSINGLETON(PVXUIBundle);
+	~PVXUIBundle();
+
+public:
+	// Nothing is looked up or recorded before this. Records added afterwards
+	// are written back by save() unless read_only is set.
+	void load(const std::string& filename, bool read_only);
+	void save();
+
+	// a fresh copy of the merged tree for these layers, false when there is
+	// no up to date record
+	bool find(const std::vector<std::string>& paths, LLXMLNodePtr& root);
+	void add(const std::vector<std::string>& paths, LLXMLNode* root);
+
+private:
+	struct Entry
+	{
+		std::vector<U64>					mStamps;		// size and mtime of each layer
+		std::vector<std::string>			mNames;			// node and attribute names
+		std::vector<LLStringTableEntry*>	mNameEntries;	// mNames in gStringTable, filled on first use
+		std::vector<U8>						mNodes;
+	};
+	typedef boost::unordered_map<std::string, Entry> entry_map_t;
+
+	static std::string makeKey(const std::vector<std::string>& paths);
+	static bool stampLayers(const std::vector<std::string>& paths, std::vector<U64>& stamps);
+
+	std::string	mFilename;
+	bool		mReadOnly;
+	bool		mDirty;
+	entry_map_t	mEntries;
+};
+
+#endif // PV_PVXUIBUNDLE_H
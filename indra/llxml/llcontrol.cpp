@@ -46,6 +46,10 @@
 #include "llxmltree.h"
 #include "llsdserialize.h"
 #include "v4math.h" // <Black Dragon:NiranV> Vector4
+// <polarity> Hashed control lookups
+#include "llmutex.h"
+#include <boost/unordered_map.hpp>
+// </polarity>
 
 #if LL_RELEASE_WITH_DEBUG_INFO || LL_DEBUG
 #define CONTROL_ERRS LL_ERRS("ControlErrors")
@@ -408,12 +412,198 @@ LLSD LLControlVariable::getSaveValue() const
 	return mValues[0];
 }
 
-LLPointer<LLControlVariable> LLControlGroup::getControl(const std::string& name)
+// <polarity> Hashed control lookups
+namespace
 {
-	ctrl_name_table_t::iterator iter = mNameTable.find(name);
-	return iter == mNameTable.end() ? LLPointer<LLControlVariable>() : iter->second;
+	const size_t MIN_HASH_SLOTS = 256;
+	const U32 LOOKUP_REPORT_FRAMES = 600;
+	const size_t LOOKUP_REPORT_LINES = 20;
+
+	// Controls are only freed by LLControlGroup::cleanup() at shutdown, after
+	// the last report, so the counts can be keyed on bare pointers. The file
+	// names are the callers' string literals.
+	struct LookupSite
+	{
+		const LLControlVariable*	mControl;
+		const char*					mFile;
+		S32							mLine;
+
+		bool operator==(const LookupSite& rhs) const
+		{
+			return mControl == rhs.mControl && mLine == rhs.mLine && mFile == rhs.mFile;
+		}
+	};
+
+	size_t hash_value(const LookupSite& site)
+	{
+		size_t seed = boost::hash_value(site.mControl);
+		boost::hash_combine(seed, site.mFile);
+		boost::hash_combine(seed, site.mLine);
+		return seed;
+	}
+
+	typedef boost::unordered_map<LookupSite, U32> lookup_count_map_t;
+
+	struct LookupStats
+	{
+		LookupStats() : mFrames(0) {}
+
+		LLMutex				mMutex;		// settings are read off the main thread too
+		lookup_count_map_t	mCounts;
+		U32					mFrames;
+	};
+
+	LookupStats& lookup_stats()
+	{
+		static LookupStats stats;
+		return stats;
+	}
+
+	void track_lookup(const LLControlVariable* control, const LLControlCallSite& site)
+	{
+		const LookupSite key = { control, site.mFile, site.mLine };
+		LookupStats& stats = lookup_stats();
+		LLMutexLock lock(&stats.mMutex);
+		++stats.mCounts[key];
+	}
+
+	bool busier(const std::pair<U32, LookupSite>& lhs, const std::pair<U32, LookupSite>& rhs)
+	{
+		return lhs.first > rhs.first;
+	}
+
+	std::string call_site_string(const LookupSite& site)
+	{
+		if (!site.mFile)
+		{
+			return std::string();
+		}
+		// full build paths are long, the file name is enough to find it
+		const char* file = site.mFile;
+		for (const char* c = site.mFile; *c; ++c)
+		{
+			if (*c == '/' || *c == '\\')
+			{
+				file = c + 1;
+			}
+		}
+		return llformat("  %s:%d", file, site.mLine);
+	}
+}
+
+//static
+bool LLControlGroup::sTrackLookups = false;
+
+//LLPointer<LLControlVariable> LLControlGroup::getControl(const std::string& name)
+LLPointer<LLControlVariable> LLControlGroup::getControl(const std::string& name, const LLControlCallSite& site)
+{
+	//ctrl_name_table_t::iterator iter = mNameTable.find(name);
+	//return iter == mNameTable.end() ? LLPointer<LLControlVariable>() : iter->second;
+	LLControlVariable* control = findControl(name.c_str(), llcontrol_hash(name.c_str()));
+	if (sTrackLookups && control)
+	{
+		track_lookup(control, site);
+	}
+	return control;
+}
+
+LLControlVariable* LLControlGroup::findControl(const char* name, U64 hash) const
+{
+	if (mHashSlots.empty())
+	{
+		return NULL;
+	}
+	const size_t mask = mHashSlots.size() - 1;
+	for (size_t index = (size_t)(hash ^ (hash >> 32)) & mask; mHashSlots[index].mControl; index = (index + 1) & mask)
+	{
+		const HashSlot& slot = mHashSlots[index];
+		if (slot.mHash == hash && slot.mControl->getName() == name)
+		{
+			return slot.mControl;
+		}
+	}
+	return NULL;
+}
+
+void LLControlGroup::indexControl(LLControlVariable* control)
+{
+	// at most half full, so lookups of names that are not there stop early too
+	if ((mHashCount + 1) * 2 > mHashSlots.size())
+	{
+		std::vector<HashSlot> old_slots;
+		old_slots.swap(mHashSlots);
+		const HashSlot empty = { 0, NULL };
+		mHashSlots.assign(llmax(MIN_HASH_SLOTS, old_slots.size() * 2), empty);
+		mHashCount = 0;
+		for (std::vector<HashSlot>::const_iterator iter = old_slots.begin(); iter != old_slots.end(); ++iter)
+		{
+			if (iter->mControl)
+			{
+				indexControl(iter->mControl);
+			}
+		}
+	}
+
+	const U64 hash = llcontrol_hash(control->getName().c_str());
+	const size_t mask = mHashSlots.size() - 1;
+	size_t index = (size_t)(hash ^ (hash >> 32)) & mask;
+	while (mHashSlots[index].mControl)
+	{
+		index = (index + 1) & mask;
+	}
+	mHashSlots[index].mHash = hash;
+	mHashSlots[index].mControl = control;
+	++mHashCount;
 }
 
+//static
+void LLControlGroup::setLookupTracking(bool enable)
+{
+	LookupStats& stats = lookup_stats();
+	LLMutexLock lock(&stats.mMutex);
+	sTrackLookups = enable;
+	stats.mCounts.clear();
+	stats.mFrames = 0;
+}
+
+//static
+void LLControlGroup::tickLookupReport()
+{
+	if (!sTrackLookups)
+	{
+		return;
+	}
+
+	LookupStats& stats = lookup_stats();
+	std::vector<std::pair<U32, LookupSite> > busiest;
+	U32 frames;
+	{
+		LLMutexLock lock(&stats.mMutex);
+		if (++stats.mFrames < LOOKUP_REPORT_FRAMES)
+		{
+			return;
+		}
+		frames = stats.mFrames;
+		busiest.reserve(stats.mCounts.size());
+		for (lookup_count_map_t::const_iterator iter = stats.mCounts.begin();
+			 iter != stats.mCounts.end(); ++iter)
+		{
+			busiest.push_back(std::make_pair(iter->second, iter->first));
+		}
+		stats.mCounts.clear();
+		stats.mFrames = 0;
+	}
+
+	std::sort(busiest.begin(), busiest.end(), busier);
+	LL_INFOS("Settings") << "Settings looked up by name over the last " << frames << " frames, busiest call sites first:" << LL_ENDL;
+	for (size_t i = 0; i < busiest.size() && i < LOOKUP_REPORT_LINES; ++i)
+	{
+		LL_INFOS("Settings") << llformat("%10.2f per frame  ", (F32)busiest[i].first / (F32)frames)
+							 << busiest[i].second.mControl->getName() << call_site_string(busiest[i].second) << LL_ENDL;
+	}
+}
+// </polarity>
+
 
 ////////////////////////////////////////////////////////////////////////////
 
@@ -444,7 +634,8 @@ const std::string LLControlGroup::mSanityTypeString[SANITY_TYPE_COUNT] = { "None
 																		  };
 
 LLControlGroup::LLControlGroup(const std::string& name)
-:	LLInstanceTracker<LLControlGroup, std::string>(name)
+:	LLInstanceTracker<LLControlGroup, std::string>(name),
+	mHashCount(0) // <polarity/>
 {
 }
 
@@ -455,6 +646,10 @@ LLControlGroup::~LLControlGroup()
 
 void LLControlGroup::cleanup()
 {
+	// <polarity> Hashed control lookups
+	mHashSlots.clear();
+	mHashCount = 0;
+	// </polarity>
 	mNameTable.clear();
 }
 
@@ -513,6 +708,7 @@ LLControlVariable* LLControlGroup::declareControl(const std::string& name, eCont
 	// LLControlVariable* control = new LLControlVariable(name, type, initial_val, comment, persist, hidefromsettingseditor);
 	LLControlVariable* control = new LLControlVariable(name, type, initial_val, comment, sanity_type, sanity_value, sanity_comment, persist, hidefromsettingseditor);
 	mNameTable[name] = control;	
+	indexControl(control); // <polarity/>
 	return control;
 }
 
@@ -577,90 +773,133 @@ LLControlVariable* LLControlGroup::declareVec4(const std::string& name, const LL
 	return declareControl(name, TYPE_VEC4, initial_val.getValue(), comment, SANITY_TYPE_NONE, LLSD(), std::string(""), persist);
 }
 
-BOOL LLControlGroup::getBOOL(const std::string& name)
+// <polarity> Hashed control lookups
+// the by-name getters and setters pass the caller on for the lookup report
+BOOL LLControlGroup::getBOOL(const std::string& name, const LLControlCallSite& site)
 {
-	return (BOOL)get<bool>(name);
+	return (BOOL)get<bool>(name, site);
 }
 
-S32 LLControlGroup::getS32(const std::string& name)
+S32 LLControlGroup::getS32(const std::string& name, const LLControlCallSite& site)
 {
-	return get<S32>(name);
+	return get<S32>(name, site);
 }
 
-U32 LLControlGroup::getU32(const std::string& name)
+U32 LLControlGroup::getU32(const std::string& name, const LLControlCallSite& site)
 {
-	return get<U32>(name);
+	return get<U32>(name, site);
 }
 
-F32 LLControlGroup::getF32(const std::string& name)
+F32 LLControlGroup::getF32(const std::string& name, const LLControlCallSite& site)
 {
-	return get<F32>(name);
+	return get<F32>(name, site);
 }
 
-std::string LLControlGroup::getString(const std::string& name)
+std::string LLControlGroup::getString(const std::string& name, const LLControlCallSite& site)
 {
-	return get<std::string>(name);
+	return get<std::string>(name, site);
 }
 
-LLWString LLControlGroup::getWString(const std::string& name)
+LLWString LLControlGroup::getWString(const std::string& name, const LLControlCallSite& site)
 {
-	return get<LLWString>(name);
+	return get<LLWString>(name, site);
 }
 
-std::string LLControlGroup::getText(const std::string& name)
+std::string LLControlGroup::getText(const std::string& name, const LLControlCallSite& site)
 {
-	std::string utf8_string = getString(name);
+	std::string utf8_string = getString(name, site);
 	LLStringUtil::replaceChar(utf8_string, '^', '\n');
 	LLStringUtil::replaceChar(utf8_string, '%', ' ');
 	return (utf8_string);
 }
 
-LLVector3 LLControlGroup::getVector3(const std::string& name)
+LLVector3 LLControlGroup::getVector3(const std::string& name, const LLControlCallSite& site)
 {
-	return get<LLVector3>(name);
+	return get<LLVector3>(name, site);
 }
 
-LLVector3d LLControlGroup::getVector3d(const std::string& name)
+LLVector3d LLControlGroup::getVector3d(const std::string& name, const LLControlCallSite& site)
 {
-	return get<LLVector3d>(name);
+	return get<LLVector3d>(name, site);
 }
 
-LLRect LLControlGroup::getRect(const std::string& name)
+LLRect LLControlGroup::getRect(const std::string& name, const LLControlCallSite& site)
 {
-	return get<LLRect>(name);
+	return get<LLRect>(name, site);
 }
 
 
-LLColor4 LLControlGroup::getColor(const std::string& name)
+LLColor4 LLControlGroup::getColor(const std::string& name, const LLControlCallSite& site)
 {
-	return get<LLColor4>(name);
+	return get<LLColor4>(name, site);
 }
 
-LLColor4 LLControlGroup::getColor4(const std::string& name)
+LLColor4 LLControlGroup::getColor4(const std::string& name, const LLControlCallSite& site)
 {
-	return get<LLColor4>(name);
+	return get<LLColor4>(name, site);
 }
 
-LLColor3 LLControlGroup::getColor3(const std::string& name)
+LLColor3 LLControlGroup::getColor3(const std::string& name, const LLControlCallSite& site)
 {
-	return get<LLColor3>(name);
+	return get<LLColor3>(name, site);
 }
 
-LLSD LLControlGroup::getLLSD(const std::string& name)
+LLSD LLControlGroup::getLLSD(const std::string& name, const LLControlCallSite& site)
 {
-	return get<LLSD>(name);
+	return get<LLSD>(name, site);
 }
 
 // <Black Dragon:NiranV> Vector4
-LLVector4 LLControlGroup::getVector4(const std::string& name)
+LLVector4 LLControlGroup::getVector4(const std::string& name, const LLControlCallSite& site)
+{
+	return get<LLVector4>(name, site);
+}
+// </polarity>
+
+// <polarity> Hashed control lookups
+std::string LLControlGroup::getString(const LLControlKey& key)
+{
+	return get<std::string>(key);
+}
+
+BOOL LLControlGroup::getBOOL(const LLControlKey& key)
+{
+	return (BOOL)get<bool>(key);
+}
+
+S32 LLControlGroup::getS32(const LLControlKey& key)
+{
+	return get<S32>(key);
+}
+
+F32 LLControlGroup::getF32(const LLControlKey& key)
+{
+	return get<F32>(key);
+}
+
+U32 LLControlGroup::getU32(const LLControlKey& key)
+{
+	return get<U32>(key);
+}
+
+LLVector3 LLControlGroup::getVector3(const LLControlKey& key)
+{
+	return get<LLVector3>(key);
+}
+
+LLColor4 LLControlGroup::getColor4(const LLControlKey& key)
 {
-	return get<LLVector4>(name);
+	return get<LLColor4>(key);
 }
+// </polarity>
 
 BOOL LLControlGroup::controlExists(const std::string& name)
 {
-	ctrl_name_table_t::iterator iter = mNameTable.find(name);
-	return iter != mNameTable.end();
+	// <polarity> Hashed control lookups
+	//ctrl_name_table_t::iterator iter = mNameTable.find(name);
+	//return iter != mNameTable.end();
+	return findControl(name.c_str(), llcontrol_hash(name.c_str())) != NULL;
+	// </polarity>
 }
 
 
@@ -668,66 +907,68 @@ BOOL LLControlGroup::controlExists(const std::string& name)
 // Set functions
 //-------------------------------------------------------------------
 
-void LLControlGroup::setBOOL(const std::string& name, BOOL val)
+// <polarity> Hashed control lookups
+void LLControlGroup::setBOOL(const std::string& name, BOOL val, const LLControlCallSite& site)
 {
-	set<bool>(name, val);
+	set<bool>(name, val, site);
 }
 
 
-void LLControlGroup::setS32(const std::string& name, S32 val)
+void LLControlGroup::setS32(const std::string& name, S32 val, const LLControlCallSite& site)
 {
-	set(name, val);
+	set(name, val, site);
 }
 
 
-void LLControlGroup::setF32(const std::string& name, F32 val)
+void LLControlGroup::setF32(const std::string& name, F32 val, const LLControlCallSite& site)
 {
-	set(name, val);
+	set(name, val, site);
 }
 
 
-void LLControlGroup::setU32(const std::string& name, U32 val)
+void LLControlGroup::setU32(const std::string& name, U32 val, const LLControlCallSite& site)
 {
-	set(name, val);
+	set(name, val, site);
 }
 
 
-void LLControlGroup::setString(const std::string& name, const std::string &val)
+void LLControlGroup::setString(const std::string& name, const std::string &val, const LLControlCallSite& site)
 {
-	set(name, val);
+	set(name, val, site);
 }
 
 
-void LLControlGroup::setVector3(const std::string& name, const LLVector3 &val)
+void LLControlGroup::setVector3(const std::string& name, const LLVector3 &val, const LLControlCallSite& site)
 {
-	set(name, val);
+	set(name, val, site);
 }
 
-void LLControlGroup::setVector3d(const std::string& name, const LLVector3d &val)
+void LLControlGroup::setVector3d(const std::string& name, const LLVector3d &val, const LLControlCallSite& site)
 {
-	set(name, val);
+	set(name, val, site);
 }
 
-void LLControlGroup::setRect(const std::string& name, const LLRect &val)
+void LLControlGroup::setRect(const std::string& name, const LLRect &val, const LLControlCallSite& site)
 {
-	set(name, val);
+	set(name, val, site);
 }
 
-void LLControlGroup::setColor4(const std::string& name, const LLColor4 &val)
+void LLControlGroup::setColor4(const std::string& name, const LLColor4 &val, const LLControlCallSite& site)
 {
-	set(name, val);
+	set(name, val, site);
 }
 
-void LLControlGroup::setLLSD(const std::string& name, const LLSD& val)
+void LLControlGroup::setLLSD(const std::string& name, const LLSD& val, const LLControlCallSite& site)
 {
-	set(name, val);
+	set(name, val, site);
 }
 
 // <Black Dragon:NiranV> Vector4
-void LLControlGroup::setVector4(const std::string& name, const LLVector4 &val)
+void LLControlGroup::setVector4(const std::string& name, const LLVector4 &val, const LLControlCallSite& site)
 {
-	set(name, val);
+	set(name, val, site);
 }
+// </polarity>
 
 void LLControlGroup::setUntypedValue(const std::string& name, const LLSD& val)
 {
@@ -1010,7 +1251,12 @@ U32 LLControlGroup::loadFromFile(const std::string& filename, bool set_default_v
 		return 0;
 	}
 
-	if (LLSDParser::PARSE_FAILURE == LLSDSerialize::fromXML(settings, infile))
+	// <polarity> Fast LLSD XML reader
+	// all of it in the stream's buffer, so the parser reads it in place
+	//if (LLSDParser::PARSE_FAILURE == LLSDSerialize::fromXML(settings, infile))
+	std::istringstream instream(std::string((std::istreambuf_iterator<char>(infile)), std::istreambuf_iterator<char>()));
+	if (LLSDParser::PARSE_FAILURE == LLSDSerialize::fromXML(settings, instream))
+	// </polarity>
 	{
 		infile.close();
 		LL_WARNS("Settings") << "Unable to parse LLSD control file " << filename << ". Trying Legacy Method." << LL_ENDL;
@@ -37,6 +37,7 @@
 #include "llcontrolgroupreader.h"
 
 #include <vector>
+#include <type_traits> // <polarity/>
 
 #include <boost/signals2.hpp>
 
@@ -199,6 +200,61 @@ T convert_from_llsd(const LLSD& sd, eControlType type, const std::string& contro
 	return T(sd);
 }
 
+// <polarity> Hashed control lookups
+// FNV-1a of a control name. It is constexpr so LL_CONTROL_KEY() can hash a
+// literal name at compile time, LLControlGroup hashes string names with the
+// same function at run time.
+constexpr U64 llcontrol_hash(const char* name, U64 hash = 0xcbf29ce484222325ULL)
+{
+	return *name ? llcontrol_hash(name + 1, (hash ^ (U8)*name) * 0x100000001b3ULL) : hash;
+}
+
+// A control name with its hash worked out ahead, for settings read every
+// frame where LLCachedControl does not fit. Looking one up costs a probe of
+// the group's hash index and one string compare, no hashing:
+//     if (gSavedSettings.getBOOL(LL_CONTROL_KEY("RenderDeferred")))
+// It has no constructor from a string on purpose, getBOOL("Name") keeps
+// going to the string overloads instead of becoming ambiguous.
+class LLControlKey
+{
+public:
+	constexpr LLControlKey(const char* name, U64 hash) : mName(name), mHash(hash) {}
+
+	const char*	mName;
+	U64			mHash;
+};
+
+// the integral_constant forces the hash to be evaluated by the compiler
+#define LL_CONTROL_KEY(name) LLControlKey(name, std::integral_constant<U64, llcontrol_hash(name)>::value)
+
+#if defined(__clang__)
+#if __has_builtin(__builtin_FILE) && __has_builtin(__builtin_LINE)
+#define LL_CONTROL_CALL_SITES 1
+#endif
+#elif defined(__GNUC__) || (defined(_MSC_VER) && _MSC_VER >= 1926)
+#define LL_CONTROL_CALL_SITES 1
+#endif
+#ifndef LL_CONTROL_CALL_SITES
+#define LL_CONTROL_CALL_SITES 0
+#endif
+
+// Where a lookup by name was made, for the lookup report. Left to its
+// default argument, the builtins give the caller's file and line. Compilers
+// without them report every lookup under the setting name alone.
+class LLControlCallSite
+{
+public:
+#if LL_CONTROL_CALL_SITES
+	explicit LLControlCallSite(const char* file = __builtin_FILE(), S32 line = __builtin_LINE()) : mFile(file), mLine(line) {}
+#else
+	LLControlCallSite() : mFile(NULL), mLine(0) {}
+#endif
+
+	const char*	mFile;
+	S32			mLine;
+};
+// </polarity>
+
 //const U32 STRING_CACHE_SIZE = 10000;
 class LLControlGroup : public LLInstanceTracker<LLControlGroup, std::string>
 {
@@ -213,6 +269,24 @@ protected:
 
 	// Settings Sanity check
 	static const std::string mSanityTypeString[SANITY_TYPE_COUNT];
+
+	// <polarity> Hashed control lookups
+	// Open addressed index over mNameTable by llcontrol_hash() of the name.
+	// mNameTable is still what owns the controls and is walked in name order
+	// for saving and the settings editor.
+	struct HashSlot
+	{
+		U64					mHash;
+		LLControlVariable*	mControl;	// NULL when the slot is free
+	};
+	std::vector<HashSlot>	mHashSlots;	// power of two sized
+	size_t					mHashCount;
+
+	void indexControl(LLControlVariable* control);
+	LLControlVariable* findControl(const char* name, U64 hash) const;
+
+	static bool sTrackLookups;
+	// </polarity>
 public:                                              
 	static eControlType typeStringToEnum(const std::string& typestr);
 
@@ -228,7 +302,19 @@ public:
 	
 	typedef LLInstanceTracker<LLControlGroup, std::string>::instance_iter instance_iter;
 
-	LLControlVariablePtr getControl(const std::string& name);
+	// <polarity> Hashed control lookups
+	//LLControlVariablePtr getControl(const std::string& name);
+	LLControlVariablePtr getControl(const std::string& name, const LLControlCallSite& site = LLControlCallSite());
+	LLControlVariable* getControl(const LLControlKey& key) const { return findControl(key.mName, key.mHash); }
+
+	// Debug report of lookups by name, the ones LL_CONTROL_KEY or
+	// LLCachedControl should take over. While tracking is on every named
+	// lookup is counted by setting and call site, and tickLookupReport(),
+	// called once a frame, logs the busiest with their lookups per frame
+	// every few seconds.
+	static void setLookupTracking(bool enable);
+	static void tickLookupReport();
+	// </polarity>
 
 	struct ApplyFunctor
 	{
@@ -256,29 +342,68 @@ public:
 	// <Black Dragon:NiranV> Vector4
 	LLControlVariable* declareVec4(const std::string& name, const LLVector4 &initial_val, const std::string& comment, LLControlVariable::ePersist persist = LLControlVariable::PERSIST_NONDFT);
 
-	std::string getString(const std::string& name);
-	std::string getText(const std::string& name);
-	BOOL		getBOOL(const std::string& name);
-	S32			getS32(const std::string& name);
-	F32			getF32(const std::string& name);
-	U32			getU32(const std::string& name);
+	// <polarity> Hashed control lookups
+	// the call site is for the lookup report, leave it to the default
+	//std::string getString(const std::string& name);
+	//std::string getText(const std::string& name);
+	//BOOL		getBOOL(const std::string& name);
+	//S32			getS32(const std::string& name);
+	//F32			getF32(const std::string& name);
+	//U32			getU32(const std::string& name);
+	//LLWString	getWString(const std::string& name);
+	//LLVector3	getVector3(const std::string& name);
+	//LLVector3d	getVector3d(const std::string& name);
+	//LLRect		getRect(const std::string& name);
+	//LLSD        getLLSD(const std::string& name);
+	//LLColor4	getColor(const std::string& name);
+	//LLColor4	getColor4(const std::string& name);
+	//LLColor3	getColor3(const std::string& name);
+	//LLVector4	getVector4(const std::string& name);
+	std::string getString(const std::string& name, const LLControlCallSite& site = LLControlCallSite());
+	std::string getText(const std::string& name, const LLControlCallSite& site = LLControlCallSite());
+	BOOL		getBOOL(const std::string& name, const LLControlCallSite& site = LLControlCallSite());
+	S32			getS32(const std::string& name, const LLControlCallSite& site = LLControlCallSite());
+	F32			getF32(const std::string& name, const LLControlCallSite& site = LLControlCallSite());
+	U32			getU32(const std::string& name, const LLControlCallSite& site = LLControlCallSite());
 	
-	LLWString	getWString(const std::string& name);
-	LLVector3	getVector3(const std::string& name);
-	LLVector3d	getVector3d(const std::string& name);
-	LLRect		getRect(const std::string& name);
-	LLSD        getLLSD(const std::string& name);
-
-
-	LLColor4	getColor(const std::string& name);
-	LLColor4	getColor4(const std::string& name);
-	LLColor3	getColor3(const std::string& name);
-	LLVector4	getVector4(const std::string& name);
+	LLWString	getWString(const std::string& name, const LLControlCallSite& site = LLControlCallSite());
+	LLVector3	getVector3(const std::string& name, const LLControlCallSite& site = LLControlCallSite());
+	LLVector3d	getVector3d(const std::string& name, const LLControlCallSite& site = LLControlCallSite());
+	LLRect		getRect(const std::string& name, const LLControlCallSite& site = LLControlCallSite());
+	LLSD        getLLSD(const std::string& name, const LLControlCallSite& site = LLControlCallSite());
+	LLColor4	getColor(const std::string& name, const LLControlCallSite& site = LLControlCallSite());
+	LLColor4	getColor4(const std::string& name, const LLControlCallSite& site = LLControlCallSite());
+	LLColor3	getColor3(const std::string& name, const LLControlCallSite& site = LLControlCallSite());
+	LLVector4	getVector4(const std::string& name, const LLControlCallSite& site = LLControlCallSite());
+
+	std::string getString(const LLControlKey& key);
+	BOOL		getBOOL(const LLControlKey& key);
+	S32			getS32(const LLControlKey& key);
+	F32			getF32(const LLControlKey& key);
+	U32			getU32(const LLControlKey& key);
+	LLVector3	getVector3(const LLControlKey& key);
+	LLColor4	getColor4(const LLControlKey& key);
+
+	template<typename T> T get(const LLControlKey& key)
+	{
+		LLControlVariable* control = getControl(key);
+		if (!control)
+		{
+			LL_WARNS() << "Control " << key.mName << " not found." << LL_ENDL;
+			return T();
+		}
+		return convert_from_llsd<T>(control->get(), control->type(), control->getName());
+	}
+	// </polarity>
 
 	// generic getter
-	template<typename T> T get(const std::string& name)
+	// <polarity> Hashed control lookups
+	//template<typename T> T get(const std::string& name)
+	template<typename T> T get(const std::string& name, const LLControlCallSite& site = LLControlCallSite())
+	// </polarity>
 	{
-		LLControlVariable* control = getControl(name);
+		//LLControlVariable* control = getControl(name);
+		LLControlVariable* control = getControl(name, site); // <polarity/>
 		LLSD value;
 		eControlType type = TYPE_COUNT;
 
@@ -295,27 +420,44 @@ public:
 		return convert_from_llsd<T>(value, type, name);
 	}
 
-	void	setBOOL(const std::string& name, BOOL val);
-	void	setS32(const std::string& name, S32 val);
-	void	setF32(const std::string& name, F32 val);
-	void	setU32(const std::string& name, U32 val);
-	void	setString(const std::string&  name, const std::string& val);
-	void	setVector3(const std::string& name, const LLVector3 &val);
-	void	setVector3d(const std::string& name, const LLVector3d &val);
-	void	setRect(const std::string& name, const LLRect &val);
-	void	setColor4(const std::string& name, const LLColor4 &val);
-	void    setLLSD(const std::string& name, const LLSD& val);
+	// <polarity> Hashed control lookups
+	//void	setBOOL(const std::string& name, BOOL val);
+	//void	setS32(const std::string& name, S32 val);
+	//void	setF32(const std::string& name, F32 val);
+	//void	setU32(const std::string& name, U32 val);
+	//void	setString(const std::string&  name, const std::string& val);
+	//void	setVector3(const std::string& name, const LLVector3 &val);
+	//void	setVector3d(const std::string& name, const LLVector3d &val);
+	//void	setRect(const std::string& name, const LLRect &val);
+	//void	setColor4(const std::string& name, const LLColor4 &val);
+	//void    setLLSD(const std::string& name, const LLSD& val);
+	//void	setVector4(const std::string& name, const LLVector4 &val);
+	void	setBOOL(const std::string& name, BOOL val, const LLControlCallSite& site = LLControlCallSite());
+	void	setS32(const std::string& name, S32 val, const LLControlCallSite& site = LLControlCallSite());
+	void	setF32(const std::string& name, F32 val, const LLControlCallSite& site = LLControlCallSite());
+	void	setU32(const std::string& name, U32 val, const LLControlCallSite& site = LLControlCallSite());
+	void	setString(const std::string&  name, const std::string& val, const LLControlCallSite& site = LLControlCallSite());
+	void	setVector3(const std::string& name, const LLVector3 &val, const LLControlCallSite& site = LLControlCallSite());
+	void	setVector3d(const std::string& name, const LLVector3d &val, const LLControlCallSite& site = LLControlCallSite());
+	void	setRect(const std::string& name, const LLRect &val, const LLControlCallSite& site = LLControlCallSite());
+	void	setColor4(const std::string& name, const LLColor4 &val, const LLControlCallSite& site = LLControlCallSite());
+	void    setLLSD(const std::string& name, const LLSD& val, const LLControlCallSite& site = LLControlCallSite());
 
 	// <Black Dragon:NiranV> Vector4
-	void	setVector4(const std::string& name, const LLVector4 &val);
+	void	setVector4(const std::string& name, const LLVector4 &val, const LLControlCallSite& site = LLControlCallSite());
+	// </polarity>
 
 	// type agnostic setter that takes LLSD
 	void	setUntypedValue(const std::string& name, const LLSD& val);
 
 	// generic setter
-	template<typename T> void set(const std::string& name, const T& val)
+	// <polarity> Hashed control lookups
+	//template<typename T> void set(const std::string& name, const T& val)
+	template<typename T> void set(const std::string& name, const T& val, const LLControlCallSite& site = LLControlCallSite())
+	// </polarity>
 	{
-		LLControlVariable* control = getControl(name);
+		//LLControlVariable* control = getControl(name);
+		LLControlVariable* control = getControl(name, site); // <polarity/>
 	
 		if (control && control->isType(get_control_type<T>()))
 		{
@@ -0,0 +1,209 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/**
+ * @file llxmlarenatree.cpp
+ * @brief Read only XML tree kept in a few flat arrays.
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llxmlarenatree.h"
+
+#include "llxmlnode.h"
+#include "llxmlparser.h"
+
+const LLXmlArenaTree::node_t LLXmlArenaTree::NO_NODE;
+
+//-----------------------------------------------------------------------------
+// LLXmlArenaTreeBuilder
+// Appends the elements to the tree as expat reports them. The last child seen
+// at each depth is kept so siblings are linked without walking the list, the
+// text of an element is collected per depth and stored on its end tag.
+//-----------------------------------------------------------------------------
+class LLXmlArenaTreeBuilder : public LLXmlParser
+{
+public:
+	LLXmlArenaTreeBuilder(LLXmlArenaTree& tree)
+	:	mTree(tree)
+	{
+	}
+
+protected:
+	/*virtual*/ void startElement(const char* name, const char** atts)
+	{
+		const LLXmlArenaTree::node_t index = (LLXmlArenaTree::node_t)mTree.mNodes.size();
+		LLXmlArenaTree::Node node;
+		node.mName = gStringTable.addStringEntry(name);
+		node.mFirstChild = LLXmlArenaTree::NO_NODE;
+		node.mNextSibling = LLXmlArenaTree::NO_NODE;
+		node.mFirstAttribute = (U32)mTree.mAttributes.size();
+		node.mAttributeCount = 0;
+		node.mValue = 0;
+		node.mLineNumber = getCurrentLineNumber();
+		for (U32 i = 0; atts[i]; i += 2)
+		{
+			LLXmlArenaTree::Attribute attribute;
+			attribute.mName = gStringTable.addStringEntry(atts[i]);
+			attribute.mValue = mTree.addString(atts[i + 1], strlen(atts[i + 1]));
+			mTree.mAttributes.push_back(attribute);
+			++node.mAttributeCount;
+		}
+		mTree.mNodes.push_back(node);
+
+		// mDepth is this element's depth until the handler returns
+		if (mLastChild.size() <= (size_t)mDepth + 1)
+		{
+			mLastChild.resize(mDepth + 2);
+			mText.resize(mDepth + 1);
+		}
+		if (mDepth > 0)
+		{
+			const LLXmlArenaTree::node_t sibling = mLastChild[mDepth];
+			if (sibling == LLXmlArenaTree::NO_NODE)
+			{
+				mTree.mNodes[mLastChild[mDepth - 1]].mFirstChild = index;
+			}
+			else
+			{
+				mTree.mNodes[sibling].mNextSibling = index;
+			}
+		}
+		mLastChild[mDepth] = index;
+		mLastChild[mDepth + 1] = LLXmlArenaTree::NO_NODE;
+		mText[mDepth].clear();
+	}
+
+	/*virtual*/ void endElement(const char* name)
+	{
+		// already counted out, mDepth is the element's own depth
+		const std::string& text = mText[mDepth];
+		if (!text.empty())
+		{
+			mTree.mNodes[mLastChild[mDepth]].mValue = mTree.addString(text.data(), text.size());
+		}
+	}
+
+	/*virtual*/ void characterData(const char* s, int len)
+	{
+		if (mDepth > 0)
+		{
+			mText[mDepth - 1].append(s, len);
+		}
+	}
+
+private:
+	LLXmlArenaTree&						mTree;
+	std::vector<LLXmlArenaTree::node_t>	mLastChild;	// by depth
+	std::vector<std::string>			mText;		// by depth, reused
+};
+
+LLXmlArenaTree::LLXmlArenaTree()
+{
+	clear();
+}
+
+void LLXmlArenaTree::clear()
+{
+	mNodes.clear();
+	mAttributes.clear();
+	mStrings.assign(1, '\0');
+	mError.clear();
+}
+
+bool LLXmlArenaTree::parseFile(const std::string& path)
+{
+	clear();
+	LLXmlArenaTreeBuilder builder(*this);
+	if (!builder.parseFile(path) || mNodes.empty())
+	{
+		std::string error = llformat("%s: %s", path.c_str(), builder.getErrorString());
+		clear();
+		mError.swap(error);
+		return false;
+	}
+	return true;
+}
+
+bool LLXmlArenaTree::parseBuffer(const char* data, S32 length)
+{
+	clear();
+	LLXmlArenaTreeBuilder builder(*this);
+	if (!builder.parse(data, length, TRUE) || mNodes.empty())
+	{
+		std::string error = builder.getErrorString();
+		clear();
+		mError.swap(error);
+		return false;
+	}
+	return true;
+}
+
+U32 LLXmlArenaTree::addString(const char* s, size_t len)
+{
+	const U32 offset = (U32)mStrings.size();
+	mStrings.insert(mStrings.end(), s, s + len);
+	mStrings.push_back('\0');
+	return offset;
+}
+
+const char* LLXmlArenaTree::getAttribute(node_t node, const char* name) const
+{
+	const LLStringTableEntry* entry = gStringTable.checkStringEntry(name);
+	if (entry)
+	{
+		const Node& n = mNodes[node];
+		for (U32 i = n.mFirstAttribute, end = n.mFirstAttribute + n.mAttributeCount; i < end; ++i)
+		{
+			if (mAttributes[i].mName == entry)
+			{
+				return &mStrings[mAttributes[i].mValue];
+			}
+		}
+	}
+	return NULL;
+}
+
+bool LLXmlArenaTree::getAttributeString(node_t node, const char* name, std::string& value) const
+{
+	const char* attribute = getAttribute(node, name);
+	if (attribute)
+	{
+		value.assign(attribute);
+	}
+	return attribute != NULL;
+}
+
+bool LLXmlArenaTree::getAttributeS32(node_t node, const char* name, S32& value) const
+{
+	const char* attribute = getAttribute(node, name);
+	return attribute && LLStringUtil::convertToS32(attribute, value);
+}
+
+bool LLXmlArenaTree::getAttributeF32(node_t node, const char* name, F32& value) const
+{
+	const char* attribute = getAttribute(node, name);
+	return attribute && LLStringUtil::convertToF32(attribute, value);
+}
+
+std::string LLXmlArenaTree::getTextContents(node_t node) const
+{
+	return LLXMLNode::getTextContents(getValue(node));
+}
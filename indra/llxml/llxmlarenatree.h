@@ -0,0 +1,105 @@
+/**
+ * @file llxmlarenatree.h
+ * @brief Read only XML tree kept in a few flat arrays.
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLXMLARENATREE_H
+#define LL_LLXMLARENATREE_H
+
+#include <string>
+#include <vector>
+
+#include "llstringtable.h"
+
+//-----------------------------------------------------------------------------
+// class LLXmlArenaTree
+// For code that walks a parsed document a few times but never edits it.
+// The elements, their attributes and all text live in three vectors owned by
+// the tree, nodes are indices into them and names are gStringTable entries,
+// so loading a file costs a handful of allocations instead of an LLXMLNode,
+// an attribute map and several strings per element, and dropping the tree
+// frees it all at once. Anything that goes through LLXUIParser or changes
+// the tree still wants LLXMLNode.
+//-----------------------------------------------------------------------------
+class LLXmlArenaTree
+{
+public:
+	typedef U32 node_t;
+	static const node_t NO_NODE = 0xffffffff;
+
+	LLXmlArenaTree();
+
+	bool parseFile(const std::string& path);
+	bool parseBuffer(const char* data, S32 length);
+	void clear();
+
+	// set when the last parse failed
+	const std::string& getErrorString() const	{ return mError; }
+
+	node_t getRoot() const						{ return mNodes.empty() ? NO_NODE : 0; }
+	node_t getFirstChild(node_t node) const		{ return mNodes[node].mFirstChild; }
+	node_t getNextSibling(node_t node) const	{ return mNodes[node].mNextSibling; }
+
+	const LLStringTableEntry* getName(node_t node) const	{ return mNodes[node].mName; }
+	const char* getNameString(node_t node) const			{ return mNodes[node].mName->mString; }
+	bool hasName(node_t node, const char* name) const		{ return mNodes[node].mName == gStringTable.checkStringEntry(name); }
+	S32 getLineNumber(node_t node) const					{ return mNodes[node].mLineNumber; }
+
+	// NULL when the node has no such attribute
+	const char* getAttribute(node_t node, const char* name) const;
+	bool getAttributeString(node_t node, const char* name, std::string& value) const;
+	bool getAttributeS32(node_t node, const char* name, S32& value) const;
+	bool getAttributeF32(node_t node, const char* name, F32& value) const;
+
+	// the character data directly inside the element, as written
+	const char* getValue(node_t node) const		{ return &mStrings[mNodes[node].mValue]; }
+	// the same with LLXMLNode::getTextContents() rules for quotes and whitespace
+	std::string getTextContents(node_t node) const;
+
+private:
+	friend class LLXmlArenaTreeBuilder;
+
+	struct Node
+	{
+		const LLStringTableEntry*	mName;
+		node_t						mFirstChild;
+		node_t						mNextSibling;
+		U32							mFirstAttribute;
+		U32							mAttributeCount;
+		U32							mValue;			// into mStrings
+		S32							mLineNumber;
+	};
+
+	struct Attribute
+	{
+		const LLStringTableEntry*	mName;
+		U32							mValue;			// into mStrings
+	};
+
+	U32 addString(const char* s, size_t len);
+
+	std::vector<Node>		mNodes;			// in document order, the root first
+	std::vector<Attribute>	mAttributes;
+	std::vector<char>		mStrings;		// zero terminated, an empty one at 0
+	std::string				mError;
+};
+
+#endif // LL_LLXMLARENATREE_H
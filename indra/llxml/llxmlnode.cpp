@@ -3211,10 +3211,13 @@ std::string LLXMLNode::getSanitizedValue() const
 }
 
 
-std::string LLXMLNode::getTextContents() const
+// <polarity> Text rules shared with LLXmlArenaTree
+// Case 1 joins quoted lines with their escapes removed, case 2 trims the
+// embedded text
+static std::string text_contents(const std::string& value)
 {
 	std::string msg;
-	std::string contents = mValue;
+	std::string contents = value;
 	std::string::size_type n = contents.find_first_not_of(" \t\n");
 	if (n != std::string::npos && contents[n] == '\"')
 	{
@@ -3258,17 +3261,17 @@ std::string LLXMLNode::getTextContents() const
 	else
 	{
 		// Case 2: node has embedded text (beginning and trailing whitespace trimmed)
-		std::string::size_type start = mValue.find_first_not_of(" \t\n");
-		if (start != mValue.npos)
+		std::string::size_type start = value.find_first_not_of(" \t\n");
+		if (start != value.npos)
 		{
-			std::string::size_type end = mValue.find_last_not_of(" \t\n");
-			if (end != mValue.npos)
+			std::string::size_type end = value.find_last_not_of(" \t\n");
+			if (end != value.npos)
 			{
-				msg = mValue.substr(start, end+1-start);
+				msg = value.substr(start, end+1-start);
 			}
 			else
 			{
-				msg = mValue.substr(start);
+				msg = value.substr(start);
 			}
 		}
 		// Convert any internal CR to LF
@@ -3277,6 +3280,18 @@ std::string LLXMLNode::getTextContents() const
 	return msg;
 }
 
+std::string LLXMLNode::getTextContents() const
+{
+	return text_contents(mValue);
+}
+
+// static
+std::string LLXMLNode::getTextContents(const std::string& value)
+{
+	return text_contents(value);
+}
+// </polarity>
+
 void LLXMLNode::setLineNumber(S32 line_number)
 {
 	mLineNumber = line_number;
@@ -210,6 +210,7 @@ public:
     const std::string& getValue() const { return mValue; }
 	std::string getSanitizedValue() const;
 	std::string getTextContents() const;
+	static std::string getTextContents(const std::string& value); // <polarity/>
     const LLStringTableEntry* getName() const { return mName; }
 	BOOL hasName(const char* name) const { return mName == gStringTable.checkStringEntry(name); }
 	BOOL hasName(const std::string& name) const { return mName == gStringTable.checkStringEntry(name.c_str()); }
@@ -0,0 +1,227 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/**
+ * @file llxmlpullreader.cpp
+ * @brief Pull style XML reader for callers that only scan a document.
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llxmlpullreader.h"
+
+#include "llerror.h"
+#include "llfile.h"
+
+LLXmlPullReader::LLXmlPullReader()
+:	mQueueHead(0),
+	mQueueCount(0),
+	mAttributeCount(0),
+	mElementDepth(0),
+	mLength(0),
+	mStarted(false),
+	mFinished(false),
+	mFailed(false)
+{
+	mEvent.mType = END_DOCUMENT;
+	mEvent.mName = NULL;
+	mEvent.mDepth = -1;
+	mEvent.mLineNumber = 0;
+}
+
+LLXmlPullReader::~LLXmlPullReader()
+{
+}
+
+bool LLXmlPullReader::openFile(const std::string& path)
+{
+	llassert(!mStarted && !mLength);
+
+	LLFILE* file = LLFile::fopen(path, "rb");
+	if (!file)
+	{
+		mAuxErrorString = llformat("Couldn't open file %s", path.c_str());
+		mFailed = true;
+		return false;
+	}
+
+	bool success = false;
+	fseek(file, 0L, SEEK_END);
+	const S32 size = (S32)ftell(file);
+	fseek(file, 0L, SEEK_SET);
+	void* buffer = size > 0 ? XML_GetBuffer(mParser, size) : NULL;
+	if (!buffer)
+	{
+		mAuxErrorString = llformat("Unable to allocate XML buffer while reading file %s", path.c_str());
+	}
+	else if ((S32)fread(buffer, 1, size, file) != size)
+	{
+		mAuxErrorString = llformat("Error while reading file %s", path.c_str());
+	}
+	else
+	{
+		mLength = size;
+		success = true;
+	}
+	fclose(file);
+
+	mFailed = !success;
+	return success;
+}
+
+bool LLXmlPullReader::openBuffer(const char* data, S32 length)
+{
+	llassert(!mStarted && !mLength);
+
+	void* buffer = length > 0 ? XML_GetBuffer(mParser, length) : NULL;
+	if (!buffer)
+	{
+		mAuxErrorString = "Unable to allocate XML buffer";
+		mFailed = true;
+		return false;
+	}
+	memcpy(buffer, data, length);
+	mLength = length;
+	return true;
+}
+
+LLXmlPullReader::EEvent LLXmlPullReader::next()
+{
+	if (!mQueueCount && !mFinished && !mFailed)
+	{
+		// the handlers suspend the parser as soon as they have an event
+		const XML_Status status = mStarted ? XML_ResumeParser(mParser) : XML_ParseBuffer(mParser, mLength, XML_TRUE);
+		mStarted = true;
+		if (status == XML_STATUS_ERROR)
+		{
+			mFailed = true;
+			mAuxErrorString = llformat("%s at line %d", XML_ErrorString(XML_GetErrorCode(mParser)), getCurrentLineNumber());
+		}
+		else if (status == XML_STATUS_OK)
+		{
+			mFinished = true;
+		}
+	}
+
+	if (mQueueCount)
+	{
+		mEvent = mQueue[mQueueHead];
+		mQueueHead = (mQueueHead + 1) & 1;
+		--mQueueCount;
+	}
+	else
+	{
+		mEvent.mType = mFailed ? PARSE_ERROR : END_DOCUMENT;
+		mEvent.mName = NULL;
+		mEvent.mDepth = -1;
+		mAttributeCount = 0;
+	}
+	return mEvent.mType;
+}
+
+LLXmlPullReader::EEvent LLXmlPullReader::skipElement()
+{
+	if (mEvent.mType != START_ELEMENT)
+	{
+		return mEvent.mType;
+	}
+	const S32 depth = mEvent.mDepth;
+	EEvent event;
+	while ((event = next()) == START_ELEMENT || (event == END_ELEMENT && mEvent.mDepth > depth))
+	{
+	}
+	return event;
+}
+
+bool LLXmlPullReader::getAttributeString(const char* name, std::string& value) const
+{
+	for (U32 i = 0; i < mAttributeCount; ++i)
+	{
+		if (mAttributes[i].first == name)
+		{
+			value = mAttributes[i].second;
+			return true;
+		}
+	}
+	return false;
+}
+
+const std::string& LLXmlPullReader::getText() const
+{
+	static const std::string empty;
+	return mEvent.mType == END_ELEMENT && mEvent.mDepth < (S32)mText.size() ? mText[mEvent.mDepth] : empty;
+}
+
+void LLXmlPullReader::pushEvent(EEvent type, const char* name, S32 depth)
+{
+	llassert(mQueueCount < 2);
+	Event& event = mQueue[(mQueueHead + mQueueCount) & 1];
+	event.mType = type;
+	event.mName = gStringTable.addStringEntry(name);
+	event.mDepth = depth;
+	event.mLineNumber = getCurrentLineNumber();
+	++mQueueCount;
+
+	XML_ParsingStatus status;
+	XML_GetParsingStatus(mParser, &status);
+	if (status.parsing == XML_PARSING)
+	{
+		XML_StopParser(mParser, XML_TRUE);
+	}
+}
+
+// virtual
+void LLXmlPullReader::startElement(const char* name, const char** atts)
+{
+	mAttributeCount = 0;
+	for (U32 i = 0; atts[i]; i += 2)
+	{
+		if (mAttributeCount == mAttributes.size())
+		{
+			mAttributes.resize(mAttributeCount + 1);
+		}
+		mAttributes[mAttributeCount].first.assign(atts[i]);
+		mAttributes[mAttributeCount].second.assign(atts[i + 1]);
+		++mAttributeCount;
+	}
+	if (mText.size() <= (size_t)mElementDepth)
+	{
+		mText.resize(mElementDepth + 1);
+	}
+	mText[mElementDepth].clear();
+	pushEvent(START_ELEMENT, name, mElementDepth);
+	++mElementDepth;
+}
+
+// virtual
+void LLXmlPullReader::endElement(const char* name)
+{
+	--mElementDepth;
+	pushEvent(END_ELEMENT, name, mElementDepth);
+}
+
+// virtual
+void LLXmlPullReader::characterData(const char* s, int len)
+{
+	if (mElementDepth > 0)
+	{
+		mText[mElementDepth - 1].append(s, len);
+	}
+}
@@ -0,0 +1,129 @@
+/**
+ * @file llxmlpullreader.h
+ * @brief Pull style XML reader for callers that only scan a document.
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLXMLPULLREADER_H
+#define LL_LLXMLPULLREADER_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "llstringtable.h"
+#include "llxmlparser.h"
+
+//-----------------------------------------------------------------------------
+// class LLXmlPullReader
+// Hands the document out one tag at a time: next() runs expat up to the
+// following start or end tag and stops there, by suspending the parser from
+// inside its own handler. Nothing is kept once the caller moves on, element
+// names are interned in gStringTable and the attribute and text buffers are
+// reused, so once it has warmed up a scan does not allocate per element the
+// way LLXMLNode::parseFile() does for every element and attribute.
+//
+// The usual loop is
+//	LLXmlPullReader reader;
+//	if (reader.openFile(path))
+//	{
+//		LLXmlPullReader::EEvent event;
+//		while ((event = reader.next()) == LLXmlPullReader::START_ELEMENT
+//			   || event == LLXmlPullReader::END_ELEMENT)
+//		{
+//			...
+//		}
+//	}
+// and ends on END_DOCUMENT, or PARSE_ERROR with getErrorString() saying why.
+//-----------------------------------------------------------------------------
+class LLXmlPullReader : public LLXmlParser
+{
+public:
+	enum EEvent
+	{
+		START_ELEMENT,	// the name and attributes are set
+		END_ELEMENT,	// the name and text are set
+		END_DOCUMENT,
+		PARSE_ERROR
+	};
+
+	LLXmlPullReader();
+	virtual ~LLXmlPullReader();
+
+	// Both copy the document into expat's buffer, the events are pulled from
+	// there. A reader reads one document.
+	bool openFile(const std::string& path);
+	bool openBuffer(const char* data, S32 length);
+
+	EEvent next();
+	// Right after START_ELEMENT, skips everything up to that element's
+	// END_ELEMENT and returns it, the text is set as usual.
+	EEvent skipElement();
+
+	// the element of the event next() last returned
+	const LLStringTableEntry* getName() const	{ return mEvent.mName; }
+	bool hasName(const char* name) const		{ return mEvent.mName && mEvent.mName == gStringTable.checkStringEntry(name); }
+	S32 getElementDepth() const					{ return mEvent.mDepth; }	// 0 for the root element
+	S32 getElementLineNumber() const			{ return mEvent.mLineNumber; }
+
+	U32 getAttributeCount() const				{ return mAttributeCount; }
+	const std::string& getAttributeName(U32 index) const	{ return mAttributes[index].first; }
+	const std::string& getAttributeValue(U32 index) const	{ return mAttributes[index].second; }
+	bool getAttributeString(const char* name, std::string& value) const;
+
+	// the character data directly inside the element, on END_ELEMENT
+	const std::string& getText() const;
+
+protected:
+	/*virtual*/ void startElement(const char* name, const char** atts);
+	/*virtual*/ void endElement(const char* name);
+	/*virtual*/ void characterData(const char* s, int len);
+
+private:
+	struct Event
+	{
+		EEvent						mType;
+		const LLStringTableEntry*	mName;
+		S32							mDepth;
+		S32							mLineNumber;
+	};
+
+	void pushEvent(EEvent type, const char* name, S32 depth);
+
+	Event		mEvent;
+	// An empty element gives its start and end tag in one go, the handler
+	// for the end tag runs before expat gets to look at the suspension.
+	Event		mQueue[2];
+	U32			mQueueHead;
+	U32			mQueueCount;
+
+	std::vector<std::pair<std::string, std::string> >	mAttributes;	// only grows, see mAttributeCount
+	U32													mAttributeCount;
+	std::vector<std::string>							mText;			// by depth, reused
+	// LLXmlParser's mDepth also counts CDATA sections and never counts the
+	// end of one back out, so the reader keeps its own
+	S32			mElementDepth;
+	S32			mLength;
+	bool		mStarted;
+	bool		mFinished;
+	bool		mFailed;
+};
+
+#endif // LL_LLXMLPULLREADER_H
@@ -158,4 +158,47 @@ namespace tut
 		ensure("listener fired on changed setting", mListenerFired);	   
 	}
 
+	// <polarity> Hashed control lookups
+	template<> template<>
+	void control_group_t::test<5>()
+	{
+		ensure_equals("compile time hash matches run time hash",
+					  LL_CONTROL_KEY("TestSetting").mHash, llcontrol_hash(std::string("TestSetting").c_str()));
+
+		mCG->loadFromFile(mTestConfigFile.c_str());
+		// enough to grow the index a few times
+		for (S32 i = 0; i < 2000; ++i)
+		{
+			mCG->declareS32(llformat("Generated%d", i), i, "generated");
+		}
+		ensure("by name", mCG->getControl("TestSetting").notNull());
+		ensure_equals("by key", mCG->getU32(LL_CONTROL_KEY("TestSetting")), 12U);
+		ensure_equals("by key after growing", mCG->getS32(LL_CONTROL_KEY("Generated1234")), 1234);
+		for (S32 i = 0; i < 2000; i += 97)
+		{
+			ensure_equals("generated by name", mCG->getS32(llformat("Generated%d", i)), i);
+		}
+		ensure("missing by key", mCG->getControl(LL_CONTROL_KEY("NoSuchSetting")) == NULL);
+		ensure("missing by name", !mCG->controlExists("NoSuchSetting"));
+
+		mCG->cleanup();
+		ensure("gone after cleanup", mCG->getControl(LL_CONTROL_KEY("TestSetting")) == NULL);
+	}
+
+	LLControlCallSite lookup_site(const LLControlCallSite& site = LLControlCallSite())
+	{
+		return site;
+	}
+
+	template<> template<>
+	void control_group_t::test<6>()
+	{
+#if LL_CONTROL_CALL_SITES
+		const S32 line = __LINE__; const LLControlCallSite site = lookup_site();
+		ensure_equals("caller's line", site.mLine, line);
+		ensure_equals("caller's file", std::string(site.mFile), std::string(__FILE__));
+#endif
+	}
+	// </polarity>
+
 }
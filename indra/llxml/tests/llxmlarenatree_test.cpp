@@ -0,0 +1,197 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/**
+ * @file llxmlarenatree_test.cpp
+ * @brief LLXmlArenaTree and LLXmlPullReader unit tests
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llxmlarenatree.h"
+#include "../llxmlpullreader.h"
+
+#include "../test/lltut.h"
+
+namespace tut
+{
+	static const char* sDocument =
+		"<?xml version=\"1.0\" encoding=\"utf-8\" standalone=\"yes\" ?>\n"
+		"<fonts>\n"
+		"  <font name=\"default\" font_style=\"BOLD\">\n"
+		"    <file>  DejaVuSans.ttf  </file>\n"
+		"    <os name=\"Windows\"/>\n"
+		"  </font>\n"
+		"  <font_size name=\"Small\" size=\"8.5\"/>\n"
+		"</fonts>\n";
+
+	struct xml_arena_tree
+	{
+	};
+
+	typedef test_group<xml_arena_tree> xml_arena_tree_group_t;
+	typedef xml_arena_tree_group_t::object xml_arena_tree_t;
+	tut::xml_arena_tree_group_t xml_arena_tree_group("llxmlarenatree");
+
+	// the tree links children and siblings in document order
+	template<> template<>
+	void xml_arena_tree_t::test<1>()
+	{
+		LLXmlArenaTree tree;
+		ensure("parsed", tree.parseBuffer(sDocument, (S32)strlen(sDocument)));
+
+		const LLXmlArenaTree::node_t root = tree.getRoot();
+		ensure("root name", tree.hasName(root, "fonts"));
+		ensure("root has no sibling", tree.getNextSibling(root) == LLXmlArenaTree::NO_NODE);
+
+		const LLXmlArenaTree::node_t font = tree.getFirstChild(root);
+		ensure("font name", tree.hasName(font, "font"));
+		const LLXmlArenaTree::node_t size = tree.getNextSibling(font);
+		ensure("font_size name", tree.hasName(size, "font_size"));
+		ensure("font_size is last", tree.getNextSibling(size) == LLXmlArenaTree::NO_NODE);
+		ensure("font_size is empty", tree.getFirstChild(size) == LLXmlArenaTree::NO_NODE);
+
+		const LLXmlArenaTree::node_t file = tree.getFirstChild(font);
+		ensure("file name", tree.hasName(file, "file"));
+		ensure("os name", tree.hasName(tree.getNextSibling(file), "os"));
+		ensure_equals("file line", tree.getLineNumber(file), 4);
+	}
+
+	// attributes and text
+	template<> template<>
+	void xml_arena_tree_t::test<2>()
+	{
+		LLXmlArenaTree tree;
+		ensure("parsed", tree.parseBuffer(sDocument, (S32)strlen(sDocument)));
+
+		const LLXmlArenaTree::node_t font = tree.getFirstChild(tree.getRoot());
+		std::string value;
+		ensure("name attribute", tree.getAttributeString(font, "name", value));
+		ensure_equals("name value", value, "default");
+		ensure("missing attribute", tree.getAttribute(font, "no_such_attribute") == NULL);
+
+		const LLXmlArenaTree::node_t file = tree.getFirstChild(font);
+		ensure_equals("raw text", std::string(tree.getValue(file)), "  DejaVuSans.ttf  ");
+		ensure_equals("text contents", tree.getTextContents(file), "DejaVuSans.ttf");
+
+		F32 size = 0.f;
+		ensure("size attribute", tree.getAttributeF32(tree.getNextSibling(font), "size", size));
+		ensure_equals("size value", size, 8.5f);
+	}
+
+	// a broken document leaves an empty tree and says why
+	template<> template<>
+	void xml_arena_tree_t::test<3>()
+	{
+		static const char* broken = "<fonts><font></fonts>";
+		LLXmlArenaTree tree;
+		ensure("not parsed", !tree.parseBuffer(broken, (S32)strlen(broken)));
+		ensure("no root", tree.getRoot() == LLXmlArenaTree::NO_NODE);
+		ensure("error set", !tree.getErrorString().empty());
+	}
+
+	// the pull reader gives every start and end tag once, empty elements included
+	template<> template<>
+	void xml_arena_tree_t::test<4>()
+	{
+		LLXmlPullReader reader;
+		ensure("opened", reader.openBuffer(sDocument, (S32)strlen(sDocument)));
+
+		std::string events;
+		LLXmlPullReader::EEvent event;
+		while ((event = reader.next()) == LLXmlPullReader::START_ELEMENT
+			   || event == LLXmlPullReader::END_ELEMENT)
+		{
+			events += llformat("%s%s%d ", event == LLXmlPullReader::START_ELEMENT ? "+" : "-",
+							   reader.getName()->mString, reader.getElementDepth());
+			if (event == LLXmlPullReader::END_ELEMENT && reader.hasName("file"))
+			{
+				ensure_equals("file text", reader.getText(), "  DejaVuSans.ttf  ");
+			}
+		}
+		ensure_equals("end of document", event, LLXmlPullReader::END_DOCUMENT);
+		ensure_equals("events", events,
+					  "+fonts0 +font1 +file2 -file2 +os2 -os2 -font1 +font_size1 -font_size1 -fonts0 ");
+	}
+
+	// attributes and skipping
+	template<> template<>
+	void xml_arena_tree_t::test<5>()
+	{
+		LLXmlPullReader reader;
+		ensure("opened", reader.openBuffer(sDocument, (S32)strlen(sDocument)));
+		ensure_equals("root", reader.next(), LLXmlPullReader::START_ELEMENT);
+		ensure_equals("font", reader.next(), LLXmlPullReader::START_ELEMENT);
+
+		std::string value;
+		ensure_equals("attribute count", reader.getAttributeCount(), 2U);
+		ensure("font_style attribute", reader.getAttributeString("font_style", value));
+		ensure_equals("font_style value", value, "BOLD");
+
+		ensure_equals("skipped font", reader.skipElement(), LLXmlPullReader::END_ELEMENT);
+		ensure("at font end", reader.hasName("font"));
+		ensure_equals("font_size", reader.next(), LLXmlPullReader::START_ELEMENT);
+		ensure("at font_size", reader.hasName("font_size"));
+		ensure_equals("skipped root", (reader.next(), reader.next(), reader.next()), LLXmlPullReader::END_DOCUMENT);
+	}
+
+	// parse errors end the scan
+	template<> template<>
+	void xml_arena_tree_t::test<6>()
+	{
+		static const char* broken = "<fonts><font></fonts>";
+		LLXmlPullReader reader;
+		ensure("opened", reader.openBuffer(broken, (S32)strlen(broken)));
+		LLXmlPullReader::EEvent event;
+		while ((event = reader.next()) == LLXmlPullReader::START_ELEMENT
+			   || event == LLXmlPullReader::END_ELEMENT)
+		{
+		}
+		ensure_equals("error", event, LLXmlPullReader::PARSE_ERROR);
+	}
+
+	// CDATA sections leave the element depths and the text alone
+	template<> template<>
+	void xml_arena_tree_t::test<7>()
+	{
+		static const char* cdata = "<a><b><![CDATA[x<y]]></b><c>z</c></a>";
+		LLXmlPullReader reader;
+		ensure("opened", reader.openBuffer(cdata, (S32)strlen(cdata)));
+
+		std::string events;
+		LLXmlPullReader::EEvent event;
+		while ((event = reader.next()) == LLXmlPullReader::START_ELEMENT
+			   || event == LLXmlPullReader::END_ELEMENT)
+		{
+			events += llformat("%s%s%d ", event == LLXmlPullReader::START_ELEMENT ? "+" : "-",
+							   reader.getName()->mString, reader.getElementDepth());
+			if (event == LLXmlPullReader::END_ELEMENT && reader.hasName("b"))
+			{
+				ensure_equals("b text", reader.getText(), "x<y");
+			}
+			else if (event == LLXmlPullReader::END_ELEMENT && reader.hasName("c"))
+			{
+				ensure_equals("c text", reader.getText(), "z");
+			}
+		}
+		ensure_equals("end of document", event, LLXmlPullReader::END_DOCUMENT);
+		ensure_equals("events", events, "+a0 +b1 -b1 +c1 -c1 -a0 ");
+	}
+}
@@ -1044,9 +1044,13 @@ void FSAreaSearch::matchObject(FSObjectProperties& details, LLViewerObject* obje
 			LLScrollListText* list_cell = static_cast<LLScrollListText*>(list_row->getColumn(i));
 			list_cell->setFontStyle(font_style);
 		}
+		mPanelList->getResultList()->refreshLineHeight(); // <polarity/>
 	}
 
-	mPanelList->getResultList()->refreshLineHeight();
+	// <polarity> addRow() already made room for plain rows, rescanning every
+	// row for each one added is quadratic
+	//mPanelList->getResultList()->refreshLineHeight();
+	// </polarity>
 }
 
 // <FS:Cron> Allows the object costs to be updated on-the-fly so as to bypass the problem with the data being stale when first accessed.
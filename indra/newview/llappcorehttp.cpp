@@ -145,7 +145,10 @@ LLAppCoreHttp::~LLAppCoreHttp()
 void LLAppCoreHttp::init()
 {
     LLCoreHttpUtil::setPropertyMethods(
-        boost::bind(&LLControlGroup::getBOOL, boost::ref(gSavedSettings), _1),
+        // <polarity> Hashed control lookups, pick the by-name overload
+        //boost::bind(&LLControlGroup::getBOOL, boost::ref(gSavedSettings), _1),
+        boost::bind(static_cast<BOOL (LLControlGroup::*)(const std::string&, const LLControlCallSite&)>(&LLControlGroup::getBOOL), boost::ref(gSavedSettings), _1, LLControlCallSite()),
+        // </polarity>
         boost::bind(&LLControlGroup::declareBOOL, boost::ref(gSavedSettings), _1, _2, _3, LLControlVariable::PERSIST_NONDFT));
 
     LLCore::LLHttp::initialize();
@@ -116,6 +116,8 @@
 #include "llexperiencecache.h"
 #include "llimagej2c.h"
 #include "llmemory.h"
+#include "llsizeclasspool.h" // <polarity/>
+#include "llframearena.h" // <polarity/>
 #include "llprimitive.h"
 #include "llurlaction.h"
 #include "llurlentry.h"
@@ -271,9 +273,15 @@
 #ifdef PVDATA_SYSTEM
 #include "pvdata.h"
 #endif
+#include "pvavatarupdatepool.h"
+#include "pvinventorycache.h"
+#include "pvinventorysearch.h"
+#include "pvparallelcull.h"
 #include "pvconstants.h"
 #include "pvfpsmeter.h"
 #include "pvgpuinfo.h"
+#include "pvxuibundle.h"
+#include "pvstartuppipeline.h"
 
 #include "llstring.h" // for boost::bind unknown override specifier
 
@@ -639,6 +647,7 @@ static void settings_to_globals()
 	LLVOTree::sTreeFactor				= gSavedSettings.getF32("RenderTreeLODFactor");
 	LLVOAvatar::sLODFactor				= gSavedSettings.getF32("RenderAvatarLODFactor");
 	LLVOAvatar::sPhysicsLODFactor		= gSavedSettings.getF32("RenderAvatarPhysicsLODFactor");
+	LLVOAvatar::sAvatarPhysics			= gSavedSettings.getBOOL("AvatarPhysics"); // <polarity/>
 	LLVOAvatar::updateImpostorRendering(gSavedSettings.getU32("RenderAvatarMaxNonImpostors"));
 	LLVOAvatar::sVisibleInFirstPerson	= gSavedSettings.getBOOL("FirstPersonAvatarVisible");
 	// clamp auto-open time to some minimum usable value
@@ -670,6 +679,15 @@ static void settings_modify()
 	gDebugPipeline = gSavedSettings.getBOOL("RenderDebugPipeline");
 }
 
+// <polarity> Startup pipeline
+static void setup_settings()
+{
+	settings_to_globals();
+	settings_setup_listeners();
+	settings_modify();
+}
+// </polarity>
+
 class LLFastTimerLogThread : public LLThread
 {
 public:
@@ -820,6 +838,8 @@ bool LLAppViewer::init()
 	// Start of the application
 	//
 
+	LLTrace::BlockTimerEventCapture::setThreadName("Main"); // <polarity/> Timer event capture
+
 	// initialize LLWearableType translation bridge.
 	// Memory will be cleaned up in ::cleanupClass()
 	LLWearableType::initClass(new LLUITranslationBridge());
@@ -852,6 +872,7 @@ bool LLAppViewer::init()
 	//set the max heap size.
 	initMaxHeapSize() ;
 	LLCoros::instance().setStackSize(gSavedSettings.getS32("CoroutineStackSize"));
+	LLCoros::instance().setStackPoolSize(gSavedSettings.getU32("PVNetwork_CoroutineStackPool")); // <polarity/>
 
 	// write Google Breakpad minidump files to a per-run dump directory to avoid multiple viewer issues.
 	std::string logdir = gDirUtilp->getExpandedFilename(LL_PATH_DUMP, "");
@@ -992,14 +1013,51 @@ bool LLAppViewer::init()
 	
 	LLViewerFloaterReg::registerFloaters();
 	
+	// <polarity> Startup pipeline
+	// The stages below used to run one after the other. Those that only read
+	// files into their own structures now run on workers next to the rest.
+	PVStartupPipeline pipeline("App Init");
+
+	// Copy settings to globals, set up their listeners and modify them based
+	// on system configuration and compile options
+	const PVStartupPipeline::stage_t settings = pipeline.addStage("settings", PVStartupPipeline::MAIN_THREAD,
+		PVStartupPipeline::always(&setup_settings));
+
+	// Find partition serial number (Windows) or hardware serial (Mac)
+	pipeline.addStage("serial_number", PVStartupPipeline::ANY_THREAD, boost::bind(&LLAppViewer::initSerialNumber, this));
+
+	// do any necessary set-up for accepting incoming SLURLs from apps
+	pipeline.addStage("slurl_handler", PVStartupPipeline::MAIN_THREAD, PVStartupPipeline::always(boost::bind(&LLAppViewer::initSLURLHandler, this)));
+
+	// Initialize the VFS, and gracefully handle initialization errors
+	const PVStartupPipeline::stage_t cache = pipeline.addStage("cache", PVStartupPipeline::MAIN_THREAD,
+		boost::bind(&LLAppViewer::initCache, this), settings);
+	// Singletons and settings stay on this thread, the worker stages below
+	// are handed what they need. Cache paths are only resolved when they run.
+	LLVOCache* object_cachep = LLVOCache::getInstance();
+	const U32 object_cache_regions = gSavedSettings.getU32("CacheNumberOfRegionsForObjects");
+	PVXUIBundle* xui_bundlep = PVXUIBundle::getInstance();
+	// the region object cache only reads its own header
+	pipeline.addStage("object_cache", PVStartupPipeline::ANY_THREAD,
+		PVStartupPipeline::always(boost::bind(&LLVOCache::initCache, object_cachep, LL_PATH_CACHE,
+											  object_cache_regions, getObjectCacheVersion())),
+		cache);
+	// Binary XUI bundle, it has to be there before anything parses XUI
+	const PVStartupPipeline::stage_t xui_bundle = pipeline.addStage("xui_bundle", PVStartupPipeline::ANY_THREAD,
+		PVStartupPipeline::always(boost::bind(&LLAppViewer::initXUIBundle, this, xui_bundlep)), cache);
+
 	/////////////////////////////////////////////////
 	//
 	// Load settings files
 	//
 	//
-	LLGroupMgr::parseRoleActions("role_actions.xml");
+	//LLGroupMgr::parseRoleActions("role_actions.xml");
+	pipeline.addStage("role_actions", PVStartupPipeline::MAIN_THREAD,
+		PVStartupPipeline::always(boost::bind(&LLGroupMgr::parseRoleActions, std::string("role_actions.xml"))), xui_bundle);
 
-	LLAgent::parseTeleportMessages("teleport_strings.xml");
+	//LLAgent::parseTeleportMessages("teleport_strings.xml");
+	pipeline.addStage("teleport_strings", PVStartupPipeline::MAIN_THREAD,
+		PVStartupPipeline::always(boost::bind(&LLAgent::parseTeleportMessages, std::string("teleport_strings.xml"))), xui_bundle);
 
 	// load MIME type -> media impl mappings
 	std::string mime_types_name;
@@ -1010,20 +1068,13 @@ bool LLAppViewer::init()
 #else
 	mime_types_name = "mime_types.xml";
 #endif
-	LLMIMETypes::parseMIMETypes( mime_types_name ); 
-
-	// Copy settings to globals. *TODO: Remove or move to appropriage class initializers
-	settings_to_globals();
-	// Setup settings listeners
-	settings_setup_listeners();
-	// Modify settings based on system configuration and compile options
-	settings_modify();
-
-	// Find partition serial number (Windows) or hardware serial (Mac)
-	mSerialNumber = generateSerialNumber();
+	//LLMIMETypes::parseMIMETypes( mime_types_name ); 
+	pipeline.addStage("mime_types", PVStartupPipeline::MAIN_THREAD,
+		PVStartupPipeline::always(boost::bind(&LLMIMETypes::parseMIMETypes, mime_types_name)), xui_bundle);
 
-	// do any necessary set-up for accepting incoming SLURLs from apps
-	initSLURLHandler();
+	// Initialize the repeater service.
+	pipeline.addStage("main_loop_repeater", PVStartupPipeline::MAIN_THREAD,
+		PVStartupPipeline::always(boost::bind(&LLMainLoopRepeater::start, LLMainLoopRepeater::getInstance())));
 
 	// Prepare for out-of-memory situations, during which we will crash on
 	// purpose and save a dump.
@@ -1033,11 +1084,11 @@ bool LLAppViewer::init()
 
 	// *Note: this is where gViewerStats used to be created.
 
-	//
-	// Initialize the VFS, and gracefully handle initialization errors
-	//
+	pipeline.run(gSavedSettings.getBOOL("PVDebug_ParallelStartup"));
+	pipeline.logTimings();
 
-	if (!initCache())
+	//if (!initCache())
+	if (!pipeline.succeeded(cache))
 	{
 		std::ostringstream msg;
 		msg << LLTrans::getString("MBUnableToAccessFile");
@@ -1045,9 +1096,7 @@ bool LLAppViewer::init()
 		return 1;
 	}
 	LL_INFOS("InitInfo") << "Cache initialization is done." << LL_ENDL ;
-
-	// Initialize the repeater service.
-	LLMainLoopRepeater::instance().start();
+	// </polarity>
 
 	//
 	// Initialize the window
@@ -1267,7 +1316,10 @@ bool LLAppViewer::init()
     /// Tell the Coprocedure manager how to discover and store the pool sizes
     // what I wanted
     LLCoprocedureManager::getInstance()->setPropertyMethods(
-        boost::bind(&LLControlGroup::getU32, boost::ref(gSavedSettings), _1),
+        // <polarity> Hashed control lookups, pick the by-name overload
+        //boost::bind(&LLControlGroup::getU32, boost::ref(gSavedSettings), _1),
+        boost::bind(static_cast<U32 (LLControlGroup::*)(const std::string&, const LLControlCallSite&)>(&LLControlGroup::getU32), boost::ref(gSavedSettings), _1, LLControlCallSite()),
+        // </polarity>
         boost::bind(&LLControlGroup::declareU32, boost::ref(gSavedSettings), _1, _2, _3, LLControlVariable::PERSIST_ALWAYS));
 
 	// TODO: consider moving proxy initialization here or LLCopocedureManager after proxy initialization, may be implement
@@ -1353,6 +1405,7 @@ static LLTrace::BlockTimerStatHandle FTM_TEXTURE_CACHE("Texture Cache");
 static LLTrace::BlockTimerStatHandle FTM_DECODE("Image Decode");
 static LLTrace::BlockTimerStatHandle FTM_VFS("VFS Thread");
 static LLTrace::BlockTimerStatHandle FTM_LFS("LFS Thread");
+static LLTrace::BlockTimerStatHandle FTM_KEYFRAME_DECODE("Keyframe Decode");
 static LLTrace::BlockTimerStatHandle FTM_PAUSE_THREADS("Pause Threads");
 static LLTrace::BlockTimerStatHandle FTM_IDLE("Idle");
 static LLTrace::BlockTimerStatHandle FTM_PUMP("Pump");
@@ -1378,8 +1431,10 @@ bool LLAppViewer::frame()
 
 	LL_RECORD_BLOCK_TIME(FTM_FRAME);
 	LLTrace::BlockTimer::processTimes();
+	LLFrameArena::newFrame(); // <polarity/> Frame arena
 	LLTrace::get_frame_recording().nextPeriod();
 	LLTrace::BlockTimer::logStats();
+	LLControlGroup::tickLookupReport(); // <polarity/> Hashed control lookups
 
 	LLTrace::get_thread_recorder()->pullFromChildren();
 
@@ -1565,6 +1620,11 @@ bool LLAppViewer::frame()
 
 				work_pending += updateTextureThreads(max_time);
 
+				{
+					LL_RECORD_BLOCK_TIME(FTM_KEYFRAME_DECODE);
+					work_pending += LLKeyframeMotion::updateDecodeThread(max_time);
+				}
+
 				{
 					LL_RECORD_BLOCK_TIME(FTM_VFS);
  					io_pending += LLVFSThread::updateClass(1);
@@ -1787,6 +1847,15 @@ bool LLAppViewer::cleanup()
 	
 	disconnectViewer();
 
+	// <polarity> Binary inventory cache
+	// disconnectViewer() queued the last inventory cache write, it has to
+	// land before the *.tmp purge below takes its temporary file
+	if (PVInventoryCache::instanceExists())
+	{
+		PVInventoryCache::instance().flush();
+	}
+	// </polarity>
+
 	LL_INFOS() << "Viewer disconnected" << LL_ENDL;
 
 	display_cleanup(); 
@@ -1886,6 +1955,13 @@ bool LLAppViewer::cleanup()
 	
 	// Cleanup Inventory after the UI since it will delete any remaining observers
 	// (Deleted observers should have already removed themselves)
+	// <polarity> Background inventory search
+	// the search deletes its own observer, so it has to go first
+	if (PVInventorySearch::instanceExists())
+	{
+		PVInventorySearch::instance().cleanup();
+	}
+	// </polarity>
 	gInventory.cleanupInventory();
 
 	LL_INFOS() << "Cleaning up Selections" << LL_ENDL;
@@ -1920,6 +1996,9 @@ bool LLAppViewer::cleanup()
 	// Turn off Space Navigator and similar devices
 	LLViewerJoystick::getInstance()->terminate();
 	
+	LLSizeClassPool::logStats(); // <polarity/>
+	LLCoros::instance().logStackStats(); // <polarity/>
+	LLFrameArena::logStats(); // <polarity/>
 	LL_INFOS() << "Cleaning up Objects" << LL_ENDL;
 	
 	LLViewerObject::cleanupVOClasses();
@@ -2061,6 +2140,25 @@ bool LLAppViewer::cleanup()
 	sTextureFetch->shutdown();
 	sTextureCache->shutdown();	
 	sImageDecodeThread->shutdown();
+	LLKeyframeMotion::cleanupDecodeThread();
+	// <polarity> Parallel avatar update
+	if (PVAvatarUpdatePool::instanceExists())
+	{
+		PVAvatarUpdatePool::instance().cleanupThreads();
+	}
+	// </polarity>
+	// <polarity> Parallel culling
+	if (PVParallelCull::instanceExists())
+	{
+		PVParallelCull::instance().cleanupThreads();
+	}
+	// </polarity>
+	// <polarity> Binary XUI bundle
+	if (PVXUIBundle::instanceExists())
+	{
+		PVXUIBundle::instance().save();
+	}
+	// </polarity>
 	
 	sTextureFetch->shutDownTextureCacheThread() ;
 	sTextureFetch->shutDownImageDecodeThread() ;
@@ -2166,6 +2264,11 @@ bool LLAppViewer::cleanup()
 
 	ll_close_fail_log();
 
+	// <polarity> Asynchronous logging
+	// the writer thread has to be gone before the log settings are
+	LLError::setAsyncLogging(false);
+	// </polarity>
+
 	LLError::LLCallStacks::cleanup();
 
 	removeMarkerFiles();
@@ -2232,6 +2335,25 @@ bool LLAppViewer::initThreads()
 
 	// Image decoding
 	LLAppViewer::sImageDecodeThread = new LLImageDecodeThread(enable_threads && true);
+	// <polarity> Decode animation assets off the main thread
+	if (gSavedSettings.getBOOL("PVAnimation_ThreadedDecode"))
+	{
+		LLKeyframeMotion::initDecodeThread(enable_threads && true);
+	}
+	LLKeyframeDataCache::setMaxSize((U64)gSavedSettings.getU32("PVAnimation_KeyframeCacheSize") * 1024 * 1024);
+	// </polarity>
+	// <polarity> Parallel avatar update
+	if (enable_threads && gSavedSettings.getBOOL("PVAvatar_ParallelUpdate"))
+	{
+		PVAvatarUpdatePool::instance().initThreads(gSavedSettings.getU32("PVAvatar_UpdateThreads"));
+	}
+	// </polarity>
+	// <polarity> Parallel culling
+	if (enable_threads && gSavedSettings.getBOOL("PVRender_ParallelCull"))
+	{
+		PVParallelCull::instance().initThreads(gSavedSettings.getU32("PVRender_CullThreads"));
+	}
+	// </polarity>
 	LLAppViewer::sTextureCache = new LLTextureCache(enable_threads && true);
 	LLAppViewer::sTextureFetch = new LLTextureFetch(LLAppViewer::getTextureCache(),
 													sImageDecodeThread,
@@ -3906,6 +4028,7 @@ void LLAppViewer::handleViewerCrash()
 
 	//print out recorded call stacks if there are any.
 	LLError::LLCallStacks::print();
+	LLError::flushAsyncLogging(); // <polarity/>
 
 	LLAppViewer* pApp = LLAppViewer::instance();
 	if (pApp->beingDebugged())
@@ -4547,6 +4670,21 @@ U32 LLAppViewer::getObjectCacheVersion()
 	return INDRA_OBJECT_CACHE_VERSION;
 }
 
+// <polarity> Startup pipeline
+bool LLAppViewer::initSerialNumber()
+{
+	mSerialNumber = generateSerialNumber();
+	return true;
+}
+
+// The cache directory is only known once initCache() ran, so the path is
+// looked up when the stage runs rather than when it is added
+void LLAppViewer::initXUIBundle(PVXUIBundle* bundlep)
+{
+	bundlep->load(gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "xui_bundle.bin"), mSecondInstance);
+}
+// </polarity>
+
 bool LLAppViewer::initCache()
 {
 	mPurgeCache = false;
@@ -4628,7 +4766,9 @@ bool LLAppViewer::initCache()
 	S64 extra = LLAppViewer::getTextureCache()->initCache(LL_PATH_CACHE, texture_cache_size, texture_cache_mismatch);
 	texture_cache_size -= extra;
 
-	LLVOCache::getInstance()->initCache(LL_PATH_CACHE, gSavedSettings.getU32("CacheNumberOfRegionsForObjects"), getObjectCacheVersion()) ;
+	// <polarity> Startup pipeline, done by the object_cache stage once this returns
+	//LLVOCache::getInstance()->initCache(LL_PATH_CACHE, gSavedSettings.getU32("CacheNumberOfRegionsForObjects"), getObjectCacheVersion()) ;
+	// </polarity>
 
 	// Init the VFS
 	vfs_size = llmin(vfs_size + extra, MAX_VFS_SIZE);
@@ -58,6 +58,7 @@ class LLTextureFetch;
 class LLWatchdogTimeout;
 class LLUpdaterService;
 class LLViewerJoystick;
+class PVXUIBundle; // <polarity/>
 
 extern LLTrace::BlockTimerStatHandle FTM_FRAME;
 
@@ -254,6 +255,10 @@ private:
 	void initStrings();       // Initialize LLTrans machinery
 	void initUpdater(); // Initialize the updater service.
 	bool initCache(); // Initialize local client cache.
+	// <polarity> Startup pipeline
+	bool initSerialNumber();
+	void initXUIBundle(PVXUIBundle* bundlep); // reads the cache location, runs after initCache()
+	// </polarity>
 	void checkMemory() ;
 
 	// We have switched locations of both Mac and Windows cache, make sure
@@ -200,8 +200,9 @@ LLVector3 LLBreastMotion::calculateAcceleration_local(const LLVector3 &new_char_
 BOOL LLBreastMotion::onUpdate(F32 time, U8* joint_mask)
 {
 	// Skip if disabled globally.
-	static LLCachedControl<bool> avatar_physics(gSavedSettings, "AvatarPhysics");
-	if (!avatar_physics)
+	//static LLCachedControl<bool> avatar_physics(gSavedSettings, "AvatarPhysics");
+	//if (!avatar_physics)
+	if (!LLVOAvatar::sAvatarPhysics) // <polarity/> Parallel avatar update
 	{
 		return TRUE;
 	}
@@ -385,7 +386,8 @@ BOOL LLBreastMotion::onUpdate(F32 time, U8* joint_mask)
 		const F32 min_delta = (1.0-lod_factor)*(mBreastParamsMax[i]-mBreastParamsMin[i])/2.0;
 		if (llabs(position_diff[i]) > min_delta)
 		{
-			mCharacter->updateVisualParams();
+			//mCharacter->updateVisualParams();
+			mCharacter->getMotionController().requestVisualParamsUpdate(); // <polarity/>
 			mBreastLastUpdatePosition_local_pt = new_local_pt;
 			return TRUE;
 		}
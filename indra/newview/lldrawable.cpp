@@ -92,7 +92,8 @@ void LLDrawable::incrementVisible()
 
 LLDrawable::LLDrawable(LLViewerObject *vobj, bool new_entry)
 :	LLViewerOctreeEntryData(LLViewerOctreeEntry::LLDRAWABLE),
-	LLTrace::MemTrackable<LLDrawable, 16>("LLDrawable"),
+//	LLTrace::MemTrackable<LLDrawable, 16>("LLDrawable"),
+	LLTrace::PoolAllocated<LLDrawable, 16>("LLDrawable"), // <polarity/>
 	mVObjp(vobj)
 {
 	init(new_entry); 
@@ -58,11 +58,13 @@ const U32 SILHOUETTE_HIGHLIGHT = 0;
 LL_ALIGN_PREFIX(16)
 class LLDrawable 
 :	public LLViewerOctreeEntryData,
-	public LLTrace::MemTrackable<LLDrawable, 16>
+//	public LLTrace::MemTrackable<LLDrawable, 16>
+	public LLTrace::PoolAllocated<LLDrawable, 16> // <polarity/>
 {
 public:
 	LLDrawable(const LLDrawable& rhs) 
-	:	LLTrace::MemTrackable<LLDrawable, 16>("LLDrawable"),
+//	:	LLTrace::MemTrackable<LLDrawable, 16>("LLDrawable"),
+	:	LLTrace::PoolAllocated<LLDrawable, 16>("LLDrawable"), // <polarity/>
 		LLViewerOctreeEntryData(rhs)
 	{
 		*this = rhs;
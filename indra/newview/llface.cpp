@@ -55,6 +55,7 @@
 #include "llviewershadermgr.h"
 #include "llviewertexture.h"
 #include "llvoavatar.h"
+#include "llframearena.h" // <polarity/>
 // [RLVa:KB] - Checked: RLVa-2.0.0
 #include "rlvhandler.h"
 // [/RLVa:KB]
@@ -1729,7 +1730,8 @@ BOOL LLFace::getGeometryVolume(const LLVolume& volume,
 			{ //bump mapped or has material, just do the whole expensive loop
 				LL_RECORD_BLOCK_TIME(FTM_FACE_TEX_DEFAULT);
 
-				std::vector<LLVector2> bump_tc;
+//				std::vector<LLVector2> bump_tc;
+				std::vector<LLVector2, LLFrameAllocator<LLVector2> > bump_tc; // <polarity/> Frame arena
 		
 				if (mat && !mat->getNormalID().isNull())
 				{ //writing out normal and specular texture coordinates, not bump offsets
@@ -52,11 +52,13 @@ class LLDrawInfo;
 const F32 MIN_ALPHA_SIZE = 1024.f;
 const F32 MIN_TEX_ANIM_SIZE = 512.f;
 
-class LLFace : public LLTrace::MemTrackableNonVirtual<LLFace, 16>
+//class LLFace : public LLTrace::MemTrackableNonVirtual<LLFace, 16>
+class LLFace : public LLTrace::PoolAllocatedNonVirtual<LLFace, 16> // <polarity/>
 {
 public:
 	LLFace(const LLFace& rhs)
-	:	LLTrace::MemTrackableNonVirtual<LLFace, 16>("LLFace")
+//	:	LLTrace::MemTrackableNonVirtual<LLFace, 16>("LLFace")
+	:	LLTrace::PoolAllocatedNonVirtual<LLFace, 16>("LLFace") // <polarity/>
 	{
 		*this = rhs;
 	}
@@ -85,7 +87,8 @@ public:
 
 public:
 	LLFace(LLDrawable* drawablep, LLViewerObject* objp)
-	:	LLTrace::MemTrackableNonVirtual<LLFace, 16>("LLFace")
+//	:	LLTrace::MemTrackableNonVirtual<LLFace, 16>("LLFace")
+	:	LLTrace::PoolAllocatedNonVirtual<LLFace, 16>("LLFace") // <polarity/>
 	{
 		init(drawablep, objp);
 	}
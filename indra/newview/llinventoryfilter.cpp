@@ -88,7 +88,8 @@ LLInventoryFilter::LLInventoryFilter(const Params& p)
 	mFilterSubString(p.substring),
 	mCurrentGeneration(0),
 	mFirstRequiredGeneration(0),
-	mFirstSuccessGeneration(0)
+	mFirstSuccessGeneration(0),
+	mSearchVersion(0) // <polarity/>
 {
 	// <FS:Zi> Begin Multi-substring inventory search
 	mSubStringMatchOffsets.clear();
@@ -113,6 +114,12 @@ void LLInventoryFilter::setFilterSubStringTarget(const std::string& targetName)
 		mFilterSubStringTarget = SUBST_TARGET_ALL;
 	else
 		LL_WARNS("LLInventoryFilter") << "Unknown sub string target: " << targetName << LL_ENDL;
+	// <polarity> Background substring search
+	if (mSearch && mSearch->getTarget() != mFilterSubStringTarget)
+	{
+		mSearch = NULL;
+	}
+	// </polarity>
 }
 LLInventoryFilter::EFilterSubstringTarget LLInventoryFilter::getFilterSubStringTarget() const
 {
@@ -133,7 +140,17 @@ bool LLInventoryFilter::check(const LLFolderViewModelItem* item)
 	// <FS:Zi> Multi-substring inventory search
 	//bool passed = (mFilterSubString.size() ? listener->getSearchableName().find(mFilterSubString) != std::string::npos : true);
 	std::string::size_type string_offset = std::string::npos;
-	if (mFilterSubStrings.size())
+	// <polarity> Background substring search
+	const PVInventorySearch::EResult search_result = mSearch ? mSearch->check(listener) : PVInventorySearch::RESULT_UNKNOWN;
+	const bool search_failed = (search_result == PVInventorySearch::RESULT_NO_MATCH || search_result == PVInventorySearch::RESULT_PENDING);
+	if (search_failed)
+	{
+		// pending ones get another look when the results come in, see updateSearch()
+		std::fill(mSubStringMatchOffsets.begin(), mSubStringMatchOffsets.end(), std::string::npos);
+	}
+	// </polarity>
+	//if (mFilterSubStrings.size())
+	if (!search_failed && mFilterSubStrings.size()) // <polarity/>
 	{
 		std::string searchLabel;
 		switch (mFilterSubStringTarget)
@@ -758,6 +775,12 @@ void LLInventoryFilter::setFilterSubString(const std::string& string)
 		while (to != std::string::npos);
 	}
 	// </FS:Zi> Multi-substring inventory search
+	// <polarity> Background substring search
+	if (mSearch && mSearch->getTerms() != mFilterSubStrings)
+	{
+		mSearch = NULL;
+	}
+	// </polarity>
 
 	if (mFilterSubString != filter_sub_string_new)
 	{
@@ -894,6 +917,12 @@ bool LLInventoryFilter::isSinceLogoff() const
 
 void LLInventoryFilter::clearModified()
 {
+	// <polarity> Keep the view filtering until the first background results are in
+	if (mSearch && mSearch->isPending())
+	{
+		return;
+	}
+	// </polarity>
 	mFilterModified = FILTER_NONE;
 }
 
@@ -1412,7 +1441,42 @@ void LLInventoryFilter::resetTime(S32 timeout)
 	mFilterTime.reset();
     F32 time_in_sec = (F32)(timeout)/1000.0;
 	mFilterTime.setTimerExpirySec(time_in_sec);
+	updateSearch(); // <polarity/>
+}
+
+// <polarity> Background substring search
+void LLInventoryFilter::updateSearch()
+{
+	// while the first results stream in, failed items are filtered again at most this often
+	static const F32 SEARCH_REFRESH_INTERVAL = 0.25f;
+
+	if (mFilterSubStrings.empty())
+	{
+		mSearch = NULL;
+		return;
+	}
+	if (!mSearch || mSearch->getTerms() != mFilterSubStrings || mSearch->getTarget() != mFilterSubStringTarget)
+	{
+		mSearch = PVInventorySearch::instance().find(mFilterSubStrings, mFilterSubStringTarget);
+		mSearchVersion = 0;
+		mSearchRefreshTimer.reset();
+		if (!mSearch)
+		{
+			return;
+		}
+	}
+
+	const U32 version = mSearch->update();
+	if (version != mSearchVersion
+		&& (mSearch->isComplete() || mSearchRefreshTimer.getElapsedTimeF32() > SEARCH_REFRESH_INTERVAL))
+	{
+		// only what failed so far needs another look
+		mSearchVersion = version;
+		mSearchRefreshTimer.reset();
+		setModified(FILTER_LESS_RESTRICTIVE);
+	}
 }
+// </polarity>
 
 S32 LLInventoryFilter::getCurrentGeneration() const
 { 
@@ -30,6 +30,7 @@
 #include "llinventorytype.h"
 #include "llpermissionsflags.h"
 #include "llfolderviewmodel.h"
+#include "pvinventorysearch.h" // <polarity/>
 
 class LLFolderViewItem;
 class LLFolderViewFolder;
@@ -305,6 +306,7 @@ private:
 	bool 				checkAgainstPermissions(const LLInventoryItem* item) const;
 	bool 				checkAgainstFilterLinks(const class LLFolderViewModelItemInventory* listener) const;
 	bool				checkAgainstClipboard(const LLUUID& object_id) const;
+	void				updateSearch(); // <polarity/>
 
 	FilterOps				mFilterOps;
 	FilterOps				mDefaultFilterOps;
@@ -331,6 +333,12 @@ private:
     
 	std::string 			mFilterText;
 	std::string 			mEmptyLookupMessage;
+
+	// <polarity> Background substring search
+	LLPointer<PVInventorySearch::Query>	mSearch;
+	U32						mSearchVersion;
+	LLTimer					mSearchRefreshTimer;
+	// </polarity>
 };
 
 #endif
@@ -60,6 +60,7 @@
 #include "bufferarray.h"
 #include "bufferstream.h"
 #include "llcorehttputil.h"
+#include "pvinventorycache.h" // <polarity/>
 // [RLVa:KB] - Checked: 2011-05-22 (RLVa-1.3.1a)
 #include "rlvhandler.h"
 #include "rlvlocks.h"
@@ -1769,6 +1770,16 @@ void LLInventoryModel::cache(
 		INCLUDE_TRASH,
 		can_cache);
 	std::string inventory_filename = getInvCacheAddres(agent_id);
+	// <polarity> Binary inventory cache
+	static LLCachedControl<bool> binary_cache(gSavedSettings, "PVInventory_BinaryCache", true);
+	if (binary_cache)
+	{
+		PVInventoryCache::instance().save(PVInventoryCache::getFilename(inventory_filename), categories, items);
+		// drop the text cache, it would be stale if the binary one gets turned off
+		LLFile::remove(inventory_filename + ".gz", ENOENT);
+		return;
+	}
+	// </polarity>
 	saveToFile(inventory_filename, categories, items);
 	std::string gzip_filename(inventory_filename);
 	gzip_filename.append(".gz");
@@ -2076,7 +2087,21 @@ bool LLInventoryModel::loadSkeleton(
 		const S32 NO_VERSION = LLViewerInventoryCategory::VERSION_UNKNOWN;
 		std::string gzip_filename(inventory_filename);
 		gzip_filename.append(".gz");
-		LLFILE* fp = LLFile::fopen(gzip_filename, "rb");
+		// <polarity> Binary inventory cache
+		// the text cache is only looked at when there is no usable binary one,
+		// e.g. the first login after switching over
+		static LLCachedControl<bool> binary_cache(gSavedSettings, "PVInventory_BinaryCache", true);
+		const std::string binary_filename = PVInventoryCache::getFilename(inventory_filename);
+		bool is_cache_obsolete = false;
+		const bool loaded_binary = binary_cache && PVInventoryCache::load(binary_filename, categories, items, is_cache_obsolete);
+		if (is_cache_obsolete)
+		{
+			LL_WARNS(LOG_INV) << "Binary inv cache out of date, removing" << LL_ENDL;
+			LLFile::remove(binary_filename);
+			is_cache_obsolete = false;
+		}
+		LLFILE* fp = loaded_binary ? NULL : LLFile::fopen(gzip_filename, "rb");
+		// </polarity>
 		bool remove_inventory_file = false;
 		if(fp)
 		{
@@ -2094,8 +2119,7 @@ bool LLInventoryModel::loadSkeleton(
 				LL_INFOS(LOG_INV) << "Unable to gunzip " << gzip_filename << LL_ENDL;
 			}
 		}
-		bool is_cache_obsolete = false;
-		if(loadFromFile(inventory_filename, categories, items, is_cache_obsolete))
+		if(loaded_binary || loadFromFile(inventory_filename, categories, items, is_cache_obsolete)) // <polarity/>
 		{
 			// We were able to find a cache of files. So, use what we
 			// found to generate a set of categories we should add. We
@@ -2141,6 +2165,7 @@ bool LLInventoryModel::loadSkeleton(
 			// go ahead and add the cats returned during the download
 			std::set<LLUUID>::const_iterator not_cached_id = cached_ids.end();
 			cached_category_count = cached_ids.size();
+			mCategoryMap.reserve(mCategoryMap.size() + temp_cats.size()); // <polarity/>
 			for(cat_set_t::iterator it = temp_cats.begin(); it != temp_cats.end(); ++it)
 			{
 				if(cached_ids.find((*it)->getUUID()) == not_cached_id)
@@ -2161,6 +2186,7 @@ bool LLInventoryModel::loadSkeleton(
 			S32 good_link_count = 0;
 			S32 recovered_link_count = 0;
 			cat_map_t::iterator unparented = mCategoryMap.end();
+			mItemMap.reserve(mItemMap.size() + items.size()); // <polarity/>
 			for(item_array_t::const_iterator item_iter = items.begin();
 				item_iter != items.end();
 				++item_iter)
@@ -2313,6 +2339,11 @@ void LLInventoryModel::buildParentChildMap()
 	cat_array_t* catsp;
 	item_array_t* itemsp;
 	
+	// <polarity> one extra for the null parent below
+	cats.reserve(mCategoryMap.size());
+	mParentChildCategoryTree.reserve(mCategoryMap.size() + 1);
+	mParentChildItemTree.reserve(mCategoryMap.size());
+	// </polarity>
 	for(cat_map_t::iterator cit = mCategoryMap.begin(); cit != mCategoryMap.end(); ++cit)
 	{
 		LLViewerInventoryCategory* cat = cit->second;
@@ -2425,12 +2456,29 @@ void LLInventoryModel::buildParentChildMap()
 	item_array_t items;
 	if(!mItemMap.empty())
 	{
+		// <polarity> Size every child array up front so each folder's items
+		// are filed into one allocation instead of growing it item by item.
+		LLUUIDHashMap<U32> item_counts;
+		item_counts.reserve(mParentChildItemTree.size());
+		items.reserve(mItemMap.size());
+		// </polarity>
 		LLPointer<LLViewerInventoryItem> item;
 		for(item_map_t::iterator iit = mItemMap.begin(); iit != mItemMap.end(); ++iit)
 		{
 			item = (*iit).second;
 			items.push_back(item);
+			++item_counts[item->getParentUUID()]; // <polarity/>
+		}
+		// <polarity>
+		for (LLUUIDHashMap<U32>::const_iterator cit = item_counts.begin(); cit != item_counts.end(); ++cit)
+		{
+			itemsp = get_ptr_in_map(mParentChildItemTree, cit->first);
+			if (itemsp)
+			{
+				itemsp->reserve(itemsp->size() + cit->second);
+			}
 		}
+		// </polarity>
 	}
 	count = items.size();
 	lost = 0;
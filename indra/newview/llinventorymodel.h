@@ -31,6 +31,7 @@
 #include "llfoldertype.h"
 #include "llframetimer.h"
 #include "lluuid.h"
+#include "lluuidhashmap.h" // <polarity/>
 #include "llpermissionsflags.h"
 #include "llviewerinventory.h"
 #include "llstring.h"
@@ -170,13 +171,16 @@ private:
 	// the inventory using several different identifiers.
 	// mInventory member data is the 'master' list of inventory, and
 	// mCategoryMap and mItemMap store uuid->object mappings. 
-	typedef std::map<LLUUID, LLPointer<LLViewerInventoryCategory> > cat_map_t;
-	typedef std::map<LLUUID, LLPointer<LLViewerInventoryItem> > item_map_t;
+	// <polarity> Hashed, these are hit millions of times by the big collect
+	// and validation passes and nothing relies on them being sorted.
+	typedef LLUUIDHashMap<LLPointer<LLViewerInventoryCategory> > cat_map_t;
+	typedef LLUUIDHashMap<LLPointer<LLViewerInventoryItem> > item_map_t;
 	cat_map_t mCategoryMap;
 	item_map_t mItemMap;
 	// This last set of indices is used to map parents to children.
-	typedef std::map<LLUUID, cat_array_t*> parent_cat_map_t;
-	typedef std::map<LLUUID, item_array_t*> parent_item_map_t;
+	typedef LLUUIDHashMap<cat_array_t*> parent_cat_map_t;
+	typedef LLUUIDHashMap<item_array_t*> parent_item_map_t;
+	// </polarity>
 	parent_cat_map_t mParentChildCategoryTree;
 	parent_item_map_t mParentChildItemTree;
 
@@ -195,6 +199,7 @@ private:
 public:
 	static BOOL getIsFirstTimeInViewer2();
 private:
+	friend class PVInventoryCache; // <polarity/> stamps the binary cache with sCurrentInvCacheVersion
 	static BOOL sFirstTimeInViewer2;
 	const static S32 sCurrentInvCacheVersion; // expected inventory cache version
 
@@ -652,8 +657,10 @@ protected:
 	cat_array_t* getUnlockedCatArray(const LLUUID& id);
 	item_array_t* getUnlockedItemArray(const LLUUID& id);
 private:
-	std::map<LLUUID, bool> mCategoryLock;
-	std::map<LLUUID, bool> mItemLock;
+	// <polarity> checked on every getUnlocked*Array()
+	LLUUIDHashMap<bool> mCategoryLock;
+	LLUUIDHashMap<bool> mItemLock;
+	// </polarity>
 	
 	//--------------------------------------------------------------------
 	// Debugging
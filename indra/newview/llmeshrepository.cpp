@@ -1532,8 +1532,16 @@ void LLMeshRepoThread::decActiveHeaderRequests()
 }
 
 //return false if failed to get header
+// <polarity> Timer event capture
+static LLTrace::BlockTimerStatHandle FTM_MESH_FETCH_HEADER("Mesh Fetch Header");
+static LLTrace::BlockTimerStatHandle FTM_MESH_FETCH_LOD("Mesh Fetch LOD");
+static LLTrace::BlockTimerStatHandle FTM_MESH_HEADER_RECEIVED("Mesh Header Received");
+static LLTrace::BlockTimerStatHandle FTM_MESH_LOD_RECEIVED("Mesh LOD Received");
+// </polarity>
+
 bool LLMeshRepoThread::fetchMeshHeader(const LLVolumeParams& mesh_params)
 {
+	LL_RECORD_BLOCK_TIME(FTM_MESH_FETCH_HEADER); // <polarity/> Timer event capture
 	++LLMeshRepository::sMeshRequestCount;
 
 	{
@@ -1593,6 +1601,7 @@ bool LLMeshRepoThread::fetchMeshHeader(const LLVolumeParams& mesh_params)
 //return false if failed to get mesh lod.
 bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod)
 {
+	LL_RECORD_BLOCK_TIME(FTM_MESH_FETCH_LOD); // <polarity/> Timer event capture
 	if (!mHeaderMutex)
 	{
 		return false;
@@ -1690,6 +1699,7 @@ bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod)
 
 bool LLMeshRepoThread::headerReceived(const LLVolumeParams& mesh_params, U8* data, S32 data_size)
 {
+	LL_RECORD_BLOCK_TIME(FTM_MESH_HEADER_RECEIVED); // <polarity/> Timer event capture
 	const LLUUID mesh_id = mesh_params.getSculptID();
 	LLSD header;
 	
@@ -1755,6 +1765,7 @@ bool LLMeshRepoThread::headerReceived(const LLVolumeParams& mesh_params, U8* dat
 
 bool LLMeshRepoThread::lodReceived(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size)
 {
+	LL_RECORD_BLOCK_TIME(FTM_MESH_LOD_RECEIVED); // <polarity/> Timer event capture
 	if (data == NULL || data_size <= 0)
 	{
 		return false;
@@ -455,7 +455,11 @@ F32 LLPhysicsMotion::calculateAcceleration_local(const F32 velocity_local)
 BOOL LLPhysicsMotionController::onUpdate(F32 time, U8* joint_mask)
 {
         // Skip if disabled globally.
-        if (!gSavedSettings.getBOOL("AvatarPhysics"))
+        // <polarity> Parallel avatar update
+        // this may run on an avatar update worker, the setting is mirrored on the main thread
+        //if (!gSavedSettings.getBOOL("AvatarPhysics"))
+        if (!LLVOAvatar::sAvatarPhysics)
+        // </polarity>
         {
                 return TRUE;
         }
@@ -470,7 +474,8 @@ BOOL LLPhysicsMotionController::onUpdate(F32 time, U8* joint_mask)
         }
                 
         if (update_visuals)
-                mCharacter->updateVisualParams();
+                //mCharacter->updateVisualParams();
+                mCharacter->getMotionController().requestVisualParamsUpdate(); // <polarity/>
         
         return TRUE;
 }
@@ -946,6 +946,16 @@ public:
 		
 		return false;
 	}
+
+	// <polarity> Parallel culling
+	virtual bool predictEarlyFail(LLViewerOctreeGroup* base_group)
+	{
+		LLSpatialGroup* group = (LLSpatialGroup*)base_group;
+		return group->getOctreeNode()->getParent() &&
+			LLPipeline::sUseOcclusion &&
+			group->isOcclusionState(LLSpatialGroup::OCCLUDED);
+	}
+	// </polarity>
 	
 	virtual S32 frustumCheck(const LLViewerOctreeGroup* group)
 	{
@@ -1361,6 +1371,21 @@ S32 LLSpatialPartition::cull(LLCamera &camera, std::vector<LLDrawable *>* result
 	}
 	
 S32 LLSpatialPartition::cull(LLCamera &camera, bool do_occlusion)
+{
+	// <polarity> Parallel culling
+	LLViewerOctreeCull* culler = beginCull(camera, do_occlusion);
+	{
+		LL_RECORD_BLOCK_TIME(FTM_FRUSTUM_CULL);
+		culler->traverse(mOctree);
+	}
+	delete culler;
+	// </polarity>
+	
+	return 0;
+}
+
+// <polarity> Parallel culling
+LLViewerOctreeCull* LLSpatialPartition::beginCull(LLCamera &camera, bool do_occlusion)
 {
 #if LL_OCTREE_PARANOIA_CHECK
 	((LLSpatialGroup*)mOctree->getListener(0))->checkStates();
@@ -1377,25 +1402,15 @@ S32 LLSpatialPartition::cull(LLCamera &camera, bool do_occlusion)
 
 	if (LLPipeline::sShadowRender)
 	{
-		LL_RECORD_BLOCK_TIME(FTM_FRUSTUM_CULL);
-		LLOctreeCullShadow culler(&camera);
-		culler.traverse(mOctree);
+		return new LLOctreeCullShadow(&camera);
 	}
 	else if (mInfiniteFarClip || !LLPipeline::sUseFarClip)
 	{
-		LL_RECORD_BLOCK_TIME(FTM_FRUSTUM_CULL);		
-		LLOctreeCullNoFarClip culler(&camera);
-		culler.traverse(mOctree);
+		return new LLOctreeCullNoFarClip(&camera);
 	}
-	else
-	{
-		LL_RECORD_BLOCK_TIME(FTM_FRUSTUM_CULL);		
-		LLOctreeCull culler(&camera);
-		culler.traverse(mOctree);
-	}
-	
-	return 0;
+	return new LLOctreeCull(&camera);
 }
+// </polarity>
 
 void pushVerts(LLDrawInfo* params, U32 mask)
 {
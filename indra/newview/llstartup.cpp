@@ -213,6 +213,7 @@
 #endif
 #include "fsassetblacklist.h"
 #include "llprogressview.h"
+#include "llxmlpullreader.h" // <polarity/>
 //
 // exported globals
 //
@@ -472,13 +473,18 @@ bool idle_startup()
 		}
 */
 		std::string xml_file = LLUI::locateSkin("xui_version.xml");
-		LLXMLNodePtr root;
+		// <polarity> Only the version is wanted, pull it without building a tree
+		//LLXMLNodePtr root;
 		bool xml_ok = false;
-		if (LLXMLNode::parseFile(xml_file, root, NULL))
+		//if (LLXMLNode::parseFile(xml_file, root, NULL))
+		LLXmlPullReader reader;
+		if (reader.openFile(xml_file) && reader.next() == LLXmlPullReader::START_ELEMENT)
 		{
-			if( (root->hasName("xui_version") ) )
+			//if( (root->hasName("xui_version") ) )
+			if (reader.hasName("xui_version") && reader.skipElement() == LLXmlPullReader::END_ELEMENT)
 			{
-				std::string value = root->getValue();
+				//std::string value = root->getValue();
+				const std::string& value = reader.getText();
 				F32 version = 0.0f;
 				LLStringUtil::convertToF32(value, version);
 				if (version >= 1.0f)
@@ -487,6 +493,7 @@ bool idle_startup()
 				}
 			}
 		}
+		// </polarity>
 		if (!xml_ok)
 		{
 			// If XML is bad, there's a good possibility that notifications.xml is ALSO bad.
@@ -714,16 +714,23 @@ bool LLTextureCacheRemoteWorker::doWrite()
 	return done;
 }
 
+// <polarity> Timer event capture
+static LLTrace::BlockTimerStatHandle FTM_TEXTURE_CACHE_READ("Texture Cache Read");
+static LLTrace::BlockTimerStatHandle FTM_TEXTURE_CACHE_WRITE("Texture Cache Write");
+// </polarity>
+
 //virtual
 bool LLTextureCacheWorker::doWork(S32 param)
 {
 	bool res = false;
 	if (param == 0) // read
 	{
+		LL_RECORD_BLOCK_TIME(FTM_TEXTURE_CACHE_READ); // <polarity/>
 		res = doRead();
 	}
 	else if (param == 1) // write
 	{
+		LL_RECORD_BLOCK_TIME(FTM_TEXTURE_CACHE_WRITE); // <polarity/>
 		res = doWrite();
 	}
 	else
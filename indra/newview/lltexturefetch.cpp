@@ -288,8 +288,11 @@ static const char* e_state_name[] =
 // Log scope
 static const char * const LOG_TXT = "Texture";
 
-class LLTextureFetchWorker : public LLWorkerClass, public LLCore::HttpHandler
-
+//class LLTextureFetchWorker : public LLWorkerClass, public LLCore::HttpHandler
+// <polarity> Size class pool
+class LLTextureFetchWorker : public LLWorkerClass, public LLCore::HttpHandler,
+							 public LLTrace::PoolAllocatedNonVirtual<LLTextureFetchWorker>
+// </polarity>
 {
 	friend class LLTextureFetch;
 	friend class LLTextureFetchDebugger;
@@ -889,6 +892,7 @@ LLTextureFetchWorker::LLTextureFetchWorker(LLTextureFetch* fetcher,
 										   S32 size)			// Desired size
 	: LLWorkerClass(fetcher, "TextureFetch"),
 	  LLCore::HttpHandler(),
+	  LLTrace::PoolAllocatedNonVirtual<LLTextureFetchWorker>("LLTextureFetchWorker"), // <polarity/>
 	  mState(INIT),
 	  mWriteToCacheState(NOT_WRITE),
 	  mFetcher(fetcher),
@@ -1124,8 +1128,11 @@ void LLTextureFetchWorker::startWork(S32 param)
 }
 
 // Threads:  Ttf
+static LLTrace::BlockTimerStatHandle FTM_TEXTURE_FETCH_WORK("Texture Fetch Worker"); // <polarity/> Timer event capture
+
 bool LLTextureFetchWorker::doWork(S32 param)
 {
+	LL_RECORD_BLOCK_TIME(FTM_TEXTURE_FETCH_WORK); // <polarity/> Timer event capture
 	static const LLCore::HttpStatus http_not_found(HTTP_NOT_FOUND);						// 404
 	static const LLCore::HttpStatus http_service_unavail(HTTP_SERVICE_UNAVAILABLE);		// 503
 	static const LLCore::HttpStatus http_not_sat(HTTP_REQUESTED_RANGE_NOT_SATISFIABLE);	// 416;
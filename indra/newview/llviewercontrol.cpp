@@ -60,6 +60,9 @@
 #include "llviewerobjectlist.h"
 #include "llparcel.h"
 #include "llerrorcontrol.h"
+#include "llevents.h" // <polarity/>
+#include "llcorehttputil.h" // <polarity/>
+#include "llsdserialize.h" // <polarity/>
 #include "llappviewer.h"
 #include "llvosurfacepatch.h"
 #include "llvowlsky.h"
@@ -89,6 +92,9 @@
 
 #include "pvfpsmeter.h"
 #include "llwindowwin32.h"
+#include "llkeyframemotion.h"
+#include "llfontgl.h" // <polarity/>
+#include "lltraceeventcapture.h" // <polarity/>
 
 #ifdef TOGGLE_HACKED_GODLIKE_VIEWER
 BOOL 				gHackGodmode = FALSE;
@@ -274,6 +280,14 @@ static bool handleAvatarPhysicsLODChanged(const LLSD& newvalue)
 	return true;
 }
 
+// <polarity> Parallel avatar update
+static bool handleAvatarPhysicsChanged(const LLSD& newvalue)
+{
+	LLVOAvatar::sAvatarPhysics = newvalue.asBoolean();
+	return true;
+}
+// </polarity>
+
 static bool handleTerrainLODChanged(const LLSD& newvalue)
 {
 		LLVOSurfacePatch::sLODFactor = (F32)newvalue.asReal();
@@ -809,6 +823,70 @@ static bool handleDynamicTitleOptionsChanged(const LLSD& val)
 	return true;
 }
 
+// <polarity> Bounded animation data cache
+static bool handleKeyframeCacheSizeChanged(const LLSD& newvalue)
+{
+	LLKeyframeDataCache::setMaxSize((U64)(U32)newvalue.asInteger() * 1024 * 1024);
+	return true;
+}
+// </polarity>
+
+// <polarity> Glyph run cache
+static bool handleFontGlyphRunCacheChanged(const LLSD& newvalue)
+{
+	LLFontGL::sUseGlyphRunCache = newvalue.asBoolean();
+	return true;
+}
+// </polarity>
+
+// <polarity> Hashed control lookups
+static bool handleReportSettingLookupsChanged(const LLSD& newvalue)
+{
+	LLControlGroup::setLookupTracking(newvalue.asBoolean());
+	return true;
+}
+// </polarity>
+
+// <polarity> Asynchronous logging
+static bool handleAsyncLoggingChanged(const LLSD& newvalue)
+{
+	LLError::setAsyncLogging(newvalue.asBoolean());
+	return true;
+}
+// </polarity>
+
+// <polarity> Flat event dispatch
+static bool handleFastEventDispatchChanged(const LLSD& newvalue)
+{
+	LLEventPump::setFastDispatch(newvalue.asBoolean());
+	return true;
+}
+// </polarity>
+
+// <polarity> Binary LLSD over HTTP
+static bool handleAcceptBinaryLLSDChanged(const LLSD& newvalue)
+{
+	LLCoreHttpUtil::setAcceptBinaryLLSD(newvalue.asBoolean());
+	return true;
+}
+// </polarity>
+
+// <polarity> Fast LLSD XML reader
+static bool handleFastLLSDXMLChanged(const LLSD& newvalue)
+{
+	LLSDXMLParser::setFastParse(newvalue.asBoolean());
+	return true;
+}
+// </polarity>
+
+// <polarity> Timer event capture
+static bool handleCaptureTimerEventsChanged(const LLSD& newvalue)
+{
+	LLTrace::BlockTimerEventCapture::setCapturing(newvalue.asBoolean());
+	return true;
+}
+// </polarity>
+
 void settings_setup_listeners()
 {
 	gSavedSettings.getControl("FirstPersonAvatarVisible")->getSignal()->connect(boost::bind(&handleRenderAvatarMouselookChanged, _2));
@@ -841,6 +919,7 @@ void settings_setup_listeners()
 	gSavedSettings.getControl("RenderVolumeLODFactor")->getSignal()->connect(boost::bind(&handleVolumeLODChanged, _2));
 	gSavedSettings.getControl("RenderAvatarLODFactor")->getSignal()->connect(boost::bind(&handleAvatarLODChanged, _2));
 	gSavedSettings.getControl("RenderAvatarPhysicsLODFactor")->getSignal()->connect(boost::bind(&handleAvatarPhysicsLODChanged, _2));
+	gSavedSettings.getControl("AvatarPhysics")->getSignal()->connect(boost::bind(&handleAvatarPhysicsChanged, _2)); // <polarity/>
 	gSavedSettings.getControl("RenderTerrainLODFactor")->getSignal()->connect(boost::bind(&handleTerrainLODChanged, _2));
 	gSavedSettings.getControl("RenderTreeLODFactor")->getSignal()->connect(boost::bind(&handleTreeLODChanged, _2));
 	gSavedSettings.getControl("RenderFlexTimeFactor")->getSignal()->connect(boost::bind(&handleFlexLODChanged, _2));
@@ -1007,6 +1086,36 @@ void settings_setup_listeners()
 	shadow_ctrl->getValidateSignal()->connect(boost::bind(&validateShadowMapsChanged, _2));
 	shadow_ctrl->getSignal()->connect(boost::bind(&handleShadowMapsChanged, _2));
 	// </polarity>
+	// <polarity> Bounded animation data cache
+	gSavedSettings.getControl("PVAnimation_KeyframeCacheSize")->getSignal()->connect(boost::bind(&handleKeyframeCacheSizeChanged, _2));
+	// </polarity>
+	// <polarity> Glyph run cache
+	gSavedSettings.getControl("PVUI_FontGlyphRunCache")->getSignal()->connect(boost::bind(&handleFontGlyphRunCacheChanged, _2));
+	// </polarity>
+	// <polarity> Hashed control lookups
+	gSavedSettings.getControl("PVDebug_ReportSettingLookups")->getSignal()->connect(boost::bind(&handleReportSettingLookupsChanged, _2));
+	LLControlGroup::setLookupTracking(gSavedSettings.getBOOL("PVDebug_ReportSettingLookups"));
+	// </polarity>
+	// <polarity> Timer event capture
+	gSavedSettings.getControl("PVDebug_CaptureTimerEvents")->getSignal()->connect(boost::bind(&handleCaptureTimerEventsChanged, _2));
+	LLTrace::BlockTimerEventCapture::setCapturing(gSavedSettings.getBOOL("PVDebug_CaptureTimerEvents"));
+	// </polarity>
+	// <polarity> Asynchronous logging
+	gSavedSettings.getControl("PVDebug_AsyncLogging")->getSignal()->connect(boost::bind(&handleAsyncLoggingChanged, _2));
+	LLError::setAsyncLogging(gSavedSettings.getBOOL("PVDebug_AsyncLogging"));
+	// </polarity>
+	// <polarity> Flat event dispatch
+	gSavedSettings.getControl("PVDebug_FastEventDispatch")->getSignal()->connect(boost::bind(&handleFastEventDispatchChanged, _2));
+	LLEventPump::setFastDispatch(gSavedSettings.getBOOL("PVDebug_FastEventDispatch"));
+	// </polarity>
+	// <polarity> Binary LLSD over HTTP
+	gSavedSettings.getControl("PVNetwork_AcceptBinaryLLSD")->getSignal()->connect(boost::bind(&handleAcceptBinaryLLSDChanged, _2));
+	LLCoreHttpUtil::setAcceptBinaryLLSD(gSavedSettings.getBOOL("PVNetwork_AcceptBinaryLLSD"));
+	// </polarity>
+	// <polarity> Fast LLSD XML reader
+	gSavedSettings.getControl("PVDebug_FastLLSDXML")->getSignal()->connect(boost::bind(&handleFastLLSDXMLChanged, _2));
+	LLSDXMLParser::setFastParse(gSavedSettings.getBOOL("PVDebug_FastLLSDXML"));
+	// </polarity>
 }
 
 #if TEST_CACHED_CONTROL
@@ -380,8 +380,12 @@ void display(BOOL rebuild, F32 zoom_factor, int subfield, BOOL for_snapshot)
 
 	LLImageGL::updateStats(gFrameTimeSeconds);
 	
-	LLVOAvatar::sRenderName = gSavedSettings.getS32("AvatarNameTagMode");
-	LLVOAvatar::sRenderGroupTitles = (gSavedSettings.getBOOL("NameTagShowGroupTitles") && LLVOAvatar::sRenderName);
+	// <polarity> Hashed control lookups
+	//LLVOAvatar::sRenderName = gSavedSettings.getS32("AvatarNameTagMode");
+	//LLVOAvatar::sRenderGroupTitles = (gSavedSettings.getBOOL("NameTagShowGroupTitles") && LLVOAvatar::sRenderName);
+	LLVOAvatar::sRenderName = gSavedSettings.getS32(LL_CONTROL_KEY("AvatarNameTagMode"));
+	LLVOAvatar::sRenderGroupTitles = (gSavedSettings.getBOOL(LL_CONTROL_KEY("NameTagShowGroupTitles")) && LLVOAvatar::sRenderName);
+	// </polarity>
 	
 	gPipeline.mBackfaceCull = TRUE;
 	gFrameCount++;
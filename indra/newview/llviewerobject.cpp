@@ -218,7 +218,8 @@ LLViewerObject *LLViewerObject::createObject(const LLUUID &id, const LLPCode pco
 }
 
 LLViewerObject::LLViewerObject(const LLUUID &id, const LLPCode pcode, LLViewerRegion *regionp, BOOL is_global)
-:	LLTrace::MemTrackable<LLViewerObject>("LLViewerObject"),
+//:	LLTrace::MemTrackable<LLViewerObject>("LLViewerObject"),
+:	LLTrace::PoolAllocated<LLViewerObject>("LLViewerObject"), // <polarity/>
 	LLPrimitive(),
 	mChildList(),
 	mID(id),
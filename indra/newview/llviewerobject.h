@@ -105,7 +105,8 @@ class LLViewerObject
 :	public LLPrimitive, 
 	public LLRefCount, 
 	public LLGLUpdate,
-	public LLTrace::MemTrackable<LLViewerObject>
+//	public LLTrace::MemTrackable<LLViewerObject>
+	public LLTrace::PoolAllocated<LLViewerObject> // <polarity/>
 {
 protected:
 	~LLViewerObject(); // use unref()
@@ -89,6 +89,7 @@
 #include "llfloaterreg.h"
 #include "fsareasearch.h" // <FS:Cron> Added to provide the ability to update the impact costs in area search. </FS:Cron>
 #include "fsassetblacklist.h"
+#include "pvavatarupdatepool.h" // <polarity/>
 
 #include "llglsandbox.h"
 
@@ -966,6 +967,12 @@ void LLViewerObjectList::update(LLAgent &agent)
 	}
 	else
 	{
+		// <polarity> Parallel avatar update
+		// other avatars defer their motion and joint updates to the pool,
+		// which runs them all at once and finishes them before flexis look at the skeletons
+		PVAvatarUpdatePool& avatar_update_pool = PVAvatarUpdatePool::instance();
+		avatar_update_pool.beginCollecting();
+		// </polarity>
 		for (std::vector<LLViewerObject*>::iterator idle_iter = idle_list.begin();
 			idle_iter != idle_end; idle_iter++)
 		{
@@ -973,6 +980,7 @@ void LLViewerObjectList::update(LLAgent &agent)
 			llassert(objectp->isActive());
 			objectp->idleUpdate(agent, frame_time);
 		}
+		avatar_update_pool.update(); // <polarity/>
 
 		//update flexible objects
 		LLVolumeImplFlexible::updateClass();
@@ -460,7 +460,8 @@ LLViewerOctreeGroup::~LLViewerOctreeGroup()
 }
 
 LLViewerOctreeGroup::LLViewerOctreeGroup(OctreeNode* node)
-:	LLTrace::MemTrackable<LLViewerOctreeGroup, 16>("LLViewerOctreeGroup"),
+//:	LLTrace::MemTrackable<LLViewerOctreeGroup, 16>("LLViewerOctreeGroup"),
+:	LLTrace::PoolAllocated<LLViewerOctreeGroup, 16>("LLViewerOctreeGroup"), // <polarity/>
 	mOctreeNode(node),
 	mAnyVisible(0),
 	mState(CLEAN)
@@ -1383,7 +1384,101 @@ void LLViewerOctreeCull::traverse(const OctreeNode* n)
 		mRes = 0;
 	}
 }
-	
+
+// <polarity> Parallel culling
+void LLViewerOctreeCull::record(const OctreeNode* n, S32& res, record_list_t& records, bool descend)
+{
+	LLViewerOctreeGroup* group = (LLViewerOctreeGroup*) n->getListener(0);
+
+	const U32 index = (U32)records.size();
+	CullRecord entry = { group, 1, res, 0 };
+
+	if (predictEarlyFail(group))
+	{
+		entry.mFlags = CullRecord::PREDICTED_FAIL;
+		records.push_back(entry);
+		return;
+	}
+
+	// mirrors traverse(), including leaving res alone for nodes that skip the check
+	const bool skip_check = res == 2 || (res && group->hasState(LLViewerOctreeGroup::SKIP_FRUSTUM_CHECK));
+	if (!skip_check)
+	{
+		res = frustumCheck(group);
+	}
+
+	if (res)
+	{
+		// same tests as checkObjects() but against res rather than mRes
+		entry.mFlags = CullRecord::TRAVERSED;
+		if (n->getElementCount() > 0 &&
+			(n->getChildCount() == 0 || res != 1 || frustumCheckObjects(group)))
+		{
+			entry.mFlags |= CullRecord::PROCESS;
+		}
+		records.push_back(entry);
+
+		if (!descend)
+		{
+			// the caller walks the children itself, starting from res
+			return;
+		}
+
+		for (U32 i = 0; i < n->getChildCount(); i++)
+		{
+			record(n->getChild(i), res, records);
+		}
+		records[index].mSubtreeSize = (U32)records.size() - index;
+	}
+	else
+	{
+		records.push_back(entry);
+	}
+
+	if (!skip_check)
+	{
+		res = 0;
+	}
+}
+
+//virtual
+void LLViewerOctreeCull::replay(const record_list_t& records)
+{
+	const U32 count = (U32)records.size();
+	for (U32 i = 0; i < count; )
+	{
+		const CullRecord& entry = records[i];
+		const bool predicted_fail = (entry.mFlags & CullRecord::PREDICTED_FAIL) != 0;
+
+		if (earlyFail(entry.mGroup))
+		{
+			// occluded now, whatever was recorded below it is moot
+			i += predicted_fail ? 1 : entry.mSubtreeSize;
+			continue;
+		}
+
+		if (predicted_fail)
+		{
+			// the occlusion query came back visible this frame, catch up serially
+			mRes = entry.mRes;
+			traverse(entry.mGroup->getOctreeNode());
+			++i;
+			continue;
+		}
+
+		if (entry.mFlags & CullRecord::TRAVERSED)
+		{
+			preprocess(entry.mGroup);
+			if (entry.mFlags & CullRecord::PROCESS)
+			{
+				processGroup(entry.mGroup);
+			}
+		}
+		++i;
+	}
+}
+// </polarity>
+
 //------------------------------------------
 //agent space group culling
 S32 LLViewerOctreeCull::AABBInFrustumNoFarClipGroupBounds(const LLViewerOctreeGroup* group)
@@ -41,6 +41,7 @@ class LLViewerOctreeEntryData;
 class LLViewerOctreeGroup;
 class LLViewerOctreeEntry;
 class LLViewerOctreePartition;
+class LLViewerOctreeCull; // <polarity/>
 
 typedef LLOctreeListener<LLViewerOctreeEntry>	OctreeListener;
 typedef LLTreeNode<LLViewerOctreeEntry>			TreeNode;
@@ -175,7 +176,8 @@ protected:
 //defines an octree group for an octree node, which contains multiple entries.
 //LL_ALIGN_PREFIX(16)
 class LLViewerOctreeGroup
-:	public LLOctreeListener<LLViewerOctreeEntry>, public LLTrace::MemTrackable<LLViewerOctreeGroup, 16>
+//:	public LLOctreeListener<LLViewerOctreeEntry>, public LLTrace::MemTrackable<LLViewerOctreeGroup, 16>
+:	public LLOctreeListener<LLViewerOctreeEntry>, public LLTrace::PoolAllocated<LLViewerOctreeGroup, 16> // <polarity/>
 {
 	friend class LLViewerOctreeCull;
 protected:
@@ -198,7 +200,8 @@ public:
 
 	LLViewerOctreeGroup(OctreeNode* node);
 	LLViewerOctreeGroup(const LLViewerOctreeGroup& rhs)
-	: LLTrace::MemTrackable<LLViewerOctreeGroup, 16>("LLViewerOctreeGroup")
+//	: LLTrace::MemTrackable<LLViewerOctreeGroup, 16>("LLViewerOctreeGroup")
+	: LLTrace::PoolAllocated<LLViewerOctreeGroup, 16>("LLViewerOctreeGroup") // <polarity/>
 	{
 		*this = rhs;
 	}
@@ -346,6 +349,13 @@ public:
 
 	// Cull on arbitrary frustum
 	virtual S32 cull(LLCamera &camera, bool do_occlusion) = 0;
+	// <polarity> Parallel culling
+	// Main-thread part of cull() up to the octree walk. Returns the culler
+	// for the walk, or NULL if this frame has nothing to walk. The caller
+	// deletes it after the walk and then calls finishCull().
+	virtual LLViewerOctreeCull* beginCull(LLCamera &camera, bool do_occlusion) { return NULL; }
+	virtual void finishCull() { }
+	// </polarity>
 	BOOL isOcclusionEnabled();
 
 public:	
@@ -366,8 +376,44 @@ public:
 	
 	virtual void traverse(const OctreeNode* n);
 
+	// <polarity> Parallel culling
+	// One entry per node a traversal reaches, in traversal order.
+	struct CullRecord
+	{
+		enum
+		{
+			PREDICTED_FAIL	= 0x1,	// occlusion state already said earlyFail()
+			TRAVERSED		= 0x2,	// frustum check passed, node was visited
+			PROCESS			= 0x4	// checkObjects() passed, processGroup() is due
+		};
+
+		LLViewerOctreeGroup*	mGroup;
+		U32						mSubtreeSize;	// this entry plus the entries of its children
+		S32						mRes;			// culler result on entry, to walk the node again
+		U32						mFlags;
+	};
+	typedef std::vector<CullRecord> record_list_t;
+
+	// Thread safe half of traverse(): only runs the frustum math and appends
+	// what it decided to records. Nothing is marked, queried or processed.
+	// res is the culler result on entry and is updated the way mRes would be.
+	// Without descend only n's own entry is appended, res is left at the
+	// result its children start from (0 if they are culled) and the caller
+	// fixes up mSubtreeSize once it has recorded them.
+	void record(const OctreeNode* n, S32& res, record_list_t& records, bool descend = true);
+	// Main thread half: applies earlyFail(), preprocess() and processGroup()
+	// for the records, in order. A node whose occlusion result changed since
+	// it was recorded as occluded is walked again with traverse().
+	virtual void replay(const record_list_t& records);
+	// </polarity>
+
 protected:
-	virtual bool earlyFail(LLViewerOctreeGroup* group);	
+	virtual bool earlyFail(LLViewerOctreeGroup* group);
+	// <polarity> Parallel culling
+	// earlyFail() without the side effects, from state only. Must not issue
+	// or read GL queries, it runs on worker threads.
+	virtual bool predictEarlyFail(LLViewerOctreeGroup* group) { return false; }
+	// </polarity>
 	
 	//agent space group cull
 	S32 AABBInFrustumNoFarClipGroupBounds(const LLViewerOctreeGroup* group);	
@@ -1840,6 +1840,7 @@ LLViewerWindow::LLViewerWindow(const Params& p)
 								mDisplayScale.mV[VX],
 								mDisplayScale.mV[VY],
 								gDirUtilp->getAppRODataDir());
+	LLFontGL::sUseGlyphRunCache = gSavedSettings.getBOOL("PVUI_FontGlyphRunCache"); // <polarity/>
 	
 	// Create container for all sub-views
 	LLView::Params rvp;
@@ -111,6 +111,7 @@
 #include "llcallstack.h"
 #include "llrendersphere.h"
 
+#include "pvavatarupdatepool.h"
 #include "pvcommon.h"
 //#include "llsidepanelappearance.h"
 #ifdef PVDATA_SYSTEM
@@ -605,6 +606,7 @@ BOOL LLVOAvatar::sShowFootPlane = FALSE;
 BOOL LLVOAvatar::sVisibleInFirstPerson = FALSE;
 F32 LLVOAvatar::sLODFactor = 1.f;
 F32 LLVOAvatar::sPhysicsLODFactor = 1.f;
+BOOL LLVOAvatar::sAvatarPhysics = TRUE; // <polarity/>
 bool LLVOAvatar::sUseImpostors = false; // overwridden by RenderAvatarMaxNonImpostors
 BOOL LLVOAvatar::sJointDebug = FALSE;
 F32 LLVOAvatar::sUnbakedTime = 0.f;
@@ -727,6 +729,10 @@ LLVOAvatar::LLVOAvatar(const LLUUID& id,
 
 	mTimeLast = 0.0f;
 	mSpeedAccum = 0.0f;
+	// <polarity> Parallel avatar update
+	mWasSitGroundConstrained = false;
+	mUseGroundSample = false;
+	// </polarity>
 
 	mRippleTimeLast = 0.f;
 
@@ -2381,8 +2387,37 @@ void LLVOAvatar::idleUpdate(LLAgent &agent, const F64 &time)
 	// animate the character
 	// store off last frame's root position to be consistent with camera position
 	mLastRootPos = mRoot->getWorldPosition();
+
+	// <polarity> Parallel avatar update
+	PVAvatarUpdatePool& update_pool = PVAvatarUpdatePool::instance();
+	if (update_pool.isCollecting() && !isSelf() && !mIsDummy)
+	{
+		if (prepareCharacterUpdate(agent))
+		{
+			// motions and joints are evaluated together with the other avatars,
+			// the pool finishes the character and idle updates once they are all done
+			beginParallelUpdate();
+			update_pool.add(this);
+		}
+		else
+		{
+			finishIdleUpdate(FALSE);
+		}
+		return;
+	}
+	// </polarity>
+
 	BOOL detailed_update = updateCharacter(agent);
+	finishIdleUpdate(detailed_update); // <polarity/>
+}
 
+// <polarity> Parallel avatar update
+//------------------------------------------------------------------------
+// finishIdleUpdate()
+// the part of idleUpdate() that runs after the character update
+//------------------------------------------------------------------------
+void LLVOAvatar::finishIdleUpdate(BOOL detailed_update)
+{
 	static LLUICachedControl<bool> visualizers_in_calls("ShowVoiceVisualizersInCalls", false);
 	bool voice_enabled = (visualizers_in_calls || LLVoiceClient::getInstance()->inProximalChannel()) &&
 						 LLVoiceClient::getInstance()->getVoiceEnabled(mID);
@@ -2402,6 +2437,47 @@ void LLVOAvatar::idleUpdate(LLAgent &agent, const F64 &time)
 	idleUpdateRenderComplexity();
 }
 
+//------------------------------------------------------------------------
+// beginParallelUpdate()
+// main thread, after prepareCharacterUpdate() returned TRUE
+//------------------------------------------------------------------------
+void LLVOAvatar::beginParallelUpdate()
+{
+	mMotionController.prepareThreadedUpdate();
+
+	// LLWorld and the land are main thread only, getGround() answers from
+	// this plane until endParallelUpdate()
+	LLVector3 left_pos, left_norm, right_pos, right_norm;
+	getGround(mAnkleLeftp->getWorldPosition(), left_pos, left_norm);
+	getGround(mAnkleRightp->getWorldPosition(), right_pos, right_norm);
+	mGroundSamplePos = (left_pos + right_pos) * 0.5f;
+	mGroundSampleNorm = left_norm + right_norm;
+	mGroundSampleNorm.normalize();
+	mUseGroundSample = true;
+}
+
+//------------------------------------------------------------------------
+// updateParallel()
+// may run on a PVAvatarUpdatePool worker; only touches this avatar's
+// motions and skeleton
+//------------------------------------------------------------------------
+void LLVOAvatar::updateParallel()
+{
+	updateCharacterMotions();
+	updateJointWorldMatrices();
+}
+
+//------------------------------------------------------------------------
+// endParallelUpdate()
+// main thread, once every avatar in the batch has been through updateParallel()
+//------------------------------------------------------------------------
+void LLVOAvatar::endParallelUpdate()
+{
+	mUseGroundSample = false;
+	mMotionController.finishThreadedUpdate();
+}
+// </polarity>
+
 void LLVOAvatar::idleUpdateVoiceVisualizer(bool voice_enabled)
 {
 	bool render_visualizer = voice_enabled;
@@ -3525,7 +3601,7 @@ void LLVOAvatar::slamPosition()
 	{
 		gPipeline.updateMoveNormalAsync(mDrawable);
 	}
-	mRoot->updateWorldMatrixChildren();
+	updateJointWorldMatrices();
 }
 
 bool LLVOAvatar::isVisuallyMuted()
@@ -3685,6 +3761,13 @@ void LLVOAvatar::updateDebugText()
 
 	if (LLVOAvatar::sShowAnimationDebug)
 	{
+		// <polarity> Animation level of detail
+		addDebugText(llformat("anim lod %d step %.3f cost %.3f ms (avg %.3f)",
+							  (S32)mMotionController.getAnimationLOD(),
+							  mMotionController.getTimeStep(),
+							  mMotionController.getLastUpdateCost(),
+							  mMotionController.getAverageUpdateCost()));
+		// </polarity>
 		for (LLMotionController::motion_list_t::iterator iter = mMotionController.getActiveMotions().begin();
 			 iter != mMotionController.getActiveMotions().end(); ++iter)
 		{
@@ -3723,11 +3806,74 @@ void LLVOAvatar::updateDebugText()
 
 }
 
+// <polarity> Animation level of detail
+//------------------------------------------------------------------------
+// updateAnimationLOD()
+// picks the animation LOD and time step from the avatar's on-screen size.
+// skipped frames are filled in by the motion controller interpolating
+// between the cached poses of the surrounding time quanta.
+//------------------------------------------------------------------------
+void LLVOAvatar::updateAnimationLOD()
+{
+	static LLCachedControl<F32> reduced_area(gSavedSettings, "PVAnimation_LODReducedPixelArea", 5000.f);
+	static LLCachedControl<F32> low_area(gSavedSettings, "PVAnimation_LODLowPixelArea", 500.f);
+	static LLCachedControl<F32> max_time_step(gSavedSettings, "PVAnimation_LODMaxTimeStep", 0.2f);
+
+	LLMotionController::EAnimationLOD lod = LLMotionController::ANIM_LOD_FULL;
+	F32 time_step = 0.f;
+	if (mPixelArea < low_area)
+	{
+		lod = LLMotionController::ANIM_LOD_LOW;
+		time_step = max_time_step;
+	}
+	else if (mPixelArea < reduced_area)
+	{
+		// scale with linear screen size rather than area
+		lod = LLMotionController::ANIM_LOD_REDUCED;
+		time_step = max_time_step * clamp_rescale(sqrtf(mPixelArea), sqrtf(low_area), sqrtf(reduced_area), 1.f, 0.f);
+	}
+
+	// snap to whole 30Hz frames so the quantum does not shift every time the pixel area does
+	time_step = ll_round(time_step, 1.f / 30.f);
+
+	if (time_step != 0.f)
+	{
+		// disable walk motion servo controller as it doesn't work with motion timesteps
+		stopMotion(ANIM_AGENT_WALK_ADJUST);
+		removeAnimationData("Walk Speed");
+	}
+	if (time_step != mMotionController.getTimeStep())
+	{
+		mMotionController.setTimeStep(time_step);
+	}
+	mMotionController.setAnimationLOD(lod);
+}
+// </polarity>
+
 //------------------------------------------------------------------------
 // updateCharacter()
 // called on both your avatar and other avatars
 //------------------------------------------------------------------------
 BOOL LLVOAvatar::updateCharacter(LLAgent &agent)
+{
+	// <polarity> Parallel avatar update
+	if (!prepareCharacterUpdate(agent))
+	{
+		return FALSE;
+	}
+	updateCharacterMotions();
+	finishCharacterUpdate();
+	return TRUE;
+	// </polarity>
+}
+
+// <polarity> Parallel avatar update
+//------------------------------------------------------------------------
+// prepareCharacterUpdate()
+// everything updateCharacter() does before evaluating motions.
+// returns FALSE when the avatar gets no full update this frame.
+//------------------------------------------------------------------------
+BOOL LLVOAvatar::prepareCharacterUpdate(LLAgent &agent)
 {	
 	updateDebugText();
 	
@@ -3809,8 +3955,18 @@ BOOL LLVOAvatar::updateCharacter(LLAgent &agent)
 	//		 creates animation issues - FIRE-3657
 	// if (!isSelf() && !mIsDummy)
 	static LLCachedControl<bool> use_timesteps(gSavedSettings,"PVMovement_UseAnimationTimeSteps");
+	// <polarity> Animation level of detail
+	// the level of detail picks its own time step, it replaces both branches below
+	static LLCachedControl<bool> use_anim_lod(gSavedSettings, "PVAnimation_LODEnabled", true);
+	const bool anim_lod = !isSelf() && !mIsDummy && use_anim_lod;
+	if (anim_lod)
+	{
+		updateAnimationLOD();
+	}
+	// </polarity>
 	// change animation time quanta based on avatar render load
-	if (!isSelf() && !mIsDummy && use_timesteps)
+	//if (!isSelf() && !mIsDummy && use_timesteps)
+	if (!anim_lod && !isSelf() && !mIsDummy && use_timesteps) // <polarity/>
 	// </FS:Zi>
 	{
 		F32 time_quantum = clamp_rescale((F32)sInstances.size(), 10.f, 35.f, 0.f, 0.25f);
@@ -3823,13 +3979,16 @@ BOOL LLVOAvatar::updateCharacter(LLAgent &agent)
 			removeAnimationData("Walk Speed");
 		}
 		mMotionController.setTimeStep(time_step);
+		mMotionController.setAnimationLOD(LLMotionController::ANIM_LOD_FULL); // <polarity/>
 		//		LL_INFOS() << "Setting timestep to " << time_quantum * pixel_area_scale << LL_ENDL;
 	}
 	// <FS:Zi> Optionally disable the usage of timesteps, testing if this affects performance or
 	//		 creates animation issues - FIRE-3657
-	else
+	//else
+	else if (!anim_lod) // <polarity/>
 	{
 		mMotionController.setTimeStep(0.0f);
+		mMotionController.setAnimationLOD(LLMotionController::ANIM_LOD_FULL); // <polarity/>
 	}
 	// </FS:Zi>
 
@@ -4118,7 +4277,16 @@ BOOL LLVOAvatar::updateCharacter(LLAgent &agent)
 	//-------------------------------------------------------------------------
 	// store data relevant to motions
 	mSpeed = speed;
+	mWasSitGroundConstrained = was_sit_ground_constrained; // <polarity/>
+
+	return TRUE;
+}
 
+//------------------------------------------------------------------------
+// updateCharacterMotions()
+//------------------------------------------------------------------------
+void LLVOAvatar::updateCharacterMotions()
+{
 	// update animations
 	if (mSpecialRenderMode == 1) // Animation Preview
 	{
@@ -4128,9 +4296,18 @@ BOOL LLVOAvatar::updateCharacter(LLAgent &agent)
 	{
 		updateMotions(LLCharacter::NORMAL_UPDATE);
 	}
+}
+
+//------------------------------------------------------------------------
+// finishCharacterUpdate()
+// everything updateCharacter() does after evaluating motions
+//------------------------------------------------------------------------
+void LLVOAvatar::finishCharacterUpdate()
+{
+	LLVector3 normal;
 
 	// Special handling for sitting on ground.
-	if (!getParent() && (mIsSitting || was_sit_ground_constrained))
+	if (!getParent() && (mIsSitting || mWasSitGroundConstrained))
 	{
 		
 		F32 off_z = LLVector3d(getHoverOffset()).mdV[VZ];
@@ -4225,12 +4402,12 @@ BOOL LLVOAvatar::updateCharacter(LLAgent &agent)
 		}
 	}
 
-	mRoot->updateWorldMatrixChildren();
+	updateJointWorldMatrices();
 
 	//mesh vertices need to be reskinned
 	mNeedsSkin = TRUE;
-	return TRUE;
 }
+// </polarity>
 //-----------------------------------------------------------------------------
 // updateHeadOffset()
 //-----------------------------------------------------------------------------
@@ -4328,10 +4505,31 @@ void LLVOAvatar::debugBodySize() const
 //------------------------------------------------------------------------
 void LLVOAvatar::postPelvisSetRecalc()
 {		
-	mRoot->updateWorldMatrixChildren();			
+	updateJointWorldMatrices();			
 	computeBodySize();
 	dirtyMesh(2);
 }
+
+// <polarity> Flat joint hierarchy update
+//------------------------------------------------------------------------
+// updateJointWorldMatrices
+//------------------------------------------------------------------------
+void LLVOAvatar::updateJointWorldMatrices()
+{
+	static LLCachedControl<bool> flat_joint_update(gSavedSettings, "PVAvatar_FlatJointUpdate", true);
+	if (!flat_joint_update)
+	{
+		mRoot->updateWorldMatrixChildren();
+		return;
+	}
+
+	if (mJointHierarchy.getRoot() != mRoot)
+	{
+		mJointHierarchy.build(mRoot);
+	}
+	mJointHierarchy.updateWorldMatrices();
+}
+// </polarity>
 //------------------------------------------------------------------------
 // updateVisibility()
 //------------------------------------------------------------------------
@@ -6162,6 +6360,23 @@ void LLVOAvatar::getGround(const LLVector3 &in_pos_agent, LLVector3 &out_pos_age
 		out_pos_agent = in_pos_agent;
 		return;
 	}
+
+	// <polarity> Parallel avatar update
+	if (mUseGroundSample)
+	{
+		// straight above or below in_pos_agent on the plane beginParallelUpdate() sampled
+		outNorm = mGroundSampleNorm;
+		out_pos_agent = in_pos_agent;
+		out_pos_agent.mV[VZ] = mGroundSamplePos.mV[VZ];
+		if (mGroundSampleNorm.mV[VZ] > F_APPROXIMATELY_ZERO)
+		{
+			out_pos_agent.mV[VZ] -= (mGroundSampleNorm.mV[VX] * (in_pos_agent.mV[VX] - mGroundSamplePos.mV[VX])
+									 + mGroundSampleNorm.mV[VY] * (in_pos_agent.mV[VY] - mGroundSamplePos.mV[VY]))
+									/ mGroundSampleNorm.mV[VZ];
+		}
+		return;
+	}
+	// </polarity>
 	
 	p0_global = gAgent.getPosGlobalFromAgent(in_pos_agent) + z_vec;
 	p1_global = gAgent.getPosGlobalFromAgent(in_pos_agent) - z_vec;
@@ -6339,7 +6554,7 @@ void LLVOAvatar::updateVisualParams()
 	{
 		computeBodySize();
 		mLastSkeletonSerialNum = mSkeletonSerialNum;
-		mRoot->updateWorldMatrixChildren();
+		updateJointWorldMatrices();
 	}
 
 	dirtyMesh();
@@ -6928,7 +7143,7 @@ void LLVOAvatar::sitOnObject(LLViewerObject *sit_object)
 	mRoot->getXform()->setParent(&sit_object->mDrawable->mXform); // LLVOAvatar::sitOnObject
 	// SL-315
 	mRoot->setPosition(getPosition());
-	mRoot->updateWorldMatrixChildren();
+	updateJointWorldMatrices();
 
 	stopMotion(ANIM_AGENT_BODY_NOISE);
 
@@ -36,6 +36,7 @@
 #include "llviewerobject.h"
 #include "llcharacter.h"
 #include "llcontrol.h"
+#include "lljointhierarchy.h"
 #include "llviewerjointmesh.h"
 #include "llviewerjointattachment.h"
 #include "llrendertarget.h"
@@ -236,6 +237,19 @@ private: //aligned members
 public:
 	void			updateDebugText();
 	virtual BOOL 	updateCharacter(LLAgent &agent);
+	void			updateAnimationLOD(); // <polarity/>
+	// <polarity> Parallel avatar update
+	// updateCharacter() and idleUpdate() split around motion evaluation, so
+	// PVAvatarUpdatePool can evaluate the motions and joints of all other
+	// avatars at once and finish the rest on the main thread.
+	BOOL			prepareCharacterUpdate(LLAgent &agent);
+	void			updateCharacterMotions();
+	void			finishCharacterUpdate();
+	void			finishIdleUpdate(BOOL detailed_update);
+	void			beginParallelUpdate();
+	void			updateParallel();
+	void			endParallelUpdate();
+	// </polarity>
 	void 			idleUpdateVoiceVisualizer(bool voice_enabled);
 	void 			idleUpdateMisc(bool detailed_update);
 	virtual void	idleUpdateAppearanceAnimation();
@@ -302,6 +316,7 @@ public:
 	static BOOL		sShowAttachmentPoints;
 	static F32		sLODFactor; // user-settable LOD factor
 	static F32		sPhysicsLODFactor; // user-settable physics LOD factor
+	static BOOL		sAvatarPhysics; // <polarity/> AvatarPhysics, read by motions on avatar update workers
 	static BOOL		sJointDebug; // output total number of joints being touched for each avatar
 	//static BOOL		sDebugAvatarRotation; // unused - Xenhat 2017.03.01
 	static BOOL		sShowTyping; // Show typing animation
@@ -377,6 +392,8 @@ public:
 	void				updateHeadOffset();
     void				debugBodySize() const;
 	void				postPelvisSetRecalc( void );
+	// <polarity> Recompute joint world matrices, flat or recursive depending on PVAvatar_FlatJointUpdate
+	void				updateJointWorldMatrices();
 
 	/*virtual*/ BOOL	loadSkeletonNode();
     void                initAttachmentPoints(bool ignore_hud_joints = false);
@@ -389,6 +406,9 @@ public:
 
 	S32					mLastSkeletonSerialNum;
 
+private:
+	LLJointHierarchy	mJointHierarchy; // <polarity> breadth-first copy of mRoot's tree
+
 
 /**                    Skeleton
  **                                                                            **
@@ -846,6 +866,14 @@ private:
 	F32 		mSpeedAccum; // measures speed (for diagnostics mostly).
 	BOOL 		mTurning; // controls hysteresis on avatar rotation
 	F32			mSpeed; // misc. animation repeated state
+	bool		mWasSitGroundConstrained; // <polarity> carried across the split character update
+	// <polarity> Parallel avatar update
+	// ground under the feet, sampled on the main thread for motions that
+	// look for the ground from an avatar update worker
+	bool		mUseGroundSample;
+	LLVector3	mGroundSamplePos;
+	LLVector3	mGroundSampleNorm;
+	// </polarity>
 
 	//--------------------------------------------------------------------
 	// Dimensions
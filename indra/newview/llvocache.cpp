@@ -719,6 +719,20 @@ public:
 		return false;
 	}
 
+	// <polarity> Parallel culling
+	virtual bool predictEarlyFail(LLViewerOctreeGroup* base_group)
+	{
+		if( mUseObjectCacheOcclusion &&
+			base_group->getOctreeNode()->getParent()) //never occlusion cull the root node
+		{
+			LLOcclusionCullingGroup* group = (LLOcclusionCullingGroup*)base_group;
+			return !group->needsUpdate() && group->isOcclusionState(LLOcclusionCullingGroup::OCCLUDED);
+		}
+
+		return false;
+	}
+	// </polarity>
+
 	virtual S32 frustumCheck(const LLViewerOctreeGroup* group)
 	{
 #if 0
@@ -901,28 +915,44 @@ void LLVOCachePartition::selectBackObjects(LLCamera &camera, F32 pixel_threshold
 }
 
 S32 LLVOCachePartition::cull(LLCamera &camera, bool do_occlusion)
+{
+	// <polarity> Parallel culling
+	LLViewerOctreeCull* culler = beginCull(camera, do_occlusion);
+	if(!culler)
+	{
+		return 0;
+	}
+	culler->traverse(mOctree);
+	delete culler;
+	finishCull();
+	// </polarity>
+	return 1;
+}
+
+// <polarity> Parallel culling
+LLViewerOctreeCull* LLVOCachePartition::beginCull(LLCamera &camera, bool do_occlusion)
 {
 	static LLCachedControl<bool> use_object_cache_occlusion(gSavedSettings,"UseObjectCacheOcclusion");
 	
 	if(!LLViewerRegion::sVOCacheCullingEnabled)
 	{
-		return 0;
+		return NULL;
 	}
 	if(mRegionp->isPaused())
 	{
-		return 0;
+		return NULL;
 	}
 
 	((LLViewerOctreeGroup*)mOctree->getListener(0))->rebound();
 
 	if(LLViewerCamera::sCurCameraID != LLViewerCamera::CAMERA_WORLD)
 	{
-		return 0; //no need for those cameras.
+		return NULL; //no need for those cameras.
 	}
 
 	if(mCulledTime[LLViewerCamera::sCurCameraID] == LLViewerOctreeEntryData::getCurrentFrame())
 	{
-		return 0; //already culled
+		return NULL; //already culled
 	}
 	mCulledTime[LLViewerCamera::sCurCameraID] = LLViewerOctreeEntryData::getCurrentFrame();
 
@@ -943,7 +973,7 @@ S32 LLVOCachePartition::cull(LLCamera &camera, bool do_occlusion)
 			//process back objects selection
 			selectBackObjects(camera, LLVOCacheEntry::getSquaredPixelThreshold(mFrontCull), 
 				do_occlusion && use_object_cache_occlusion);
-			return 0; //nothing changed, reduce frequency of culling
+			return NULL; //nothing changed, reduce frequency of culling
 		}
 	}
 	else
@@ -956,16 +986,18 @@ S32 LLVOCachePartition::cull(LLCamera &camera, bool do_occlusion)
 	camera.calcRegionFrustumPlanes(region_agent, gAgentCamera.mDrawDistance);
 
 	mFrontCull = TRUE;
-	LLVOCacheOctreeCull culler(&camera, mRegionp, region_agent, do_occlusion && use_object_cache_occlusion, 
+	return new LLVOCacheOctreeCull(&camera, mRegionp, region_agent, do_occlusion && use_object_cache_occlusion, 
 		LLVOCacheEntry::getSquaredPixelThreshold(mFrontCull), this);
-	culler.traverse(mOctree);	
+}
 
+void LLVOCachePartition::finishCull()
+{
 	if(!sNeedsOcclusionCheck)
 	{
 		sNeedsOcclusionCheck = !mOccludedGroups.empty();
 	}
-	return 1;
 }
+// </polarity>
 
 void LLVOCachePartition::setCullHistory(BOOL has_new_object)
 {
@@ -193,6 +193,8 @@ public:
 	bool addEntry(LLViewerOctreeEntry* entry);
 	void removeEntry(LLViewerOctreeEntry* entry);
 	/*virtual*/ S32 cull(LLCamera &camera, bool do_occlusion);
+	/*virtual*/ LLViewerOctreeCull* beginCull(LLCamera &camera, bool do_occlusion); // <polarity/>
+	/*virtual*/ void finishCull(); // <polarity/>
 	void addOccluders(LLViewerOctreeGroup* gp);
 	void resetOccluders();
 	void processOccluders(LLCamera* camera);
@@ -40,6 +40,7 @@
 #include "llnotificationsutil.h"
 #include "llregioninfomodel.h"
 #include "llstartup.h"
+#include "lltraceeventcapture.h"
 #include "lltrans.h"
 #include "llviewercontrol.h"
 #include "llviewermessage.h"
@@ -52,6 +53,7 @@
 #ifdef PVDATA_SYSTEM
 #include "pvdata.h"
 #endif
+#include "pvavatarupdatepool.h"
 #include "pvcommon.h"
 #include "llappviewer.h"
 
@@ -79,6 +81,8 @@ OSChatCommand::OSChatCommand()
 	//gSavedSettings.getControl("PVChatCommand_PVDataDump")->getSignal()->connect(boost::bind(&OSChatCommand::refreshCommands, this));
 	gSavedSettings.getControl("PVChatCommand_PurgeChat")->getSignal()->connect(boost::bind(&OSChatCommand::refreshCommands, this));
 	gSavedSettings.getControl("PVChatCommand_Uptime")->getSignal()->connect(boost::bind(&OSChatCommand::refreshCommands, this));
+	gSavedSettings.getControl("PVChatCommand_AvatarBenchmark")->getSignal()->connect(boost::bind(&OSChatCommand::refreshCommands, this));
+	gSavedSettings.getControl("PVChatCommand_TimerTrace")->getSignal()->connect(boost::bind(&OSChatCommand::refreshCommands, this));
 }
 
 void OSChatCommand::refreshCommands()
@@ -102,6 +106,8 @@ void OSChatCommand::refreshCommands()
 	//mChatCommands.emplace(utf8str_tolower(gSavedSettings.getString("PVChatCommand_PVDataDump")), CMD_PVDATA_DUMP); 
 	mChatCommands.emplace(utf8str_tolower(gSavedSettings.getString("PVChatCommand_PurgeChat")), CMD_PURGE_CHAT);
 	mChatCommands.emplace(utf8str_tolower(gSavedSettings.getString("PVChatCommand_Uptime")), CMD_GET_UPTIME);
+	mChatCommands.emplace(utf8str_tolower(gSavedSettings.getString("PVChatCommand_AvatarBenchmark")), CMD_AVATAR_BENCHMARK);
+	mChatCommands.emplace(utf8str_tolower(gSavedSettings.getString("PVChatCommand_TimerTrace")), CMD_TIMER_TRACE);
 }
 
 bool OSChatCommand::matchPrefix(const std::string& in_str, std::string* out_str)
@@ -449,6 +455,45 @@ bool OSChatCommand::parseCommand(std::string data)
 			PVCommon::getInstance()->reportToNearbyChat(LLAppViewer::secondsToTimeString(gUptimeTimer.getElapsedTimeF32()), "Session Uptime");
 			return true;
 		}
+	case CMD_AVATAR_BENCHMARK:
+		{
+			U32 num_avatars = 50;
+			U32 num_frames = 100;
+			U32 value;
+			if (input >> value)
+			{
+				num_avatars = value;
+				if (input >> value)
+				{
+					num_frames = value;
+				}
+			}
+			num_avatars = llclamp<U32>(num_avatars, 1, 500);
+			num_frames = llclamp<U32>(num_frames, 1, 1000);
+			PVCommon::getInstance()->reportToNearbyChat(PVAvatarUpdatePool::instance().runBenchmark(num_avatars, num_frames), "Avatar Benchmark");
+			return true;
+		}
+	case CMD_TIMER_TRACE:
+		{
+			if (!LLTrace::BlockTimerEventCapture::isCapturing())
+			{
+				PVCommon::getInstance()->reportToNearbyChat("Enable PVDebug_CaptureTimerEvents first, then run this after the stall.", "Timer Trace");
+				return true;
+			}
+			F32 seconds = 10.f;
+			F32 value;
+			if (input >> value)
+			{
+				seconds = llclamp(value, 0.1f, 600.f);
+			}
+			const std::string filename = gDirUtilp->getExpandedFilename(LL_PATH_LOGS,
+				"timer_trace_" + LLDate::now().toHTTPDateString("%Y%m%d_%H%M%S") + ".json");
+			const S32 written = LLTrace::BlockTimerEventCapture::writeChromeTrace(filename, seconds);
+			PVCommon::getInstance()->reportToNearbyChat(written < 0 ? "Could not write " + filename
+														: llformat("%d timer calls from the last %.1f s written to ", written, seconds) + filename,
+														"Timer Trace");
+			return true;
+		}
 	}
 	return false;
 }
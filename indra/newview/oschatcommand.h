@@ -48,6 +48,8 @@ class OSChatCommand : public LLSingleton<OSChatCommand>
 		CMD_PVDATA_REFRESH,
 		//CMD_PVDATA_DUMP,
 		CMD_GET_UPTIME,
+		CMD_AVATAR_BENCHMARK,
+		CMD_TIMER_TRACE,
 		CMD_UNKNOWN
 	} e_chat_commands;
 
@@ -85,6 +85,8 @@
 #include "llviewerwindow.h" // For getSpinAxis
 #include "llvoavatarself.h"
 #include "llvocache.h"
+#include "pvparallelcull.h" // <polarity/>
+#include "llframearena.h" // <polarity/>
 #include "llvoground.h"
 #include "llvosky.h"
 #include "llvotree.h"
@@ -132,6 +134,13 @@
 #define MATERIALS_IN_REFLECTIONS 0
 #define shadow_min_alpha 0.598f
 
+// <polarity> Frame arena
+// scratch lists of the frame being drawn, taken from LLFrameArena
+typedef std::list<LLVector4, LLFrameAllocator<LLVector4> > frame_vector4_list_t;
+typedef std::list<LLPointer<LLDrawable>, LLFrameAllocator<LLPointer<LLDrawable> > > frame_drawable_list_t;
+typedef std::vector<LLVector3, LLFrameAllocator<LLVector3> > frame_point_vector_t;
+// </polarity>
+
 bool gShiftFrame = false;
 
 //cached settings
@@ -2575,6 +2584,11 @@ void LLPipeline::updateCull(LLCamera& camera, LLCullResult& result, S32 water_cl
 		mCubeVB->setBuffer(LLVertexBuffer::MAP_VERTEX);
 	}
 	
+	// <polarity> Parallel culling
+	PVParallelCull& parallel_cull = PVParallelCull::instance();
+	const bool use_parallel_cull = parallel_cull.isEnabled();
+	// </polarity>
+
 	for (LLWorld::region_list_t::const_iterator iter = LLWorld::getInstance()->getRegionList().begin(); 
 			iter != LLWorld::getInstance()->getRegionList().end(); ++iter)
 	{
@@ -2589,6 +2603,11 @@ void LLPipeline::updateCull(LLCamera& camera, LLCullResult& result, S32 water_cl
 			camera.disableUserClipPlane();
 		}
 
+		// <polarity> Parallel culling
+		// the walks run after this loop, by then camera holds the last region's clip plane
+		LLCamera& region_camera = use_parallel_cull ? *parallel_cull.copyCamera(camera) : camera;
+		// </polarity>
+
 		for (U32 i = 0; i < LLViewerRegion::NUM_PARTITIONS; i++)
 		{
 			LLSpatialPartition* part = region->getSpatialPartition(i);
@@ -2596,7 +2615,16 @@ void LLPipeline::updateCull(LLCamera& camera, LLCullResult& result, S32 water_cl
 			{
 				if (hasRenderType(part->mDrawableType))
 				{
-					part->cull(camera);
+					// <polarity> Parallel culling
+					if (use_parallel_cull)
+					{
+						parallel_cull.add(part, region_camera, false);
+					}
+					else
+					{
+						part->cull(camera);
+					}
+					// </polarity>
 				}
 			}
 		}
@@ -2606,10 +2634,27 @@ void LLPipeline::updateCull(LLCamera& camera, LLCullResult& result, S32 water_cl
 		if(vo_part)
 		{
 			bool do_occlusion_cull = can_use_occlusion && use_occlusion && !gUseWireframe/* && !gViewerWindow->getProgressView()->getVisible()*/;
-			vo_part->cull(camera, do_occlusion_cull);
+			// <polarity> Parallel culling
+			if (use_parallel_cull)
+			{
+				parallel_cull.add(vo_part, region_camera, do_occlusion_cull);
+			}
+			else
+			{
+				vo_part->cull(camera, do_occlusion_cull);
+			}
+			// </polarity>
 		}
 	}
 
+	// <polarity> Parallel culling
+	if (use_parallel_cull)
+	{
+		// replays with the occlusion shader and cube buffer still bound
+		parallel_cull.cull();
+	}
+	// </polarity>
+
 	if (bound_shader)
 	{
 		gOcclusionCubeProgram.unbind();
@@ -7247,13 +7292,17 @@ void LLPipeline::renderBloom(BOOL for_snapshot, F32 zoom_factor, int subfield)
 
 	//BD - Disable the use of Occlusion when we are in Freeze World Mode to prevent
 	//     attachments from becoming desyncronized with their attached positions.
+	// <polarity> Hashed control lookups
 	LLPipeline::sUseOcclusion =
 		(!gUseWireframe
 		&& LLGLSLShader::sNoFixedFunction
 		&& LLFeatureManager::getInstance()->isFeatureAvailable("UseOcclusion")
-		&& gSavedSettings.getBOOL("UseOcclusion")
+		//&& gSavedSettings.getBOOL("UseOcclusion")
+		&& gSavedSettings.getBOOL(LL_CONTROL_KEY("UseOcclusion"))
 		&& (gGLManager.mHasOcclusionQuery) ? 2 : 0)
-		&& !gSavedSettings.getBOOL("PVRender_FreezeWorld");
+		//&& !gSavedSettings.getBOOL("PVRender_FreezeWorld");
+		&& !gSavedSettings.getBOOL(LL_CONTROL_KEY("PVRender_FreezeWorld"));
+	// </polarity>
 
 	LLVertexBuffer::unbind();
 	LLGLState::checkStates();
@@ -7531,7 +7580,8 @@ void LLPipeline::renderBloom(BOOL for_snapshot, F32 zoom_factor, int subfield)
 			}
 
 			//BD
-			if(gSavedSettings.getBOOL("CameraDoFLocked"))
+			//if(gSavedSettings.getBOOL("CameraDoFLocked"))
+			if(gSavedSettings.getBOOL(LL_CONTROL_KEY("CameraDoFLocked"))) // <polarity/> Hashed control lookups
 			{
 				focus_point = PrevDoFFocusPoint;
 			}
@@ -8478,16 +8528,22 @@ void LLPipeline::renderDeferredLighting()
 		if (render_local)
 		{
 			gGL.setSceneBlendType(LLRender::BT_ADD);
-			std::list<LLVector4> fullscreen_lights;
-			LLDrawable::drawable_list_t spot_lights;
-			LLDrawable::drawable_list_t fullscreen_spot_lights;
+//			std::list<LLVector4> fullscreen_lights;
+//			LLDrawable::drawable_list_t spot_lights;
+//			LLDrawable::drawable_list_t fullscreen_spot_lights;
+			// <polarity> Frame arena
+			frame_vector4_list_t fullscreen_lights;
+			frame_drawable_list_t spot_lights;
+			frame_drawable_list_t fullscreen_spot_lights;
+			// </polarity>
 
 			for (U32 i = 0; i < 2; i++)
 			{
 				mTargetShadowSpotLight[i] = NULL;
 			}
 
-			std::list<LLVector4> light_colors;
+//			std::list<LLVector4> light_colors;
+			frame_vector4_list_t light_colors; // <polarity/>
 
 			LLVertexBuffer::unbind();
 
@@ -8612,7 +8668,8 @@ void LLPipeline::renderDeferredLighting()
 
 				gDeferredSpotLightProgram.enableTexture(LLShaderMgr::DEFERRED_PROJECTION);
 
-				for (LLDrawable::drawable_list_t::iterator iter = spot_lights.begin(); iter != spot_lights.end(); ++iter)
+//				for (LLDrawable::drawable_list_t::iterator iter = spot_lights.begin(); iter != spot_lights.end(); ++iter)
+				for (frame_drawable_list_t::iterator iter = spot_lights.begin(); iter != spot_lights.end(); ++iter) // <polarity/>
 				{
 					LL_RECORD_BLOCK_TIME(FTM_PROJECTORS);
 					LLDrawable* drawablep = *iter;
@@ -8706,7 +8763,8 @@ void LLPipeline::renderDeferredLighting()
 
 				mDeferredVB->setBuffer(LLVertexBuffer::MAP_VERTEX);
 
-				for (LLDrawable::drawable_list_t::iterator iter = fullscreen_spot_lights.begin(); iter != fullscreen_spot_lights.end(); ++iter)
+//				for (LLDrawable::drawable_list_t::iterator iter = fullscreen_spot_lights.begin(); iter != fullscreen_spot_lights.end(); ++iter)
+				for (frame_drawable_list_t::iterator iter = fullscreen_spot_lights.begin(); iter != fullscreen_spot_lights.end(); ++iter) // <polarity/>
 				{
 					LL_RECORD_BLOCK_TIME(FTM_PROJECTORS);
 					LLDrawable* drawablep = *iter;
@@ -9027,16 +9085,22 @@ void LLPipeline::renderDeferredLightingToRT(LLRenderTarget* target)
 		if (render_local)
 		{
 			gGL.setSceneBlendType(LLRender::BT_ADD);
-			std::list<LLVector4> fullscreen_lights;
-			LLDrawable::drawable_list_t spot_lights;
-			LLDrawable::drawable_list_t fullscreen_spot_lights;
+//			std::list<LLVector4> fullscreen_lights;
+//			LLDrawable::drawable_list_t spot_lights;
+//			LLDrawable::drawable_list_t fullscreen_spot_lights;
+			// <polarity> Frame arena
+			frame_vector4_list_t fullscreen_lights;
+			frame_drawable_list_t spot_lights;
+			frame_drawable_list_t fullscreen_spot_lights;
+			// </polarity>
 
 			for (U32 i = 0; i < 2; i++)
 			{
 				mTargetShadowSpotLight[i] = NULL;
 			}
 
-			std::list<LLVector4> light_colors;
+//			std::list<LLVector4> light_colors;
+			frame_vector4_list_t light_colors; // <polarity/>
 
 			LLVertexBuffer::unbind();
 
@@ -9156,7 +9220,8 @@ void LLPipeline::renderDeferredLightingToRT(LLRenderTarget* target)
 
 				gDeferredSpotLightProgram.enableTexture(LLShaderMgr::DEFERRED_PROJECTION);
 
-				for (LLDrawable::drawable_list_t::iterator iter = spot_lights.begin(); iter != spot_lights.end(); ++iter)
+//				for (LLDrawable::drawable_list_t::iterator iter = spot_lights.begin(); iter != spot_lights.end(); ++iter)
+				for (frame_drawable_list_t::iterator iter = spot_lights.begin(); iter != spot_lights.end(); ++iter) // <polarity/>
 				{
 					LL_RECORD_BLOCK_TIME(FTM_PROJECTORS);
 					LLDrawable* drawablep = *iter;
@@ -9251,7 +9316,8 @@ void LLPipeline::renderDeferredLightingToRT(LLRenderTarget* target)
 
 				mDeferredVB->setBuffer(LLVertexBuffer::MAP_VERTEX);
 
-				for (LLDrawable::drawable_list_t::iterator iter = fullscreen_spot_lights.begin(); iter != fullscreen_spot_lights.end(); ++iter)
+//				for (LLDrawable::drawable_list_t::iterator iter = fullscreen_spot_lights.begin(); iter != fullscreen_spot_lights.end(); ++iter)
+				for (frame_drawable_list_t::iterator iter = fullscreen_spot_lights.begin(); iter != fullscreen_spot_lights.end(); ++iter) // <polarity/>
 				{
 					LL_RECORD_BLOCK_TIME(FTM_PROJECTORS);
 					LLDrawable* drawablep = *iter;
@@ -10126,7 +10192,8 @@ BOOL LLPipeline::getVisiblePointCloud(LLCamera& camera, LLVector3& min, LLVector
 		LLPlane(max, LLVector3(0,0,1))};
 	
 	//potential points
-	std::vector<LLVector3> pp;
+//	std::vector<LLVector3> pp;
+	frame_point_vector_t pp; // <polarity/> Frame arena
 
 	//add corners of AABB
 	pp.push_back(LLVector3(min.mV[0], min.mV[1], min.mV[2]));
@@ -10657,7 +10724,8 @@ void LLPipeline::generateSunShadow(LLCamera& camera)
 			//get a temporary view projection
 			view[j] = look(camera.getOrigin(), lightDir, -up);
 
-			std::vector<LLVector3> wpf;
+//			std::vector<LLVector3> wpf;
+			frame_point_vector_t wpf; // <polarity/> Frame arena
 
 			for (U32 i = 0; i < fp.size(); i++)
 			{
@@ -0,0 +1,179 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/**
+ * @file pvavatarupdatepool.cpp
+ * @brief Evaluates avatar motions and joints on a pool of worker threads (source)
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+#include "llviewerprecompiledheaders.h"
+#include "pvavatarupdatepool.h"
+
+#include "llanimationstates.h"
+#include "llfasttimer.h"
+#include "lltimer.h"
+
+#include "llagent.h"
+#include "llviewercontrol.h"
+#include "llviewerobjectlist.h"
+#include "llvoavatar.h"
+#include "pipeline.h"
+
+static const U32 BENCHMARK_WARMUP_FRAMES = 5;
+
+static LLTrace::BlockTimerStatHandle FTM_AVATAR_PARALLEL_UPDATE("Avatar Parallel Update");
+static LLTrace::BlockTimerStatHandle FTM_AVATAR_FINISH_UPDATE("Avatar Finish Update");
+
+PVAvatarUpdatePool::PVAvatarUpdatePool()
+	: PVWorkerPool("Avatar Update"),
+	  mCollecting(false),
+	  mNextAvatar(0)
+{
+}
+
+PVAvatarUpdatePool::~PVAvatarUpdatePool()
+{
+	cleanupThreads();
+}
+
+void PVAvatarUpdatePool::beginCollecting()
+{
+	static LLCachedControl<bool> parallel_update(gSavedSettings, "PVAvatar_ParallelUpdate", true);
+	mCollecting = parallel_update && getNumThreads() > 0;
+}
+
+void PVAvatarUpdatePool::add(LLVOAvatar* avatarp)
+{
+	llassert(mCollecting);
+	mBatch.push_back(avatarp);
+}
+
+void PVAvatarUpdatePool::update()
+{
+	mCollecting = false;
+	if (mBatch.empty())
+	{
+		return;
+	}
+
+	{
+		LL_RECORD_BLOCK_TIME(FTM_AVATAR_PARALLEL_UPDATE);
+		runAvatarBatch();
+	}
+
+	{
+		LL_RECORD_BLOCK_TIME(FTM_AVATAR_FINISH_UPDATE);
+		for (avatar_list_t::iterator iter = mBatch.begin(); iter != mBatch.end(); ++iter)
+		{
+			LLVOAvatar* avatarp = *iter;
+			avatarp->endParallelUpdate();
+			if (!avatarp->isDead())
+			{
+				avatarp->finishCharacterUpdate();
+				avatarp->finishIdleUpdate(TRUE);
+			}
+		}
+	}
+	mBatch.clear();
+}
+
+void PVAvatarUpdatePool::runAvatarBatch()
+{
+	mNextAvatar = 0;
+	runBatch();
+}
+
+//virtual
+void PVAvatarUpdatePool::processBatch()
+{
+	const U32 count = (U32)mBatch.size();
+	for (U32 i = mNextAvatar++; i < count; i = mNextAvatar++)
+	{
+		mBatch[i]->updateParallel();
+	}
+}
+
+std::string PVAvatarUpdatePool::runBenchmark(U32 num_avatars, U32 num_frames)
+{
+	LLViewerRegion* regionp = gAgent.getRegion();
+	if (!regionp || mCollecting || num_avatars == 0 || num_frames == 0)
+	{
+		return "Avatar update benchmark needs a region and at least one avatar and frame.";
+	}
+
+	avatar_list_t avatars;
+	for (U32 i = 0; i < num_avatars; ++i)
+	{
+		LLVOAvatar* avatarp = (LLVOAvatar*)gObjectList.createObjectViewer(LL_PCODE_LEGACY_AVATAR, regionp);
+		avatarp->createDrawable(&gPipeline);
+		avatarp->mIsDummy = TRUE;
+		avatarp->mSpecialRenderMode = 1;
+		avatarp->setPositionAgent(LLVector3::zero);
+		avatarp->slamPosition();
+		avatarp->startMotion(ANIM_AGENT_STAND);
+		avatars.push_back(avatarp);
+	}
+
+	LLTimer timer;
+	F64 serial_time = 0.0;
+	for (U32 frame = 0; frame < BENCHMARK_WARMUP_FRAMES + num_frames; ++frame)
+	{
+		if (frame == BENCHMARK_WARMUP_FRAMES)
+		{
+			timer.reset();
+		}
+		for (avatar_list_t::iterator iter = avatars.begin(); iter != avatars.end(); ++iter)
+		{
+			(*iter)->beginParallelUpdate();
+			(*iter)->updateParallel();
+			(*iter)->endParallelUpdate();
+		}
+	}
+	serial_time = timer.getElapsedTimeF64();
+
+	mBatch = avatars;
+	timer.reset();
+	for (U32 frame = 0; frame < num_frames; ++frame)
+	{
+		for (avatar_list_t::iterator iter = mBatch.begin(); iter != mBatch.end(); ++iter)
+		{
+			(*iter)->beginParallelUpdate();
+		}
+		runAvatarBatch();
+		for (avatar_list_t::iterator iter = mBatch.begin(); iter != mBatch.end(); ++iter)
+		{
+			(*iter)->endParallelUpdate();
+		}
+	}
+	const F64 parallel_time = timer.getElapsedTimeF64();
+	mBatch.clear();
+
+	for (avatar_list_t::iterator iter = avatars.begin(); iter != avatars.end(); ++iter)
+	{
+		(*iter)->markDead();
+	}
+
+	const F64 serial_ms = serial_time * 1000.0 / num_frames;
+	const F64 parallel_ms = parallel_time * 1000.0 / num_frames;
+	std::string result = llformat("Avatar update benchmark: %u avatars, %u frames, %u worker threads. Serial %.3f ms/frame, parallel %.3f ms/frame (%.2fx).",
+								  num_avatars, num_frames, getNumThreads(), serial_ms, parallel_ms,
+								  parallel_ms > 0.0 ? serial_ms / parallel_ms : 0.0);
+	LL_INFOS("AvatarUpdatePool") << result << LL_ENDL;
+	return result;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file pvavatarupdatepool.h
+ * @brief Evaluates avatar motions and joints on a pool of worker threads (header)
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+#pragma once
+#ifndef PV_AVATAR_UPDATE_POOL_H
+#define PV_AVATAR_UPDATE_POOL_H
+
+#include "llatomic.h"
+#include "llpointer.h"
+#include "llsingleton.h"
+#include "pvworkerpool.h"
+
+class LLVOAvatar;
+
+// While the object list runs idleUpdate(), other avatars only do the
+// main-thread part of their character update and add themselves here.
+// update() then evaluates their motions and joint matrices in parallel,
+// joins, and finishes each avatar's idle update on the main thread before
+// anything else looks at the skeletons.
+class PVAvatarUpdatePool : public LLSingleton<PVAvatarUpdatePool>, public PVWorkerPool
+{
+	LLSINGLETON(PVAvatarUpdatePool);
+	~PVAvatarUpdatePool();
+
+public:
+	typedef std::vector<LLPointer<LLVOAvatar> > avatar_list_t;
+
+	// called around the object list's idleUpdate() loop
+	void beginCollecting();
+	bool isCollecting() const { return mCollecting; }
+	void add(LLVOAvatar* avatarp);
+	void update();
+
+	// synthetic scene: times serial against parallel motion and joint updates
+	// for num_avatars local dummy avatars over num_frames frames
+	std::string runBenchmark(U32 num_avatars, U32 num_frames);
+
+private:
+	// evaluates mBatch on the workers and this thread, returns once all are done
+	void runAvatarBatch();
+	/*virtual*/ void processBatch();
+
+	avatar_list_t			mBatch;
+	bool					mCollecting;
+	LLAtomic32<U32>			mNextAvatar;
+};
+
+#endif // PV_AVATAR_UPDATE_POOL_H
@@ -0,0 +1,610 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/**
+ * @file pvinventorycache.cpp
+ * @brief Binary, memory mapped inventory cache (source)
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+#include "llviewerprecompiledheaders.h"
+#include "pvinventorycache.h"
+
+#include "llfasttimer.h"
+#include "llfile.h"
+#include "lltimer.h"
+#include "llxorcipher.h"
+
+#include "llviewerinventory.h"
+
+#include <boost/unordered_map.hpp>
+
+#if LL_WINDOWS
+#include "llwin32headerslean.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static LLTrace::BlockTimerStatHandle FTM_INVENTORY_CACHE_LOAD("Inventory Cache Load");
+static LLTrace::BlockTimerStatHandle FTM_INVENTORY_CACHE_PACK("Inventory Cache Pack");
+
+static const char BINARY_CACHE_SUFFIX[] = ".bin";
+static const char CACHE_MAGIC[4] = { 'P', 'V', 'I', 'C' };
+// bump whenever a record layout below changes
+static const U32 CACHE_FORMAT_VERSION = 1;
+// the key LLInventoryItem uses for shadow_id in the text format, so restricted
+// asset ids are no more readable here than they were there
+static const LLUUID SHADOW_KEY("3c115e51-04f4-523c-9fa6-98aff1034730");
+
+namespace
+{
+	// Everything is stored in host order, the cache never leaves the machine.
+	struct CacheHeader
+	{
+		char	mMagic[4];
+		U32		mFormatVersion;
+		S32		mInvCacheVersion;	// LLInventoryModel::sCurrentInvCacheVersion
+		U32		mCategoryCount;
+		U32		mItemCount;
+		U32		mStringPoolSize;
+		U32		mReserved[2];
+	};
+	LL_STATIC_ASSERT(sizeof(CacheHeader) == 32, "inventory cache header layout changed");
+
+	struct CategoryRecord
+	{
+		U8		mID[UUID_BYTES];
+		U8		mParentID[UUID_BYTES];
+		U8		mOwnerID[UUID_BYTES];
+		S32		mVersion;
+		U32		mNameOffset;
+		U32		mNameLength;
+		S8		mPreferredType;
+		U8		mPad[3];
+	};
+	LL_STATIC_ASSERT(sizeof(CategoryRecord) == 64, "inventory cache category layout changed");
+
+	struct ItemRecord
+	{
+		enum
+		{
+			GROUP_OWNED		= 0x1,
+			SHADOW_ASSET	= 0x2
+		};
+
+		U8		mID[UUID_BYTES];
+		U8		mParentID[UUID_BYTES];
+		U8		mAssetID[UUID_BYTES];
+		U8		mCreatorID[UUID_BYTES];
+		U8		mOwnerID[UUID_BYTES];
+		U8		mLastOwnerID[UUID_BYTES];
+		U8		mGroupID[UUID_BYTES];
+		U32		mMaskBase;
+		U32		mMaskOwner;
+		U32		mMaskGroup;
+		U32		mMaskEveryone;
+		U32		mMaskNextOwner;
+		U32		mFlags;
+		S32		mCreationDate;
+		S32		mSalePrice;
+		U32		mNameOffset;
+		U32		mNameLength;
+		U32		mDescOffset;
+		U32		mDescLength;
+		S8		mType;
+		S8		mInventoryType;
+		U8		mSaleType;
+		U8		mRecordFlags;
+	};
+	LL_STATIC_ASSERT(sizeof(ItemRecord) == 164, "inventory cache item layout changed");
+
+	// names repeat a lot (links, no-copy duplicates, empty descriptions), so
+	// identical strings share one copy in the pool
+	class StringPool
+	{
+	public:
+		void add(const std::string& str, U32& offset, U32& length)
+		{
+			length = (U32)str.size();
+			if (str.empty())
+			{
+				offset = 0;
+				return;
+			}
+			std::pair<offset_map_t::iterator, bool> result = mOffsets.insert(std::make_pair(str, (U32)mData.size()));
+			if (result.second)
+			{
+				mData.append(str);
+			}
+			offset = result.first->second;
+		}
+
+		const std::string& getData() const { return mData; }
+
+	private:
+		typedef boost::unordered_map<std::string, U32> offset_map_t;
+		offset_map_t	mOffsets;
+		std::string		mData;
+	};
+
+	// Read-only view of a whole file. Pages are faulted in as the records are
+	// walked, nothing is copied up front.
+	class MappedFile
+	{
+	public:
+		MappedFile()
+			: mData(NULL),
+			  mSize(0)
+#if LL_WINDOWS
+			, mFile(INVALID_HANDLE_VALUE),
+			  mMapping(NULL)
+#endif
+		{
+		}
+
+		~MappedFile()
+		{
+#if LL_WINDOWS
+			if (mData) UnmapViewOfFile(mData);
+			if (mMapping) CloseHandle(mMapping);
+			if (mFile != INVALID_HANDLE_VALUE) CloseHandle(mFile);
+#else
+			if (mData) munmap((void*)mData, mSize);
+#endif
+		}
+
+		bool open(const std::string& filename)
+		{
+#if LL_WINDOWS
+			llutf16string utf16filename = utf8str_to_utf16str(filename);
+			mFile = CreateFileW(utf16filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+								OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+			if (mFile == INVALID_HANDLE_VALUE)
+			{
+				return false;
+			}
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(mFile, &size) || size.QuadPart == 0)
+			{
+				return false;
+			}
+			mMapping = CreateFileMappingW(mFile, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (!mMapping)
+			{
+				return false;
+			}
+			mData = (const U8*)MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+			mSize = (size_t)size.QuadPart;
+#else
+			int fd = ::open(filename.c_str(), O_RDONLY);
+			if (fd < 0)
+			{
+				return false;
+			}
+			struct stat st;
+			if (fstat(fd, &st) != 0 || st.st_size == 0)
+			{
+				close(fd);
+				return false;
+			}
+			void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			close(fd);
+			if (data == MAP_FAILED)
+			{
+				return false;
+			}
+			madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+			mData = (const U8*)data;
+			mSize = (size_t)st.st_size;
+#endif
+			return mData != NULL;
+		}
+
+		const U8* getData() const { return mData; }
+		size_t getSize() const { return mSize; }
+
+	private:
+		const U8*	mData;
+		size_t		mSize;
+#if LL_WINDOWS
+		HANDLE		mFile;
+		HANDLE		mMapping;
+#endif
+	};
+
+	inline LLUUID to_uuid(const U8* data)
+	{
+		LLUUID id;
+		memcpy(id.mData, data, UUID_BYTES);
+		return id;
+	}
+
+	inline bool string_in_pool(U32 offset, U32 length, U32 pool_size)
+	{
+		return offset <= pool_size && length <= pool_size - offset;
+	}
+}
+
+//----------------------------------------------------------------------------
+// Writer
+//----------------------------------------------------------------------------
+PVInventoryCache::Writer::Writer(PVInventoryCache* cache)
+	: LLThread("Inventory Cache Writer"),
+	  mCache(cache)
+{
+}
+
+//virtual
+void PVInventoryCache::Writer::run()
+{
+	while (true)
+	{
+		PendingWrite write;
+		{
+			LLMutexLock lock(&mCache->mQueueCondition);
+			while (mCache->mQueue.empty() && !mCache->mQuitting)
+			{
+				mCache->mQueueCondition.wait();
+			}
+			if (mCache->mQueue.empty())
+			{
+				// drained and asked to quit, flush() waits for this
+				mCache->mDrained = true;
+				mCache->mQueueCondition.broadcast();
+				break;
+			}
+			write.mFilename.swap(mCache->mQueue.front().mFilename);
+			write.mBuffer.swap(mCache->mQueue.front().mBuffer);
+			mCache->mQueue.pop_front();
+		}
+		writeFile(write.mFilename, write.mBuffer);
+	}
+	LL_INFOS("InventoryCache") << mName << " exiting." << LL_ENDL;
+}
+
+//----------------------------------------------------------------------------
+// PVInventoryCache
+//----------------------------------------------------------------------------
+PVInventoryCache::PVInventoryCache()
+	: mWriter(NULL),
+	  mQuitting(false),
+	  mDrained(false)
+{
+}
+
+PVInventoryCache::~PVInventoryCache()
+{
+	flush();
+}
+
+//static
+std::string PVInventoryCache::getFilename(const std::string& inventory_filename)
+{
+	return inventory_filename + BINARY_CACHE_SUFFIX;
+}
+
+//static
+bool PVInventoryCache::load(const std::string& filename,
+							LLInventoryModel::cat_array_t& categories,
+							LLInventoryModel::item_array_t& items,
+							bool& is_cache_obsolete)
+{
+	LL_RECORD_BLOCK_TIME(FTM_INVENTORY_CACHE_LOAD);
+
+	// obsolete until proven current, same as the text loader
+	is_cache_obsolete = true;
+
+	MappedFile file;
+	if (!file.open(filename))
+	{
+		LL_INFOS("InventoryCache") << "unable to map inventory cache: " << filename << LL_ENDL;
+		is_cache_obsolete = false;
+		return false;
+	}
+
+	LLTimer timer;
+	const U8* data = file.getData();
+	const size_t size = file.getSize();
+	if (size < sizeof(CacheHeader))
+	{
+		LL_WARNS("InventoryCache") << "Truncated inventory cache " << filename << LL_ENDL;
+		return false;
+	}
+
+	const CacheHeader* header = (const CacheHeader*)data;
+	if (memcmp(header->mMagic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0
+		|| header->mFormatVersion != CACHE_FORMAT_VERSION
+		|| header->mInvCacheVersion != LLInventoryModel::sCurrentInvCacheVersion)
+	{
+		LL_INFOS("InventoryCache") << "Inventory cache " << filename << " is from another version" << LL_ENDL;
+		return false;
+	}
+
+	const U64 categories_size = (U64)header->mCategoryCount * sizeof(CategoryRecord);
+	const U64 items_size = (U64)header->mItemCount * sizeof(ItemRecord);
+	if (sizeof(CacheHeader) + categories_size + items_size + header->mStringPoolSize != size)
+	{
+		LL_WARNS("InventoryCache") << "Inventory cache " << filename << " has the wrong size" << LL_ENDL;
+		return false;
+	}
+
+	const CategoryRecord* cat_records = (const CategoryRecord*)(data + sizeof(CacheHeader));
+	const ItemRecord* item_records = (const ItemRecord*)(data + sizeof(CacheHeader) + categories_size);
+	const char* pool = (const char*)(data + sizeof(CacheHeader) + categories_size + items_size);
+	const U32 pool_size = header->mStringPoolSize;
+
+	categories.reserve(categories.size() + header->mCategoryCount);
+	for (U32 i = 0; i < header->mCategoryCount; ++i)
+	{
+		const CategoryRecord& record = cat_records[i];
+		if (!string_in_pool(record.mNameOffset, record.mNameLength, pool_size))
+		{
+			LL_WARNS("InventoryCache") << "Inventory cache " << filename << " is corrupt" << LL_ENDL;
+			categories.clear();
+			return false;
+		}
+
+		LLPointer<LLViewerInventoryCategory> cat = new LLViewerInventoryCategory(
+			to_uuid(record.mID),
+			to_uuid(record.mParentID),
+			(LLFolderType::EType)record.mPreferredType,
+			std::string(pool + record.mNameOffset, record.mNameLength),
+			to_uuid(record.mOwnerID));
+		cat->setVersion(record.mVersion);
+		categories.push_back(cat);
+	}
+
+	items.reserve(items.size() + header->mItemCount);
+	for (U32 i = 0; i < header->mItemCount; ++i)
+	{
+		const ItemRecord& record = item_records[i];
+		if (!string_in_pool(record.mNameOffset, record.mNameLength, pool_size)
+			|| !string_in_pool(record.mDescOffset, record.mDescLength, pool_size))
+		{
+			LL_WARNS("InventoryCache") << "Inventory cache " << filename << " is corrupt" << LL_ENDL;
+			categories.clear();
+			items.clear();
+			return false;
+		}
+
+		LLPermissions perm;
+		perm.init(to_uuid(record.mCreatorID), to_uuid(record.mOwnerID),
+				  to_uuid(record.mLastOwnerID), to_uuid(record.mGroupID));
+		if (record.mRecordFlags & ItemRecord::GROUP_OWNED)
+		{
+			perm.yesReallySetOwner(perm.getOwner(), true);
+		}
+		perm.initMasks(record.mMaskBase, record.mMaskOwner, record.mMaskEveryone,
+					   record.mMaskGroup, record.mMaskNextOwner);
+
+		LLUUID asset_id = to_uuid(record.mAssetID);
+		if (record.mRecordFlags & ItemRecord::SHADOW_ASSET)
+		{
+			LLXORCipher cipher(SHADOW_KEY.mData, UUID_BYTES);
+			cipher.decrypt(asset_id.mData, UUID_BYTES);
+		}
+
+		LLPointer<LLViewerInventoryItem> item = new LLViewerInventoryItem(
+			to_uuid(record.mID),
+			to_uuid(record.mParentID),
+			perm,
+			asset_id,
+			(LLAssetType::EType)record.mType,
+			(LLInventoryType::EType)record.mInventoryType,
+			std::string(pool + record.mNameOffset, record.mNameLength),
+			std::string(pool + record.mDescOffset, record.mDescLength),
+			LLSaleInfo((LLSaleInfo::EForSale)record.mSaleType, record.mSalePrice),
+			record.mFlags,
+			(time_t)record.mCreationDate);
+		// like importFileLocal(), cached items still have to be fetched
+		item->setComplete(FALSE);
+		items.push_back(item);
+	}
+
+	is_cache_obsolete = false;
+	LL_INFOS("InventoryCache") << "Loaded " << header->mCategoryCount << " categories and "
+							   << header->mItemCount << " items from " << filename
+							   << " in " << timer.getElapsedTimeF32() * 1000.f << " ms" << LL_ENDL;
+	return true;
+}
+
+void PVInventoryCache::save(const std::string& filename,
+							const LLInventoryModel::cat_array_t& categories,
+							const LLInventoryModel::item_array_t& items)
+{
+	if (filename.empty())
+	{
+		LL_WARNS("InventoryCache") << "Filename is empty!" << LL_ENDL;
+		return;
+	}
+
+	PendingWrite write;
+	write.mFilename = filename;
+	{
+		LL_RECORD_BLOCK_TIME(FTM_INVENTORY_CACHE_PACK);
+
+		StringPool pool;
+		std::vector<CategoryRecord> cat_records;
+		cat_records.reserve(categories.size());
+		for (LLInventoryModel::cat_array_t::const_iterator iter = categories.begin(); iter != categories.end(); ++iter)
+		{
+			const LLViewerInventoryCategory* cat = *iter;
+			if (cat->getVersion() == LLViewerInventoryCategory::VERSION_UNKNOWN)
+			{
+				continue;
+			}
+
+			CategoryRecord record;
+			memset(&record, 0, sizeof(record));
+			memcpy(record.mID, cat->getUUID().mData, UUID_BYTES);
+			memcpy(record.mParentID, cat->getParentUUID().mData, UUID_BYTES);
+			memcpy(record.mOwnerID, cat->getOwnerID().mData, UUID_BYTES);
+			record.mVersion = cat->getVersion();
+			record.mPreferredType = (S8)cat->getPreferredType();
+			pool.add(cat->getName(), record.mNameOffset, record.mNameLength);
+			cat_records.push_back(record);
+		}
+
+		std::vector<ItemRecord> item_records;
+		item_records.reserve(items.size());
+		for (LLInventoryModel::item_array_t::const_iterator iter = items.begin(); iter != items.end(); ++iter)
+		{
+			// qualified calls: the viewer item getters follow links, the cache
+			// wants the link itself just like exportFile() writes it
+			const LLViewerInventoryItem* item = *iter;
+			const LLPermissions& perm = item->LLInventoryItem::getPermissions();
+			const LLSaleInfo& sale_info = item->LLInventoryItem::getSaleInfo();
+
+			ItemRecord record;
+			memset(&record, 0, sizeof(record));
+			memcpy(record.mID, item->getUUID().mData, UUID_BYTES);
+			memcpy(record.mParentID, item->getParentUUID().mData, UUID_BYTES);
+			memcpy(record.mCreatorID, perm.getCreator().mData, UUID_BYTES);
+			memcpy(record.mOwnerID, perm.getOwner().mData, UUID_BYTES);
+			memcpy(record.mLastOwnerID, perm.getLastOwner().mData, UUID_BYTES);
+			memcpy(record.mGroupID, perm.getGroup().mData, UUID_BYTES);
+			record.mMaskBase = perm.getMaskBase();
+			record.mMaskOwner = perm.getMaskOwner();
+			record.mMaskGroup = perm.getMaskGroup();
+			record.mMaskEveryone = perm.getMaskEveryone();
+			record.mMaskNextOwner = perm.getMaskNextOwner();
+			if (perm.isGroupOwned())
+			{
+				record.mRecordFlags |= ItemRecord::GROUP_OWNED;
+			}
+
+			LLUUID asset_id = item->LLInventoryItem::getAssetUUID();
+			if ((perm.getMaskBase() & PERM_ITEM_UNRESTRICTED) != PERM_ITEM_UNRESTRICTED && asset_id.notNull())
+			{
+				LLXORCipher cipher(SHADOW_KEY.mData, UUID_BYTES);
+				cipher.encrypt(asset_id.mData, UUID_BYTES);
+				record.mRecordFlags |= ItemRecord::SHADOW_ASSET;
+			}
+			memcpy(record.mAssetID, asset_id.mData, UUID_BYTES);
+
+			record.mFlags = item->LLInventoryItem::getFlags();
+			record.mCreationDate = (S32)item->LLInventoryItem::getCreationDate();
+			record.mSalePrice = sale_info.getSalePrice();
+			record.mType = (S8)item->LLInventoryItem::getType();
+			record.mInventoryType = (S8)item->LLInventoryItem::getInventoryType();
+			record.mSaleType = (U8)sale_info.getSaleType();
+			pool.add(item->LLInventoryItem::getName(), record.mNameOffset, record.mNameLength);
+			pool.add(item->LLInventoryItem::getActualDescription(), record.mDescOffset, record.mDescLength);
+			item_records.push_back(record);
+		}
+
+		CacheHeader header;
+		memset(&header, 0, sizeof(header));
+		memcpy(header.mMagic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+		header.mFormatVersion = CACHE_FORMAT_VERSION;
+		header.mInvCacheVersion = LLInventoryModel::sCurrentInvCacheVersion;
+		header.mCategoryCount = (U32)cat_records.size();
+		header.mItemCount = (U32)item_records.size();
+		header.mStringPoolSize = (U32)pool.getData().size();
+
+		const size_t categories_size = cat_records.size() * sizeof(CategoryRecord);
+		const size_t items_size = item_records.size() * sizeof(ItemRecord);
+		write.mBuffer.resize(sizeof(CacheHeader) + categories_size + items_size + pool.getData().size());
+		U8* out = &write.mBuffer[0];
+		memcpy(out, &header, sizeof(CacheHeader));
+		out += sizeof(CacheHeader);
+		if (categories_size)
+		{
+			memcpy(out, &cat_records[0], categories_size);
+			out += categories_size;
+		}
+		if (items_size)
+		{
+			memcpy(out, &item_records[0], items_size);
+			out += items_size;
+		}
+		if (!pool.getData().empty())
+		{
+			memcpy(out, pool.getData().data(), pool.getData().size());
+		}
+	}
+
+	LLMutexLock lock(&mQueueCondition);
+	if (!mWriter)
+	{
+		mQuitting = false;
+		mDrained = false;
+		mWriter = new Writer(this);
+		mWriter->start();
+	}
+	mQueue.push_back(PendingWrite());
+	mQueue.back().mFilename.swap(write.mFilename);
+	mQueue.back().mBuffer.swap(write.mBuffer);
+	mQueueCondition.signal();
+}
+
+void PVInventoryCache::flush()
+{
+	{
+		LLMutexLock lock(&mQueueCondition);
+		if (!mWriter)
+		{
+			return;
+		}
+		mQuitting = true;
+		mQueueCondition.broadcast();
+		// the writer drains the queue before it looks at mQuitting
+		while (!mDrained)
+		{
+			mQueueCondition.wait();
+		}
+	}
+
+	mWriter->shutdown();
+	delete mWriter;
+	mWriter = NULL;
+}
+
+//static
+bool PVInventoryCache::writeFile(const std::string& filename, const buffer_t& buffer)
+{
+	// write next to the real file and swap it in, a crash mid-write must not
+	// leave a cache that maps but lies
+	const std::string temp_filename = filename + ".tmp";
+	LLFILE* fp = LLFile::fopen(temp_filename, "wb");
+	if (!fp)
+	{
+		LL_WARNS("InventoryCache") << "unable to save inventory cache to: " << temp_filename << LL_ENDL;
+		return false;
+	}
+	const size_t written = buffer.empty() ? 0 : fwrite(&buffer[0], 1, buffer.size(), fp);
+	fclose(fp);
+	if (written != buffer.size())
+	{
+		LL_WARNS("InventoryCache") << "short write saving inventory cache to: " << temp_filename << LL_ENDL;
+		LLFile::remove(temp_filename);
+		return false;
+	}
+
+	LLFile::remove(filename, ENOENT);
+	if (LLFile::rename(temp_filename, filename) != 0)
+	{
+		LLFile::remove(temp_filename);
+		return false;
+	}
+	LL_INFOS("InventoryCache") << "Saved " << buffer.size() << " bytes of inventory cache to " << filename << LL_ENDL;
+	return true;
+}
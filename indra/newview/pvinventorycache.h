@@ -0,0 +1,91 @@
+/**
+ * @file pvinventorycache.h
+ * @brief Binary, memory mapped inventory cache (header)
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+#pragma once
+#ifndef PV_INVENTORY_CACHE_H
+#define PV_INVENTORY_CACHE_H
+
+#include "llinventorymodel.h"
+#include "llmutex.h"
+#include "llsingleton.h"
+#include "llthread.h"
+
+// Replacement for the gzipped text .inv cache. The file is a fixed header,
+// an array of fixed size category records, an array of fixed size item
+// records and a pool of the names and descriptions they point into. It is
+// read through a read-only mapping, so loading is a pass over the records
+// with no parsing, no decompression and no temporary file.
+//
+// save() packs the records on the calling thread, since the model may
+// change right after, and hands the buffer to a writer thread. flush()
+// must be called before exit to make sure the last write landed.
+class PVInventoryCache : public LLSingleton<PVInventoryCache>
+{
+	LLSINGLETON(PVInventoryCache);
+	~PVInventoryCache();
+
+public:
+	// file the binary cache for the given text cache name lives in
+	static std::string getFilename(const std::string& inventory_filename);
+
+	// same contract as LLInventoryModel::loadFromFile()
+	static bool load(const std::string& filename,
+					 LLInventoryModel::cat_array_t& categories,
+					 LLInventoryModel::item_array_t& items,
+					 bool& is_cache_obsolete);
+
+	void save(const std::string& filename,
+			  const LLInventoryModel::cat_array_t& categories,
+			  const LLInventoryModel::item_array_t& items);
+
+	// waits for pending writes and stops the writer thread
+	void flush();
+
+private:
+	typedef std::vector<U8> buffer_t;
+
+	class Writer : public LLThread
+	{
+	public:
+		Writer(PVInventoryCache* cache);
+		/*virtual*/ void run();
+
+	private:
+		PVInventoryCache* mCache;
+	};
+
+	static bool writeFile(const std::string& filename, const buffer_t& buffer);
+
+	struct PendingWrite
+	{
+		std::string	mFilename;
+		buffer_t	mBuffer;
+	};
+
+	Writer*						mWriter;
+	LLCondition					mQueueCondition;	// guards the three below
+	std::deque<PendingWrite>	mQueue;
+	bool						mQuitting;
+	bool						mDrained;			// the writer is done with the queue
+};
+
+#endif // PV_INVENTORY_CACHE_H
@@ -0,0 +1,612 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/**
+ * @file pvinventorysearch.cpp
+ * @brief Inventory substring search on a worker thread (source)
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+#include "llviewerprecompiledheaders.h"
+#include "pvinventorysearch.h"
+
+#include <boost/functional/hash.hpp>
+
+#include "llfasttimer.h"
+
+#include "llfolderviewmodelinventory.h"
+#include "llinventoryfilter.h"
+#include "llinventorymodel.h"
+#include "llviewercontrol.h"
+#include "llviewerinventory.h"
+
+static LLTrace::BlockTimerStatHandle FTM_INVENTORY_SEARCH_SEED("Inventory Search Seed");
+
+// ids the worker collects before handing them over
+static const U32 RESULT_BATCH_SIZE = 2048;
+
+static inline U32 trigram_at(const std::string& text, size_t pos)
+{
+	return ((U32)(U8)text[pos] << 16) | ((U32)(U8)text[pos + 1] << 8) | (U32)(U8)text[pos + 2];
+}
+
+//----------------------------------------------------------------------------
+// PVInventorySearch::Query
+//----------------------------------------------------------------------------
+PVInventorySearch::Query::Query(const indexed_map_t& indexed, const std::vector<std::string>& terms,
+								S32 target, bool use_trigrams)
+	: mIndexed(indexed),
+	  mTerms(terms),
+	  mTarget(target),
+	  mUseTrigrams(use_trigrams),
+	  mComplete(false),
+	  mHadResults(false),
+	  mVersion(0),
+	  mGeneration(0),
+	  mIncomingDone(false)
+{
+}
+
+U32 PVInventorySearch::Query::update()
+{
+	uuid_vec_t incoming;
+	bool done;
+	{
+		LLMutexLock lock(&mMutex);
+		incoming.swap(mIncoming);
+		done = mIncomingDone;
+		mIncomingDone = false;
+	}
+
+	// the first run shows matches as they come in, a rerun swaps its whole
+	// set in at the end so nothing blinks out in the meantime
+	LLUUIDHashMap<bool>& matches = mHadResults ? mNextMatches : mMatches;
+	for (uuid_vec_t::const_iterator iter = incoming.begin(); iter != incoming.end(); ++iter)
+	{
+		matches[*iter] = true;
+	}
+	if (!mHadResults && !incoming.empty())
+	{
+		++mVersion;
+	}
+	if (done)
+	{
+		if (mHadResults)
+		{
+			mMatches.swap(mNextMatches);
+			mNextMatches.clear();
+		}
+		mComplete = true;
+		mHadResults = true;
+		++mVersion;
+	}
+	return mVersion;
+}
+
+PVInventorySearch::EResult PVInventorySearch::Query::check(const LLFolderViewModelItemInventory* listener) const
+{
+	if (listener->getInventoryType() == LLInventoryType::IT_CATEGORY)
+	{
+		return RESULT_UNKNOWN;
+	}
+
+	const LLUUID& id = listener->getUUID();
+	indexed_map_t::const_iterator indexed = mIndexed.find(id);
+	if (indexed == mIndexed.end())
+	{
+		return RESULT_UNKNOWN;
+	}
+	// the searchable name is the item name plus the label suffix, "(worn)",
+	// "(no copy)" and so on. The index only knows the name.
+	if (mTarget == LLInventoryFilter::SUBST_TARGET_NAME && listener->getSearchableName().size() != indexed->second.mNameLength)
+	{
+		return RESULT_UNKNOWN;
+	}
+
+	if (mMatches.count(id))
+	{
+		return RESULT_MATCH;
+	}
+	return mHadResults ? RESULT_NO_MATCH : RESULT_PENDING;
+}
+
+//----------------------------------------------------------------------------
+// PVInventorySearch::Observer
+//----------------------------------------------------------------------------
+//virtual
+void PVInventorySearch::Observer::changed(U32 mask)
+{
+	// names, descriptions and asset ids change with LABEL or INTERNAL. REBUILD
+	// only changes the label suffix, which check() already leaves to the filter.
+	if (!(mask & (LLInventoryObserver::LABEL | LLInventoryObserver::INTERNAL | LLInventoryObserver::ADD
+				  | LLInventoryObserver::REMOVE)))
+	{
+		return;
+	}
+
+	PVInventorySearch& search = PVInventorySearch::instance();
+	std::deque<Update> updates;
+	const LLInventoryModel::changed_items_t& changed_ids = gInventory.getChangedIDs();
+	for (LLInventoryModel::changed_items_t::const_iterator iter = changed_ids.begin(); iter != changed_ids.end(); ++iter)
+	{
+		search.makeUpdate(*iter, gInventory.getItem(*iter), updates);
+	}
+	if (!updates.empty())
+	{
+		search.post(updates);
+		search.rerunQueries();
+	}
+}
+
+//----------------------------------------------------------------------------
+// PVInventorySearch::Worker
+//----------------------------------------------------------------------------
+PVInventorySearch::Worker::Worker(PVInventorySearch* search)
+	: LLThread("Inventory Search"),
+	  mSearch(search)
+{
+}
+
+//virtual
+void PVInventorySearch::Worker::run()
+{
+	while (true)
+	{
+		std::deque<Update> updates;
+		LLPointer<Query> query;
+		{
+			LLMutexLock lock(&mSearch->mCondition);
+			while (mSearch->mUpdates.empty() && mSearch->mPending.empty() && !mSearch->mQuitting)
+			{
+				mSearch->mCondition.wait();
+			}
+			if (mSearch->mQuitting)
+			{
+				break;
+			}
+			updates.swap(mSearch->mUpdates);
+			if (!mSearch->mPending.empty())
+			{
+				query = mSearch->mPending.front();
+				mSearch->mPending.pop_front();
+			}
+		}
+
+		mSearch->applyUpdates(updates);
+		if (query)
+		{
+			U32 generation;
+			{
+				LLMutexLock lock(&query->mMutex);
+				generation = query->mGeneration;
+			}
+			mSearch->runQuery(query, generation);
+		}
+	}
+	LL_INFOS("InventorySearch") << mName << " exiting." << LL_ENDL;
+}
+
+//----------------------------------------------------------------------------
+// PVInventorySearch
+//----------------------------------------------------------------------------
+PVInventorySearch::PVInventorySearch()
+	: mWorker(NULL),
+	  mObserver(NULL),
+	  mQuitting(false),
+	  mTrigramsDirty(true)
+{
+}
+
+PVInventorySearch::~PVInventorySearch()
+{
+	cleanup();
+}
+
+LLPointer<PVInventorySearch::Query> PVInventorySearch::find(const std::vector<std::string>& terms, S32 target)
+{
+	static LLCachedControl<bool> background_search(gSavedSettings, "PVInventory_BackgroundSearch", true);
+	static LLCachedControl<bool> trigram_index(gSavedSettings, "PVInventory_SearchTrigramIndex", false);
+
+	// the creator name comes from the name cache, which only lives on this thread
+	if (!background_search || terms.empty()
+		|| target == LLInventoryFilter::SUBST_TARGET_CREATOR || target == LLInventoryFilter::SUBST_TARGET_ALL
+		|| !gInventory.isInventoryUsable())
+	{
+		return NULL;
+	}
+
+	if (!mWorker)
+	{
+		seed();
+		mObserver = new Observer;
+		gInventory.addObserver(mObserver);
+		mWorker = new Worker(this);
+		mWorker->start();
+	}
+
+	pruneQueries();
+	for (std::vector<LLPointer<Query> >::const_iterator iter = mQueries.begin(); iter != mQueries.end(); ++iter)
+	{
+		if ((*iter)->mTarget == target && (*iter)->mTerms == terms && (*iter)->mUseTrigrams == trigram_index)
+		{
+			return *iter;
+		}
+	}
+
+	LLPointer<Query> query = new Query(mIndexed, terms, target, trigram_index);
+	mQueries.push_back(query);
+	LLMutexLock lock(&mCondition);
+	mPending.push_back(query);
+	mCondition.signal();
+	return query;
+}
+
+void PVInventorySearch::cleanup()
+{
+	if (mObserver)
+	{
+		gInventory.removeObserver(mObserver);
+		delete mObserver;
+		mObserver = NULL;
+	}
+
+	if (mWorker)
+	{
+		{
+			LLMutexLock lock(&mCondition);
+			mQuitting = true;
+			mCondition.signal();
+		}
+		mWorker->shutdown();
+		delete mWorker;
+		mWorker = NULL;
+	}
+
+	mPending.clear();
+	mUpdates.clear();
+	mQueries.clear();
+}
+
+void PVInventorySearch::seed()
+{
+	LL_RECORD_BLOCK_TIME(FTM_INVENTORY_SEARCH_SEED);
+
+	LLInventoryModel::cat_array_t cats;
+	LLInventoryModel::item_array_t items;
+	gInventory.collectDescendents(gInventory.getRootFolderID(), cats, items, LLInventoryModel::INCLUDE_TRASH);
+	if (gInventory.getLibraryRootFolderID().notNull())
+	{
+		gInventory.collectDescendents(gInventory.getLibraryRootFolderID(), cats, items, LLInventoryModel::INCLUDE_TRASH);
+	}
+
+	std::deque<Update> updates;
+	mIndexed.reserve(items.size());
+	for (LLInventoryModel::item_array_t::const_iterator iter = items.begin(); iter != items.end(); ++iter)
+	{
+		makeUpdate((*iter)->getUUID(), *iter, updates);
+	}
+	post(updates);
+}
+
+void PVInventorySearch::makeUpdate(const LLUUID& id, const LLViewerInventoryItem* item, std::deque<Update>& updates)
+{
+	if (!item || item->getIsLinkType())
+	{
+		if (mIndexed.erase(id))
+		{
+			updates.push_back(Update());
+			updates.back().mID = id;
+			updates.back().mRemove = true;
+		}
+		return;
+	}
+
+	size_t hash = boost::hash<std::string>()(item->getName());
+	boost::hash_combine(hash, item->getDescription());
+	boost::hash_combine(hash, std::hash<LLUUID>()(item->getAssetUUID()));
+	indexed_map_t::const_iterator indexed = mIndexed.find(id);
+	if (indexed != mIndexed.end() && indexed->second.mHash == hash)
+	{
+		// permissions, flags, the parent folder, nothing a query looks at
+		return;
+	}
+
+	updates.push_back(Update());
+	Update& update = updates.back();
+	update.mID = id;
+	update.mName = item->getName();
+	update.mDescription = item->getDescription();
+	update.mAssetID = item->getAssetUUID();
+	update.mRemove = false;
+	IndexedItem& indexed_item = mIndexed[id];
+	// upper casing works per byte, so this is the length of the searchable name too
+	indexed_item.mNameLength = (U32)update.mName.size();
+	indexed_item.mHash = hash;
+}
+
+void PVInventorySearch::post(std::deque<Update>& updates)
+{
+	LLMutexLock lock(&mCondition);
+	if (mUpdates.empty())
+	{
+		mUpdates.swap(updates);
+	}
+	else
+	{
+		mUpdates.insert(mUpdates.end(), updates.begin(), updates.end());
+		updates.clear();
+	}
+	mCondition.signal();
+}
+
+void PVInventorySearch::rerunQueries()
+{
+	pruneQueries();
+	for (std::vector<LLPointer<Query> >::iterator iter = mQueries.begin(); iter != mQueries.end(); ++iter)
+	{
+		Query* query = *iter;
+		{
+			LLMutexLock lock(&query->mMutex);
+			++query->mGeneration;
+			query->mIncoming.clear();
+			query->mIncomingDone = false;
+		}
+		query->mNextMatches.clear();
+		query->mComplete = false;
+
+		LLMutexLock lock(&mCondition);
+		if (std::find(mPending.begin(), mPending.end(), *iter) == mPending.end())
+		{
+			mPending.push_back(*iter);
+		}
+		mCondition.signal();
+	}
+}
+
+void PVInventorySearch::pruneQueries()
+{
+	// queries no filter holds any more. One still waiting for the worker is
+	// held by mPending too and goes on a later pass.
+	for (std::vector<LLPointer<Query> >::iterator iter = mQueries.begin(); iter != mQueries.end(); )
+	{
+		if ((*iter)->getNumRefs() == 1)
+		{
+			iter = mQueries.erase(iter);
+		}
+		else
+		{
+			++iter;
+		}
+	}
+}
+
+void PVInventorySearch::applyUpdates(std::deque<Update>& updates)
+{
+	for (std::deque<Update>::iterator iter = updates.begin(); iter != updates.end(); ++iter)
+	{
+		LLUUIDHashMap<U32>::iterator index = mEntryIndex.find(iter->mID);
+		if (iter->mRemove)
+		{
+			if (index != mEntryIndex.end())
+			{
+				Entry& entry = mEntries[index->second];
+				entry.mLive = false;
+				std::string().swap(entry.mName);
+				std::string().swap(entry.mDescription);
+				mFreeEntries.push_back(index->second);
+				mEntryIndex.erase(index);
+			}
+			continue;
+		}
+
+		U32 slot;
+		if (index != mEntryIndex.end())
+		{
+			slot = index->second;
+		}
+		else if (!mFreeEntries.empty())
+		{
+			slot = mFreeEntries.back();
+			mFreeEntries.pop_back();
+			mEntryIndex[iter->mID] = slot;
+		}
+		else
+		{
+			slot = (U32)mEntries.size();
+			mEntries.push_back(Entry());
+			mEntryIndex[iter->mID] = slot;
+		}
+
+		Entry& entry = mEntries[slot];
+		entry.mID = iter->mID;
+		entry.mName.swap(iter->mName);
+		LLStringUtil::toUpper(entry.mName);
+		entry.mDescription.swap(iter->mDescription);
+		LLStringUtil::toUpper(entry.mDescription);
+		entry.mAssetID = iter->mAssetID;
+		entry.mLive = true;
+	}
+
+	if (!updates.empty())
+	{
+		mTrigramsDirty = true;
+	}
+}
+
+void PVInventorySearch::buildTrigrams()
+{
+	// (trigram << 32 | entry) sorted is the whole index, it only needs
+	// splitting into keys and posting lists
+	std::vector<U64> pairs;
+	std::vector<U32> keys;
+	for (U32 i = 0; i < (U32)mEntries.size(); ++i)
+	{
+		const Entry& entry = mEntries[i];
+		if (!entry.mLive || entry.mName.size() < 3)
+		{
+			continue;
+		}
+		keys.clear();
+		for (size_t pos = 0; pos + 3 <= entry.mName.size(); ++pos)
+		{
+			keys.push_back(trigram_at(entry.mName, pos));
+		}
+		std::sort(keys.begin(), keys.end());
+		keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+		for (std::vector<U32>::const_iterator key = keys.begin(); key != keys.end(); ++key)
+		{
+			pairs.push_back(((U64)*key << 32) | i);
+		}
+	}
+	std::sort(pairs.begin(), pairs.end());
+
+	mTrigramKeys.clear();
+	mTrigramOffsets.clear();
+	mTrigramPostings.resize(pairs.size());
+	for (size_t i = 0; i < pairs.size(); ++i)
+	{
+		const U32 key = (U32)(pairs[i] >> 32);
+		if (mTrigramKeys.empty() || mTrigramKeys.back() != key)
+		{
+			mTrigramKeys.push_back(key);
+			mTrigramOffsets.push_back((U32)i);
+		}
+		mTrigramPostings[i] = (U32)pairs[i];
+	}
+	mTrigramOffsets.push_back((U32)pairs.size());
+	mTrigramsDirty = false;
+}
+
+bool PVInventorySearch::collectCandidates(const Query* query, std::vector<U32>& candidates) const
+{
+	// posting lists of every trigram of every term, a match has all of them
+	typedef std::pair<const U32*, const U32*> span_t;
+	std::vector<span_t> spans;
+	for (std::vector<std::string>::const_iterator term = query->mTerms.begin(); term != query->mTerms.end(); ++term)
+	{
+		for (size_t pos = 0; pos + 3 <= term->size(); ++pos)
+		{
+			const U32 key = trigram_at(*term, pos);
+			std::vector<U32>::const_iterator found = std::lower_bound(mTrigramKeys.begin(), mTrigramKeys.end(), key);
+			if (found == mTrigramKeys.end() || *found != key)
+			{
+				candidates.clear();
+				return true;
+			}
+			const size_t k = found - mTrigramKeys.begin();
+			spans.push_back(span_t(&mTrigramPostings[0] + mTrigramOffsets[k], &mTrigramPostings[0] + mTrigramOffsets[k + 1]));
+		}
+	}
+	if (spans.empty())
+	{
+		// every term is shorter than a trigram
+		return false;
+	}
+
+	struct ShorterSpan
+	{
+		bool operator()(const span_t& a, const span_t& b) const { return a.second - a.first < b.second - b.first; }
+	};
+	std::sort(spans.begin(), spans.end(), ShorterSpan());
+
+	candidates.assign(spans[0].first, spans[0].second);
+	std::vector<U32> narrowed;
+	for (size_t i = 1; i < spans.size() && !candidates.empty(); ++i)
+	{
+		narrowed.clear();
+		std::set_intersection(candidates.begin(), candidates.end(), spans[i].first, spans[i].second, std::back_inserter(narrowed));
+		candidates.swap(narrowed);
+	}
+	return true;
+}
+
+void PVInventorySearch::runQuery(Query* query, U32 generation)
+{
+	std::vector<U32> candidates;
+	bool use_candidates = false;
+	if (query->mUseTrigrams && query->mTarget == LLInventoryFilter::SUBST_TARGET_NAME)
+	{
+		if (mTrigramsDirty)
+		{
+			buildTrigrams();
+		}
+		use_candidates = collectCandidates(query, candidates);
+	}
+
+	uuid_vec_t batch;
+	batch.reserve(RESULT_BATCH_SIZE);
+	const U32 count = use_candidates ? (U32)candidates.size() : (U32)mEntries.size();
+	for (U32 i = 0; i < count; ++i)
+	{
+		const Entry& entry = mEntries[use_candidates ? candidates[i] : i];
+		if (entry.mLive && matches(entry, query))
+		{
+			batch.push_back(entry.mID);
+			if (batch.size() == RESULT_BATCH_SIZE)
+			{
+				if (!postResults(query, generation, batch, false))
+				{
+					return;
+				}
+				batch.clear();
+			}
+		}
+	}
+	postResults(query, generation, batch, true);
+}
+
+bool PVInventorySearch::postResults(Query* query, U32 generation, uuid_vec_t& batch, bool done)
+{
+	LLMutexLock lock(&query->mMutex);
+	if (query->mGeneration != generation)
+	{
+		// rerun queued, this pass is stale
+		return false;
+	}
+	query->mIncoming.insert(query->mIncoming.end(), batch.begin(), batch.end());
+	query->mIncomingDone = done;
+	return true;
+}
+
+bool PVInventorySearch::matches(const Entry& entry, const Query* query) const
+{
+	std::string asset_id;
+	const std::string* text = &entry.mName;
+	if (query->mTarget == LLInventoryFilter::SUBST_TARGET_DESCRIPTION)
+	{
+		text = &entry.mDescription;
+	}
+	else if (query->mTarget == LLInventoryFilter::SUBST_TARGET_UUID)
+	{
+		if (entry.mAssetID.notNull())
+		{
+			asset_id = entry.mAssetID.asString();
+			LLStringUtil::toUpper(asset_id);
+		}
+		text = &asset_id;
+	}
+
+	for (std::vector<std::string>::const_iterator term = query->mTerms.begin(); term != query->mTerms.end(); ++term)
+	{
+		if (text->find(*term) == std::string::npos)
+		{
+			return false;
+		}
+	}
+	return true;
+}
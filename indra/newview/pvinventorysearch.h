@@ -0,0 +1,184 @@
+/**
+ * @file pvinventorysearch.h
+ * @brief Inventory substring search on a worker thread (header)
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+#pragma once
+#ifndef PV_INVENTORY_SEARCH_H
+#define PV_INVENTORY_SEARCH_H
+
+#include "llinventoryobserver.h"
+#include "llmutex.h"
+#include "llpointer.h"
+#include "llsingleton.h"
+#include "llthread.h"
+#include "lluuidhashmap.h"
+
+class LLFolderViewModelItemInventory;
+class LLViewerInventoryItem;
+
+// Runs the substring part of LLInventoryFilter::check() off the main thread.
+// The worker keeps its own copy of the names, descriptions and asset ids of
+// every agent and library item, fed by an inventory observer, so it never
+// touches the model. A query scans that copy, or the trigram index of the
+// names when PVInventory_SearchTrigramIndex is on, and posts matching ids
+// back in batches. The filter then only has to look ids up.
+//
+// Only items are indexed, and links are left out since their names follow
+// another item. Anything the index does not cover, folders, task inventory,
+// items with a label suffix, the creator target, is checked the old way.
+class PVInventorySearch : public LLSingleton<PVInventorySearch>
+{
+	LLSINGLETON(PVInventorySearch);
+	~PVInventorySearch();
+
+public:
+	enum EResult
+	{
+		RESULT_UNKNOWN,		// not indexed, check the strings
+		RESULT_PENDING,		// indexed but not reached yet, fails for now
+		RESULT_NO_MATCH,
+		RESULT_MATCH		// still check the strings for the match offsets
+	};
+
+	// main thread record of an indexed item
+	struct IndexedItem
+	{
+		U32		mNameLength;
+		size_t	mHash;		// of the indexed fields, changes to anything else are skipped
+	};
+	typedef LLUUIDHashMap<IndexedItem> indexed_map_t;
+
+	class Query : public LLThreadSafeRefCount
+	{
+		friend class PVInventorySearch;
+
+	public:
+		Query(const indexed_map_t& indexed, const std::vector<std::string>& terms,
+			  S32 target, bool use_trigrams);
+
+		// main thread, moves the worker's results in. Returns the result
+		// version, which changes whenever check() may answer differently.
+		U32 update();
+		const std::vector<std::string>& getTerms() const { return mTerms; }
+		S32 getTarget() const { return mTarget; }
+		bool isComplete() const { return mComplete; }
+		// nothing to show yet, the first run is still going
+		bool isPending() const { return !mComplete && !mHadResults; }
+		EResult check(const LLFolderViewModelItemInventory* listener) const;
+
+	private:
+		const indexed_map_t&			mIndexed;	// the search's, main thread only
+		const std::vector<std::string>	mTerms;
+		const S32						mTarget;	// LLInventoryFilter::EFilterSubstringTarget
+		const bool						mUseTrigrams;
+
+		// main thread
+		LLUUIDHashMap<bool>			mMatches;
+		LLUUIDHashMap<bool>			mNextMatches;	// a rerun collects here so the old results stay up
+		bool						mComplete;
+		bool						mHadResults;
+		U32							mVersion;
+
+		// shared with the worker
+		LLMutex						mMutex;
+		U32							mGeneration;	// bumped on rerun, stale batches are dropped
+		uuid_vec_t					mIncoming;
+		bool						mIncomingDone;
+	};
+
+	// shared query for these terms, NULL when the background search cannot
+	// answer for this target
+	LLPointer<Query> find(const std::vector<std::string>& terms, S32 target);
+
+	// stops the worker, call before exit
+	void cleanup();
+
+private:
+	struct Entry
+	{
+		LLUUID		mID;
+		std::string	mName;			// upper case, like the searchable strings
+		std::string	mDescription;
+		LLUUID		mAssetID;
+		bool		mLive;
+	};
+
+	struct Update
+	{
+		LLUUID		mID;
+		std::string	mName;
+		std::string	mDescription;
+		LLUUID		mAssetID;
+		bool		mRemove;
+	};
+
+	class Observer : public LLInventoryObserver
+	{
+	public:
+		/*virtual*/ void changed(U32 mask);
+	};
+
+	class Worker : public LLThread
+	{
+	public:
+		Worker(PVInventorySearch* search);
+		/*virtual*/ void run();
+
+	private:
+		PVInventorySearch* mSearch;
+	};
+
+	// main thread
+	void seed();
+	void makeUpdate(const LLUUID& id, const LLViewerInventoryItem* item, std::deque<Update>& updates);
+	void post(std::deque<Update>& updates);
+	void rerunQueries();
+	void pruneQueries();
+
+	// worker
+	void applyUpdates(std::deque<Update>& updates);
+	void buildTrigrams();
+	bool collectCandidates(const Query* query, std::vector<U32>& candidates) const;
+	void runQuery(Query* query, U32 generation);
+	bool postResults(Query* query, U32 generation, uuid_vec_t& batch, bool done);
+	bool matches(const Entry& entry, const Query* query) const;
+
+	Worker*							mWorker;
+	Observer*						mObserver;
+	indexed_map_t					mIndexed;			// main thread
+	std::vector<LLPointer<Query> >	mQueries;			// main thread, live queries
+
+	LLCondition						mCondition;			// guards the three below
+	std::deque<Update>				mUpdates;
+	std::deque<LLPointer<Query> >	mPending;
+	bool							mQuitting;
+
+	// worker only
+	std::vector<Entry>				mEntries;
+	std::vector<U32>				mFreeEntries;
+	LLUUIDHashMap<U32>				mEntryIndex;
+	bool							mTrigramsDirty;
+	std::vector<U32>				mTrigramKeys;		// sorted
+	std::vector<U32>				mTrigramOffsets;	// mTrigramKeys.size() + 1 offsets into the postings
+	std::vector<U32>				mTrigramPostings;	// entry indices, sorted per key
+};
+
+#endif // PV_INVENTORY_SEARCH_H
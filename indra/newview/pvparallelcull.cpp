@@ -0,0 +1,156 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/**
+ * @file pvparallelcull.cpp
+ * @brief Walks the spatial and object cache octrees on worker threads (source)
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+#include "llviewerprecompiledheaders.h"
+#include "pvparallelcull.h"
+
+#include "llfasttimer.h"
+
+#include "llviewercontrol.h"
+
+static LLTrace::BlockTimerStatHandle FTM_CULL_PARALLEL_WALK("Parallel Cull Walk");
+static LLTrace::BlockTimerStatHandle FTM_CULL_REPLAY("Parallel Cull Replay");
+
+PVParallelCull::PVParallelCull()
+	: PVWorkerPool("Octree Cull"),
+	  mNumPartitions(0),
+	  mNumTasks(0),
+	  mNextTask(0)
+{
+}
+
+PVParallelCull::~PVParallelCull()
+{
+	cleanupThreads();
+	for (std::vector<LLCamera*>::iterator iter = mCameras.begin(); iter != mCameras.end(); ++iter)
+	{
+		delete *iter;
+	}
+}
+
+bool PVParallelCull::isEnabled() const
+{
+	static LLCachedControl<bool> parallel_cull(gSavedSettings, "PVRender_ParallelCull", true);
+	return parallel_cull && getNumThreads() > 0;
+}
+
+LLCamera* PVParallelCull::copyCamera(const LLCamera& camera)
+{
+	LLCamera* copy = new LLCamera(camera);
+	mCameras.push_back(copy);
+	return copy;
+}
+
+void PVParallelCull::add(LLViewerOctreePartition* partp, LLCamera& camera, bool do_occlusion)
+{
+	LLViewerOctreeCull* culler = partp->beginCull(camera, do_occlusion);
+	if (!culler)
+	{
+		return;
+	}
+
+	if (mNumPartitions == mPartitions.size())
+	{
+		mPartitions.push_back(Partition());
+	}
+	Partition& partition = mPartitions[mNumPartitions++];
+	partition.mPartition = partp;
+	partition.mCuller = culler;
+	partition.mRecords.clear();
+	partition.mFirstTask = mNumTasks;
+	partition.mNumTasks = 0;
+
+	S32 res = 0;
+	culler->record(partp->mOctree, res, partition.mRecords, false);
+	if (!res)
+	{
+		return;
+	}
+
+	// every child starts from the root's result. Serially a sibling can
+	// inherit a reset result from the one before it, which only decides
+	// whether a SKIP_FRUSTUM_CHECK group is tested again, not what is visible.
+	for (U32 i = 0; i < partp->mOctree->getChildCount(); ++i)
+	{
+		if (mNumTasks == mTasks.size())
+		{
+			mTasks.push_back(Task());
+		}
+		Task& task = mTasks[mNumTasks++];
+		task.mCuller = culler;
+		task.mNode = partp->mOctree->getChild(i);
+		task.mRes = res;
+		task.mRecords.clear();
+		++partition.mNumTasks;
+	}
+}
+
+void PVParallelCull::cull()
+{
+	if (mNumTasks > 0)
+	{
+		LL_RECORD_BLOCK_TIME(FTM_CULL_PARALLEL_WALK);
+		mNextTask = 0;
+		runBatch();
+	}
+
+	{
+		LL_RECORD_BLOCK_TIME(FTM_CULL_REPLAY);
+		for (U32 i = 0; i < mNumPartitions; ++i)
+		{
+			Partition& partition = mPartitions[i];
+			LLViewerOctreeCull::record_list_t& records = partition.mRecords;
+			for (U32 t = partition.mFirstTask; t < partition.mFirstTask + partition.mNumTasks; ++t)
+			{
+				records.insert(records.end(), mTasks[t].mRecords.begin(), mTasks[t].mRecords.end());
+			}
+			records.front().mSubtreeSize = (U32)records.size();
+
+			partition.mCuller->replay(records);
+			delete partition.mCuller;
+			partition.mCuller = NULL;
+			partition.mPartition->finishCull();
+		}
+	}
+
+	mNumPartitions = 0;
+	mNumTasks = 0;
+	for (std::vector<LLCamera*>::iterator iter = mCameras.begin(); iter != mCameras.end(); ++iter)
+	{
+		delete *iter;
+	}
+	mCameras.clear();
+}
+
+//virtual
+void PVParallelCull::processBatch()
+{
+	const U32 count = mNumTasks;
+	for (U32 i = mNextTask++; i < count; i = mNextTask++)
+	{
+		Task& task = mTasks[i];
+		S32 res = task.mRes;
+		task.mCuller->record(task.mNode, res, task.mRecords);
+	}
+}
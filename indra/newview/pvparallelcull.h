@@ -0,0 +1,84 @@
+/**
+ * @file pvparallelcull.h
+ * @brief Walks the spatial and object cache octrees on worker threads (header)
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+#pragma once
+#ifndef PV_PARALLEL_CULL_H
+#define PV_PARALLEL_CULL_H
+
+#include "llatomic.h"
+#include "llsingleton.h"
+#include "llvieweroctree.h"
+#include "pvworkerpool.h"
+
+// LLPipeline::updateCull() hands every partition it would cull to add()
+// instead. Each partition's root is checked on the main thread and its
+// children become separate tasks, so one big volume tree does not end up on
+// a single worker. The workers only run the frustum math and record what
+// they decided into their task's list; cull() then merges the lists back
+// into traversal order and replays them on the main thread, where the
+// occlusion queries, markNotCulled() and friends happen exactly as the
+// serial walk would have done them.
+class PVParallelCull : public LLSingleton<PVParallelCull>, public PVWorkerPool
+{
+	LLSINGLETON(PVParallelCull);
+	~PVParallelCull();
+
+public:
+	// true when the setting is on and there are workers to use
+	bool isEnabled() const;
+
+	// the pipeline keeps changing its camera between regions, so every
+	// region gets a copy that outlives the walk
+	LLCamera* copyCamera(const LLCamera& camera);
+	void add(LLViewerOctreePartition* partp, LLCamera& camera, bool do_occlusion);
+	void cull();
+
+private:
+	struct Task
+	{
+		LLViewerOctreeCull*					mCuller;
+		const OctreeNode*					mNode;
+		S32									mRes;
+		LLViewerOctreeCull::record_list_t	mRecords;
+	};
+
+	struct Partition
+	{
+		LLViewerOctreePartition*			mPartition;
+		LLViewerOctreeCull*					mCuller;
+		LLViewerOctreeCull::record_list_t	mRecords;	// the root, then the merged tasks
+		U32									mFirstTask;
+		U32									mNumTasks;
+	};
+
+	/*virtual*/ void processBatch();
+
+	// the lists keep their capacity from frame to frame, only the counts reset
+	std::vector<Partition>	mPartitions;
+	U32						mNumPartitions;
+	std::vector<Task>		mTasks;
+	U32						mNumTasks;
+	LLAtomic32<U32>			mNextTask;
+	std::vector<LLCamera*>	mCameras;
+};
+
+#endif // PV_PARALLEL_CULL_H
@@ -0,0 +1,291 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/**
+ * @file pvstartuppipeline.cpp
+ * @brief Runs independent startup stages on worker threads
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+#include "pvstartuppipeline.h"
+
+#include <algorithm>
+
+#include <boost/bind.hpp>
+
+#include "lltimer.h"
+
+namespace
+{
+	bool run_always(const boost::function<void()>& func)
+	{
+		func();
+		return true;
+	}
+
+	bool sort_by_start(const std::pair<F64, std::string>& a, const std::pair<F64, std::string>& b)
+	{
+		return a.first < b.first;
+	}
+}
+
+PVStartupPipeline::PVStartupPipeline(const std::string& name)
+	: PVWorkerPool(name),
+	  mPipelineName(name),
+	  mUnfinished(0),
+	  mRunStart(0.0),
+	  mRunTime(0.0),
+	  mThreadsUsed(1)
+{
+}
+
+PVStartupPipeline::~PVStartupPipeline()
+{
+	cleanupThreads();
+}
+
+PVStartupPipeline::stage_t PVStartupPipeline::addStage(const std::string& name, EThread thread, const stage_func_t& func,
+													   const stage_list_t& depends_on)
+{
+	const stage_t stage = (stage_t)mStages.size();
+	mStages.push_back(Stage());
+	Stage& new_stage = mStages.back();
+	new_stage.mName = name;
+	new_stage.mThread = thread;
+	new_stage.mFunc = func;
+	new_stage.mDependsOn = depends_on;
+	new_stage.mPending = (U32)depends_on.size();
+	new_stage.mState = STAGE_WAITING;
+	new_stage.mOnMainThread = true;
+	new_stage.mReadyTime = new_stage.mStartTime = new_stage.mEndTime = 0.0;
+
+	for (stage_list_t::const_iterator iter = depends_on.begin(); iter != depends_on.end(); ++iter)
+	{
+		// only earlier stages, so there can't be a cycle
+		llassert_always(*iter < stage);
+		mStages[*iter].mDependents.push_back(stage);
+	}
+	return stage;
+}
+
+PVStartupPipeline::stage_t PVStartupPipeline::addStage(const std::string& name, EThread thread, const stage_func_t& func,
+													   stage_t depends_on)
+{
+	return addStage(name, thread, func, stage_list_t(1, depends_on));
+}
+
+// static
+PVStartupPipeline::stage_func_t PVStartupPipeline::always(const boost::function<void()>& func)
+{
+	return boost::bind(&run_always, func);
+}
+
+bool PVStartupPipeline::run(bool parallel)
+{
+	mMainThreadID = LLThread::currentID();
+
+	// no point in more workers than there are stages they can take
+	U32 any_stages = 0;
+	for (std::vector<Stage>::const_iterator iter = mStages.begin(); iter != mStages.end(); ++iter)
+	{
+		any_stages += iter->mThread == ANY_THREAD ? 1 : 0;
+	}
+	const U32 hardware_threads = boost::thread::hardware_concurrency();
+	const U32 num_threads = parallel ? llmin(any_stages, hardware_threads > 1 ? hardware_threads - 1 : 0) : 0;
+	if (num_threads)
+	{
+		initThreads(num_threads);
+	}
+	mThreadsUsed = getNumThreads() + 1;
+
+	mQueueCondition.lock();
+	mRunStart = LLTimer::getTotalSeconds();
+	mUnfinished = (U32)mStages.size();
+	for (stage_t stage = 0; stage < mStages.size(); ++stage)
+	{
+		if (!mStages[stage].mPending)
+		{
+			makeReady(stage);
+		}
+	}
+	mQueueCondition.unlock();
+
+	runBatch();
+	cleanupThreads();
+	mRunTime = LLTimer::getTotalSeconds() - mRunStart;
+
+	bool success = true;
+	for (std::vector<Stage>::const_iterator iter = mStages.begin(); iter != mStages.end(); ++iter)
+	{
+		success = success && iter->mState == STAGE_SUCCEEDED;
+	}
+	return success;
+}
+
+//virtual
+void PVStartupPipeline::processBatch()
+{
+	const bool main_thread = LLThread::currentID() == mMainThreadID;
+
+	mQueueCondition.lock();
+	stage_t stage;
+	while (takeStage(main_thread, stage))
+	{
+		// mStages doesn't change size while running, the reference stays good
+		Stage& current = mStages[stage];
+		current.mState = STAGE_RUNNING;
+		current.mOnMainThread = main_thread;
+		current.mStartTime = LLTimer::getTotalSeconds() - mRunStart;
+		mQueueCondition.unlock();
+
+		const bool success = current.mFunc();
+
+		mQueueCondition.lock();
+		current.mEndTime = LLTimer::getTotalSeconds() - mRunStart;
+		finishStage(stage, success ? STAGE_SUCCEEDED : STAGE_FAILED);
+		mQueueCondition.broadcast();
+	}
+	mQueueCondition.unlock();
+}
+
+bool PVStartupPipeline::takeStage(bool main_thread, stage_t& stage)
+{
+	while (true)
+	{
+		// the main thread sees to its own stages first, they can't go elsewhere
+		if (main_thread && !mMainQueue.empty())
+		{
+			stage = mMainQueue.front();
+			mMainQueue.pop_front();
+			return true;
+		}
+		if (!mAnyQueue.empty())
+		{
+			stage = mAnyQueue.front();
+			mAnyQueue.pop_front();
+			return true;
+		}
+		if (!mUnfinished)
+		{
+			return false;
+		}
+		mQueueCondition.wait();
+	}
+}
+
+void PVStartupPipeline::makeReady(stage_t stage)
+{
+	Stage& ready = mStages[stage];
+	ready.mState = STAGE_READY;
+	ready.mReadyTime = LLTimer::getTotalSeconds() - mRunStart;
+	(ready.mThread == MAIN_THREAD ? mMainQueue : mAnyQueue).push_back(stage);
+}
+
+void PVStartupPipeline::finishStage(stage_t stage, EState state)
+{
+	Stage& finished = mStages[stage];
+	finished.mState = state;
+	--mUnfinished;
+
+	for (stage_list_t::const_iterator iter = finished.mDependents.begin(); iter != finished.mDependents.end(); ++iter)
+	{
+		Stage& dependent = mStages[*iter];
+		if (state != STAGE_SUCCEEDED)
+		{
+			dependent.mState = STAGE_SKIPPED;
+		}
+		if (--dependent.mPending)
+		{
+			continue;
+		}
+		if (dependent.mState == STAGE_SKIPPED)
+		{
+			dependent.mReadyTime = dependent.mStartTime = dependent.mEndTime = finished.mEndTime;
+			finishStage(*iter, STAGE_SKIPPED);
+		}
+		else
+		{
+			makeReady(*iter);
+		}
+	}
+}
+
+void PVStartupPipeline::logTimings() const
+{
+	F64 total_stage_time = 0.0;
+	std::vector<std::pair<F64, std::string> > lines;
+	for (std::vector<Stage>::const_iterator iter = mStages.begin(); iter != mStages.end(); ++iter)
+	{
+		const F64 duration = iter->mEndTime - iter->mStartTime;
+		total_stage_time += duration;
+		const char* state = iter->mState == STAGE_FAILED ? " FAILED" : iter->mState == STAGE_SKIPPED ? " skipped" : "";
+		lines.push_back(std::make_pair(iter->mStartTime,
+			llformat("%9.1f ms %9.1f ms  waited %7.1f ms  %-6s %s%s",
+					 iter->mStartTime * 1000.0, duration * 1000.0, (iter->mStartTime - iter->mReadyTime) * 1000.0,
+					 iter->mOnMainThread ? "main" : "worker", iter->mName.c_str(), state)));
+	}
+	std::stable_sort(lines.begin(), lines.end(), sort_by_start);
+
+	LL_INFOS("StartupPipeline") << mPipelineName << ": " << mStages.size() << " stages took "
+								<< llformat("%.1f", mRunTime * 1000.0) << " ms on " << mThreadsUsed << " threads, "
+								<< llformat("%.1f", total_stage_time * 1000.0) << " ms when run one after the other" << LL_ENDL;
+	LL_INFOS("StartupPipeline") << "     start      time                     thread stage" << LL_ENDL;
+	for (std::vector<std::pair<F64, std::string> >::const_iterator iter = lines.begin(); iter != lines.end(); ++iter)
+	{
+		LL_INFOS("StartupPipeline") << iter->second << LL_ENDL;
+	}
+
+	// Walk back from the stage that finished last through whichever stage it
+	// depended on finished last. A stage that waited with no such stage was
+	// held up by the main thread running the ones before it.
+	if (mStages.empty())
+	{
+		return;
+	}
+	stage_t last = 0;
+	for (stage_t stage = 1; stage < mStages.size(); ++stage)
+	{
+		if (mStages[stage].mEndTime > mStages[last].mEndTime)
+		{
+			last = stage;
+		}
+	}
+	std::string path;
+	for (stage_t stage = last; ; )
+	{
+		const Stage& current = mStages[stage];
+		path = llformat("%s (%.1f ms)", current.mName.c_str(), (current.mEndTime - current.mStartTime) * 1000.0)
+			   + (path.empty() ? "" : " > ") + path;
+		if (current.mDependsOn.empty())
+		{
+			break;
+		}
+		stage_t latest = current.mDependsOn.front();
+		for (stage_list_t::const_iterator iter = current.mDependsOn.begin(); iter != current.mDependsOn.end(); ++iter)
+		{
+			if (mStages[*iter].mEndTime > mStages[latest].mEndTime)
+			{
+				latest = *iter;
+			}
+		}
+		stage = latest;
+	}
+	LL_INFOS("StartupPipeline") << "Critical path: " << path << LL_ENDL;
+}
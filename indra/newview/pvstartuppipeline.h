@@ -0,0 +1,121 @@
+/**
+ * @file pvstartuppipeline.h
+ * @brief Runs independent startup stages on worker threads (header)
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+#pragma once
+#ifndef PV_STARTUP_PIPELINE_H
+#define PV_STARTUP_PIPELINE_H
+
+#include <deque>
+
+#include <boost/function.hpp>
+
+#include "pvworkerpool.h"
+
+// A small dependency graph of startup stages. run() starts each stage as
+// soon as the stages it depends on are done: MAIN_THREAD stages on the
+// calling thread, in the order they were added, ANY_THREAD stages on
+// whichever thread is free, the calling thread included. A stage that
+// returns false or depends on one that did is not run, the rest still are.
+//
+// ANY_THREAD stages must leave the settings and the UI alone, neither is
+// thread safe; anything parsed through LLXMLNode or LLXUIParser belongs on
+// the main thread.
+//
+// Every run logs when each stage became ready, started and finished, and
+// the chain of stages that decided how long the whole run took.
+class PVStartupPipeline : public PVWorkerPool
+{
+public:
+	enum EThread
+	{
+		MAIN_THREAD,
+		ANY_THREAD
+	};
+
+	typedef U32 stage_t;
+	typedef std::vector<stage_t> stage_list_t;
+	typedef boost::function<bool()> stage_func_t;
+
+	PVStartupPipeline(const std::string& name);
+	~PVStartupPipeline();
+
+	// depends_on only takes stages that were added before
+	stage_t addStage(const std::string& name, EThread thread, const stage_func_t& func,
+					 const stage_list_t& depends_on = stage_list_t());
+	stage_t addStage(const std::string& name, EThread thread, const stage_func_t& func, stage_t depends_on);
+
+	// for stages whose result nobody checked before they were stages
+	static stage_func_t always(const boost::function<void()>& func);
+
+	// false when a stage failed or was skipped. parallel false runs every
+	// stage on this thread, for comparing timings.
+	bool run(bool parallel);
+	bool succeeded(stage_t stage) const		{ return mStages[stage].mState == STAGE_SUCCEEDED; }
+
+	void logTimings() const;
+
+private:
+	enum EState
+	{
+		STAGE_WAITING,
+		STAGE_READY,
+		STAGE_RUNNING,
+		STAGE_SUCCEEDED,
+		STAGE_FAILED,
+		STAGE_SKIPPED
+	};
+
+	struct Stage
+	{
+		std::string		mName;
+		EThread			mThread;
+		stage_func_t	mFunc;
+		stage_list_t	mDependsOn;
+		stage_list_t	mDependents;
+		U32				mPending;		// unfinished stages this one depends on
+		EState			mState;
+		bool			mOnMainThread;
+		F64				mReadyTime;		// seconds since run() started
+		F64				mStartTime;
+		F64				mEndTime;
+	};
+
+	/*virtual*/ void processBatch();
+
+	// under mQueueCondition
+	bool takeStage(bool main_thread, stage_t& stage);
+	void makeReady(stage_t stage);
+	void finishStage(stage_t stage, EState state);
+
+	std::string			mPipelineName;
+	std::vector<Stage>	mStages;
+	boost::thread::id	mMainThreadID;
+	LLCondition			mQueueCondition;	// guards everything below and the stage states
+	std::deque<stage_t>	mMainQueue;
+	std::deque<stage_t>	mAnyQueue;
+	U32					mUnfinished;
+	F64					mRunStart;
+	F64					mRunTime;
+	U32					mThreadsUsed;
+};
+
+#endif // PV_STARTUP_PIPELINE_H
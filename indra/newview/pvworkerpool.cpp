@@ -0,0 +1,155 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/**
+ * @file pvworkerpool.cpp
+ * @brief Fixed set of worker threads that join the main thread on a batch (source)
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+#include "llviewerprecompiledheaders.h"
+#include "pvworkerpool.h"
+
+#include "lltracethreadrecorder.h"
+
+static const U32 MAX_WORKER_THREADS = 8;
+
+//----------------------------------------------------------------------------
+// Worker
+//----------------------------------------------------------------------------
+PVWorkerPool::Worker::Worker(PVWorkerPool* pool, U32 index, U32 generation)
+	: LLThread(llformat("%s %u", pool->mName.c_str(), index)),
+	  mPool(pool),
+	  mStartGeneration(generation)
+{
+}
+
+//virtual
+void PVWorkerPool::Worker::run()
+{
+	U32 generation = mStartGeneration;
+	while (mPool->waitForBatch(generation))
+	{
+		mPool->processBatch();
+		LLTrace::get_thread_recorder()->pushToParent();
+
+		mPool->mDoneCondition.lock();
+		++mPool->mWorkersDone;
+		mPool->mDoneCondition.signal();
+		mPool->mDoneCondition.unlock();
+	}
+	LL_INFOS("WorkerPool") << mName << " exiting." << LL_ENDL;
+}
+
+//----------------------------------------------------------------------------
+// PVWorkerPool
+//----------------------------------------------------------------------------
+PVWorkerPool::PVWorkerPool(const std::string& name)
+	: mName(name),
+	  mGeneration(0),
+	  mQuitting(false),
+	  mWorkersDone(0)
+{
+}
+
+PVWorkerPool::~PVWorkerPool()
+{
+	// subclasses must have stopped the workers already, processBatch() is
+	// pure virtual by the time we get here
+	llassert(mWorkers.empty());
+	cleanupThreads();
+}
+
+void PVWorkerPool::initThreads(U32 num_threads)
+{
+	cleanupThreads();
+
+	if (num_threads == 0)
+	{
+		const U32 hardware_threads = boost::thread::hardware_concurrency();
+		num_threads = hardware_threads > 1 ? hardware_threads - 1 : 0;
+	}
+	num_threads = llmin(num_threads, MAX_WORKER_THREADS);
+
+	// a re-initialized pool has counted batches already, workers starting
+	// at 0 would take the last one for a new one and run it again
+	mStartCondition.lock();
+	mQuitting = false;
+	const U32 generation = mGeneration;
+	mStartCondition.unlock();
+	for (U32 i = 0; i < num_threads; ++i)
+	{
+		Worker* worker = new Worker(this, i, generation);
+		worker->start();
+		mWorkers.push_back(worker);
+	}
+	LL_INFOS("WorkerPool") << "Started " << num_threads << " " << mName << " threads" << LL_ENDL;
+}
+
+void PVWorkerPool::cleanupThreads()
+{
+	if (mWorkers.empty())
+	{
+		return;
+	}
+
+	mStartCondition.lock();
+	mQuitting = true;
+	mStartCondition.broadcast();
+	mStartCondition.unlock();
+
+	for (std::vector<Worker*>::iterator iter = mWorkers.begin(); iter != mWorkers.end(); ++iter)
+	{
+		(*iter)->shutdown();
+		delete *iter;
+	}
+	mWorkers.clear();
+}
+
+void PVWorkerPool::runBatch()
+{
+	mDoneCondition.lock();
+	mWorkersDone = 0;
+	mDoneCondition.unlock();
+
+	mStartCondition.lock();
+	++mGeneration;
+	mStartCondition.broadcast();
+	mStartCondition.unlock();
+
+	// the main thread takes its share instead of idling at the join
+	processBatch();
+
+	mDoneCondition.lock();
+	while (mWorkersDone < mWorkers.size())
+	{
+		mDoneCondition.wait();
+	}
+	mDoneCondition.unlock();
+}
+
+bool PVWorkerPool::waitForBatch(U32& generation)
+{
+	LLMutexLock lock(&mStartCondition);
+	while (!mQuitting && mGeneration == generation)
+	{
+		mStartCondition.wait();
+	}
+	generation = mGeneration;
+	return !mQuitting;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file pvworkerpool.h
+ * @brief Fixed set of worker threads that join the main thread on a batch (header)
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+#pragma once
+#ifndef PV_WORKER_POOL_H
+#define PV_WORKER_POOL_H
+
+#include "llmutex.h"
+#include "llthread.h"
+
+// Base for the main-thread fork/join pools. runBatch() wakes every worker,
+// runs processBatch() on them and on the calling thread, and returns once
+// all of them are done. Subclasses hand out their own work items from
+// processBatch(), usually through an atomic index.
+class PVWorkerPool
+{
+public:
+	PVWorkerPool(const std::string& name);
+	virtual ~PVWorkerPool();
+
+	// 0 worker threads picks one less than the number of hardware threads
+	void initThreads(U32 num_threads);
+	void cleanupThreads();
+	U32 getNumThreads() const { return (U32)mWorkers.size(); }
+
+protected:
+	void runBatch();
+	virtual void processBatch() = 0;
+
+private:
+	class Worker : public LLThread
+	{
+	public:
+		Worker(PVWorkerPool* pool, U32 index, U32 generation);
+		/*virtual*/ void run();
+
+	private:
+		PVWorkerPool*	mPool;
+		const U32		mStartGeneration;	// the pool's batch count when this worker was made
+	};
+
+	bool waitForBatch(U32& generation);
+
+	std::string				mName;
+	std::vector<Worker*>	mWorkers;
+
+	LLCondition				mStartCondition;	// guards mGeneration and mQuitting
+	U32						mGeneration;
+	bool					mQuitting;
+	LLCondition				mDoneCondition;		// guards mWorkersDone
+	U32						mWorkersDone;
+};
+
+#endif // PV_WORKER_POOL_H
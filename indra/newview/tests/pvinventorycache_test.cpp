@@ -0,0 +1,280 @@
+// This is an open source non-commercial project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/**
+ * @file pvinventorycache_test.cpp
+ * @brief Round trips through the binary inventory cache file
+ *
+ * $LicenseInfo:firstyear=2018&license=viewerlgpl$
+ * Polarity Viewer Source Code
+ * Copyright (C) 2018 Xenhat Liamano
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * The Polarity Viewer Project
+ * http://www.polarityviewer.org
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include <boost/signals2.hpp>
+
+#include "../pvinventorycache.h"
+
+#include "../llviewerinventory.h"
+#include "llfile.h"
+
+#include "../test/lltut.h"
+#include "../test/namedtempfile.h"
+
+//----------------------------------------------------------------------------
+// Stubs: the cache only builds the viewer classes and reads them through
+// their LLInventoryItem/LLInventoryCategory parts.
+//----------------------------------------------------------------------------
+const S32 LLInventoryModel::sCurrentInvCacheVersion = 2;
+
+LLViewerInventoryItem::LLViewerInventoryItem(const LLUUID& uuid, const LLUUID& parent_uuid,
+											 const LLPermissions& permissions,
+											 const LLUUID& asset_uuid,
+											 LLAssetType::EType type,
+											 LLInventoryType::EType inv_type,
+											 const std::string& name,
+											 const std::string& desc,
+											 const LLSaleInfo& sale_info,
+											 U32 flags,
+											 time_t creation_date_utc)
+:	LLInventoryItem(uuid, parent_uuid, permissions, asset_uuid, type, inv_type,
+					name, desc, sale_info, flags, creation_date_utc),
+	mIsComplete(TRUE)
+{
+}
+LLViewerInventoryItem::~LLViewerInventoryItem() {}
+LLAssetType::EType LLViewerInventoryItem::getType() const { return LLInventoryItem::getType(); }
+const LLUUID& LLViewerInventoryItem::getAssetUUID() const { return LLInventoryItem::getAssetUUID(); }
+const LLUUID& LLViewerInventoryItem::getProtectedAssetUUID() const { return LLInventoryItem::getAssetUUID(); }
+const std::string& LLViewerInventoryItem::getName() const { return LLInventoryItem::getName(); }
+S32 LLViewerInventoryItem::getSortField() const { return 0; }
+void LLViewerInventoryItem::getSLURL() {}
+const LLPermissions& LLViewerInventoryItem::getPermissions() const { return LLInventoryItem::getPermissions(); }
+const bool LLViewerInventoryItem::getIsFullPerm() const { return false; }
+const LLUUID& LLViewerInventoryItem::getCreatorUUID() const { return LLInventoryItem::getCreatorUUID(); }
+const std::string& LLViewerInventoryItem::getDescription() const { return LLInventoryItem::getDescription(); }
+const LLSaleInfo& LLViewerInventoryItem::getSaleInfo() const { return LLInventoryItem::getSaleInfo(); }
+LLInventoryType::EType LLViewerInventoryItem::getInventoryType() const { return LLInventoryItem::getInventoryType(); }
+bool LLViewerInventoryItem::isWearableType() const { return false; }
+LLWearableType::EType LLViewerInventoryItem::getWearableType() const { return LLWearableType::WT_INVALID; }
+U32 LLViewerInventoryItem::getFlags() const { return LLInventoryItem::getFlags(); }
+time_t LLViewerInventoryItem::getCreationDate() const { return LLInventoryItem::getCreationDate(); }
+U32 LLViewerInventoryItem::getCRC32() const { return LLInventoryItem::getCRC32(); }
+void LLViewerInventoryItem::copyItem(const LLInventoryItem* other) { LLInventoryItem::copyItem(other); }
+void LLViewerInventoryItem::updateParentOnServer(BOOL restamp) const {}
+void LLViewerInventoryItem::updateServer(BOOL is_new) const {}
+void LLViewerInventoryItem::packMessage(LLMessageSystem* msg) const {}
+BOOL LLViewerInventoryItem::unpackMessage(LLMessageSystem* msg, const char* block, S32 block_num) { return FALSE; }
+BOOL LLViewerInventoryItem::unpackMessage(const LLSD& item) { return FALSE; }
+BOOL LLViewerInventoryItem::importFile(LLFILE* fp) { return FALSE; }
+BOOL LLViewerInventoryItem::importLegacyStream(std::istream& input_stream) { return FALSE; }
+void LLViewerInventoryItem::setTransactionID(const LLTransactionID& transaction_id) {}
+
+LLViewerInventoryCategory::LLViewerInventoryCategory(const LLUUID& uuid, const LLUUID& parent_uuid,
+													 LLFolderType::EType preferred_type,
+													 const std::string& name,
+													 const LLUUID& owner_id)
+:	LLInventoryCategory(uuid, parent_uuid, preferred_type, name),
+	mOwnerID(owner_id),
+	mVersion(VERSION_UNKNOWN),
+	mDescendentCount(DESCENDENT_COUNT_UNKNOWN)
+{
+}
+LLViewerInventoryCategory::~LLViewerInventoryCategory() {}
+void LLViewerInventoryCategory::updateParentOnServer(BOOL restamp_children) const {}
+void LLViewerInventoryCategory::updateServer(BOOL is_new) const {}
+void LLViewerInventoryCategory::packMessage(LLMessageSystem* msg) const {}
+void LLViewerInventoryCategory::unpackMessage(LLMessageSystem* msg, const char* block, S32 block_num) {}
+BOOL LLViewerInventoryCategory::unpackMessage(const LLSD& category) { return FALSE; }
+S32 LLViewerInventoryCategory::getVersion() const { return mVersion; }
+void LLViewerInventoryCategory::setVersion(S32 version) { mVersion = version; }
+
+//----------------------------------------------------------------------------
+namespace
+{
+	LLViewerInventoryItem* make_item(const LLUUID& parent_id, const std::string& name, const std::string& desc,
+									 PermissionMask base_mask, bool group_owned)
+	{
+		LLPermissions perm;
+		perm.init(LLUUID::generateNewID(), LLUUID::generateNewID(), LLUUID::generateNewID(),
+				  group_owned ? LLUUID::generateNewID() : LLUUID::null);
+		if (group_owned)
+		{
+			perm.yesReallySetOwner(perm.getGroup(), true);
+		}
+		perm.initMasks(base_mask, base_mask & PERM_ITEM_UNRESTRICTED, PERM_NONE, PERM_COPY, PERM_TRANSFER);
+		return new LLViewerInventoryItem(LLUUID::generateNewID(), parent_id, perm, LLUUID::generateNewID(),
+										 LLAssetType::AT_OBJECT, LLInventoryType::IT_OBJECT, name, desc,
+										 LLSaleInfo(LLSaleInfo::FS_COPY, 25), 0x1234, 1500000000);
+	}
+
+	void write_file(const std::string& filename, const std::string& contents)
+	{
+		llofstream file(filename.c_str(), std::ios::out | std::ios::binary);
+		file << contents;
+	}
+
+	std::string read_file(const std::string& filename)
+	{
+		llifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+		return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	}
+}
+
+namespace tut
+{
+	struct pvinventorycache_data
+	{
+		pvinventorycache_data()
+		:	mTempFile("pvinventorycache", "")
+		{
+			mFilename = mTempFile.getName();
+			LLFile::remove(mFilename);
+		}
+
+		~pvinventorycache_data()
+		{
+			LLFile::remove(mFilename, ENOENT);
+		}
+
+		void save()
+		{
+			PVInventoryCache::instance().save(mFilename, mCategories, mItems);
+			PVInventoryCache::instance().flush();
+		}
+
+		bool load(bool& is_cache_obsolete)
+		{
+			mLoadedCategories.clear();
+			mLoadedItems.clear();
+			return PVInventoryCache::load(mFilename, mLoadedCategories, mLoadedItems, is_cache_obsolete);
+		}
+
+		NamedTempFile mTempFile;
+		std::string mFilename;
+		LLInventoryModel::cat_array_t mCategories;
+		LLInventoryModel::item_array_t mItems;
+		LLInventoryModel::cat_array_t mLoadedCategories;
+		LLInventoryModel::item_array_t mLoadedItems;
+	};
+	typedef test_group<pvinventorycache_data> pvinventorycache_group;
+	typedef pvinventorycache_group::object object;
+	pvinventorycache_group pvinventorycachegrp("PVInventoryCache");
+
+	template<> template<>
+	void object::test<1>()
+	{
+		set_test_name("categories and items come back as they were written");
+
+		const LLUUID owner_id = LLUUID::generateNewID();
+		LLPointer<LLViewerInventoryCategory> root = new LLViewerInventoryCategory(
+			LLUUID::generateNewID(), LLUUID::null, LLFolderType::FT_ROOT_INVENTORY, "My Inventory", owner_id);
+		root->setVersion(12);
+		LLPointer<LLViewerInventoryCategory> objects = new LLViewerInventoryCategory(
+			LLUUID::generateNewID(), root->getUUID(), LLFolderType::FT_OBJECT, "Objects", owner_id);
+		objects->setVersion(3);
+		// never fetched, not cached
+		LLPointer<LLViewerInventoryCategory> unknown = new LLViewerInventoryCategory(
+			LLUUID::generateNewID(), root->getUUID(), LLFolderType::FT_NONE, "Unknown", owner_id);
+		mCategories.push_back(root);
+		mCategories.push_back(objects);
+		mCategories.push_back(unknown);
+
+		mItems.push_back(make_item(objects->getUUID(), "Box", "", PERM_ALL, false));
+		// same name, shares a string in the pool
+		mItems.push_back(make_item(objects->getUUID(), "Box", "no copy", PERM_ALL & ~PERM_COPY, false));
+		mItems.push_back(make_item(objects->getUUID(), "Group box", "owned by a group", PERM_ALL, true));
+
+		save();
+		bool is_cache_obsolete = true;
+		ensure("loaded", load(is_cache_obsolete));
+		ensure("current", !is_cache_obsolete);
+
+		ensure_equals("categories", mLoadedCategories.size(), (size_t)2);
+		for (size_t i = 0; i < 2; ++i)
+		{
+			const LLViewerInventoryCategory* written = mCategories[i];
+			const LLViewerInventoryCategory* read = mLoadedCategories[i];
+			ensure_equals("category id", read->getUUID(), written->getUUID());
+			ensure_equals("category parent", read->getParentUUID(), written->getParentUUID());
+			ensure_equals("category owner", read->getOwnerID(), written->getOwnerID());
+			ensure_equals("category name", read->getName(), written->getName());
+			ensure_equals("category type", read->getPreferredType(), written->getPreferredType());
+			ensure_equals("category version", read->getVersion(), written->getVersion());
+		}
+
+		ensure_equals("items", mLoadedItems.size(), mItems.size());
+		for (size_t i = 0; i < mItems.size(); ++i)
+		{
+			const LLViewerInventoryItem* written = mItems[i];
+			const LLViewerInventoryItem* read = mLoadedItems[i];
+			ensure_equals("item id", read->getUUID(), written->getUUID());
+			ensure_equals("item parent", read->getParentUUID(), written->getParentUUID());
+			ensure_equals("item name", read->getName(), written->getName());
+			ensure_equals("item description", read->getDescription(), written->getDescription());
+			ensure_equals("item asset", read->getAssetUUID(), written->getAssetUUID());
+			ensure("item permissions", read->getPermissions() == written->getPermissions());
+			ensure_equals("item group owned", read->getPermissions().isGroupOwned(), written->getPermissions().isGroupOwned());
+			ensure("item sale info", read->getSaleInfo() == written->getSaleInfo());
+			ensure_equals("item type", read->getType(), written->getType());
+			ensure_equals("item inventory type", read->getInventoryType(), written->getInventoryType());
+			ensure_equals("item flags", read->getFlags(), written->getFlags());
+			ensure_equals("item creation date", read->getCreationDate(), written->getCreationDate());
+			ensure("item still to fetch", !read->isFinished());
+		}
+
+		// restricted asset ids are not stored in the clear
+		const std::string contents = read_file(mFilename);
+		const LLUUID& restricted = mItems[1]->getAssetUUID();
+		const LLUUID& unrestricted = mItems[0]->getAssetUUID();
+		ensure("shadowed", contents.find(std::string((const char*)restricted.mData, UUID_BYTES)) == std::string::npos);
+		ensure("in the clear", contents.find(std::string((const char*)unrestricted.mData, UUID_BYTES)) != std::string::npos);
+		ensure("no temporary file left", !LLFile::isfile(mFilename + ".tmp"));
+	}
+
+	template<> template<>
+	void object::test<2>()
+	{
+		set_test_name("damaged or foreign files are not loaded");
+
+		bool is_cache_obsolete = true;
+		ensure("missing", !load(is_cache_obsolete));
+		ensure("missing is not obsolete", !is_cache_obsolete);
+
+		mItems.push_back(make_item(LLUUID::generateNewID(), "Box", "a box", PERM_ALL, false));
+		save();
+		const std::string contents = read_file(mFilename);
+		ensure("saved", load(is_cache_obsolete));
+
+		write_file(mFilename, contents.substr(0, contents.size() - 1));
+		ensure("truncated", !load(is_cache_obsolete));
+		ensure("truncated is obsolete", is_cache_obsolete);
+		ensure("nothing kept", mLoadedItems.empty());
+
+		std::string other_version = contents;
+		other_version[4] ^= 0x7f;		// mFormatVersion
+		write_file(mFilename, other_version);
+		ensure("other format version", !load(is_cache_obsolete));
+		ensure("other format version is obsolete", is_cache_obsolete);
+
+		std::string bad_name = contents;
+		bad_name[32 + 144 + 3] = (char)0xff;	// in the item's mNameOffset, past the pool
+		write_file(mFilename, bad_name);
+		ensure("name out of the pool", !load(is_cache_obsolete));
+		ensure("nothing kept from a corrupt file", mLoadedItems.empty());
+	}
+}
@@ -53,6 +53,7 @@
 #include "lltut.h"
 #include "catch_and_store_what_in.h"
 #include "stringize.h"
+#include "lltimer.h" // <polarity/>
 
 template<typename T>
 T make(const T& value)
@@ -721,4 +722,150 @@ ensure("implicit disconnect", ! connection.connected());
 heaptest.post(2);
 #endif // 0
 }
+
+// <polarity> Flat event dispatch
+struct CountingListener
+{
+	CountingListener(): mCalls(0), mLast(0) {}
+	bool call(const LLSD& event)
+	{
+		++mCalls;
+		mLast = event.asInteger();
+		return false;
+	}
+	S32 mCalls;
+	S32 mLast;
+};
+
+bool recordOrder(std::string* order, const std::string& name, const LLSD&)
+{
+	*order += name;
+	return false;
+}
+
+struct CopyCounter
+{
+	CopyCounter() { ++sCopies; }
+	CopyCounter(const CopyCounter&) { ++sCopies; }
+	~CopyCounter() { --sCopies; }
+	bool operator()(const LLSD&) const { return false; }
+	static S32 sCopies;
+};
+S32 CopyCounter::sCopies = 0;
+
+bool connectDuringPost(LLEventPump* pump, std::string* order, const LLSD&)
+{
+	// must not see the event that is being posted
+	if (!pump->getListener("late").connected())
+	{
+		pump->listen("late", boost::bind(recordOrder, order, "L", _1), LLEventPump::NameList{"c"});
+	}
+	return false;
+}
+
+template<> template<>
+void events_object::test<17>()
+{
+	set_test_name("fast and signal dispatch call the same listeners");
+	for (S32 fast = 0; fast < 2; ++fast)
+	{
+		LLEventPump::setFastDispatch(fast != 0);
+		LLEventStream pump("dispatch", true);
+		std::string order;
+		pump.listen("a", boost::bind(recordOrder, &order, "a", _1));
+		pump.listen("b", boost::bind(recordOrder, &order, "b", _1), LLEventPump::NameList{"a"});
+		pump.listen("c", boost::bind(recordOrder, &order, "c", _1), LLEventPump::NameList{"b"});
+		// anonymous listeners share the first named listener's place and
+		// come after it
+		LLBoundListener anon = pump.listen(LLEventPump::ANONYMOUS, boost::bind(recordOrder, &order, "x", _1));
+		pump.post(1);
+		ensure_equals("order", order, "axbc");
+
+		// disconnected without stopListening(), then blocked
+		anon.disconnect();
+		order.clear();
+		{
+			LLEventPump::Blocker block(pump.getListener("b"));
+			pump.post(2);
+		}
+		ensure_equals("disconnected and blocked", order, "ac");
+
+		// the next post lets go of a listener dropped the same way (mSignal
+		// may keep its slot until it cleans up on its own)
+		if (fast)
+		{
+			LLBoundListener dropped = pump.listen(LLEventPump::ANONYMOUS, CopyCounter());
+			ensure("dropped listener held", CopyCounter::sCopies > 0);
+			dropped.disconnect();
+			pump.post(2);
+			ensure_equals("dropped listener released", CopyCounter::sCopies, 0);
+		}
+
+		// connected while posting: only the next post sees it
+		pump.listen("adder", boost::bind(connectDuringPost, &pump, &order, _1));
+		order.clear();
+		pump.post(3);
+		ensure_equals("added during post", order, "abc");
+		order.clear();
+		pump.post(4);
+		ensure_equals("added after post", order, "abcL");
+		pump.stopListening("adder");
+		pump.stopListening("late");
+
+		// stop when handled
+		listener0.reset(0);
+		listener0.listenTo(pump, &Listener::callstop, LLEventPump::NameList{"c"});
+		order.clear();
+		pump.post(5);
+		ensure_equals("stopped", order, "abc");
+		check_listener("stopper", listener0, 5);
+		pump.stopListening(listener0.getName());
+
+		// tracked listener goes when its object does
+		bool live = false;
+		{
+			TempTrackableListener tracked("tracked", live);
+			pump.listen(tracked.getName(), boost::bind(&TempTrackableListener::call, boost::ref(tracked), _1));
+			pump.post(6);
+			check_listener("tracked", tracked, 6);
+		}
+		ensure("tracked destroyed", !live);
+		pump.post(7);
+	}
+	LLEventPump::setFastDispatch(true);
+}
+
+template<> template<>
+void events_object::test<18>()
+{
+	set_test_name("event throughput");
+	const S32 POSTS = 200000;
+	std::cout << "\n" << POSTS << " posts on an LLEventStream:" << std::endl;
+	for (S32 listeners = 1; listeners <= 100; listeners *= 10)
+	{
+		std::vector<CountingListener> counters(listeners);
+		LLEventStream pump("throughput", true);
+		for (S32 i = 0; i < listeners; ++i)
+		{
+			pump.listen(STRINGIZE("counter" << i), boost::bind(&CountingListener::call, &counters[i], _1));
+		}
+		const LLSD event(LLSD::emptyMap().with("status", 200));
+		F64 seconds[2];
+		for (S32 fast = 0; fast < 2; ++fast)
+		{
+			LLEventPump::setFastDispatch(fast != 0);
+			LLTimer timer;
+			for (S32 i = 0; i < POSTS; ++i)
+			{
+				pump.post(event);
+			}
+			seconds[fast] = timer.getElapsedTimeF64();
+		}
+		LLEventPump::setFastDispatch(true);
+		ensure_equals("every listener called", counters.back().mCalls, POSTS * 2);
+		std::cout << "  " << listeners << " listener(s): signal " << POSTS / seconds[0] << " posts/s, flat "
+				  << POSTS / seconds[1] << " posts/s" << std::endl;
+	}
+}
+// </polarity>
 } // namespace tut